@@ -12,6 +12,7 @@ TabbedPane {
             singleShot: true
             onTimeout: {
                 // delayed init of data
+                dataManager.traceMark("startupDelayedTimer.timeout")
                 dataManager.init()
             }
         }
@@ -37,6 +38,7 @@ TabbedPane {
 
     onCreationCompleted: {
         // init dataManager, connect(), SceneCover
+        dataManager.traceMark("startupDelayedTimer.start")
         startupDelayedTimer.start()
     }
 }
@@ -0,0 +1,800 @@
+#include "BenchmarkRunner.hpp"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QtAlgorithms>
+#include <QDebug>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include "DatasetGenerator.hpp"
+#include "DataWriter.hpp"
+#include "OrderColumns.hpp"
+#include "AggregationKernels.hpp"
+#include "DateCodec.hpp"
+#include "src-gen/DataManager.hpp"
+#include "src-gen/Order.hpp"
+#include "src-gen/Department.hpp"
+#include "src-gen/Item.hpp"
+#include "src-gen/SubItem.hpp"
+#include "src-gen/Info.hpp"
+
+BenchmarkRunner::BenchmarkRunner(const Options& options, DataWriter* report) :
+		mOptions(options), mReport(report)
+{
+}
+
+BenchmarkRunner::~BenchmarkRunner()
+{
+}
+
+bool BenchmarkRunner::run()
+{
+	QString startDirectory = QDir::currentPath();
+	mReport->beginObject();
+	mReport->writeString("benchmark", "ekkesDSLSample data layer");
+	mReport->writeString("timestamp", QDateTime::currentDateTime().toString(Qt::ISODate));
+	mReport->writeString("qtVersion", qVersion());
+	mReport->writeString("instructionSet", AggregationKernels::instructionSet());
+	mReport->writeInt("seed", (int) mOptions.seed);
+	mReport->writeBool("binaryCache", mOptions.binaryCache);
+	mReport->writeInt("lookups", mOptions.lookups);
+	mReport->beginArray("microbenchmarks");
+	bool dateCodecMatch = runDateCodec();
+	mReport->endArray();
+	mReport->writeBool("dateCodecMatch", dateCodecMatch);
+	mReport->beginArray("runs");
+	bool ok = dateCodecMatch;
+	for (int i = 0; i < mOptions.orderCounts.size() && ok; ++i) {
+		ok = runScale(mOptions.orderCounts.at(i));
+	}
+	mReport->endArray();
+	mReport->endObject();
+	QDir::setCurrent(startDirectory);
+	return mReport->flush() && ok;
+}
+
+bool BenchmarkRunner::runScale(const int& orders)
+{
+	QDir scaleDirectory(QDir(mOptions.workDirectory).filePath(QString("orders-%1").arg(orders)));
+	if (!scaleDirectory.mkpath("data")) {
+		qWarning() << "cannot create" << scaleDirectory.absolutePath();
+		return false;
+	}
+	// start without caches and database of the last run
+	QDir dataDirectory(scaleDirectory.filePath("data"));
+	QStringList oldFiles = dataDirectory.entryList(QDir::Files);
+	for (int i = 0; i < oldFiles.size(); ++i) {
+		dataDirectory.remove(oldFiles.at(i));
+	}
+	QDir::setCurrent(scaleDirectory.absolutePath());
+
+	DatasetGenerator generator(DatasetGenerator::scaleForOrders(orders, mOptions.positionsPerOrder),
+			mOptions.seed);
+	const DatasetGenerator::Scale& scale = generator.scale();
+	mReport->beginObject();
+	mReport->writeInt("orders", scale.orders);
+	mReport->writeInt("customers", scale.customers);
+	mReport->writeInt("topics", scale.topics);
+	mReport->writeInt("departments", scale.departments);
+	mReport->writeInt("tags", scale.tags);
+	mReport->writeInt("xtras", scale.xtras);
+	mReport->writeInt("positionsPerOrder", scale.positionsPerOrder);
+	mReport->beginArray("operations");
+
+	// Tag lives in SQLite: an empty DataManager imports and saves them
+	DataManager* tagManager = new DataManager();
+	tagManager->init();
+	tagManager->insertTags(generator.createTags());
+	startOperation();
+	tagManager->saveTagToSqlCache();
+	finishOperation("saveTagToSqlCache");
+	delete tagManager;
+	QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+
+	startOperation();
+	bool generated = generator.writeCaches(dataDirectory.absolutePath(), mOptions.binaryCache);
+	finishOperation("generateCaches");
+	if (!generated) {
+		mReport->endArray();
+		mReport->endObject();
+		return false;
+	}
+
+	DataManager* dataManager = new DataManager();
+	startOperation();
+	dataManager->init();
+	finishOperation("init");
+	QVariantMap initStages = dataManager->metrics().value("initStages").toMap();
+	QVariantMap::const_iterator it;
+	for (it = initStages.constBegin(); it != initStages.constEnd(); ++it) {
+		writeStage("init." + it.key(), it.value().toLongLong());
+	}
+	// estimated heap of DataObjects and caches - positions are still pending here
+	QVariantMap memoryAfterInit = dataManager->memoryStatistics();
+
+	DatasetGenerator random(scale, mOptions.seed + 1);
+	int lookupsFound = runLookups(dataManager, &random);
+	int queryResults = runQueries(dataManager, &random);
+	bool kernelsMatch = runKernels(dataManager);
+	// lookups and queries materialized positions and built the indexes
+	QVariantMap memoryAfterQueries = dataManager->memoryStatistics();
+
+	// as on low memory: positions and references of all cold Order are released
+	startOperation();
+	dataManager->evictColdOrders(true);
+	QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+	finishOperation("evictColdOrders");
+	QVariantMap memoryAfterEviction = dataManager->memoryStatistics();
+	int positionsAfterEviction = runAccessAfterEviction(dataManager, &random);
+	// as many cascaded DataObjects as all positions of this scale
+	runAllocations(scale.orders * qMax(1, scale.positionsPerOrder));
+	QVariantMap dataObjectPools = dataManager->dataObjectPoolStatistics();
+
+	// fill...DataModel hands this list to GroupDataModel::insertList()
+	startOperation();
+	QList<QObject*> orderList = dataManager->allOrder();
+	finishOperation("allOrder");
+	orderList.clear();
+
+	startOperation();
+	dataManager->finish();
+	finishOperation("finish");
+	// counters of all operations above - find hits / misses, parsed and saved records ...
+	QVariantMap metrics = dataManager->metrics();
+
+	startOperation();
+	delete dataManager;
+	QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+	finishOperation("deleteDataManager");
+	QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+
+	mReport->endArray();
+	mReport->writeBool("kernelsMatch", kernelsMatch);
+	// found Objects and results of the timed loops
+	mReport->writeInt("lookupsFound", lookupsFound);
+	mReport->writeInt("queryResults", queryResults);
+	mReport->writeInt("positionsAfterEviction", positionsAfterEviction);
+	mReport->writeVariant("metrics", metrics);
+	mReport->writeVariant("memoryAfterInit", memoryAfterInit);
+	mReport->writeVariant("memoryAfterQueries", memoryAfterQueries);
+	mReport->writeVariant("memoryAfterEviction", memoryAfterEviction);
+	mReport->writeVariant("dataObjectPools", dataObjectPools);
+	qint64 cacheBytes = 0;
+	QFileInfoList cacheFiles = dataDirectory.entryInfoList(QDir::Files);
+	for (int i = 0; i < cacheFiles.size(); ++i) {
+		cacheBytes += cacheFiles.at(i).size();
+	}
+	mReport->writeDouble("cacheBytes", (double) cacheBytes);
+	mReport->endObject();
+	return kernelsMatch;
+}
+
+/*
+ * random keys are created before the timed loops
+ * about 5% of the keys don't exist - misses are part of real use
+ * returns the number of Objects found
+ */
+int BenchmarkRunner::runLookups(DataManager* dataManager, DatasetGenerator* random)
+{
+	const DatasetGenerator::Scale& scale = random->scale();
+	int lookups = qMax(1, mOptions.lookups);
+	QVector<int> keys(lookups);
+	QVector<qint64> latencies;
+	latencies.reserve(lookups);
+	int found;
+
+	for (int i = 0; i < lookups; ++i) {
+		keys[i] = 1 + random->nextInt(scale.orders + scale.orders / 20 + 1);
+	}
+	found = 0;
+	startOperation();
+	for (int i = 0; i < lookups; ++i) {
+		mLatencyTimer.start();
+		found += (dataManager->findOrderByNr(keys.at(i)) != 0);
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("findOrderByNr", latencies);
+
+	for (int i = 0; i < lookups; ++i) {
+		keys[i] = 1 + random->nextSkewed(scale.customers + scale.customers / 20 + 1);
+	}
+	startOperation();
+	for (int i = 0; i < lookups; ++i) {
+		mLatencyTimer.start();
+		found += (dataManager->findCustomerById(keys.at(i)) != 0);
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("findCustomerById", latencies);
+
+	for (int i = 0; i < lookups; ++i) {
+		keys[i] = 1 + random->nextInt(scale.topics + scale.topics / 20 + 1);
+	}
+	startOperation();
+	for (int i = 0; i < lookups; ++i) {
+		mLatencyTimer.start();
+		found += (dataManager->findTopicById(keys.at(i)) != 0);
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("findTopicById", latencies);
+
+	for (int i = 0; i < lookups; ++i) {
+		keys[i] = 1 + random->nextInt(scale.departments + scale.departments / 20 + 1);
+	}
+	startOperation();
+	for (int i = 0; i < lookups; ++i) {
+		mLatencyTimer.start();
+		found += (dataManager->findDepartmentById(keys.at(i)) != 0);
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("findDepartmentById", latencies);
+
+	for (int i = 0; i < lookups; ++i) {
+		keys[i] = 1 + random->nextInt(scale.xtras + scale.xtras / 20 + 1);
+	}
+	startOperation();
+	for (int i = 0; i < lookups; ++i) {
+		mLatencyTimer.start();
+		found += (dataManager->findXtrasById(keys.at(i)) != 0);
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("findXtrasById", latencies);
+
+	QStringList uuids;
+	for (int i = 0; i < lookups; ++i) {
+		uuids.append(DatasetGenerator::tagUuid(1 + random->nextInt(scale.tags + scale.tags / 20 + 1)));
+	}
+	startOperation();
+	for (int i = 0; i < lookups; ++i) {
+		mLatencyTimer.start();
+		found += (dataManager->findTagByUuid(uuids.at(i)) != 0);
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("findTagByUuid", latencies);
+
+	// barcodes of SubItems maybe not created: pos and subPos are random
+	QStringList barcodes;
+	for (int i = 0; i < lookups; ++i) {
+		barcodes.append(
+				DatasetGenerator::subItemBarcode(1 + random->nextInt(scale.orders),
+						1 + random->nextInt(qMax(1, scale.positionsPerOrder)),
+						1 + random->nextInt(qMax(1, scale.subItemsPerPosition))));
+	}
+	// the first lookup builds the barcode index
+	startOperation();
+	found += (dataManager->findSubItemByBarcode(barcodes.first()) != 0);
+	finishOperation("findSubItemByBarcode.buildIndex");
+	startOperation();
+	for (int i = 0; i < lookups; ++i) {
+		mLatencyTimer.start();
+		found += (dataManager->findSubItemByBarcode(barcodes.at(i)) != 0);
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("findSubItemByBarcode", latencies);
+	return found;
+}
+
+/*
+ * positions and customer of random Order - evicted ones are restored
+ * see counters reloadedPositions and reloadedReferences in metrics
+ * returns the number of positions accessed
+ */
+int BenchmarkRunner::runAccessAfterEviction(DataManager* dataManager, DatasetGenerator* random)
+{
+	const DatasetGenerator::Scale& scale = random->scale();
+	int lookups = qMax(1, mOptions.lookups);
+	QVector<int> keys(lookups);
+	QVector<qint64> latencies;
+	latencies.reserve(lookups);
+	int positions = 0;
+
+	for (int i = 0; i < lookups; ++i) {
+		keys[i] = 1 + random->nextInt(scale.orders);
+	}
+	startOperation();
+	for (int i = 0; i < lookups; ++i) {
+		mLatencyTimer.start();
+		Order* order = dataManager->findOrderByNr(keys.at(i));
+		if (order) {
+			positions += order->positions().size();
+			order->customerIdAsDataObject();
+		}
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("accessAfterEviction", latencies);
+	return positions;
+}
+
+/*
+ * 1M yyyy-MM-dd values: DateCodec against QDate::fromString()
+ * all values are created before the timed loops
+ * false if any result differs
+ */
+bool BenchmarkRunner::runDateCodec()
+{
+	static const int dateCount = 1000000;
+	QDate firstDate = DatasetGenerator::firstOrderDate();
+	int days = qMax(1, firstDate.daysTo(DatasetGenerator::lastOrderDate()));
+	QStringList values;
+	values.reserve(dateCount);
+	for (int i = 0; i < dateCount; ++i) {
+		values.append(firstDate.addDays(i % days).toString("yyyy-MM-dd"));
+	}
+	QVector<int> codecDays(dateCount);
+	QVector<int> qtDays(dateCount);
+
+	startOperation();
+	for (int i = 0; i < dateCount; ++i) {
+		codecDays[i] = (int) DateCodec::fromIsoString(values.at(i)).toJulianDay();
+	}
+	finishOperation("dateCodec.fromIsoString");
+	startOperation();
+	for (int i = 0; i < dateCount; ++i) {
+		qtDays[i] = (int) QDate::fromString(values.at(i), "yyyy-MM-dd").toJulianDay();
+	}
+	finishOperation("dateCodec.qDateFromString");
+
+	bool match = codecDays == qtDays;
+	if (!match) {
+		qWarning() << "DateCodec differs from QDate::fromString";
+	}
+	return match;
+}
+
+// returns the number of results of all queries
+int BenchmarkRunner::runQueries(DataManager* dataManager, DatasetGenerator* random)
+{
+	int queries = qMax(10, mOptions.lookups / 100);
+	QDate firstDate = DatasetGenerator::firstOrderDate();
+	int days = firstDate.daysTo(DatasetGenerator::lastOrderDate());
+	const DatasetGenerator::Scale& scale = random->scale();
+	QVector<qint64> latencies;
+	latencies.reserve(queries);
+	int results = 0;
+
+	QList<QVariantMap> queryMaps;
+	for (int i = 0; i < queries; ++i) {
+		QDate from = firstDate.addDays(random->nextInt(days - 30));
+		QVariantMap queryMap;
+		queryMap.insert("orderDateFrom", from.toString(Qt::ISODate));
+		queryMap.insert("orderDateTo", from.addDays(30).toString(Qt::ISODate));
+		queryMap.insert("states", QVariantList() << random->nextInt(4));
+		queryMap.insert("sortBy", QStringList() << "orderDate" << "-nr");
+		queryMap.insert("limit", 50);
+		queryMaps.append(queryMap);
+	}
+	startOperation();
+	for (int i = 0; i < queries; ++i) {
+		mLatencyTimer.start();
+		results += dataManager->queryOrderKeys(queryMaps.at(i)).size();
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("queryOrderKeys.dateRangeAndState", latencies);
+
+	queryMaps.clear();
+	for (int i = 0; i < queries; ++i) {
+		QVariantMap queryMap;
+		queryMap.insert("depId", 1 + random->nextInt(scale.departments));
+		queryMap.insert("depSubtree", true);
+		queryMap.insert("expressOrder", true);
+		queryMap.insert("sortBy", QStringList() << "-orderDate");
+		queryMap.insert("limit", 50);
+		queryMaps.append(queryMap);
+	}
+	startOperation();
+	for (int i = 0; i < queries; ++i) {
+		mLatencyTimer.start();
+		results += dataManager->queryOrderKeys(queryMaps.at(i)).size();
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("queryOrderKeys.departmentSubtree", latencies);
+
+	startOperation();
+	for (int i = 0; i < queries; ++i) {
+		QDate from = firstDate.addDays(random->nextInt(days - 365));
+		mLatencyTimer.start();
+		results += dataManager->orderStateCountsByDay(from, from.addDays(365)).size();
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("orderStateCountsByDay.year", latencies);
+
+	startOperation();
+	for (int i = 0; i < queries; ++i) {
+		mLatencyTimer.start();
+		results += dataManager->orderDateHistogram(firstDate, DatasetGenerator::lastOrderDate(), 7).size();
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("orderDateHistogram.weeks", latencies);
+
+	startOperation();
+	for (int i = 0; i < queries; ++i) {
+		mLatencyTimer.start();
+		results += dataManager->orderCountsByCustomer().size();
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("orderCountsByCustomer", latencies);
+
+	// the first search builds the word index
+	startOperation();
+	results += dataManager->searchOrders("service", 50).size();
+	finishOperation("searchOrders.buildIndex");
+	static const char* prefixes[] = { "ser", "rep", "cab", "mon", "express kit", "net", "bat", "spare parts" };
+	startOperation();
+	for (int i = 0; i < queries; ++i) {
+		mLatencyTimer.start();
+		results += dataManager->searchOrders(prefixes[i % 8], 50).size();
+		latencies.append(mLatencyTimer.nsecsElapsed());
+	}
+	finishOperation("searchOrders", latencies);
+	return results;
+}
+
+/*
+ * vector kernels against the plain loops on the Order columns
+ * false if any result differs
+ */
+bool BenchmarkRunner::runKernels(DataManager* dataManager)
+{
+	OrderColumns columns;
+	columns.rebuild(dataManager->allOrder());
+	const int* dates = columns.orderDateColumn();
+	const int* states = columns.stateColumn();
+	int size = columns.size();
+	int from = OrderColumns::julianDay(DatasetGenerator::firstOrderDate().addDays(100));
+	int to = OrderColumns::julianDay(DatasetGenerator::firstOrderDate().addDays(465));
+	int repeat = qMax(1, 10000000 / qMax(1, size));
+	bool match = true;
+	int vectorResult = 0;
+	int scalarResult = 0;
+
+	startOperation();
+	for (int i = 0; i < repeat; ++i) {
+		vectorResult = AggregationKernels::countInRange(dates, size, from, to);
+	}
+	finishOperation("kernel.countInRange");
+	startOperation();
+	for (int i = 0; i < repeat; ++i) {
+		scalarResult = AggregationKernels::countInRangeScalar(dates, size, from, to);
+	}
+	finishOperation("kernel.countInRangeScalar");
+	match = match && vectorResult == scalarResult;
+
+	startOperation();
+	for (int i = 0; i < repeat; ++i) {
+		vectorResult = AggregationKernels::countEqual(states, size, 3);
+	}
+	finishOperation("kernel.countEqual");
+	startOperation();
+	for (int i = 0; i < repeat; ++i) {
+		scalarResult = AggregationKernels::countEqualScalar(states, size, 3);
+	}
+	finishOperation("kernel.countEqualScalar");
+	match = match && vectorResult == scalarResult;
+
+	int vectorMin = 0;
+	int vectorMax = 0;
+	int scalarMin = 0;
+	int scalarMax = 0;
+	startOperation();
+	for (int i = 0; i < repeat; ++i) {
+		AggregationKernels::minMax(dates, size, vectorMin, vectorMax);
+	}
+	finishOperation("kernel.minMax");
+	startOperation();
+	for (int i = 0; i < repeat; ++i) {
+		AggregationKernels::minMaxScalar(dates, size, scalarMin, scalarMax);
+	}
+	finishOperation("kernel.minMaxScalar");
+	match = match && vectorMin == scalarMin && vectorMax == scalarMax;
+
+	qint64 vectorSum = 0;
+	qint64 scalarSum = 0;
+	startOperation();
+	for (int i = 0; i < repeat; ++i) {
+		vectorSum = AggregationKernels::sum(dates, size);
+	}
+	finishOperation("kernel.sum");
+	startOperation();
+	for (int i = 0; i < repeat; ++i) {
+		scalarSum = AggregationKernels::sumScalar(dates, size);
+	}
+	finishOperation("kernel.sumScalar");
+	match = match && vectorSum == scalarSum;
+
+	if (!match) {
+		qWarning() << "vector kernels differ from scalar loops";
+	}
+
+	// short lengths run only the tails, the edges of int wrap in unsigned offsets
+	QVector<int> dateValues(size);
+	QVector<int> stateValues(size);
+	for (int i = 0; i < size; ++i) {
+		dateValues[i] = dates[i];
+		stateValues[i] = states[i];
+	}
+	static const int edgeValues[] = { INT_MIN, INT_MIN + 1, -101, -1, 0, 1, 100, INT_MAX - 1, INT_MAX };
+	static const int edgeCount = sizeof(edgeValues) / sizeof(edgeValues[0]);
+	QVector<int> edges(edgeCount * 5);
+	QVector<int> edgeGroups(edges.size());
+	for (int i = 0; i < edges.size(); ++i) {
+		edges[i] = edgeValues[(i * 7) % edgeCount];
+		// -1 and 4 are outside of the 4 groups
+		edgeGroups[i] = i % 6 - 1;
+	}
+	bool kernelsChecked = checkKernels(dateValues, stateValues) && checkKernels(edges, edgeGroups);
+	if (!kernelsChecked) {
+		qWarning() << "kernels differ from naive loops";
+	}
+	bool aggregationsChecked = checkAggregations(dataManager);
+	if (!aggregationsChecked) {
+		qWarning() << "DataManager aggregations differ from naive loops over Order";
+	}
+	return match && kernelsChecked && aggregationsChecked;
+}
+
+/*
+ * all kernels against naive loops in 64 bit arithmetic
+ * for the lengths 0 .. 17 (vector blocks plus tails of 1 - 3) and the whole array
+ * groups: the second column of countByDayAndGroup
+ */
+bool BenchmarkRunner::checkKernels(const QVector<int>& values, const QVector<int>& groups)
+{
+	static const int bucketCount = 8;
+	static const int bucketWidth = 25;
+	static const int dayCount = 201;
+	static const int groupCount = 4;
+	bool match = true;
+	for (int length = 0; length <= values.size(); ++length) {
+		if (length > 17 && length < values.size()) {
+			length = values.size();
+		}
+		const int* data = values.constData();
+		int firstValue = length > 0 ? data[0] : 0;
+		int from = (int) qMax((qint64) INT_MIN, (qint64) firstValue - 100);
+		int to = (int) qMin((qint64) INT_MAX, (qint64) firstValue + 100);
+
+		int naiveEqual = 0;
+		int naiveInRange = 0;
+		qint64 naiveSum = 0;
+		int naiveMin = INT_MAX;
+		int naiveMax = INT_MIN;
+		QVector<int> naiveHistogram(bucketCount, 0);
+		QVector<int> naiveHalves(2, 0);
+		QVector<int> naiveByValue(dayCount, 0);
+		QVector<int> naiveByDayAndGroup(dayCount * groupCount, 0);
+		for (int i = 0; i < length; ++i) {
+			qint64 value = data[i];
+			naiveEqual += (value == firstValue);
+			naiveInRange += (value >= from && value <= to);
+			naiveSum += value;
+			naiveMin = qMin(naiveMin, data[i]);
+			naiveMax = qMax(naiveMax, data[i]);
+			qint64 offset = value - from;
+			if (offset >= 0 && offset / bucketWidth < bucketCount) {
+				naiveHistogram[(int) (offset / bucketWidth)]++;
+			}
+			// INT_MIN .. INT_MAX in two buckets of 2^31
+			naiveHalves[(int) ((value - INT_MIN) >> 31)]++;
+			if (offset >= 0 && offset < dayCount) {
+				naiveByValue[(int) offset]++;
+				if (groups.at(i) >= 0 && groups.at(i) < groupCount) {
+					naiveByDayAndGroup[(int) offset * groupCount + groups.at(i)]++;
+				}
+			}
+		}
+
+		int minValue = 0;
+		int maxValue = 0;
+		bool hasMinMax = AggregationKernels::minMax(data, length, minValue, maxValue);
+		match = match && hasMinMax == (length > 0)
+				&& (!hasMinMax || (minValue == naiveMin && maxValue == naiveMax));
+		match = match && AggregationKernels::countEqual(data, length, firstValue) == naiveEqual;
+		match = match && AggregationKernels::countInRange(data, length, from, to) == naiveInRange;
+		match = match && AggregationKernels::sum(data, length) == naiveSum;
+
+		QVector<int> counts(bucketCount, 0);
+		AggregationKernels::histogram(data, length, from, bucketWidth, counts.data(), bucketCount);
+		match = match && counts == naiveHistogram;
+		counts.fill(0, 2);
+		AggregationKernels::histogram(data, length, INT_MIN, 1u << 31, counts.data(), 2);
+		match = match && counts == naiveHalves;
+		counts.fill(0, dayCount);
+		AggregationKernels::countByValue(data, length, from, counts.data(), dayCount);
+		match = match && counts == naiveByValue;
+		counts.fill(0, dayCount * groupCount);
+		AggregationKernels::countByDayAndGroup(data, groups.constData(), length, from, dayCount, counts.data(),
+				groupCount);
+		match = match && counts == naiveByDayAndGroup;
+	}
+	return match;
+}
+
+/*
+ * the column based aggregations of DataManager against loops over the Order objects
+ */
+bool BenchmarkRunner::checkAggregations(DataManager* dataManager)
+{
+	static const char* stateNames[] = { "NEW", "CONFIRMED", "DELIVERED", "CLOSED" };
+	static const int stateCount = 4;
+	static const int bucketDays = 7;
+	QDate fromDate = DatasetGenerator::firstOrderDate().addDays(100);
+	QDate toDate = DatasetGenerator::firstOrderDate().addDays(465);
+	int dayCount = fromDate.daysTo(toDate) + 1;
+	int bucketCount = (dayCount + bucketDays - 1) / bucketDays;
+
+	QVector<int> naiveByDay(dayCount * stateCount, 0);
+	QVector<int> naiveBuckets(bucketCount, 0);
+	QHash<int, int> naiveByDepId;
+	QList<QObject*> orderList = dataManager->allOrder();
+	for (int i = 0; i < orderList.size(); ++i) {
+		Order* order = (Order*) orderList.at(i);
+		naiveByDepId[order->depId()]++;
+		QDate orderDate = order->orderDate();
+		if (!orderDate.isValid() || orderDate < fromDate || orderDate > toDate) {
+			continue;
+		}
+		int day = fromDate.daysTo(orderDate);
+		naiveBuckets[day / bucketDays]++;
+		if (order->state() >= 0 && order->state() < stateCount) {
+			naiveByDay[day * stateCount + order->state()]++;
+		}
+	}
+
+	bool match = true;
+	QVariantList dayList = dataManager->orderStateCountsByDay(fromDate, toDate);
+	match = match && dayList.size() == dayCount;
+	for (int day = 0; match && day < dayCount; ++day) {
+		QVariantMap dayMap = dayList.at(day).toMap();
+		for (int state = 0; state < stateCount; ++state) {
+			match = match && dayMap.value(stateNames[state]).toInt() == naiveByDay.at(day * stateCount + state);
+		}
+	}
+
+	QVariantList bucketList = dataManager->orderDateHistogram(fromDate, toDate, bucketDays);
+	match = match && bucketList.size() == bucketCount;
+	for (int bucket = 0; match && bucket < bucketCount; ++bucket) {
+		match = bucketList.at(bucket).toMap().value("count").toInt() == naiveBuckets.at(bucket);
+	}
+
+	QVariantMap departmentMap = dataManager->orderCountsByDepartment(true);
+	QList<QObject*> departmentList = dataManager->allDepartmentFlat();
+	match = match && departmentMap.size() == departmentList.size() + (naiveByDepId.contains(-1) ? 1 : 0);
+	for (int i = 0; match && i < departmentList.size(); ++i) {
+		Department* department = (Department*) departmentList.at(i);
+		int count = naiveByDepId.value(department->id());
+		QList<QObject*> children = department->allDepartmentChildren();
+		for (int j = 0; j < children.size(); ++j) {
+			count += naiveByDepId.value(((Department*) children.at(j))->id());
+		}
+		match = departmentMap.value(QString::number(department->id())).toInt() == count;
+	}
+	match = match && departmentMap.value("-1").toInt() == naiveByDepId.value(-1);
+	return match;
+}
+
+/*
+ * cascaded DataObjects from DataObjectPool against the global heap
+ * the heap loops allocate raw memory of the same sizes,
+ * the pool loops create and delete Item, SubItem and Info -
+ * so the pool numbers include the QObject constructors.
+ * allocations, releases and chunks are counted in dataObjectPools
+ */
+void BenchmarkRunner::runAllocations(const int& count)
+{
+	QVector<void*> memory(count * 3);
+	startOperation();
+	for (int i = 0; i < count; ++i) {
+		memory[i * 3] = ::operator new(sizeof(Item));
+		memory[i * 3 + 1] = ::operator new(sizeof(SubItem));
+		memory[i * 3 + 2] = ::operator new(sizeof(Info));
+	}
+	finishOperation("allocation.heap.allocate");
+	startOperation();
+	for (int i = 0; i < memory.size(); ++i) {
+		::operator delete(memory.at(i));
+	}
+	finishOperation("allocation.heap.release");
+	memory.clear();
+
+	QVector<Item*> items(count);
+	QVector<SubItem*> subItems(count);
+	QVector<Info*> infos(count);
+	startOperation();
+	for (int i = 0; i < count; ++i) {
+		items[i] = new Item();
+		subItems[i] = new SubItem();
+		infos[i] = new Info();
+	}
+	finishOperation("allocation.pool.create");
+	startOperation();
+	for (int i = 0; i < count; ++i) {
+		delete infos.at(i);
+		delete subItems.at(i);
+		delete items.at(i);
+	}
+	finishOperation("allocation.pool.delete");
+}
+
+void BenchmarkRunner::startOperation()
+{
+	resetPeakRss();
+	mOperationTimer.start();
+}
+
+/*
+ * latencies in ns - cleared for the next operation
+ * without latencies the whole operation is the only sample
+ */
+void BenchmarkRunner::finishOperation(const QString& name, QVector<qint64>& latencies)
+{
+	qint64 totalNs = mOperationTimer.nsecsElapsed();
+	if (latencies.isEmpty()) {
+		latencies.append(totalNs);
+	}
+	qSort(latencies.begin(), latencies.end());
+	int size = latencies.size();
+	mReport->beginObject();
+	mReport->writeString("name", name);
+	mReport->writeInt("iterations", size);
+	mReport->writeDouble("totalMs", totalNs / 1000000.0);
+	mReport->writeDouble("throughput", totalNs > 0 ? size * 1000000000.0 / totalNs : 0.0);
+	mReport->writeDouble("p50Us", latencies.at((size - 1) * 50 / 100) / 1000.0);
+	mReport->writeDouble("p90Us", latencies.at((size - 1) * 90 / 100) / 1000.0);
+	mReport->writeDouble("p99Us", latencies.at((size - 1) * 99 / 100) / 1000.0);
+	mReport->writeDouble("maxUs", latencies.last() / 1000.0);
+	mReport->writeDouble("rssKb", (double) statusKb("VmRSS:"));
+	mReport->writeDouble("peakRssKb", (double) statusKb("VmHWM:"));
+	mReport->endObject();
+	latencies.clear();
+}
+
+void BenchmarkRunner::finishOperation(const QString& name)
+{
+	QVector<qint64> latencies;
+	finishOperation(name, latencies);
+}
+
+void BenchmarkRunner::writeStage(const QString& name, const qint64& milliseconds)
+{
+	mReport->beginObject();
+	mReport->writeString("name", name);
+	mReport->writeInt("iterations", 1);
+	mReport->writeDouble("totalMs", (double) milliseconds);
+	mReport->endObject();
+}
+
+/*
+ * since Linux 4.0 writing 5 to clear_refs resets VmHWM
+ */
+void BenchmarkRunner::resetPeakRss()
+{
+	FILE* clearRefs = fopen("/proc/self/clear_refs", "w");
+	if (clearRefs) {
+		fputs("5", clearRefs);
+		fclose(clearRefs);
+	}
+}
+
+qint64 BenchmarkRunner::statusKb(const char* field)
+{
+	FILE* status = fopen("/proc/self/status", "r");
+	if (!status) {
+		return 0;
+	}
+	char line[256];
+	qint64 kb = 0;
+	size_t fieldLength = strlen(field);
+	while (fgets(line, sizeof(line), status)) {
+		if (strncmp(line, field, fieldLength) == 0) {
+			kb = QByteArray(line + fieldLength).trimmed().split(' ').first().toLongLong();
+			break;
+		}
+	}
+	fclose(status);
+	return kb;
+}
@@ -0,0 +1,81 @@
+#ifndef BENCHMARKRUNNER_HPP_
+#define BENCHMARKRUNNER_HPP_
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QElapsedTimer>
+
+class DataWriter;
+class DataManager;
+class DatasetGenerator;
+
+/*
+ * runs the data layer benchmarks for each scale (number of Orders)
+ * and writes one JSON report
+ *
+ * per scale a fresh working directory is used:
+ *   Tags are saved to SQLite by a first DataManager (saveTagToSqlCache),
+ *   the other caches are written by DatasetGenerator,
+ *   a second DataManager runs init(), lookups, queries and finish().
+ * DataManager reads and writes <current directory>/data/,
+ * so the runner changes into the working directory of the scale.
+ *
+ * each operation reports:
+ *   iterations, totalMs, throughput (iterations per second),
+ *   latency percentiles p50 / p90 / p99 / max in microseconds,
+ *   rssKb after and peakRssKb while running (Linux: /proc/self/status,
+ *   the peak is reset before each operation - 0 if not available)
+ *
+ * microbenchmarks without cache files run once before the scales
+ */
+class BenchmarkRunner
+{
+public:
+
+	struct Options
+	{
+		QList<int> orderCounts;
+		quint32 seed;
+		bool binaryCache;
+		// lookups per find... operation
+		int lookups;
+		int positionsPerOrder;
+		QString workDirectory;
+	};
+
+	BenchmarkRunner(const Options& options, DataWriter* report);
+	virtual ~BenchmarkRunner();
+
+	bool run();
+
+private:
+
+	bool runDateCodec();
+	bool runScale(const int& orders);
+	// results are returned and reported: the timed loops can't be optimized away
+	int runLookups(DataManager* dataManager, DatasetGenerator* random);
+	int runQueries(DataManager* dataManager, DatasetGenerator* random);
+	int runAccessAfterEviction(DataManager* dataManager, DatasetGenerator* random);
+	bool runKernels(DataManager* dataManager);
+	bool checkKernels(const QVector<int>& values, const QVector<int>& groups);
+	bool checkAggregations(DataManager* dataManager);
+	void runAllocations(const int& count);
+
+	// timing and memory of one operation
+	void startOperation();
+	void finishOperation(const QString& name, QVector<qint64>& latencies);
+	void finishOperation(const QString& name);
+	// stages measured inside DataManager (init statistics)
+	void writeStage(const QString& name, const qint64& milliseconds);
+
+	static void resetPeakRss();
+	static qint64 statusKb(const char* field);
+
+	Options mOptions;
+	DataWriter* mReport;
+	QElapsedTimer mOperationTimer;
+	QElapsedTimer mLatencyTimer;
+};
+
+#endif /* BENCHMARKRUNNER_HPP_ */
@@ -0,0 +1,392 @@
+#include "DatasetGenerator.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QScopedPointer>
+#include <QVector>
+#include <QDebug>
+
+#include "JsonDataWriter.hpp"
+#include "BinaryDataWriter.hpp"
+#include "GeoCoordinate.hpp"
+#include "GeoAddress.hpp"
+#include "src-gen/Order.hpp"
+#include "src-gen/Item.hpp"
+#include "src-gen/SubItem.hpp"
+#include "src-gen/Info.hpp"
+#include "src-gen/Customer.hpp"
+#include "src-gen/Topic.hpp"
+#include "src-gen/Department.hpp"
+#include "src-gen/Tag.hpp"
+#include "src-gen/Xtras.hpp"
+#include "src-gen/OrderState.hpp"
+
+// same names as used by DataManager
+static const QString cacheOrder = "cacheOrder.json";
+static const QString cacheCustomer = "cacheCustomer.json";
+static const QString cacheTopic = "cacheTopic.json";
+static const QString cacheDepartment = "cacheDepartment.json";
+static const QString cacheXtras = "cacheXtras.json";
+
+// a few percent of the references point to nothing
+static const int UNRESOLVABLE_PERCENT = 2;
+static const int ROOT_TOPICS = 8;
+static const int ROOT_DEPARTMENTS = 4;
+
+DatasetGenerator::Scale DatasetGenerator::scaleForOrders(const int& orders, const int& positionsPerOrder)
+{
+	Scale scale;
+	scale.orders = orders;
+	scale.customers = qBound(10, orders / 20, 50000);
+	scale.topics = qBound(ROOT_TOPICS, orders / 1000, 500);
+	scale.departments = qBound(ROOT_DEPARTMENTS * 4, orders / 500, 2000);
+	scale.tags = qBound(16, orders / 1000, 1000);
+	scale.xtras = qBound(10, orders / 10, 100000);
+	scale.positionsPerOrder = qMax(0, positionsPerOrder);
+	scale.subItemsPerPosition = 2;
+	scale.valuesPerXtras = 64;
+	return scale;
+}
+
+DatasetGenerator::DatasetGenerator(const Scale& scale, const quint32& seed) :
+		mScale(scale), mState(seed ? seed : 0x9E3779B9)
+{
+	mWords << "express" << "delivery" << "spare" << "parts" << "repair" << "service" << "kit" << "cable"
+			<< "monitor" << "keyboard" << "battery" << "charger" << "holster" << "license" << "update"
+			<< "installation" << "training" << "consulting" << "hardware" << "software" << "network"
+			<< "router" << "switch" << "server" << "storage" << "backup" << "printer" << "toner" << "paper"
+			<< "office" << "desk" << "chair" << "lamp" << "phone" << "tablet" << "case" << "screen"
+			<< "adapter" << "mount" << "antenna";
+	mDomains << "sales" << "service" << "logistics" << "finance" << "support" << "field";
+	mCities << "Munich" << "Berlin" << "Hamburg" << "Cologne" << "Frankfurt" << "Stuttgart" << "Waterloo"
+			<< "Toronto" << "Ottawa" << "Vancouver";
+}
+
+DatasetGenerator::~DatasetGenerator()
+{
+}
+
+const DatasetGenerator::Scale& DatasetGenerator::scale() const
+{
+	return mScale;
+}
+
+/*
+ * xorshift32 - same sequence on all platforms
+ */
+quint32 DatasetGenerator::next()
+{
+	mState ^= mState << 13;
+	mState ^= mState >> 17;
+	mState ^= mState << 5;
+	return mState;
+}
+
+int DatasetGenerator::nextInt(const int& bound)
+{
+	if (bound <= 1) {
+		return 0;
+	}
+	return (int) (next() % (quint32) bound);
+}
+
+/*
+ * product of two uniform numbers: about a third of the values
+ * are below bound / 10 - like a few big customers with most orders
+ */
+int DatasetGenerator::nextSkewed(const int& bound)
+{
+	if (bound <= 1) {
+		return 0;
+	}
+	quint64 a = next() % (quint32) bound;
+	quint64 b = next() % (quint32) bound;
+	return (int) ((a * b) / (quint64) bound);
+}
+
+QString DatasetGenerator::tagUuid(const int& tagNr)
+{
+	return QString("00000000-0000-4000-8000-%1").arg(tagNr, 12, 10, QChar('0'));
+}
+
+QString DatasetGenerator::subItemBarcode(const int& orderNr, const int& posNr, const int& subPosNr)
+{
+	return QString("B%1-%2-%3").arg(orderNr, 8, 10, QChar('0')).arg(posNr).arg(subPosNr);
+}
+
+QDate DatasetGenerator::firstOrderDate()
+{
+	return QDate(2013, 1, 1);
+}
+
+QDate DatasetGenerator::lastOrderDate()
+{
+	return QDate(2015, 12, 31);
+}
+
+bool DatasetGenerator::writeCaches(const QString& dataDirectory, const bool& binary)
+{
+	QDir directory(dataDirectory);
+	if (!directory.exists() && !directory.mkpath(".")) {
+		qWarning() << "cannot create data directory" << dataDirectory;
+		return false;
+	}
+	return writeCache(directory.filePath(cacheCustomer), mScale.customers, binary,
+			&DatasetGenerator::writeCustomers)
+			&& writeCache(directory.filePath(cacheTopic), mScale.topics, binary, &DatasetGenerator::writeTopics)
+			&& writeCache(directory.filePath(cacheDepartment), mScale.departments, binary,
+					&DatasetGenerator::writeDepartments)
+			&& writeCache(directory.filePath(cacheXtras), mScale.xtras, binary,
+					&DatasetGenerator::writeXtrasList)
+			&& writeCache(directory.filePath(cacheOrder), mScale.orders, binary, &DatasetGenerator::writeOrders);
+}
+
+bool DatasetGenerator::writeCache(const QString& fileName, const int& count, const bool& binary,
+		void (DatasetGenerator::*writeRecords)(DataWriter* writer, const int& count))
+{
+	QFile cacheFile(fileName);
+	if (!cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		qWarning() << "cannot open cache to write: " << fileName;
+		return false;
+	}
+	QScopedPointer<DataWriter> writer;
+	if (binary) {
+		writer.reset(new BinaryDataWriter(&cacheFile));
+	} else {
+		writer.reset(new JsonDataWriter(&cacheFile));
+	}
+	writer->beginArray();
+	(this->*writeRecords)(writer.data(), count);
+	writer->endArray();
+	return writer->flush();
+}
+
+void DatasetGenerator::writeOrders(DataWriter* writer, const int& count)
+{
+	for (int nr = 1; nr <= count; ++nr) {
+		Order* order = createOrder(nr);
+		writer->beginObject();
+		order->writeTo(writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+		writer->endObject();
+		delete order;
+	}
+}
+
+void DatasetGenerator::writeCustomers(DataWriter* writer, const int& count)
+{
+	for (int id = 1; id <= count; ++id) {
+		Customer* customer = createCustomer(id);
+		writer->beginObject();
+		customer->writeTo(writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+		writer->endObject();
+		delete customer;
+	}
+}
+
+/*
+ * Orders only reference root Topics (DataManager finds root Topics by id)
+ * roots get up to two levels of subTopics with ids above count
+ */
+void DatasetGenerator::writeTopics(DataWriter* writer, const int& count)
+{
+	int subTopicId = count;
+	for (int id = 1; id <= count; ++id) {
+		Topic* topic = new Topic();
+		topic->setId(id);
+		topic->setUuid(QString("topic-%1").arg(id));
+		topic->setClassification(QString(QChar('A' + (id - 1) % 26)));
+		int subTopics = nextInt(3);
+		for (int i = 0; i < subTopics; ++i) {
+			Topic* subTopic = new Topic(topic);
+			subTopic->setId(++subTopicId);
+			subTopic->setUuid(QString("topic-%1").arg(subTopicId));
+			subTopic->setClassification(topic->classification() + QChar('A' + i));
+			topic->addToSubTopic(subTopic);
+		}
+		writer->beginObject();
+		topic->writeTo(writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+		writer->endObject();
+		delete topic;
+	}
+}
+
+/*
+ * random recursive tree: each Department below the roots
+ * becomes a child of one of the Departments created before
+ */
+void DatasetGenerator::writeDepartments(DataWriter* writer, const int& count)
+{
+	QVector<Department*> departments;
+	departments.reserve(count);
+	for (int id = 1; id <= count; ++id) {
+		Department* department;
+		if (id <= ROOT_DEPARTMENTS) {
+			department = new Department();
+		} else {
+			Department* parentDepartment = departments.at(nextInt(departments.size()));
+			department = new Department(parentDepartment);
+			parentDepartment->addToChildren(department);
+		}
+		department->setId(id);
+		department->setUuid(QString("department-%1").arg(id));
+		department->setName(words(2));
+		departments.append(department);
+	}
+	for (int i = 0; i < qMin(ROOT_DEPARTMENTS, departments.size()); ++i) {
+		writer->beginObject();
+		departments.at(i)->writeTo(writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+		writer->endObject();
+	}
+	// children are deleted with their roots
+	for (int i = 0; i < qMin(ROOT_DEPARTMENTS, departments.size()); ++i) {
+		delete departments.at(i);
+	}
+}
+
+void DatasetGenerator::writeXtrasList(DataWriter* writer, const int& count)
+{
+	for (int id = 1; id <= count; ++id) {
+		Xtras* xtras = createXtras(id);
+		writer->beginObject();
+		xtras->writeTo(writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+		writer->endObject();
+		delete xtras;
+	}
+}
+
+QList<Tag*> DatasetGenerator::createTags()
+{
+	static const char* colors[] = { "red", "green", "blue", "yellow", "orange", "grey" };
+	QList<Tag*> tagList;
+	tagList.reserve(mScale.tags);
+	for (int i = 1; i <= mScale.tags; ++i) {
+		Tag* tag = new Tag();
+		tag->setUuid(tagUuid(i));
+		tag->setName(words(1));
+		tag->setValue(nextInt(100));
+		tag->setColor(colors[nextInt(6)]);
+		tagList.append(tag);
+	}
+	return tagList;
+}
+
+Order* DatasetGenerator::createOrder(const int& nr)
+{
+	Order* order = new Order();
+	order->setNr(nr);
+	order->setExpressOrder(nextInt(10) == 0);
+	order->setTitle(words(2 + nextInt(4)));
+	int days = firstOrderDate().daysTo(lastOrderDate());
+	int day = nextInt(days + 1);
+	order->setOrderDate(firstOrderDate().addDays(day));
+	// older Orders are more likely closed
+	int age = days - day;
+	int stateDice = nextInt(100);
+	if (age > 180) {
+		order->setState(stateDice < 85 ? OrderState::CLOSED : OrderState::DELIVERED);
+	} else if (age > 30) {
+		order->setState(stateDice < 50 ? OrderState::DELIVERED : OrderState::CONFIRMED);
+	} else {
+		order->setState(stateDice < 60 ? OrderState::NEW : OrderState::CONFIRMED);
+	}
+	order->setProcessingState(nextInt(4));
+	if (nextInt(100) < 30) {
+		Info* info = new Info();
+		info->setUuid(QString("info-%1").arg(nr));
+		info->setRemarks(words(4 + nextInt(8)));
+		order->setInfo(info);
+	}
+	bool unresolvable = nextInt(100) < UNRESOLVABLE_PERCENT;
+	order->setTopicId(unresolvable ? mScale.topics * 10 + 1 : 1 + nextSkewed(mScale.topics));
+	order->setExtras(nextInt(100) < 40 ? 1 + nextInt(mScale.xtras) : -1);
+	order->setCustomerId(1 + nextSkewed(mScale.customers));
+	order->setDepId(1 + nextInt(mScale.departments));
+	int positions = mScale.positionsPerOrder > 0 ? 1 + nextInt(mScale.positionsPerOrder * 2 - 1) : 0;
+	for (int posNr = 1; posNr <= positions; ++posNr) {
+		Item* item = new Item(order);
+		item->setUuid(QString("item-%1-%2").arg(nr).arg(posNr));
+		item->setPosNr(posNr);
+		item->setName(words(1 + nextInt(3)));
+		item->setQuantity(1 + nextInt(20) * 0.5);
+		int subItems = nextInt(mScale.subItemsPerPosition * 2 + 1);
+		for (int subPosNr = 1; subPosNr <= subItems; ++subPosNr) {
+			SubItem* subItem = new SubItem(item);
+			subItem->setUuid(QString("subitem-%1-%2-%3").arg(nr).arg(posNr).arg(subPosNr));
+			subItem->setSubPosNr(subPosNr);
+			subItem->setDescription(words(2 + nextInt(4)));
+			subItem->setBarcode(subItemBarcode(nr, posNr, subPosNr));
+			item->addToSubItems(subItem);
+		}
+		order->addToPositions(item);
+	}
+	// Tag uuids are written from the Tag objects: temporary ones are enough
+	int tags = nextInt(4);
+	for (int i = 0; i < tags; ++i) {
+		Tag* tag = new Tag(order);
+		tag->setUuid(tagUuid(1 + nextSkewed(mScale.tags)));
+		order->addToTags(tag);
+	}
+	int domains = nextInt(3);
+	for (int i = 0; i < domains; ++i) {
+		order->addToDomainsStringList(mDomains.at(nextInt(mDomains.size())));
+	}
+	return order;
+}
+
+Customer* DatasetGenerator::createCustomer(const int& id)
+{
+	Customer* customer = new Customer();
+	customer->setId(id);
+	customer->setCompanyName(words(1 + nextInt(2)) + (nextInt(2) ? " Ltd" : " GmbH"));
+	if (nextInt(100) < 70) {
+		GeoCoordinate* coordinate = new GeoCoordinate();
+		coordinate->setUuid(QString("coordinate-%1").arg(id));
+		coordinate->setLatitude(47.0 + nextInt(60000) / 10000.0);
+		coordinate->setLongitude(6.0 + nextInt(90000) / 10000.0);
+		customer->setCoordinate(coordinate);
+	}
+	if (nextInt(100) < 80) {
+		GeoAddress* geoAddress = new GeoAddress();
+		geoAddress->setUuid(QString("address-%1").arg(id));
+		geoAddress->setCity(mCities.at(nextInt(mCities.size())));
+		geoAddress->setCountryCode(nextInt(4) ? "DE" : "CA");
+		geoAddress->setPostcode(QString::number(10000 + nextInt(89999)));
+		geoAddress->setStreet(words(1) + QString(" %1").arg(1 + nextInt(200)));
+		customer->setGeoAddress(geoAddress);
+	}
+	return customer;
+}
+
+/*
+ * values look like sensor readings: a slow wave plus noise
+ */
+Xtras* DatasetGenerator::createXtras(const int& id)
+{
+	Xtras* xtras = new Xtras();
+	xtras->setId(id);
+	xtras->setName(words(2));
+	QStringList text;
+	int lines = nextInt(3);
+	for (int i = 0; i < lines; ++i) {
+		text.append(words(3));
+	}
+	xtras->setTextStringList(text);
+	int size = mScale.valuesPerXtras > 0 ? nextInt(mScale.valuesPerXtras * 2) : 0;
+	QVector<int> values(size);
+	int level = nextInt(1000);
+	for (int i = 0; i < size; ++i) {
+		level += nextInt(21) - 10;
+		values[i] = level + nextInt(5);
+	}
+	xtras->setValues(values);
+	return xtras;
+}
+
+QString DatasetGenerator::words(const int& count)
+{
+	QStringList wordList;
+	for (int i = 0; i < count; ++i) {
+		wordList.append(mWords.at(nextSkewed(mWords.size())));
+	}
+	return wordList.join(" ");
+}
@@ -0,0 +1,103 @@
+#ifndef DATASETGENERATOR_HPP_
+#define DATASETGENERATOR_HPP_
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QDate>
+
+class DataWriter;
+class Order;
+class Customer;
+class Topic;
+class Department;
+class Tag;
+class Xtras;
+
+/*
+ * seeded generator of synthetic datasets for all DataObjects:
+ * Order (with Info, Item, SubItem), Customer, Topic, Department, Tag, Xtras
+ *
+ * the same seed and scale always produce the same data,
+ * random numbers come from an own xorshift generator - not from qrand()
+ *
+ * distributions try to look like real data:
+ *   few Customers get most of the Orders,
+ *   Orders spread over three years, older Orders are more likely closed,
+ *   Departments form a tree, Topics a shallow tree,
+ *   Orders reference inner and leaf Departments, some keys are not resolvable
+ *
+ * caches are streamed with the writeTo() of the DataObjects:
+ * only one Order lives at a time, so 1M Orders don't need 1M QObjects.
+ * Tags are read from SQLite by DataManager - createTags() hands out
+ * the Tag objects to be inserted and saved with saveTagToSqlCache()
+ */
+class DatasetGenerator
+{
+public:
+
+	struct Scale
+	{
+		int orders;
+		int customers;
+		int topics;
+		int departments;
+		int tags;
+		int xtras;
+		// average, the real number varies per Order / Item
+		int positionsPerOrder;
+		int subItemsPerPosition;
+		int valuesPerXtras;
+	};
+
+	// counts of all other DataObjects derived from the number of Orders
+	static Scale scaleForOrders(const int& orders, const int& positionsPerOrder = 3);
+
+	DatasetGenerator(const Scale& scale, const quint32& seed);
+	virtual ~DatasetGenerator();
+
+	const Scale& scale() const;
+
+	// writes cacheOrder, cacheCustomer, cacheTopic, cacheDepartment and cacheXtras
+	// into dataDirectory as JSON or binary
+	bool writeCaches(const QString& dataDirectory, const bool& binary);
+
+	// Tag objects without parent - the caller takes ownership
+	QList<Tag*> createTags();
+
+	// keys as written to the caches
+	static QString tagUuid(const int& tagNr);
+	static QString subItemBarcode(const int& orderNr, const int& posNr, const int& subPosNr);
+	static QDate firstOrderDate();
+	static QDate lastOrderDate();
+
+	// next random number of the seeded sequence
+	quint32 next();
+	// 0 .. bound - 1
+	int nextInt(const int& bound);
+	// 0 .. bound - 1, small values more likely
+	int nextSkewed(const int& bound);
+
+private:
+
+	bool writeCache(const QString& fileName, const int& count, const bool& binary,
+			void (DatasetGenerator::*writeRecords)(DataWriter* writer, const int& count));
+	void writeOrders(DataWriter* writer, const int& count);
+	void writeCustomers(DataWriter* writer, const int& count);
+	void writeTopics(DataWriter* writer, const int& count);
+	void writeDepartments(DataWriter* writer, const int& count);
+	void writeXtrasList(DataWriter* writer, const int& count);
+
+	Order* createOrder(const int& nr);
+	Customer* createCustomer(const int& id);
+	Xtras* createXtras(const int& id);
+	QString words(const int& count);
+
+	Scale mScale;
+	quint32 mState;
+	QStringList mWords;
+	QStringList mDomains;
+	QStringList mCities;
+};
+
+#endif /* DATASETGENERATOR_HPP_ */
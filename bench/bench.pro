@@ -0,0 +1,23 @@
+# headless benchmarks of the data layer
+# plain Qt on Linux - no Cascades, no BB10 libs:
+#   (cd ../core && qmake core.pro && make)
+#   qmake bench.pro && make && ./bench --orders 1000,10000,100000 --output report.json
+# links the data layer as static library (../core)
+
+TEMPLATE = app
+TARGET = bench
+CONFIG += console release warn_on
+CONFIG -= app_bundle
+
+include(../core/core.pri)
+
+CORE_LIB_DIR = $$OUT_PWD/../core
+LIBS += -L$$CORE_LIB_DIR -lekkesdatacore
+PRE_TARGETDEPS += $$CORE_LIB_DIR/libekkesdatacore.a
+
+SOURCES += main.cpp \
+	DatasetGenerator.cpp \
+	BenchmarkRunner.cpp
+
+HEADERS += DatasetGenerator.hpp \
+	BenchmarkRunner.hpp
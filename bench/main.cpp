@@ -0,0 +1,134 @@
+#include <QCoreApplication>
+#include <QStringList>
+#include <QFile>
+#include <QDir>
+#include <QScopedPointer>
+#include <QDebug>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "BenchmarkRunner.hpp"
+#include "JsonDataWriter.hpp"
+#include "DataTracer.hpp"
+
+/*
+ * headless benchmarks of the data layer - plain Qt, no Cascades
+ *
+ * bench [--orders 1000,10000,100000] [--seed 42] [--binary]
+ *       [--lookups 10000] [--positions 3] [--work-dir dir]
+ *       [--output report.json] [--trace trace.json] [--verbose]
+ *
+ * the report (JSON) goes to --output or stdout,
+ * --trace writes spans of all scales as Chrome trace-event JSON,
+ * qDebug() output of DataManager is dropped unless --verbose
+ */
+
+static bool verbose = false;
+
+#if QT_VERSION >= 0x050000
+static void benchMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+	Q_UNUSED(context);
+	if (type == QtDebugMsg && !verbose) {
+		return;
+	}
+	fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
+	if (type == QtFatalMsg) {
+		abort();
+	}
+}
+#else
+static void benchMessageHandler(QtMsgType type, const char* message)
+{
+	if (type == QtDebugMsg && !verbose) {
+		return;
+	}
+	fprintf(stderr, "%s\n", message);
+	if (type == QtFatalMsg) {
+		abort();
+	}
+}
+#endif
+
+static void usage()
+{
+	fprintf(stderr, "usage: bench [--orders 1000,10000,100000] [--seed 42] [--binary] [--lookups 10000]\n"
+			"             [--positions 3] [--work-dir dir] [--output report.json] [--trace trace.json]\n"
+			"             [--verbose]\n");
+}
+
+int main(int argc, char **argv)
+{
+	QCoreApplication app(argc, argv);
+#if QT_VERSION >= 0x050000
+	qInstallMessageHandler(benchMessageHandler);
+#else
+	qInstallMsgHandler(benchMessageHandler);
+#endif
+
+	BenchmarkRunner::Options options;
+	options.orderCounts << 1000 << 10000 << 100000;
+	options.seed = 42;
+	options.binaryCache = false;
+	options.lookups = 10000;
+	options.positionsPerOrder = 3;
+	options.workDirectory = QDir::temp().filePath("ekkesDSLSample-bench");
+	QString outputFileName;
+	QString traceFileName;
+
+	QStringList arguments = app.arguments();
+	for (int i = 1; i < arguments.size(); ++i) {
+		QString argument = arguments.at(i);
+		bool hasValue = i + 1 < arguments.size();
+		if (argument == "--binary") {
+			options.binaryCache = true;
+		} else if (argument == "--verbose") {
+			verbose = true;
+		} else if (argument == "--orders" && hasValue) {
+			options.orderCounts.clear();
+			QStringList counts = arguments.at(++i).split(',', QString::SkipEmptyParts);
+			for (int c = 0; c < counts.size(); ++c) {
+				options.orderCounts.append(qMax(1, counts.at(c).toInt()));
+			}
+		} else if (argument == "--seed" && hasValue) {
+			options.seed = arguments.at(++i).toUInt();
+		} else if (argument == "--lookups" && hasValue) {
+			options.lookups = arguments.at(++i).toInt();
+		} else if (argument == "--positions" && hasValue) {
+			options.positionsPerOrder = arguments.at(++i).toInt();
+		} else if (argument == "--work-dir" && hasValue) {
+			options.workDirectory = QDir(arguments.at(++i)).absolutePath();
+		} else if (argument == "--output" && hasValue) {
+			outputFileName = QDir(arguments.at(++i)).absolutePath();
+		} else if (argument == "--trace" && hasValue) {
+			traceFileName = QDir(arguments.at(++i)).absolutePath();
+		} else {
+			usage();
+			return 2;
+		}
+	}
+
+	QFile reportFile;
+	bool opened;
+	if (outputFileName.isEmpty()) {
+		opened = reportFile.open(stdout, QIODevice::WriteOnly);
+	} else {
+		reportFile.setFileName(outputFileName);
+		opened = reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+	}
+	if (!opened) {
+		qWarning() << "cannot open report" << outputFileName;
+		return 1;
+	}
+	QScopedPointer<DataWriter> report(new JsonDataWriter(&reportFile));
+	if (!traceFileName.isEmpty()) {
+		DataTracer::start(traceFileName);
+	}
+	BenchmarkRunner runner(options, report.data());
+	bool ok = runner.run();
+	if (!traceFileName.isEmpty() && !DataTracer::stop()) {
+		ok = false;
+	}
+	reportFile.close();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,8 @@
+# the data layer without Cascades:
+# DataObjects, DataManager, caches, indexes and queries - plain Qt
+# include from a .pro linking libekkesdatacore (see core.pro, ../bench/bench.pro)
+
+INCLUDEPATH += $$PWD/../src
+DEPENDPATH += $$PWD/../src
+QT += sql declarative
+greaterThan(QT_MAJOR_VERSION, 4): QT += concurrent
@@ -0,0 +1,23 @@
+# static library of the data layer - plain Qt, no Cascades, no BB10 libs
+# the app adds the Cascades glue (src/CascadesDataManager, src/applicationui)
+# and the QtLocationSubset conversion of the Geo types (src/GeoConversion)
+#   qmake core.pro && make
+
+TEMPLATE = lib
+TARGET = ekkesdatacore
+CONFIG += staticlib release warn_on
+
+include(core.pri)
+
+CORE_SOURCES = $$files($$PWD/../src/*.cpp) $$files($$PWD/../src/src-gen/*.cpp)
+CORE_SOURCES -= $$PWD/../src/main.cpp \
+	$$PWD/../src/applicationui.cpp \
+	$$PWD/../src/CascadesDataManager.cpp \
+	$$PWD/../src/GeoConversion.cpp
+CORE_HEADERS = $$files($$PWD/../src/*.hpp) $$files($$PWD/../src/src-gen/*.hpp)
+CORE_HEADERS -= $$PWD/../src/applicationui.hpp \
+	$$PWD/../src/CascadesDataManager.hpp \
+	$$PWD/../src/GeoConversion.hpp
+
+SOURCES += $$CORE_SOURCES
+HEADERS += $$CORE_HEADERS
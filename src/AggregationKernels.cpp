@@ -0,0 +1,292 @@
+#include "AggregationKernels.hpp"
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AGGREGATION_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define AGGREGATION_SSE2
+#endif
+
+#if defined(AGGREGATION_NEON) || defined(AGGREGATION_SSE2)
+static int minOfLanes(const int* lanes)
+{
+	int minValue = lanes[0];
+	for (int i = 1; i < 4; ++i) {
+		if (lanes[i] < minValue) {
+			minValue = lanes[i];
+		}
+	}
+	return minValue;
+}
+
+static int maxOfLanes(const int* lanes)
+{
+	int maxValue = lanes[0];
+	for (int i = 1; i < 4; ++i) {
+		if (lanes[i] > maxValue) {
+			maxValue = lanes[i];
+		}
+	}
+	return maxValue;
+}
+#endif
+
+const char* AggregationKernels::instructionSet()
+{
+#if defined(AGGREGATION_NEON)
+	return "NEON";
+#elif defined(AGGREGATION_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+int AggregationKernels::countEqual(const int* values, const int& size, const int& value)
+{
+	int i = 0;
+	int count = 0;
+#if defined(AGGREGATION_NEON)
+	int32x4_t needle = vdupq_n_s32(value);
+	uint32x4_t counter = vdupq_n_u32(0);
+	for (; i + 4 <= size; i += 4) {
+		// equal lanes are all ones (-1)
+		counter = vsubq_u32(counter, vceqq_s32(vld1q_s32(values + i), needle));
+	}
+	count = vgetq_lane_u32(counter, 0) + vgetq_lane_u32(counter, 1) + vgetq_lane_u32(counter, 2)
+			+ vgetq_lane_u32(counter, 3);
+#elif defined(AGGREGATION_SSE2)
+	__m128i needle = _mm_set1_epi32(value);
+	__m128i counter = _mm_setzero_si128();
+	for (; i + 4 <= size; i += 4) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+		counter = _mm_sub_epi32(counter, _mm_cmpeq_epi32(block, needle));
+	}
+	int lanes[4];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counter);
+	count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+	return count + countEqualScalar(values + i, size - i, value);
+}
+
+int AggregationKernels::countEqualScalar(const int* values, const int& size, const int& value)
+{
+	int count = 0;
+	for (int i = 0; i < size; ++i) {
+		count += (values[i] == value);
+	}
+	return count;
+}
+
+int AggregationKernels::countInRange(const int* values, const int& size, const int& from, const int& to)
+{
+	if (from > to) {
+		return 0;
+	}
+	int i = 0;
+	int count = 0;
+#if defined(AGGREGATION_NEON)
+	int32x4_t low = vdupq_n_s32(from);
+	int32x4_t high = vdupq_n_s32(to);
+	uint32x4_t counter = vdupq_n_u32(0);
+	for (; i + 4 <= size; i += 4) {
+		int32x4_t block = vld1q_s32(values + i);
+		uint32x4_t inside = vandq_u32(vcgeq_s32(block, low), vcleq_s32(block, high));
+		counter = vsubq_u32(counter, inside);
+	}
+	count = vgetq_lane_u32(counter, 0) + vgetq_lane_u32(counter, 1) + vgetq_lane_u32(counter, 2)
+			+ vgetq_lane_u32(counter, 3);
+#elif defined(AGGREGATION_SSE2)
+	__m128i low = _mm_set1_epi32(from);
+	__m128i high = _mm_set1_epi32(to);
+	__m128i outsideCounter = _mm_setzero_si128();
+	int blocks = 0;
+	for (; i + 4 <= size; i += 4) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+		// SSE2 has no >= : count the lanes outside
+		__m128i outside = _mm_or_si128(_mm_cmplt_epi32(block, low), _mm_cmpgt_epi32(block, high));
+		outsideCounter = _mm_sub_epi32(outsideCounter, outside);
+		blocks++;
+	}
+	int lanes[4];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), outsideCounter);
+	count = blocks * 4 - (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#endif
+	return count + countInRangeScalar(values + i, size - i, from, to);
+}
+
+int AggregationKernels::countInRangeScalar(const int* values, const int& size, const int& from,
+		const int& to)
+{
+	int count = 0;
+	for (int i = 0; i < size; ++i) {
+		count += (values[i] >= from && values[i] <= to);
+	}
+	return count;
+}
+
+qint64 AggregationKernels::sum(const int* values, const int& size)
+{
+	int i = 0;
+	qint64 total = 0;
+#if defined(AGGREGATION_NEON)
+	int64x2_t accumulator = vdupq_n_s64(0);
+	for (; i + 4 <= size; i += 4) {
+		// pairwise add of 32 bit lanes into 64 bit lanes
+		accumulator = vpadalq_s32(accumulator, vld1q_s32(values + i));
+	}
+	total = vgetq_lane_s64(accumulator, 0) + vgetq_lane_s64(accumulator, 1);
+#elif defined(AGGREGATION_SSE2)
+	__m128i zero = _mm_setzero_si128();
+	__m128i accumulator = _mm_setzero_si128();
+	for (; i + 4 <= size; i += 4) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+		// SSE2 has no sign extension: interleave with the sign mask
+		__m128i sign = _mm_cmpgt_epi32(zero, block);
+		accumulator = _mm_add_epi64(accumulator, _mm_unpacklo_epi32(block, sign));
+		accumulator = _mm_add_epi64(accumulator, _mm_unpackhi_epi32(block, sign));
+	}
+	qint64 lanes[2];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), accumulator);
+	total = lanes[0] + lanes[1];
+#endif
+	return total + sumScalar(values + i, size - i);
+}
+
+qint64 AggregationKernels::sumScalar(const int* values, const int& size)
+{
+	qint64 total = 0;
+	for (int i = 0; i < size; ++i) {
+		total += values[i];
+	}
+	return total;
+}
+
+bool AggregationKernels::minMax(const int* values, const int& size, int& minValue, int& maxValue)
+{
+	if (size <= 0) {
+		return false;
+	}
+	int i = 0;
+	minValue = values[0];
+	maxValue = values[0];
+#if defined(AGGREGATION_NEON)
+	if (size >= 4) {
+		int32x4_t minimum = vld1q_s32(values);
+		int32x4_t maximum = minimum;
+		for (i = 4; i + 4 <= size; i += 4) {
+			int32x4_t block = vld1q_s32(values + i);
+			minimum = vminq_s32(minimum, block);
+			maximum = vmaxq_s32(maximum, block);
+		}
+		int lanes[4];
+		vst1q_s32(lanes, minimum);
+		minValue = minOfLanes(lanes);
+		vst1q_s32(lanes, maximum);
+		maxValue = maxOfLanes(lanes);
+	}
+#elif defined(AGGREGATION_SSE2)
+	if (size >= 4) {
+		__m128i minimum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+		__m128i maximum = minimum;
+		for (i = 4; i + 4 <= size; i += 4) {
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+			// SSE2 has no _mm_min_epi32: select by compare mask
+			__m128i less = _mm_cmplt_epi32(block, minimum);
+			minimum = _mm_or_si128(_mm_and_si128(less, block), _mm_andnot_si128(less, minimum));
+			__m128i greater = _mm_cmpgt_epi32(block, maximum);
+			maximum = _mm_or_si128(_mm_and_si128(greater, block), _mm_andnot_si128(greater, maximum));
+		}
+		int lanes[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), minimum);
+		minValue = minOfLanes(lanes);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), maximum);
+		maxValue = maxOfLanes(lanes);
+	}
+#endif
+	for (; i < size; ++i) {
+		if (values[i] < minValue) {
+			minValue = values[i];
+		}
+		if (values[i] > maxValue) {
+			maxValue = values[i];
+		}
+	}
+	return true;
+}
+
+bool AggregationKernels::minMaxScalar(const int* values, const int& size, int& minValue, int& maxValue)
+{
+	if (size <= 0) {
+		return false;
+	}
+	minValue = values[0];
+	maxValue = values[0];
+	for (int i = 1; i < size; ++i) {
+		if (values[i] < minValue) {
+			minValue = values[i];
+		}
+		if (values[i] > maxValue) {
+			maxValue = values[i];
+		}
+	}
+	return true;
+}
+
+int AggregationKernels::countBits(const unsigned int* words, const int& size)
+{
+	int count = 0;
+	for (int i = 0; i < size; ++i) {
+		unsigned int word = words[i];
+		word = word - ((word >> 1) & 0x55555555);
+		word = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+		count += (((word + (word >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+	}
+	return count;
+}
+
+void AggregationKernels::countByValue(const int* values, const int& size, const int& firstValue, int* counts,
+		const int& bucketCount)
+{
+	for (int i = 0; i < size; ++i) {
+		// unsigned compare: values below firstValue wrap around
+		unsigned int bucket = (unsigned int) values[i] - (unsigned int) firstValue;
+		if (bucket < (unsigned int) bucketCount) {
+			counts[bucket]++;
+		}
+	}
+}
+
+void AggregationKernels::histogram(const int* values, const int& size, const int& origin,
+		const unsigned int& bucketWidth, int* counts, const int& bucketCount)
+{
+	if (bucketWidth == 0) {
+		return;
+	}
+	if (bucketWidth == 1) {
+		countByValue(values, size, origin, counts, bucketCount);
+		return;
+	}
+	for (int i = 0; i < size; ++i) {
+		if (values[i] < origin) {
+			continue;
+		}
+		unsigned int bucket = ((unsigned int) values[i] - (unsigned int) origin) / bucketWidth;
+		if (bucket < (unsigned int) bucketCount) {
+			counts[bucket]++;
+		}
+	}
+}
+
+void AggregationKernels::countByDayAndGroup(const int* days, const int* groups, const int& size,
+		const int& firstDay, const int& dayCount, int* counts, const int& groupCount)
+{
+	for (int i = 0; i < size; ++i) {
+		unsigned int day = (unsigned int) days[i] - (unsigned int) firstDay;
+		unsigned int group = (unsigned int) groups[i];
+		if (day < (unsigned int) dayCount && group < (unsigned int) groupCount) {
+			counts[day * groupCount + group]++;
+		}
+	}
+}
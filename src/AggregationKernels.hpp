@@ -0,0 +1,60 @@
+#ifndef AGGREGATIONKERNELS_HPP_
+#define AGGREGATIONKERNELS_HPP_
+
+#include <QtGlobal>
+
+/*
+ * counting kernels over int columns (see OrderColumns.hpp)
+ * and packed int arrays (see Xtras values)
+ *
+ * compare-and-count kernels are vectorized:
+ * NEON on the device (ARM), SSE2 on the simulator (x86),
+ * plain loops everywhere else.
+ * the ...Scalar() variants are the plain loops and always available -
+ * the benchmarks compare both.
+ *
+ * histogram kernels scatter into counts and stay scalar,
+ * counts must be zeroed by the caller, values outside are skipped.
+ * offsets (value - firstValue ...) are taken in unsigned arithmetic:
+ * defined for the whole int range, values below wrap around and are skipped.
+ */
+class AggregationKernels
+{
+public:
+
+	// name of the compiled vector path: "NEON", "SSE2" or "scalar"
+	static const char* instructionSet();
+
+	static int countEqual(const int* values, const int& size, const int& value);
+	static int countEqualScalar(const int* values, const int& size, const int& value);
+
+	// from .. to inclusive
+	static int countInRange(const int* values, const int& size, const int& from, const int& to);
+	static int countInRangeScalar(const int* values, const int& size, const int& from, const int& to);
+
+	// summed up in 64 bit: no overflow for int arrays
+	static qint64 sum(const int* values, const int& size);
+	static qint64 sumScalar(const int* values, const int& size);
+
+	// false if size is 0
+	static bool minMax(const int* values, const int& size, int& minValue, int& maxValue);
+	static bool minMaxScalar(const int* values, const int& size, int& minValue, int& maxValue);
+
+	// bits set in size words
+	static int countBits(const unsigned int* words, const int& size);
+
+	// counts[value - firstValue] for firstValue .. firstValue + bucketCount - 1
+	static void countByValue(const int* values, const int& size, const int& firstValue, int* counts,
+			const int& bucketCount);
+
+	// counts[(value - origin) / bucketWidth] for value >= origin
+	// unsigned bucketWidth: up to 2^32 - 1 for ranges over the whole int range
+	static void histogram(const int* values, const int& size, const int& origin,
+			const unsigned int& bucketWidth, int* counts, const int& bucketCount);
+
+	// counts[(day - firstDay) * groupCount + group] for groups 0 .. groupCount - 1
+	static void countByDayAndGroup(const int* days, const int* groups, const int& size, const int& firstDay,
+			const int& dayCount, int* counts, const int& groupCount);
+};
+
+#endif /* AGGREGATIONKERNELS_HPP_ */
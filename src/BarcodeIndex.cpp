@@ -0,0 +1,152 @@
+#include "BarcodeIndex.hpp"
+#include "src-gen/Order.hpp"
+#include "MemoryUsage.hpp"
+
+BarcodeIndex::BarcodeIndex() :
+		mBuilt(false)
+{
+}
+
+/*
+ * the index is built again on next lookup
+ */
+void BarcodeIndex::clear()
+{
+	mOrderByBarcode.clear();
+	mBarcodesOfOrder.clear();
+	mDirty.clear();
+	mBuilt = false;
+}
+
+void BarcodeIndex::rebuild(const QList<QObject*>& orderList)
+{
+	clear();
+	for (int i = 0; i < orderList.size(); ++i) {
+		Order* order = (Order*) orderList.at(i);
+		order->setBarcodeIndex(this);
+		indexOrder(order);
+	}
+	mBuilt = true;
+}
+
+bool BarcodeIndex::isBuilt() const
+{
+	return mBuilt;
+}
+
+void BarcodeIndex::addOrder(Order* order)
+{
+	order->setBarcodeIndex(this);
+	if (mBuilt) {
+		indexOrder(order);
+	}
+}
+
+void BarcodeIndex::removeOrder(Order* order)
+{
+	order->setBarcodeIndex(0);
+	mDirty.remove(order);
+	unindexOrder(order);
+}
+
+void BarcodeIndex::markDirty(Order* order)
+{
+	if (mBuilt) {
+		mDirty.insert(order);
+	}
+}
+
+SubItem* BarcodeIndex::findSubItem(const QString& barcode)
+{
+	if (barcode.isEmpty()) {
+		return 0;
+	}
+	indexDirtyOrders();
+	QMultiHash<QString, Order*>::const_iterator it = mOrderByBarcode.constFind(barcode);
+	for (; it != mOrderByBarcode.constEnd() && it.key() == barcode; ++it) {
+		SubItem* subItem = subItemOfOrder(it.value(), barcode);
+		if (subItem) {
+			return subItem;
+		}
+	}
+	return 0;
+}
+
+int BarcodeIndex::barcodeCount() const
+{
+	return mOrderByBarcode.size();
+}
+
+// barcodes are shared between both hashes and the SubItems - counted once here
+qint64 BarcodeIndex::memoryBytes() const
+{
+	qint64 bytes = MemoryUsage::hashBytes(mOrderByBarcode.size(), sizeof(QString) + sizeof(Order*));
+	bytes += MemoryUsage::hashBytes(mBarcodesOfOrder.size(), sizeof(Order*) + sizeof(QStringList));
+	QHash<Order*, QStringList>::const_iterator it;
+	for (it = mBarcodesOfOrder.constBegin(); it != mBarcodesOfOrder.constEnd(); ++it) {
+		const QStringList& barcodes = it.value();
+		bytes += MemoryUsage::listBytes(barcodes.size());
+		for (int i = 0; i < barcodes.size(); ++i) {
+			bytes += MemoryUsage::stringDataBytes(barcodes.at(i));
+		}
+	}
+	return bytes + MemoryUsage::hashBytes(mDirty.size(), sizeof(Order*));
+}
+
+void BarcodeIndex::indexOrder(Order* order)
+{
+	unindexOrder(order);
+	QStringList names;
+	QStringList descriptions;
+	QStringList barcodes;
+	order->collectSearchText(names, descriptions, barcodes);
+	if (barcodes.isEmpty()) {
+		return;
+	}
+	barcodes.removeDuplicates();
+	for (int i = 0; i < barcodes.size(); ++i) {
+		mOrderByBarcode.insert(barcodes.at(i), order);
+	}
+	mBarcodesOfOrder.insert(order, barcodes);
+}
+
+void BarcodeIndex::unindexOrder(Order* order)
+{
+	QHash<Order*, QStringList>::iterator it = mBarcodesOfOrder.find(order);
+	if (it == mBarcodesOfOrder.end()) {
+		return;
+	}
+	const QStringList& barcodes = it.value();
+	for (int i = 0; i < barcodes.size(); ++i) {
+		mOrderByBarcode.remove(barcodes.at(i), order);
+	}
+	mBarcodesOfOrder.erase(it);
+}
+
+void BarcodeIndex::indexDirtyOrders()
+{
+	QSet<Order*>::const_iterator it;
+	for (it = mDirty.constBegin(); it != mDirty.constEnd(); ++it) {
+		indexOrder(*it);
+	}
+	mDirty.clear();
+}
+
+// materializes positions and subItems of this Order only
+SubItem* BarcodeIndex::subItemOfOrder(Order* order, const QString& barcode)
+{
+	QList<Item*> positions = order->positions();
+	for (int i = 0; i < positions.size(); ++i) {
+		QList<SubItem*> subItems = positions.at(i)->subItems();
+		for (int s = 0; s < subItems.size(); ++s) {
+			if (subItems.at(s)->barcode() == barcode) {
+				return subItems.at(s);
+			}
+		}
+	}
+	return 0;
+}
+
+BarcodeIndex::~BarcodeIndex()
+{
+}
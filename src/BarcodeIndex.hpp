@@ -0,0 +1,63 @@
+#ifndef BARCODEINDEX_HPP_
+#define BARCODEINDEX_HPP_
+
+#include <QHash>
+#include <QMultiHash>
+#include <QSet>
+#include <QList>
+#include <QStringList>
+
+class Order;
+class SubItem;
+class QObject;
+
+/*
+ * SubItem barcode -> Order containing the SubItem
+ *
+ * scanning a barcode only has to look at the positions of one Order
+ * instead of all Order -> Item -> SubItem.
+ * positions and subItems still pending (not materialized)
+ * are indexed from their maps - only the Order found is materialized.
+ *
+ * the index is built on first lookup.
+ * an attached Order calls markDirty() if barcodes of its subItems
+ * or its positions / subItems are changed - dirty Order are
+ * indexed again before the next lookup.
+ * DataManager adds and removes Order together with mAllOrder.
+ */
+class BarcodeIndex
+{
+public:
+	BarcodeIndex();
+	virtual ~BarcodeIndex();
+
+	void clear();
+	void rebuild(const QList<QObject*>& orderList);
+	bool isBuilt() const;
+
+	void addOrder(Order* order);
+	void removeOrder(Order* order);
+	void markDirty(Order* order);
+
+	// 0 if no SubItem has the barcode
+	SubItem* findSubItem(const QString& barcode);
+
+	int barcodeCount() const;
+	// estimated heap bytes of both hashes and dirty Order
+	qint64 memoryBytes() const;
+
+private:
+
+	void indexOrder(Order* order);
+	void unindexOrder(Order* order);
+	void indexDirtyOrders();
+	static SubItem* subItemOfOrder(Order* order, const QString& barcode);
+
+	bool mBuilt;
+	// same barcode can be used in more than one Order
+	QMultiHash<QString, Order*> mOrderByBarcode;
+	QHash<Order*, QStringList> mBarcodesOfOrder;
+	QSet<Order*> mDirty;
+};
+
+#endif /* BARCODEINDEX_HPP_ */
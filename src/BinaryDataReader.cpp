@@ -0,0 +1,272 @@
+#include "BinaryDataReader.hpp"
+#include "BinaryDataWriter.hpp"
+
+#include <QDate>
+#include <QtEndian>
+#include <limits.h>
+#include <string.h>
+
+// lengths read from devices without a size (sockets ...) are capped
+static const quint64 maxSequentialLength = 64 * 1024 * 1024;
+
+BinaryDataReader::BinaryDataReader(QIODevice* device, const int& bufferSize) :
+		DataReader(device, bufferSize), mInsideArray(false), mFinished(false)
+{
+}
+
+bool BinaryDataReader::readNext(QVariantMap& map)
+{
+	map.clear();
+	if (mFinished || mError) {
+		return false;
+	}
+	uchar token;
+	if (!mInsideArray) {
+		if (!readHeader() || !readToken(token)) {
+			return false;
+		}
+		if (token != BinaryDataWriter::ARRAY_BEGIN) {
+			setError("binary cache must contain an array");
+			return false;
+		}
+		mInsideArray = true;
+	}
+	if (!readToken(token)) {
+		return false;
+	}
+	if (token == BinaryDataWriter::ARRAY_END) {
+		mFinished = true;
+		return false;
+	}
+	if (token != BinaryDataWriter::OBJECT_BEGIN) {
+		setError("top-level array must contain objects");
+		return false;
+	}
+	return readObject(map);
+}
+
+bool BinaryDataReader::readHeader()
+{
+	QByteArray magic = BinaryDataWriter::magic();
+	QByteArray header;
+	if (!readBytes(header, magic.size() + 1)) {
+		return false;
+	}
+	if (!header.startsWith(magic)) {
+		setError("not a binary cache");
+		return false;
+	}
+	if ((uchar) header.at(magic.size()) > BinaryDataWriter::VERSION) {
+		setError("binary cache version not supported");
+		return false;
+	}
+	return true;
+}
+
+// OBJECT_BEGIN / ARRAY_BEGIN already consumed
+bool BinaryDataReader::readValue(const uchar& token, QVariant& value)
+{
+	switch (token) {
+	case BinaryDataWriter::OBJECT_BEGIN: {
+		QVariantMap map;
+		if (!readObject(map)) {
+			return false;
+		}
+		value = map;
+		return true;
+	}
+	case BinaryDataWriter::ARRAY_BEGIN: {
+		QVariantList list;
+		if (!readArray(list)) {
+			return false;
+		}
+		value = list;
+		return true;
+	}
+	case BinaryDataWriter::INT_VALUE: {
+		quint32 intValue;
+		if (!readUInt32(intValue)) {
+			return false;
+		}
+		value = (int) intValue;
+		return true;
+	}
+	case BinaryDataWriter::TRUE_VALUE:
+		value = true;
+		return true;
+	case BinaryDataWriter::FALSE_VALUE:
+		value = false;
+		return true;
+	case BinaryDataWriter::DOUBLE_VALUE: {
+		quint32 low;
+		quint32 high;
+		if (!readUInt32(low) || !readUInt32(high)) {
+			return false;
+		}
+		quint64 bits = ((quint64) high << 32) | low;
+		double doubleValue;
+		memcpy(&doubleValue, &bits, sizeof(doubleValue));
+		value = doubleValue;
+		return true;
+	}
+	case BinaryDataWriter::STRING_VALUE: {
+		quint32 size;
+		if (!readUInt32(size) || !checkLength(size) || !readBytes(mBytes, (int) size)) {
+			return false;
+		}
+		value = QString::fromUtf8(mBytes.constData(), mBytes.size());
+		return true;
+	}
+	case BinaryDataWriter::DATE_VALUE: {
+		quint32 julianDay;
+		if (!readUInt32(julianDay)) {
+			return false;
+		}
+		value = QDate::fromJulianDay((int) julianDay);
+		return true;
+	}
+	case BinaryDataWriter::LONG_VALUE: {
+		quint32 low;
+		quint32 high;
+		if (!readUInt32(low) || !readUInt32(high)) {
+			return false;
+		}
+		value = (qint64) (((quint64) high << 32) | low);
+		return true;
+	}
+	case BinaryDataWriter::NULL_VALUE:
+		value = QVariant();
+		return true;
+	case BinaryDataWriter::INT_ARRAY: {
+		QVector<int> values;
+		if (!readIntArray(values)) {
+			return false;
+		}
+		value = QVariant::fromValue(values);
+		return true;
+	}
+	default:
+		setError(QString("unknown token %1").arg(token));
+		return false;
+	}
+}
+
+bool BinaryDataReader::readObject(QVariantMap& map)
+{
+	uchar token;
+	while (readToken(token)) {
+		if (token == BinaryDataWriter::OBJECT_END) {
+			return true;
+		}
+		QString key;
+		QVariant value;
+		if (!readKey(key) || !readValue(token, value)) {
+			return false;
+		}
+		map.insert(key, value);
+	}
+	return false;
+}
+
+bool BinaryDataReader::readArray(QVariantList& list)
+{
+	uchar token;
+	while (readToken(token)) {
+		if (token == BinaryDataWriter::ARRAY_END) {
+			return true;
+		}
+		QVariant value;
+		if (!readValue(token, value)) {
+			return false;
+		}
+		list.append(value);
+	}
+	return false;
+}
+
+// bulk copy into the vector, no QVariant per value
+bool BinaryDataReader::readIntArray(QVector<int>& values)
+{
+	quint32 count;
+	if (!readUInt32(count)) {
+		return false;
+	}
+	// the data must exist before the vector is allocated
+	if (!checkLength((quint64) count * sizeof(int))) {
+		return false;
+	}
+	values.resize((int) count);
+	if (!readBytes(reinterpret_cast<char*>(values.data()), (int) (count * sizeof(int)))) {
+		return false;
+	}
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+	for (int i = 0; i < values.size(); ++i) {
+		values[i] = (int) qFromLittleEndian<quint32>((quint32) values.at(i));
+	}
+#endif
+	return true;
+}
+
+bool BinaryDataReader::readKey(QString& key)
+{
+	uchar reference;
+	if (!readToken(reference)) {
+		return false;
+	}
+	if (reference == BinaryDataWriter::KEY_DEFINE || reference == BinaryDataWriter::KEY_INLINE) {
+		uchar size;
+		if (!readToken(size) || !readBytes(mBytes, size)) {
+			return false;
+		}
+		key = QString::fromUtf8(mBytes.constData(), mBytes.size());
+		if (reference == BinaryDataWriter::KEY_DEFINE) {
+			mKeys.append(key);
+		}
+		return true;
+	}
+	if (reference >= mKeys.size()) {
+		setError("undefined key");
+		return false;
+	}
+	key = mKeys.at(reference);
+	return true;
+}
+
+bool BinaryDataReader::readToken(uchar& token)
+{
+	if (atEnd()) {
+		setError("unexpected end of data");
+		return false;
+	}
+	token = (uchar) getChar();
+	return true;
+}
+
+bool BinaryDataReader::readUInt32(quint32& value)
+{
+	uchar bytes[4];
+	if (!readBytes((char*) bytes, 4)) {
+		return false;
+	}
+	value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((quint32) bytes[3] << 24);
+	return true;
+}
+
+/*
+ * a length from the data must fit into the data left:
+ * a corrupt length must not allocate gigabytes or turn negative
+ */
+bool BinaryDataReader::checkLength(const quint64& bytes)
+{
+	qint64 remaining = remainingBytes();
+	quint64 limit = remaining < 0 ? maxSequentialLength : (quint64) remaining;
+	if (bytes > (quint64) INT_MAX || bytes > limit) {
+		setError(QString("length %1 exceeds the data").arg(bytes));
+		return false;
+	}
+	return true;
+}
+
+BinaryDataReader::~BinaryDataReader()
+{
+}
@@ -0,0 +1,38 @@
+#ifndef BINARYDATAREADER_HPP_
+#define BINARYDATAREADER_HPP_
+
+#include <QVector>
+
+#include "DataReader.hpp"
+
+/*
+ * reads caches written by BinaryDataWriter
+ * (format see BinaryDataWriter.hpp)
+ */
+class BinaryDataReader: public DataReader
+{
+public:
+	BinaryDataReader(QIODevice* device, const int& bufferSize = 64 * 1024);
+	virtual ~BinaryDataReader();
+
+	virtual bool readNext(QVariantMap& map);
+
+private:
+
+	bool readHeader();
+	bool readValue(const uchar& token, QVariant& value);
+	bool readObject(QVariantMap& map);
+	bool readArray(QVariantList& list);
+	bool readIntArray(QVector<int>& values);
+	bool readKey(QString& key);
+	bool readToken(uchar& token);
+	bool readUInt32(quint32& value);
+	bool checkLength(const quint64& bytes);
+
+	bool mInsideArray;
+	bool mFinished;
+	QVector<QString> mKeys;
+	QByteArray mBytes;
+};
+
+#endif /* BINARYDATAREADER_HPP_ */
@@ -0,0 +1,173 @@
+#include "BinaryDataWriter.hpp"
+
+#include <QDebug>
+#include <string.h>
+
+QByteArray BinaryDataWriter::magic()
+{
+	return QByteArray("EKDB");
+}
+
+BinaryDataWriter::BinaryDataWriter(QIODevice* device, const int& bufferSize) :
+		mDevice(device), mBufferSize(bufferSize), mError(false)
+{
+	mBuffer.reserve(mBufferSize + 1024);
+	mBuffer.append(magic());
+	mBuffer.append((char) VERSION);
+}
+
+void BinaryDataWriter::beginObject(const QString& key)
+{
+	writeToken(OBJECT_BEGIN, key);
+	mIsArray.append(false);
+}
+
+void BinaryDataWriter::endObject()
+{
+	mBuffer.append((char) OBJECT_END);
+	mIsArray.pop_back();
+	flushIfFull();
+}
+
+void BinaryDataWriter::beginArray(const QString& key)
+{
+	writeToken(ARRAY_BEGIN, key);
+	mIsArray.append(true);
+}
+
+void BinaryDataWriter::endArray()
+{
+	mBuffer.append((char) ARRAY_END);
+	mIsArray.pop_back();
+	flushIfFull();
+}
+
+void BinaryDataWriter::writeInt(const QString& key, const int& value)
+{
+	writeToken(INT_VALUE, key);
+	appendUInt32((quint32) value);
+}
+
+void BinaryDataWriter::writeLongLong(const QString& key, const qint64& value)
+{
+	writeToken(LONG_VALUE, key);
+	appendUInt32((quint32) ((quint64) value & 0xFFFFFFFF));
+	appendUInt32((quint32) ((quint64) value >> 32));
+}
+
+void BinaryDataWriter::writeBool(const QString& key, const bool& value)
+{
+	writeToken(value ? TRUE_VALUE : FALSE_VALUE, key);
+}
+
+void BinaryDataWriter::writeDouble(const QString& key, const double& value)
+{
+	writeToken(DOUBLE_VALUE, key);
+	quint64 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	appendUInt32((quint32) (bits & 0xFFFFFFFF));
+	appendUInt32((quint32) (bits >> 32));
+}
+
+void BinaryDataWriter::writeString(const QString& key, const QString& value)
+{
+	writeToken(STRING_VALUE, key);
+	appendUtf8(value.toUtf8(), false);
+}
+
+// julian day - no formatting or parsing
+void BinaryDataWriter::writeDate(const QString& key, const QDate& value)
+{
+	writeToken(DATE_VALUE, key);
+	appendUInt32((quint32) value.toJulianDay());
+}
+
+void BinaryDataWriter::writeNull(const QString& key)
+{
+	writeToken(NULL_VALUE, key);
+}
+
+// packed: count + raw little endian ints instead of one token per value
+void BinaryDataWriter::writeIntList(const QString& key, const QVector<int>& values)
+{
+	writeToken(INT_ARRAY, key);
+	appendUInt32((quint32) values.size());
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+	mBuffer.append(reinterpret_cast<const char*>(values.constData()), values.size() * (int) sizeof(int));
+#else
+	for (int i = 0; i < values.size(); ++i) {
+		appendUInt32((quint32) values.at(i));
+	}
+#endif
+	flushIfFull();
+}
+
+bool BinaryDataWriter::flush()
+{
+	if (!mBuffer.isEmpty()) {
+		if (mDevice->write(mBuffer) != mBuffer.size()) {
+			qWarning() << "BinaryDataWriter cannot write: " << mDevice->errorString();
+			mError = true;
+		}
+		mBuffer.clear();
+	}
+	return !mError;
+}
+
+bool BinaryDataWriter::hasError() const
+{
+	return mError;
+}
+
+// token followed by the key reference if inside an object
+void BinaryDataWriter::writeToken(const uchar& token, const QString& key)
+{
+	mBuffer.append((char) token);
+	if (mIsArray.isEmpty() || mIsArray.last()) {
+		return;
+	}
+	QHash<QString, int>::const_iterator it = mKeys.constFind(key);
+	if (it != mKeys.constEnd()) {
+		mBuffer.append((char) it.value());
+		return;
+	}
+	if (mKeys.size() < MAX_KEYS) {
+		mKeys.insert(key, mKeys.size());
+		mBuffer.append((char) KEY_DEFINE);
+	} else {
+		mBuffer.append((char) KEY_INLINE);
+	}
+	appendUtf8(key.toUtf8(), true);
+}
+
+void BinaryDataWriter::appendUInt32(const quint32& value)
+{
+	mBuffer.append((char) (value & 0xFF));
+	mBuffer.append((char) ((value >> 8) & 0xFF));
+	mBuffer.append((char) ((value >> 16) & 0xFF));
+	mBuffer.append((char) ((value >> 24) & 0xFF));
+}
+
+void BinaryDataWriter::appendUtf8(const QByteArray& utf8, const bool& shortLength)
+{
+	if (shortLength) {
+		// keys are short property names
+		mBuffer.append((char) qMin(utf8.size(), 0xFF));
+		mBuffer.append(utf8.constData(), qMin(utf8.size(), 0xFF));
+		return;
+	}
+	appendUInt32((quint32) utf8.size());
+	mBuffer.append(utf8);
+}
+
+void BinaryDataWriter::flushIfFull()
+{
+	if (mBuffer.size() >= mBufferSize) {
+		flush();
+	}
+}
+
+BinaryDataWriter::~BinaryDataWriter()
+{
+	flush();
+}
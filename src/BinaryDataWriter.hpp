@@ -0,0 +1,99 @@
+#ifndef BINARYDATAWRITER_HPP_
+#define BINARYDATAWRITER_HPP_
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+
+#include "DataWriter.hpp"
+
+/*
+ * DataWriter writing a compact tagged binary format to a QIODevice
+ * the same tree as JSON, but without text formatting and parsing
+ *
+ * header: magic "EKDB" + quint8 version
+ * then one value:
+ *   quint8 token, [key reference if inside an object], payload
+ * tokens and payload:
+ *   OBJECT_BEGIN ... OBJECT_END
+ *   ARRAY_BEGIN ... ARRAY_END
+ *   INT      qint32
+ *   TRUE / FALSE
+ *   DOUBLE   8 bytes IEEE 754
+ *   STRING   quint32 byte length + UTF-8
+ *   DATE     qint32 julian day (since version 2)
+ *   INT_ARRAY quint32 count + count * qint32 (since version 3)
+ *   LONG     qint64 as low and high quint32 (since version 4)
+ *   NULL     no payload (since version 4)
+ * key reference:
+ *   quint8 index of a key defined before
+ *   or KEY_DEFINE quint8 length + UTF-8 -> gets the next free index
+ *   or KEY_INLINE quint8 length + UTF-8 if all indexes are used
+ * all numbers are little endian
+ */
+class BinaryDataWriter: public DataWriter
+{
+public:
+
+	enum Token
+	{
+		OBJECT_BEGIN = 1,
+		OBJECT_END = 2,
+		ARRAY_BEGIN = 3,
+		ARRAY_END = 4,
+		INT_VALUE = 5,
+		TRUE_VALUE = 6,
+		FALSE_VALUE = 7,
+		DOUBLE_VALUE = 8,
+		STRING_VALUE = 9,
+		DATE_VALUE = 10,
+		INT_ARRAY = 11,
+		LONG_VALUE = 12,
+		NULL_VALUE = 13
+	};
+	static const uchar KEY_DEFINE = 0xFF;
+	static const uchar KEY_INLINE = 0xFE;
+	static const int MAX_KEYS = 0xFE;
+	static const uchar VERSION = 4;
+
+	static QByteArray magic();
+
+	BinaryDataWriter(QIODevice* device, const int& bufferSize = 64 * 1024);
+	virtual ~BinaryDataWriter();
+
+	virtual void beginObject(const QString& key = QString());
+	virtual void endObject();
+	virtual void beginArray(const QString& key = QString());
+	virtual void endArray();
+
+	virtual void writeInt(const QString& key, const int& value);
+	virtual void writeLongLong(const QString& key, const qint64& value);
+	virtual void writeBool(const QString& key, const bool& value);
+	virtual void writeDouble(const QString& key, const double& value);
+	virtual void writeString(const QString& key, const QString& value);
+	virtual void writeDate(const QString& key, const QDate& value);
+	virtual void writeNull(const QString& key);
+	virtual void writeIntList(const QString& key, const QVector<int>& values);
+
+	virtual bool flush();
+
+	bool hasError() const;
+
+private:
+
+	void writeToken(const uchar& token, const QString& key);
+	void appendUInt32(const quint32& value);
+	void appendUtf8(const QByteArray& utf8, const bool& shortLength);
+	void flushIfFull();
+
+	QIODevice* mDevice;
+	int mBufferSize;
+	QByteArray mBuffer;
+	// true for arrays, false for objects
+	QVector<bool> mIsArray;
+	QHash<QString, int> mKeys;
+	bool mError;
+};
+
+#endif /* BINARYDATAWRITER_HPP_ */
@@ -0,0 +1,259 @@
+#include "CascadesDataManager.hpp"
+#include "DataLog.hpp"
+#include "DataTracer.hpp"
+
+#include <bb/MemoryInfo>
+#include <bb/cascades/Application>
+#include <bb/cascades/AbstractPane>
+#include <bb/cascades/GroupDataModel>
+
+using namespace bb::cascades;
+
+CascadesDataManager::CascadesDataManager(QObject *parent) :
+		DataManager(parent), mMemoryInfo(new bb::MemoryInfo(this))
+{
+	// no auto exit: we must persist the cache before
+	bb::Application::instance()->setAutoExit(false);
+	bool res = QObject::connect(bb::Application::instance(), SIGNAL(manualExit()), this,
+			SLOT(onManualExit()));
+	Q_ASSERT(res);
+	res = QObject::connect(mMemoryInfo, SIGNAL(lowMemory(bb::LowMemoryWarningLevel::Type)), this,
+			SLOT(onLowMemory(bb::LowMemoryWarningLevel::Type)));
+	Q_ASSERT(res);
+	Q_UNUSED(res);
+}
+
+CascadesDataManager::~CascadesDataManager()
+{
+}
+
+void CascadesDataManager::onManualExit()
+{
+	DATA_LOG(DATA_LOG_INIT) << "## DataManager ## MANUAL EXIT";
+	finish();
+	// writes the trace if started by DATA_TRACE_FILE or startTrace()
+	DataTracer::stop();
+	bb::Application::instance()->exit(0);
+}
+
+/*
+ * the OS is running out of memory - log what the data layer holds
+ * and release positions of cold Order (see OrderEviction.hpp)
+ * HighPriority: the app will be terminated if memory is not freed,
+ * so also resolved references of cold Order are released
+ */
+void CascadesDataManager::onLowMemory(bb::LowMemoryWarningLevel::Type level)
+{
+	if (level == bb::LowMemoryWarningLevel::HighPriority) {
+		reportMemoryStatistics("lowMemory HighPriority");
+		evictColdOrders(true);
+	} else {
+		reportMemoryStatistics("lowMemory LowPriority");
+		evictColdOrders(false);
+	}
+}
+
+/*
+ * using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
+ * probably there are GroupDataModels not deleted yet from previous destroyed Pages
+ */
+GroupDataModel* CascadesDataManager::dataModel(const QString& objectName)
+{
+	QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<GroupDataModel*>(
+			objectName);
+	if (dataModelList.isEmpty()) {
+		DATA_LOG(DATA_LOG_MODEL) << "no DataModel found for " << objectName;
+		return 0;
+	}
+	return dataModelList.last();
+}
+
+void CascadesDataManager::fillDataModel(const QString& objectName, const QList<QObject*>& list)
+{
+	GroupDataModel* groupDataModel = dataModel(objectName);
+	if (groupDataModel) {
+		ScopedMetricsTimer fillTimer(dataMetrics(), DataMetrics::FILL_DATA_MODEL);
+		TraceSpan span("fillDataModel", "model", objectName);
+		groupDataModel->clear();
+		groupDataModel->insertList(list);
+		dataMetrics()->increment(DataMetrics::DATA_MODEL_ITEMS, list.size());
+	}
+}
+
+/**
+ * removing and re-inserting a single item of a DataModel
+ * this will cause the ListView to redraw or recalculate all values for this ListItem
+ * we do this, because only changing properties won't call List functions
+ */
+void CascadesDataManager::replaceItemInDataModel(const QString& objectName, QObject* listItem)
+{
+	GroupDataModel* groupDataModel = dataModel(objectName);
+	if (groupDataModel) {
+		if (groupDataModel->remove(listItem)) {
+			groupDataModel->insert(listItem);
+			return;
+		}
+		DATA_LOG(DATA_LOG_MODEL) << listItem->metaObject()->className() << " not found and not replaced in " << objectName;
+	}
+}
+
+void CascadesDataManager::removeItemFromDataModel(const QString& objectName, QObject* listItem)
+{
+	GroupDataModel* groupDataModel = dataModel(objectName);
+	if (groupDataModel && !groupDataModel->remove(listItem)) {
+		DATA_LOG(DATA_LOG_MODEL) << listItem->metaObject()->className() << " not found and not removed from " << objectName;
+	}
+}
+
+void CascadesDataManager::insertItemIntoDataModel(const QString& objectName, QObject* listItem)
+{
+	GroupDataModel* groupDataModel = dataModel(objectName);
+	if (groupDataModel) {
+		groupDataModel->insert(listItem);
+	}
+}
+
+void CascadesDataManager::fillOrderDataModel(QString objectName)
+{
+	fillDataModel(objectName, allOrder());
+}
+
+void CascadesDataManager::replaceItemInOrderDataModel(QString objectName, Order* listItem)
+{
+	replaceItemInDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::removeItemFromOrderDataModel(QString objectName, Order* listItem)
+{
+	removeItemFromDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::insertItemIntoOrderDataModel(QString objectName, Order* listItem)
+{
+	insertItemIntoDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::fillOrderDataModelByQuery(QString objectName, const QVariantMap& queryMap)
+{
+	QList<Order*> orderList = queryOrder(OrderQuery(queryMap));
+	QList<QObject*> theList;
+	theList.reserve(orderList.size());
+	for (int i = 0; i < orderList.size(); ++i) {
+		theList.append(orderList.at(i));
+	}
+	fillDataModel(objectName, theList);
+	DATA_LOG(DATA_LOG_MODEL) << "fillOrderDataModelByQuery (" << objectName << ") #" << theList.size();
+}
+
+void CascadesDataManager::fillCustomerDataModel(QString objectName)
+{
+	fillDataModel(objectName, allCustomer());
+}
+
+void CascadesDataManager::replaceItemInCustomerDataModel(QString objectName, Customer* listItem)
+{
+	replaceItemInDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::removeItemFromCustomerDataModel(QString objectName, Customer* listItem)
+{
+	removeItemFromDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::insertItemIntoCustomerDataModel(QString objectName, Customer* listItem)
+{
+	insertItemIntoDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::fillCustomerDataModelByCompanyName(QString objectName, const QString& companyName)
+{
+	QList<QObject*> theList = listOfCustomerForCompanyName(companyName);
+	fillDataModel(objectName, theList);
+	DATA_LOG(DATA_LOG_MODEL) << "fillCustomerDataModelByCompanyName " << companyName << " (" << objectName << ") #"
+			<< theList.size();
+}
+
+void CascadesDataManager::fillTopicDataModel(QString objectName)
+{
+	fillDataModel(objectName, allTopic());
+}
+
+void CascadesDataManager::replaceItemInTopicDataModel(QString objectName, Topic* listItem)
+{
+	replaceItemInDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::removeItemFromTopicDataModel(QString objectName, Topic* listItem)
+{
+	removeItemFromDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::insertItemIntoTopicDataModel(QString objectName, Topic* listItem)
+{
+	insertItemIntoDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::fillDepartmentTreeDataModel(QString objectName)
+{
+	fillDataModel(objectName, allDepartment());
+}
+
+void CascadesDataManager::fillDepartmentFlatDataModel(QString objectName)
+{
+	fillDataModel(objectName, allDepartmentFlat());
+}
+
+void CascadesDataManager::replaceItemInDepartmentDataModel(QString objectName, Department* listItem)
+{
+	replaceItemInDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::removeItemFromDepartmentDataModel(QString objectName, Department* listItem)
+{
+	removeItemFromDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::insertItemIntoDepartmentDataModel(QString objectName, Department* listItem)
+{
+	insertItemIntoDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::fillTagDataModel(QString objectName)
+{
+	fillDataModel(objectName, allTag());
+}
+
+void CascadesDataManager::replaceItemInTagDataModel(QString objectName, Tag* listItem)
+{
+	replaceItemInDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::removeItemFromTagDataModel(QString objectName, Tag* listItem)
+{
+	removeItemFromDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::insertItemIntoTagDataModel(QString objectName, Tag* listItem)
+{
+	insertItemIntoDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::fillXtrasDataModel(QString objectName)
+{
+	fillDataModel(objectName, allXtras());
+}
+
+void CascadesDataManager::replaceItemInXtrasDataModel(QString objectName, Xtras* listItem)
+{
+	replaceItemInDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::removeItemFromXtrasDataModel(QString objectName, Xtras* listItem)
+{
+	removeItemFromDataModel(objectName, listItem);
+}
+
+void CascadesDataManager::insertItemIntoXtrasDataModel(QString objectName, Xtras* listItem)
+{
+	insertItemIntoDataModel(objectName, listItem);
+}
@@ -0,0 +1,137 @@
+#ifndef CASCADESDATAMANAGER_HPP_
+#define CASCADESDATAMANAGER_HPP_
+
+#include "src-gen/DataManager.hpp"
+
+#include <bb/LowMemoryWarningLevel>
+
+namespace bb
+{
+	class MemoryInfo;
+
+	namespace cascades
+	{
+		class GroupDataModel;
+	}
+}
+
+/*
+ * Cascades glue on top of the platform-neutral DataManager
+ *
+ * DataManager (persistence, indexes, resolving references) builds
+ * with plain Qt - see core/core.pro.
+ * this adapter adds what needs Cascades:
+ *   fill... / replaceItemIn... / removeItemFrom... / insertItemInto...DataModel
+ *   for the GroupDataModels of the current scene (found by objectName)
+ *   and the manual exit of bb::Application to persist caches before exit.
+ *   low memory warnings of the OS log memoryStatistics() and evict cold Order
+ * ApplicationUI creates it as 'dataManager' for QML - QML sees
+ * all invokables of DataManager plus the DataModel ones.
+ */
+class CascadesDataManager: public DataManager
+{
+	Q_OBJECT
+
+public:
+	CascadesDataManager(QObject *parent = 0);
+	virtual ~CascadesDataManager();
+
+	Q_INVOKABLE
+	void fillOrderDataModel(QString objectName);
+
+	Q_INVOKABLE
+	void replaceItemInOrderDataModel(QString objectName, Order* listItem);
+
+	Q_INVOKABLE
+	void removeItemFromOrderDataModel(QString objectName, Order* listItem);
+
+	Q_INVOKABLE
+	void insertItemIntoOrderDataModel(QString objectName, Order* listItem);
+
+	Q_INVOKABLE
+	void fillOrderDataModelByQuery(QString objectName, const QVariantMap& queryMap);
+
+	Q_INVOKABLE
+	void fillCustomerDataModel(QString objectName);
+
+	Q_INVOKABLE
+	void replaceItemInCustomerDataModel(QString objectName, Customer* listItem);
+
+	Q_INVOKABLE
+	void removeItemFromCustomerDataModel(QString objectName, Customer* listItem);
+
+	Q_INVOKABLE
+	void insertItemIntoCustomerDataModel(QString objectName, Customer* listItem);
+
+	Q_INVOKABLE
+	void fillCustomerDataModelByCompanyName(QString objectName, const QString& companyName);
+
+	Q_INVOKABLE
+	void fillTopicDataModel(QString objectName);
+
+	Q_INVOKABLE
+	void replaceItemInTopicDataModel(QString objectName, Topic* listItem);
+
+	Q_INVOKABLE
+	void removeItemFromTopicDataModel(QString objectName, Topic* listItem);
+
+	Q_INVOKABLE
+	void insertItemIntoTopicDataModel(QString objectName, Topic* listItem);
+
+	Q_INVOKABLE
+	void fillDepartmentTreeDataModel(QString objectName);
+
+	Q_INVOKABLE
+	void fillDepartmentFlatDataModel(QString objectName);
+
+	Q_INVOKABLE
+	void replaceItemInDepartmentDataModel(QString objectName, Department* listItem);
+
+	Q_INVOKABLE
+	void removeItemFromDepartmentDataModel(QString objectName, Department* listItem);
+
+	Q_INVOKABLE
+	void insertItemIntoDepartmentDataModel(QString objectName, Department* listItem);
+
+	Q_INVOKABLE
+	void fillTagDataModel(QString objectName);
+
+	Q_INVOKABLE
+	void replaceItemInTagDataModel(QString objectName, Tag* listItem);
+
+	Q_INVOKABLE
+	void removeItemFromTagDataModel(QString objectName, Tag* listItem);
+
+	Q_INVOKABLE
+	void insertItemIntoTagDataModel(QString objectName, Tag* listItem);
+
+	Q_INVOKABLE
+	void fillXtrasDataModel(QString objectName);
+
+	Q_INVOKABLE
+	void replaceItemInXtrasDataModel(QString objectName, Xtras* listItem);
+
+	Q_INVOKABLE
+	void removeItemFromXtrasDataModel(QString objectName, Xtras* listItem);
+
+	Q_INVOKABLE
+	void insertItemIntoXtrasDataModel(QString objectName, Xtras* listItem);
+
+public slots:
+	void onManualExit();
+	void onLowMemory(bb::LowMemoryWarningLevel::Type level);
+
+private:
+
+	bb::MemoryInfo* mMemoryInfo;
+
+	// last GroupDataModel named objectName in the scene or 0
+	bb::cascades::GroupDataModel* dataModel(const QString& objectName);
+
+	void fillDataModel(const QString& objectName, const QList<QObject*>& list);
+	void replaceItemInDataModel(const QString& objectName, QObject* listItem);
+	void removeItemFromDataModel(const QString& objectName, QObject* listItem);
+	void insertItemIntoDataModel(const QString& objectName, QObject* listItem);
+};
+
+#endif /* CASCADESDATAMANAGER_HPP_ */
@@ -0,0 +1,184 @@
+#include "ChunkedCache.hpp"
+
+#include <QFile>
+#include <QDebug>
+#include <limits.h>
+
+// per chunk: quint64 offset, quint32 byte size, quint32 records
+static const int tableEntrySize = 16;
+
+QByteArray ChunkedCache::magic()
+{
+	return QByteArray("EKDC");
+}
+
+int ChunkedCache::headerSize()
+{
+	return magic().size() + 1 + 4;
+}
+
+bool ChunkedCache::isChunked(QIODevice* device)
+{
+	QByteArray chunkedMagic = magic();
+	return device->peek(chunkedMagic.size()) == chunkedMagic;
+}
+
+/*
+ * reads header and offset table
+ * the device is positioned behind the table
+ * nothing read is trusted: the table must fit into the device,
+ * each chunk must lie behind the table and inside the device,
+ * a record takes at least one byte.
+ * a corrupted or truncated cache is rejected, not read
+ */
+bool ChunkedCache::readTable(QIODevice* device, QVector<Chunk>& chunks)
+{
+	chunks.clear();
+	qint64 deviceSize = device->size();
+	QByteArray header = device->read(headerSize());
+	if (header.size() != headerSize() || !header.startsWith(magic())) {
+		qWarning() << "ChunkedCache: no chunked cache";
+		return false;
+	}
+	if ((uchar) header.at(magic().size()) > VERSION) {
+		qWarning() << "ChunkedCache: unknown version " << (int) (uchar) header.at(magic().size());
+		return false;
+	}
+	quint32 chunkCount = uInt32At(header, magic().size() + 1);
+	qint64 tableSize = (qint64) chunkCount * tableEntrySize;
+	if (tableSize > deviceSize - headerSize()) {
+		qWarning() << "ChunkedCache: offset table larger than the file - chunks: " << chunkCount;
+		return false;
+	}
+	QByteArray table = device->read(tableSize);
+	if (table.size() != tableSize) {
+		qWarning() << "ChunkedCache: offset table truncated";
+		return false;
+	}
+	qint64 dataStart = headerSize() + tableSize;
+	chunks.reserve((int) chunkCount);
+	for (int i = 0; i < (int) chunkCount; ++i) {
+		int pos = i * tableEntrySize;
+		quint64 offset = (quint64) uInt32At(table, pos) | ((quint64) uInt32At(table, pos + 4) << 32);
+		quint32 size = uInt32At(table, pos + 8);
+		quint32 records = uInt32At(table, pos + 12);
+		if (offset < (quint64) dataStart || offset > (quint64) deviceSize
+				|| size > (quint64) deviceSize - offset || size > (quint32) INT_MAX || records > size) {
+			qWarning() << "ChunkedCache: invalid chunk " << i << " offset: " << offset << " size: " << size
+					<< " records: " << records;
+			chunks.clear();
+			return false;
+		}
+		Chunk chunk;
+		chunk.offset = (qint64) offset;
+		chunk.size = (int) size;
+		chunk.records = (int) records;
+		chunks.append(chunk);
+	}
+	return true;
+}
+
+QByteArray ChunkedCache::readChunk(const QString& fileName, const Chunk& chunk)
+{
+	QFile chunkFile(fileName);
+	if (!chunkFile.open(QIODevice::ReadOnly)) {
+		qWarning() << "ChunkedCache: cannot read chunk from " << fileName;
+		return QByteArray();
+	}
+	// the file may have changed since the table was read
+	if (chunk.offset < 0 || chunk.size < 0 || chunk.offset > chunkFile.size()
+			|| chunk.size > chunkFile.size() - chunk.offset || !chunkFile.seek(chunk.offset)) {
+		qWarning() << "ChunkedCache: chunk outside of " << fileName;
+		return QByteArray();
+	}
+	QByteArray data = chunkFile.read(chunk.size);
+	if (data.size() != chunk.size) {
+		qWarning() << "ChunkedCache: chunk truncated in " << fileName;
+		return QByteArray();
+	}
+	return data;
+}
+
+/*
+ * writes the header and reserves the offset table for chunkCount chunks
+ */
+ChunkedCache::ChunkedCache(QIODevice* device, const int& chunkCount) :
+		mDevice(device), mError(false)
+{
+	QByteArray header = magic();
+	header.append((char) VERSION);
+	appendUInt32(header, (quint32) chunkCount);
+	mTablePos = mDevice->pos() + header.size();
+	header.append(QByteArray(chunkCount * tableEntrySize, '\0'));
+	if (mDevice->write(header) != header.size()) {
+		mError = true;
+	}
+	mChunks.reserve(chunkCount);
+}
+
+void ChunkedCache::beginChunk()
+{
+	Chunk chunk;
+	chunk.offset = mDevice->pos();
+	chunk.size = 0;
+	chunk.records = 0;
+	mChunks.append(chunk);
+}
+
+// the DataWriter of the chunk must be flushed before
+void ChunkedCache::endChunk(const int& records)
+{
+	Chunk& chunk = mChunks.last();
+	chunk.size = (int) (mDevice->pos() - chunk.offset);
+	chunk.records = records;
+}
+
+/*
+ * writes the offset table
+ * all chunks announced to the constructor must be written
+ */
+bool ChunkedCache::finish()
+{
+	if (mError) {
+		qWarning() << "ChunkedCache cannot write: " << mDevice->errorString();
+		return false;
+	}
+	QByteArray table;
+	table.reserve(mChunks.size() * tableEntrySize);
+	for (int i = 0; i < mChunks.size(); ++i) {
+		const Chunk& chunk = mChunks.at(i);
+		appendUInt32(table, (quint32) (chunk.offset & 0xFFFFFFFF));
+		appendUInt32(table, (quint32) (chunk.offset >> 32));
+		appendUInt32(table, (quint32) chunk.size);
+		appendUInt32(table, (quint32) chunk.records);
+	}
+	qint64 endPos = mDevice->pos();
+	if (!mDevice->seek(mTablePos) || mDevice->write(table) != table.size() || !mDevice->seek(endPos)) {
+		qWarning() << "ChunkedCache cannot write offset table: " << mDevice->errorString();
+		mError = true;
+	}
+	return !mError;
+}
+
+const QVector<ChunkedCache::Chunk>& ChunkedCache::chunks() const
+{
+	return mChunks;
+}
+
+void ChunkedCache::appendUInt32(QByteArray& buffer, const quint32& value)
+{
+	buffer.append((char) (value & 0xFF));
+	buffer.append((char) ((value >> 8) & 0xFF));
+	buffer.append((char) ((value >> 16) & 0xFF));
+	buffer.append((char) ((value >> 24) & 0xFF));
+}
+
+quint32 ChunkedCache::uInt32At(const QByteArray& buffer, const int& pos)
+{
+	const uchar* data = reinterpret_cast<const uchar*>(buffer.constData() + pos);
+	return (quint32) data[0] | ((quint32) data[1] << 8) | ((quint32) data[2] << 16) | ((quint32) data[3] << 24);
+}
+
+ChunkedCache::~ChunkedCache()
+{
+}
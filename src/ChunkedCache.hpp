@@ -0,0 +1,68 @@
+#ifndef CHUNKEDCACHE_HPP_
+#define CHUNKEDCACHE_HPP_
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/*
+ * container for large caches: the records are split into chunks
+ * and each chunk is a complete cache array of its own,
+ * written by JsonDataWriter or BinaryDataWriter.
+ * so the chunks can be parsed independently by several threads
+ * and the results appended in chunk order (= order written)
+ *
+ * header: magic "EKDC" + quint8 version + quint32 chunk count
+ * offset table: per chunk quint64 offset, quint32 byte size, quint32 records
+ * then the chunks
+ * all numbers are little endian
+ *
+ * writing: the table is reserved by the constructor and written by finish(),
+ * so the device must be seekable
+ */
+class ChunkedCache
+{
+public:
+
+	struct Chunk
+	{
+		qint64 offset;
+		int size;
+		int records;
+	};
+
+	static const uchar VERSION = 1;
+
+	static QByteArray magic();
+
+	// device must be open - nothing is consumed
+	static bool isChunked(QIODevice* device);
+	// false if the table doesn't fit to the size of the device
+	static bool readTable(QIODevice* device, QVector<Chunk>& chunks);
+	// opens its own QFile, so chunks can be read from any thread
+	static QByteArray readChunk(const QString& fileName, const Chunk& chunk);
+
+	ChunkedCache(QIODevice* device, const int& chunkCount);
+	virtual ~ChunkedCache();
+
+	// data of the chunk is written to the device in between
+	void beginChunk();
+	void endChunk(const int& records);
+	bool finish();
+	// offset table of the chunks written
+	const QVector<Chunk>& chunks() const;
+
+private:
+
+	static void appendUInt32(QByteArray& buffer, const quint32& value);
+	static quint32 uInt32At(const QByteArray& buffer, const int& pos);
+	static int headerSize();
+
+	QIODevice* mDevice;
+	qint64 mTablePos;
+	QVector<Chunk> mChunks;
+	bool mError;
+};
+
+#endif /* CHUNKEDCACHE_HPP_ */
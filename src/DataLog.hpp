@@ -0,0 +1,41 @@
+#ifndef DATALOG_HPP_
+#define DATALOG_HPP_
+
+#include <QDebug>
+
+/*
+ * categorized debug output of the data layer
+ *
+ *   DATA_LOG(DATA_LOG_CACHE) << "created Order* #" << mAllOrder.size();
+ *
+ * DATA_LOG_CATEGORIES selects the categories at compile time:
+ * all in debug builds, none in release builds (QT_NO_DEBUG).
+ * a disabled category is a constant false condition - the compiler
+ * drops the statement, the arguments are never evaluated.
+ * log some categories of a release build:
+ *   DEFINES += DATA_LOG_CATEGORIES=0x06
+ * warnings (qWarning) are not affected
+ */
+#define DATA_LOG_INIT		0x01
+#define DATA_LOG_CACHE		0x02
+#define DATA_LOG_SQL		0x04
+#define DATA_LOG_FIND		0x08
+#define DATA_LOG_RESOLVE	0x10
+#define DATA_LOG_MODEL		0x20
+#define DATA_LOG_DTO		0x40
+#define DATA_LOG_TRACE		0x80
+#define DATA_LOG_ALL		0xff
+
+#ifndef DATA_LOG_CATEGORIES
+#ifdef QT_NO_DEBUG
+#define DATA_LOG_CATEGORIES 0
+#else
+#define DATA_LOG_CATEGORIES DATA_LOG_ALL
+#endif
+#endif
+
+// if / else: safe inside an if without braces
+#define DATA_LOG(category) \
+	if (!((category) & (DATA_LOG_CATEGORIES))) {} else qDebug()
+
+#endif /* DATALOG_HPP_ */
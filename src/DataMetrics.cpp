@@ -0,0 +1,105 @@
+#include "DataMetrics.hpp"
+
+#include <QMutexLocker>
+
+// names used in snapshot() - same order as the enums
+static const char* const timerNames[DataMetrics::TIMER_COUNT] = {
+		"init", "initDatabase", "parseOrder", "parseCustomer", "parseTopic", "parseDepartment", "parseTag",
+		"parseXtras", "resolveOrder", "fillDataModel", "sqlBatch", "saveOrder", "saveCustomer", "saveTopic",
+		"saveDepartment", "saveTag", "saveXtras", "evictOrder" };
+
+static const char* const counterNames[DataMetrics::COUNTER_COUNT] = {
+		"findHit", "findMiss", "resolveInvalid", "parsedRecords", "savedRecords", "sqlRows", "dataModelItems",
+		"evictedPositions", "reloadedPositions", "evictedReferences", "reloadedReferences" };
+
+DataMetrics::DataMetrics()
+{
+	reset();
+}
+
+void DataMetrics::record(const Timer& timer, const qint64& nsecs)
+{
+	QMutexLocker locker(&mMutex);
+	TimerSlot& slot = mTimers[timer];
+	slot.count++;
+	slot.totalNsecs += nsecs;
+	if (nsecs > slot.maxNsecs) {
+		slot.maxNsecs = nsecs;
+	}
+}
+
+void DataMetrics::increment(const Counter& counter, const int& by)
+{
+	mCounters[counter].fetchAndAddRelaxed(by);
+}
+
+/*
+ * { "sinceResetMs": ...,
+ *   "timers": { "init": { "count", "totalMs", "meanMs", "maxMs" }, ... },
+ *   "counters": { "findHit": ..., ... } }
+ * timers never started are left out
+ */
+QVariantMap DataMetrics::snapshot() const
+{
+	QVariantMap timers;
+	QVariantMap counters;
+	QVariantMap snapshotMap;
+	QMutexLocker locker(&mMutex);
+	for (int i = 0; i < TIMER_COUNT; ++i) {
+		const TimerSlot& slot = mTimers[i];
+		if (slot.count == 0) {
+			continue;
+		}
+		QVariantMap timerMap;
+		timerMap.insert("count", slot.count);
+		timerMap.insert("totalMs", slot.totalNsecs / 1000000.0);
+		timerMap.insert("meanMs", slot.totalNsecs / 1000000.0 / slot.count);
+		timerMap.insert("maxMs", slot.maxNsecs / 1000000.0);
+		timers.insert(timerNames[i], timerMap);
+	}
+	for (int i = 0; i < COUNTER_COUNT; ++i) {
+		// relaxed read: adding 0 works with Qt 4 and Qt 5
+		counters.insert(counterNames[i], mCounters[i].fetchAndAddRelaxed(0));
+	}
+	snapshotMap.insert("sinceResetMs", mSinceReset.elapsed());
+	snapshotMap.insert("timers", timers);
+	snapshotMap.insert("counters", counters);
+	return snapshotMap;
+}
+
+void DataMetrics::reset()
+{
+	QMutexLocker locker(&mMutex);
+	for (int i = 0; i < TIMER_COUNT; ++i) {
+		mTimers[i].count = 0;
+		mTimers[i].totalNsecs = 0;
+		mTimers[i].maxNsecs = 0;
+	}
+	for (int i = 0; i < COUNTER_COUNT; ++i) {
+		mCounters[i].fetchAndStoreRelaxed(0);
+	}
+	mSinceReset.start();
+}
+
+QString DataMetrics::timerName(const Timer& timer)
+{
+	return QString::fromLatin1(timerNames[timer]);
+}
+
+QString DataMetrics::counterName(const Counter& counter)
+{
+	return QString::fromLatin1(counterNames[counter]);
+}
+
+ScopedMetricsTimer::ScopedMetricsTimer(DataMetrics* metrics, const DataMetrics::Timer& timer) :
+		mMetrics(metrics), mTimer(timer)
+{
+	mElapsed.start();
+}
+
+ScopedMetricsTimer::~ScopedMetricsTimer()
+{
+	if (mMetrics) {
+		mMetrics->record(mTimer, mElapsed.nsecsElapsed());
+	}
+}
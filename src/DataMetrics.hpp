@@ -0,0 +1,106 @@
+#ifndef DATAMETRICS_HPP_
+#define DATAMETRICS_HPP_
+
+#include <QVariantMap>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
+/*
+ * timing and counters of the hot paths of DataManager
+ *
+ * timers and counters are fixed slots - nothing is looked up by name
+ * while measuring. a timer slot sums count, total and max nsecs,
+ * a counter slot is a plain total.
+ * record() is synchronized: the read... stages of init() run on worker threads,
+ * increment() is a relaxed atomic add - cheap enough for find...
+ * snapshot() names the slots: DataManager::metrics(), metricsSnapshot()
+ */
+class DataMetrics
+{
+public:
+	enum Timer {
+		INIT,
+		INIT_DATABASE,
+		PARSE_ORDER,
+		PARSE_CUSTOMER,
+		PARSE_TOPIC,
+		PARSE_DEPARTMENT,
+		PARSE_TAG,
+		PARSE_XTRAS,
+		RESOLVE_ORDER,
+		FILL_DATA_MODEL,
+		SQL_BATCH,
+		SAVE_ORDER,
+		SAVE_CUSTOMER,
+		SAVE_TOPIC,
+		SAVE_DEPARTMENT,
+		SAVE_TAG,
+		SAVE_XTRAS,
+		EVICT_ORDER,
+		TIMER_COUNT
+	};
+
+	enum Counter {
+		FIND_HIT,
+		FIND_MISS,
+		RESOLVE_INVALID,
+		PARSED_RECORDS,
+		SAVED_RECORDS,
+		SQL_ROWS,
+		DATA_MODEL_ITEMS,
+		EVICTED_POSITIONS,
+		RELOADED_POSITIONS,
+		EVICTED_REFERENCES,
+		RELOADED_REFERENCES,
+		COUNTER_COUNT
+	};
+
+	DataMetrics();
+
+	void record(const Timer& timer, const qint64& nsecs);
+	void increment(const Counter& counter, const int& by = 1);
+
+	QVariantMap snapshot() const;
+	void reset();
+
+	static QString timerName(const Timer& timer);
+	static QString counterName(const Counter& counter);
+
+private:
+	Q_DISABLE_COPY(DataMetrics)
+
+	struct TimerSlot
+	{
+		qint64 count;
+		qint64 totalNsecs;
+		qint64 maxNsecs;
+	};
+
+	mutable QMutex mMutex;
+	TimerSlot mTimers[TIMER_COUNT];
+	// 32 bit: good for ~2 billion events between reset()
+	mutable QAtomicInt mCounters[COUNTER_COUNT];
+	QElapsedTimer mSinceReset;
+};
+
+/*
+ * records the time from construction to destruction
+ *   ScopedMetricsTimer scopedTimer(&mMetrics, DataMetrics::PARSE_ORDER);
+ */
+class ScopedMetricsTimer
+{
+public:
+	// metrics 0: nothing recorded
+	ScopedMetricsTimer(DataMetrics* metrics, const DataMetrics::Timer& timer);
+	~ScopedMetricsTimer();
+
+private:
+	Q_DISABLE_COPY(ScopedMetricsTimer)
+
+	DataMetrics* mMetrics;
+	DataMetrics::Timer mTimer;
+	QElapsedTimer mElapsed;
+};
+
+#endif /* DATAMETRICS_HPP_ */
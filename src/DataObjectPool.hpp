@@ -0,0 +1,282 @@
+#ifndef DATAOBJECTPOOL_HPP_
+#define DATAOBJECTPOOL_HPP_
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QMap>
+#include <QHash>
+#include <QList>
+#include <QVariantMap>
+#include <new>
+
+/*
+ * typed Pool for cascaded DataObjects (Item, SubItem, Info)
+ *
+ * cascaded DataObjects are created in large numbers while
+ * filling a root DataObject from cache and all of them
+ * die together when the root is deleted.
+ * instead of one heap allocation per QObject the pool hands out
+ * fixed size slots from chunks of SlotsPerChunk objects,
+ * so siblings are close together in memory.
+ *
+ * the DataObject class routes its operator new / delete to the pool.
+ * memory not allocated from the pool (per ex. QML created objects
+ * of a derived type) is detected and handed back to the global heap.
+ *
+ * if the last living object of a type is released all chunks
+ * (except one as reserve) are freed in bulk -
+ * this is the case after deleteOrder() or reloading the cache.
+ * trim() frees all completely unused chunks.
+ *
+ * the pool of a type lives until the process ends:
+ * DataObjects may be deleted after static destruction
+ * (per ex. children of a QObject that is a static itself)
+ *
+ * DATA_OBJECT_POOL_OPERATORS in the class declaration and
+ * DATA_OBJECT_POOL_OPERATORS_IMPL(Type) in the .cpp route
+ * operator new / delete of a DataObject class to its pool.
+ */
+template<typename T, int SlotsPerChunk = 256>
+class DataObjectPool
+{
+public:
+
+    // never destroyed - see above
+    static DataObjectPool<T, SlotsPerChunk>* instance()
+    {
+        static DataObjectPool<T, SlotsPerChunk>* pool = new DataObjectPool<T, SlotsPerChunk>();
+        return pool;
+    }
+
+    void* allocate(size_t size)
+    {
+        QMutexLocker locker(&mMutex);
+        if (size != sizeof(T)) {
+            // derived types are not pooled
+            mForeignAllocations++;
+            return ::operator new(size);
+        }
+        if (!mFreeList) {
+            addChunk();
+        }
+        FreeSlot* slot = mFreeList;
+        mFreeList = slot->next;
+        mAllocations++;
+        mLive++;
+        if (mLive > mPeakLive) {
+            mPeakLive = mLive;
+        }
+        return slot;
+    }
+
+    void release(void* memory)
+    {
+        if (!memory) {
+            return;
+        }
+        QMutexLocker locker(&mMutex);
+        if (!owns(memory)) {
+            mForeignReleases++;
+            ::operator delete(memory);
+            return;
+        }
+        FreeSlot* slot = static_cast<FreeSlot*>(memory);
+        slot->next = mFreeList;
+        mFreeList = slot;
+        mReleases++;
+        mLive--;
+        if (mLive == 0 && mChunks.size() > 1) {
+            releaseAllChunksButOne();
+        }
+    }
+
+    /*
+     * frees all chunks without living objects
+     */
+    void trim()
+    {
+        QMutexLocker locker(&mMutex);
+        if (mChunks.isEmpty()) {
+            return;
+        }
+        QHash<quintptr, int> freeSlotsPerChunk;
+        for (FreeSlot* slot = mFreeList; slot; slot = slot->next) {
+            freeSlotsPerChunk[chunkOf(slot)]++;
+        }
+        QList<quintptr> unusedChunks;
+        QHash<quintptr, int>::const_iterator it;
+        for (it = freeSlotsPerChunk.constBegin(); it != freeSlotsPerChunk.constEnd(); ++it) {
+            if (it.value() == SlotsPerChunk) {
+                unusedChunks.append(it.key());
+            }
+        }
+        if (unusedChunks.isEmpty()) {
+            return;
+        }
+        for (int i = 0; i < unusedChunks.size(); ++i) {
+            mChunks.remove(unusedChunks.at(i));
+        }
+        // rebuild the free list without slots of the unused chunks
+        FreeSlot* freeList = 0;
+        FreeSlot* slot = mFreeList;
+        while (slot) {
+            FreeSlot* next = slot->next;
+            if (mChunks.contains(chunkOf(slot))) {
+                slot->next = freeList;
+                freeList = slot;
+            }
+            slot = next;
+        }
+        mFreeList = freeList;
+        for (int i = 0; i < unusedChunks.size(); ++i) {
+            ::operator delete(reinterpret_cast<void*>(unusedChunks.at(i)));
+            mChunkReleases++;
+        }
+    }
+
+    QVariantMap statistics()
+    {
+        QMutexLocker locker(&mMutex);
+        QVariantMap statisticsMap;
+        statisticsMap.insert("allocations", mAllocations);
+        statisticsMap.insert("releases", mReleases);
+        statisticsMap.insert("live", mLive);
+        statisticsMap.insert("peakLive", mPeakLive);
+        statisticsMap.insert("chunks", mChunks.size());
+        statisticsMap.insert("chunkAllocations", mChunkAllocations);
+        statisticsMap.insert("chunkReleases", mChunkReleases);
+        statisticsMap.insert("foreignAllocations", mForeignAllocations);
+        statisticsMap.insert("foreignReleases", mForeignReleases);
+        statisticsMap.insert("slotSize", (int) slotSize());
+        statisticsMap.insert("bytesReserved", (qlonglong) (mChunks.size() * chunkSize()));
+        return statisticsMap;
+    }
+
+private:
+
+    struct FreeSlot
+    {
+        FreeSlot* next;
+    };
+
+    DataObjectPool() :
+            mFreeList(0), mAllocations(0), mReleases(0), mLive(0), mPeakLive(0), mChunkAllocations(
+                    0), mChunkReleases(0), mForeignAllocations(0), mForeignReleases(0)
+    {
+    }
+
+    // instance() is never deleted: chunks are freed by the OS at exit
+    ~DataObjectPool()
+    {
+    }
+
+    static size_t slotSize()
+    {
+        // keep slots aligned for doubles and pointers
+        size_t size = sizeof(T) < sizeof(FreeSlot) ? sizeof(FreeSlot) : sizeof(T);
+        return ((size + sizeof(double) - 1) / sizeof(double)) * sizeof(double);
+    }
+
+    static size_t chunkSize()
+    {
+        return slotSize() * SlotsPerChunk;
+    }
+
+    void addChunk()
+    {
+        char* memory = static_cast<char*>(::operator new(chunkSize()));
+        mChunks.insert(reinterpret_cast<quintptr>(memory), reinterpret_cast<quintptr>(memory) + chunkSize());
+        mChunkAllocations++;
+        // push slots in reverse order: first allocation gets first slot
+        for (int i = SlotsPerChunk - 1; i >= 0; --i) {
+            FreeSlot* slot = reinterpret_cast<FreeSlot*>(memory + i * slotSize());
+            slot->next = mFreeList;
+            mFreeList = slot;
+        }
+    }
+
+    // start address of the chunk containing memory or 0
+    quintptr chunkOf(const void* memory) const
+    {
+        quintptr address = reinterpret_cast<quintptr>(memory);
+        QMap<quintptr, quintptr>::const_iterator it = mChunks.upperBound(address);
+        if (it == mChunks.constBegin()) {
+            return 0;
+        }
+        --it;
+        if (address < it.value()) {
+            return it.key();
+        }
+        return 0;
+    }
+
+    bool owns(const void* memory) const
+    {
+        return chunkOf(memory) != 0;
+    }
+
+    void releaseAllChunksButOne()
+    {
+        QMap<quintptr, quintptr>::iterator it = mChunks.begin();
+        quintptr reserve = it.key();
+        ++it;
+        while (it != mChunks.end()) {
+            ::operator delete(reinterpret_cast<void*>(it.key()));
+            mChunkReleases++;
+            it = mChunks.erase(it);
+        }
+        char* memory = reinterpret_cast<char*>(reserve);
+        mFreeList = 0;
+        for (int i = SlotsPerChunk - 1; i >= 0; --i) {
+            FreeSlot* slot = reinterpret_cast<FreeSlot*>(memory + i * slotSize());
+            slot->next = mFreeList;
+            mFreeList = slot;
+        }
+    }
+
+    QMutex mMutex;
+    // start address -> end address of all chunks
+    QMap<quintptr, quintptr> mChunks;
+    FreeSlot* mFreeList;
+    qlonglong mAllocations;
+    qlonglong mReleases;
+    int mLive;
+    int mPeakLive;
+    int mChunkAllocations;
+    int mChunkReleases;
+    int mForeignAllocations;
+    int mForeignReleases;
+
+    Q_DISABLE_COPY(DataObjectPool)
+};
+
+/*
+ * placement new is needed for QML created objects
+ */
+#define DATA_OBJECT_POOL_OPERATORS \
+    static void* operator new(size_t size); \
+    static void* operator new(size_t size, void* memory); \
+    static void operator delete(void* memory); \
+    static void operator delete(void* memory, void* place);
+
+#define DATA_OBJECT_POOL_OPERATORS_IMPL(Type) \
+    void* Type::operator new(size_t size) \
+    { \
+        return DataObjectPool<Type>::instance()->allocate(size); \
+    } \
+    void* Type::operator new(size_t size, void* memory) \
+    { \
+        Q_UNUSED(size); \
+        return memory; \
+    } \
+    void Type::operator delete(void* memory) \
+    { \
+        DataObjectPool<Type>::instance()->release(memory); \
+    } \
+    void Type::operator delete(void* memory, void* place) \
+    { \
+        Q_UNUSED(memory); \
+        Q_UNUSED(place); \
+    }
+
+#endif /* DATAOBJECTPOOL_HPP_ */
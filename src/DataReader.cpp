@@ -0,0 +1,97 @@
+#include "DataReader.hpp"
+#include "JsonDataReader.hpp"
+#include "BinaryDataReader.hpp"
+#include "BinaryDataWriter.hpp"
+
+#include <QDebug>
+#include <string.h>
+
+DataReader::DataReader(QIODevice* device, const int& bufferSize) :
+		mError(false), mDevice(device), mBufferSize(bufferSize), mPos(0)
+{
+}
+
+/*
+ * JSON or binary reader - depends on the first bytes of the device
+ * the device must be open
+ */
+DataReader* DataReader::create(QIODevice* device)
+{
+	QByteArray magic = BinaryDataWriter::magic();
+	if (device->peek(magic.size()) == magic) {
+		return new BinaryDataReader(device);
+	}
+	return new JsonDataReader(device);
+}
+
+bool DataReader::hasError() const
+{
+	return mError;
+}
+
+QString DataReader::errorString() const
+{
+	return mErrorString;
+}
+
+void DataReader::setError(const QString& errorString)
+{
+	if (!mError) {
+		mError = true;
+		mErrorString = errorString;
+		qWarning() << "DataReader: " << errorString;
+	}
+}
+
+bool DataReader::readBytes(char* data, const int& size)
+{
+	if (size < 0) {
+		setError("negative length");
+		return false;
+	}
+	int copied = 0;
+	while (copied < size) {
+		if (atEnd()) {
+			setError("unexpected end of data");
+			return false;
+		}
+		int available = qMin(size - copied, mBuffer.size() - mPos);
+		memcpy(data + copied, mBuffer.constData() + mPos, available);
+		mPos += available;
+		copied += available;
+	}
+	return true;
+}
+
+bool DataReader::readBytes(QByteArray& data, const int& size)
+{
+	if (size < 0) {
+		setError("negative length");
+		return false;
+	}
+	data.resize(size);
+	return readBytes(data.data(), size);
+}
+
+qint64 DataReader::remainingBytes() const
+{
+	if (mDevice->isSequential()) {
+		return -1;
+	}
+	return (mBuffer.size() - mPos) + qMax((qint64) 0, mDevice->size() - mDevice->pos());
+}
+
+// next block from device - the consumed part of the buffer is dropped
+bool DataReader::fill()
+{
+	if (mError) {
+		return false;
+	}
+	mBuffer = mDevice->read(mBufferSize);
+	mPos = 0;
+	return !mBuffer.isEmpty();
+}
+
+DataReader::~DataReader()
+{
+}
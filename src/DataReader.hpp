@@ -0,0 +1,71 @@
+#ifndef DATAREADER_HPP_
+#define DATAREADER_HPP_
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QString>
+#include <QVariantMap>
+
+/*
+ * streaming reader for caches and import files
+ *
+ * caches are arrays of DataObjects written by JsonDataWriter
+ * or BinaryDataWriter. readNext() parses only the next element
+ * of the top-level array, so memory is bounded by the largest
+ * element, not the file: the caller fills a DataObject
+ * from the map and discards it before reading the next one.
+ *
+ * create() sniffs the format: binary caches start with
+ * BinaryDataWriter::magic(), everything else is parsed as JSON
+ */
+class DataReader
+{
+public:
+	DataReader(QIODevice* device, const int& bufferSize = 64 * 1024);
+	virtual ~DataReader();
+
+	// next element of the top-level array
+	// false at the end of the array or if there's an error
+	virtual bool readNext(QVariantMap& map) = 0;
+
+	bool hasError() const;
+	QString errorString() const;
+
+	static DataReader* create(QIODevice* device);
+
+protected:
+
+	// buffered input
+	inline bool atEnd()
+	{
+		return mPos >= mBuffer.size() && !fill();
+	}
+	inline char peekChar()
+	{
+		return mBuffer.at(mPos);
+	}
+	inline char getChar()
+	{
+		return mBuffer.at(mPos++);
+	}
+	bool readBytes(char* data, const int& size);
+	bool readBytes(QByteArray& data, const int& size);
+	// bytes not read yet - -1 if the device doesn't know its size
+	qint64 remainingBytes() const;
+
+	void setError(const QString& errorString);
+
+	bool mError;
+
+private:
+
+	bool fill();
+
+	QIODevice* mDevice;
+	int mBufferSize;
+	QByteArray mBuffer;
+	int mPos;
+	QString mErrorString;
+};
+
+#endif /* DATAREADER_HPP_ */
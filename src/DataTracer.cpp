@@ -0,0 +1,187 @@
+#include "DataTracer.hpp"
+#include "JsonDataWriter.hpp"
+#include "DataLog.hpp"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QFile>
+#include <QMutexLocker>
+#include <QScopedPointer>
+#include <stdlib.h>
+
+QAtomicInt DataTracer::sEnabled(0);
+
+DataTracer::DataTracer()
+{
+}
+
+DataTracer* DataTracer::instance()
+{
+	static DataTracer tracer;
+	return &tracer;
+}
+
+/*
+ * starts recording - events of a previous start() not stopped are dropped
+ */
+bool DataTracer::start(const QString& fileName)
+{
+	if (fileName.isEmpty()) {
+		return false;
+	}
+	DataTracer* tracer = instance();
+	QMutexLocker locker(&tracer->mMutex);
+	tracer->mFileName = fileName;
+	tracer->mEvents.clear();
+	tracer->mEvents.reserve(64 * 1024);
+	tracer->mThreadIds.clear();
+	tracer->mThreadNames.clear();
+	tracer->mClock.start();
+	sEnabled.fetchAndStoreRelease(1);
+	return true;
+}
+
+// DATA_TRACE_FILE=/path/trace.json traces from the start of the app
+bool DataTracer::startFromEnvironment()
+{
+	const char* fileName = getenv("DATA_TRACE_FILE");
+	if (!fileName || !*fileName) {
+		return false;
+	}
+	return start(QString::fromLocal8Bit(fileName));
+}
+
+/*
+ * stops recording and writes the trace file
+ * false if not started or the file cannot be written
+ */
+bool DataTracer::stop()
+{
+	// only one stop() writes the file
+	if (!sEnabled.testAndSetRelease(1, 0)) {
+		return false;
+	}
+	DataTracer* tracer = instance();
+	QMutexLocker locker(&tracer->mMutex);
+	bool written = tracer->write();
+	tracer->mEvents.clear();
+	tracer->mEvents.squeeze();
+	return written;
+}
+
+void DataTracer::begin(const char* name, const char* category, const QString& detail)
+{
+	instance()->append(name, category, 'B', detail);
+}
+
+void DataTracer::end(const char* name, const char* category)
+{
+	instance()->append(name, category, 'E', QString());
+}
+
+void DataTracer::mark(const QString& name, const char* category)
+{
+	if (!isEnabled()) {
+		return;
+	}
+	instance()->append(0, category, 'i', name);
+}
+
+void DataTracer::append(const char* name, const char* category, const char& phase, const QString& text)
+{
+	QMutexLocker locker(&mMutex);
+	if (!isEnabled()) {
+		return;
+	}
+	Event event;
+	event.name = name;
+	event.category = category;
+	event.phase = phase;
+	event.timestamp = mClock.nsecsElapsed() / 1000.0;
+	event.threadId = currentThreadId();
+	event.text = text;
+	mEvents.append(event);
+}
+
+/*
+ * small ids instead of Qt::HANDLE, in order of the first event
+ * called with mMutex locked
+ */
+int DataTracer::currentThreadId()
+{
+	Qt::HANDLE handle = QThread::currentThreadId();
+	QHash<Qt::HANDLE, int>::const_iterator it = mThreadIds.constFind(handle);
+	if (it != mThreadIds.constEnd()) {
+		return it.value();
+	}
+	int threadId = mThreadNames.size() + 1;
+	mThreadIds.insert(handle, threadId);
+	QThread* thread = QThread::currentThread();
+	QString threadName = thread->objectName();
+	if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+		threadName = "main";
+	} else if (threadName.isEmpty()) {
+		threadName = QString("worker %1").arg(threadId);
+	}
+	mThreadNames.append(threadName);
+	return threadId;
+}
+
+/*
+ * { "traceEvents": [ { "name", "cat", "ph", "ts" (us), "pid", "tid", "args" }, ... ],
+ *   "displayTimeUnit": "ms" }
+ * thread names as metadata events
+ * called with mMutex locked
+ */
+bool DataTracer::write()
+{
+	QFile traceFile(mFileName);
+	if (!traceFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		qWarning() << "cannot open trace to write: " << mFileName;
+		return false;
+	}
+	int pid = (int) QCoreApplication::applicationPid();
+	QScopedPointer<DataWriter> writer(new JsonDataWriter(&traceFile));
+	writer->beginObject();
+	writer->beginArray("traceEvents");
+	for (int i = 0; i < mThreadNames.size(); ++i) {
+		writer->beginObject();
+		writer->writeString("name", "thread_name");
+		writer->writeString("ph", "M");
+		writer->writeInt("pid", pid);
+		writer->writeInt("tid", i + 1);
+		writer->beginObject("args");
+		writer->writeString("name", mThreadNames.at(i));
+		writer->endObject();
+		writer->endObject();
+	}
+	for (int i = 0; i < mEvents.size(); ++i) {
+		const Event& event = mEvents.at(i);
+		writer->beginObject();
+		writer->writeString("name", event.name ? QString::fromLatin1(event.name) : event.text);
+		writer->writeString("cat", QString::fromLatin1(event.category));
+		writer->writeString("ph", QString(QLatin1Char(event.phase)));
+		writer->writeDouble("ts", event.timestamp);
+		writer->writeInt("pid", pid);
+		writer->writeInt("tid", event.threadId);
+		if (event.phase == 'i') {
+			// instant event: thread scope
+			writer->writeString("s", "t");
+		}
+		if (event.name && !event.text.isEmpty()) {
+			writer->beginObject("args");
+			writer->writeString("detail", event.text);
+			writer->endObject();
+		}
+		writer->endObject();
+	}
+	writer->endArray();
+	writer->writeString("displayTimeUnit", "ms");
+	writer->endObject();
+	if (!writer->flush()) {
+		qWarning() << "trace NOT written: " << mFileName;
+		return false;
+	}
+	DATA_LOG(DATA_LOG_TRACE) << "trace written: " << mFileName << " events #" << mEvents.size();
+	return true;
+}
@@ -0,0 +1,120 @@
+#ifndef DATATRACER_HPP_
+#define DATATRACER_HPP_
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
+/*
+ * opt-in tracer writing Chrome trace-event JSON
+ * load the file in chrome://tracing or https://ui.perfetto.dev
+ *
+ * off by default: a span costs one bool check until start()
+ *   DataTracer::start("/path/trace.json") or env DATA_TRACE_FILE (startFromEnvironment())
+ *   ... TraceSpan span("initDatabase", "sql"); ...
+ *   DataTracer::stop() writes the file
+ * spans are begin / end events of the current thread -
+ * nested spans of a thread nest on the timeline, each thread is a track.
+ * events are buffered in memory until stop()
+ *
+ * start() / stop() from the thread of DataManager while no other thread
+ * is tracing (per ex. not while init() runs)
+ */
+class DataTracer
+{
+public:
+	static bool start(const QString& fileName);
+	static bool startFromEnvironment();
+	static bool stop();
+
+	// acquire: pairs with the release in start() / stop()
+	static inline bool isEnabled()
+	{
+#if QT_VERSION >= 0x050000
+		return sEnabled.loadAcquire() != 0;
+#else
+		// Qt 4 QAtomicInt has no plain load with acquire
+		return sEnabled.fetchAndAddAcquire(0) != 0;
+#endif
+	}
+
+	static void begin(const char* name, const char* category, const QString& detail = QString());
+	static void end(const char* name, const char* category);
+	// point in time - per ex. from QML
+	static void mark(const QString& name, const char* category);
+
+private:
+	// name of spans is a literal - no copy per event
+	// marks have no name, their name is in text
+	struct Event
+	{
+		const char* name;
+		const char* category;
+		char phase;
+		double timestamp;
+		int threadId;
+		QString text;
+	};
+
+	DataTracer();
+	static DataTracer* instance();
+	void append(const char* name, const char* category, const char& phase, const QString& text);
+	int currentThreadId();
+	bool write();
+
+	// read from all threads with a TraceSpan
+	static QAtomicInt sEnabled;
+
+	QMutex mMutex;
+	QString mFileName;
+	QElapsedTimer mClock;
+	QVector<Event> mEvents;
+	// Qt::HANDLE of a thread -> small id and name for the trace
+	QHash<Qt::HANDLE, int> mThreadIds;
+	QVector<QString> mThreadNames;
+};
+
+/*
+ * begin event now, end event at the end of the scope
+ * name and category must be literals - they are kept until stop()
+ */
+class TraceSpan
+{
+public:
+	TraceSpan(const char* name, const char* category) :
+			mName(0), mCategory(category)
+	{
+		if (DataTracer::isEnabled()) {
+			mName = name;
+			DataTracer::begin(name, category);
+		}
+	}
+
+	TraceSpan(const char* name, const char* category, const QString& detail) :
+			mName(0), mCategory(category)
+	{
+		if (DataTracer::isEnabled()) {
+			mName = name;
+			DataTracer::begin(name, category, detail);
+		}
+	}
+
+	~TraceSpan()
+	{
+		// also ends if stop() came in between: end() is a no-op then
+		if (mName) {
+			DataTracer::end(mName, mCategory);
+		}
+	}
+
+private:
+	Q_DISABLE_COPY(TraceSpan)
+
+	const char* mName;
+	const char* mCategory;
+};
+
+#endif /* DATATRACER_HPP_ */
@@ -0,0 +1,152 @@
+#ifndef DATAWRITER_HPP_
+#define DATAWRITER_HPP_
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include <QDate>
+#include <QVariant>
+
+/*
+ * streaming writer used by all DataObjects to export their properties
+ *
+ * each DataObject implements writeTo(writer, keyNaming, transientPolicy) once,
+ * writeTo() writes the properties into the current object of the writer -
+ * beginObject() / endObject() are called by the owner
+ * (DataManager for root DataObjects, the parent for contained ones).
+ *
+ * toMap(), toForeignMap() and toCacheMap() use a VariantMapWriter,
+ * caches are written with JsonDataWriter or BinaryDataWriter
+ * directly into the file without building QVariantMaps.
+ *
+ * inside an object all values need a key,
+ * inside an array the key is ignored - use QString()
+ */
+class DataWriter
+{
+public:
+
+	// property names: own names or names used from Server API
+	enum KeyNaming
+	{
+		OWN_KEYS, FOREIGN_KEYS
+	};
+	// transient properties are not written to cache
+	enum TransientPolicy
+	{
+		WITH_TRANSIENT, WITHOUT_TRANSIENT
+	};
+
+	virtual ~DataWriter()
+	{
+	}
+
+	virtual void beginObject(const QString& key = QString()) = 0;
+	virtual void endObject() = 0;
+	virtual void beginArray(const QString& key = QString()) = 0;
+	virtual void endArray() = 0;
+
+	virtual void writeInt(const QString& key, const int& value) = 0;
+	virtual void writeLongLong(const QString& key, const qint64& value) = 0;
+	virtual void writeBool(const QString& key, const bool& value) = 0;
+	virtual void writeDouble(const QString& key, const double& value) = 0;
+	virtual void writeString(const QString& key, const QString& value) = 0;
+	virtual void writeDate(const QString& key, const QDate& value) = 0;
+	virtual void writeNull(const QString& key) = 0;
+
+	virtual void writeStringList(const QString& key, const QStringList& values)
+	{
+		beginArray(key);
+		for (int i = 0; i < values.size(); ++i) {
+			writeString(QString(), values.at(i));
+		}
+		endArray();
+	}
+
+	// arrays of int are kept packed in a QVector
+	// writers with a packed format override this
+	virtual void writeIntList(const QString& key, const QVector<int>& values)
+	{
+		beginArray(key);
+		for (int i = 0; i < values.size(); ++i) {
+			writeInt(QString(), values.at(i));
+		}
+		endArray();
+	}
+
+	// writes a value kept as read from cache or map
+	// per ex. contained DataObjects not materialized yet
+	// 64-bit and null values are written as they are, not as int or ""
+	virtual void writeVariant(const QString& key, const QVariant& value)
+	{
+		switch (value.type()) {
+		case QVariant::Invalid:
+			writeNull(key);
+			break;
+		case QVariant::Map: {
+			beginObject(key);
+			QVariantMap map = value.toMap();
+			QVariantMap::const_iterator it;
+			for (it = map.constBegin(); it != map.constEnd(); ++it) {
+				writeVariant(it.key(), it.value());
+			}
+			endObject();
+			break;
+		}
+		case QVariant::List:
+		case QVariant::StringList: {
+			beginArray(key);
+			QVariantList list = value.toList();
+			for (int i = 0; i < list.size(); ++i) {
+				writeVariant(QString(), list.at(i));
+			}
+			endArray();
+			break;
+		}
+		case QVariant::Int:
+			writeInt(key, value.toInt());
+			break;
+		case QVariant::UInt:
+		case QVariant::LongLong:
+			writeLongLong(key, value.toLongLong());
+			break;
+		case QVariant::ULongLong:
+			// above the qint64 range only a double keeps the magnitude
+			if (value.toULongLong() > (quint64) Q_INT64_C(0x7FFFFFFFFFFFFFFF)) {
+				writeDouble(key, value.toDouble());
+			} else {
+				writeLongLong(key, value.toLongLong());
+			}
+			break;
+		case QVariant::Bool:
+			writeBool(key, value.toBool());
+			break;
+		case QVariant::Double:
+			writeDouble(key, value.toDouble());
+			break;
+		case QVariant::Date:
+			writeDate(key, value.toDate());
+			break;
+		default:
+			// packed int array read from binary cache
+			if (value.userType() == qMetaTypeId<QVector<int> >()) {
+				writeIntList(key, value.value<QVector<int> >());
+				break;
+			}
+			writeString(key, value.toString());
+			break;
+		}
+	}
+
+	// writes buffered data to the device
+	virtual bool flush()
+	{
+		return true;
+	}
+};
+
+// packed arrays of int inside QVariantMaps (see BinaryDataReader)
+Q_DECLARE_METATYPE(QVector<int>)
+
+#endif /* DATAWRITER_HPP_ */
@@ -0,0 +1,91 @@
+#include "DateCodec.hpp"
+
+static inline int digit(const QChar& c)
+{
+	ushort u = c.unicode();
+	return (u >= '0' && u <= '9') ? u - '0' : -1;
+}
+
+QDate DateCodec::fromIsoString(const QString& value)
+{
+	if (value.size() != 10) {
+		return QDate();
+	}
+	const QChar* data = value.constData();
+	if (data[4] != QLatin1Char('-') || data[7] != QLatin1Char('-')) {
+		return QDate();
+	}
+	int digits[8];
+	const int positions[8] = { 0, 1, 2, 3, 5, 6, 8, 9 };
+	for (int i = 0; i < 8; ++i) {
+		digits[i] = digit(data[positions[i]]);
+		if (digits[i] < 0) {
+			return QDate();
+		}
+	}
+	int year = digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3];
+	int month = digits[4] * 10 + digits[5];
+	int day = digits[6] * 10 + digits[7];
+	if (!QDate::isValid(year, month, day)) {
+		return QDate();
+	}
+	return QDate(year, month, day);
+}
+
+QString DateCodec::toIsoString(const QDate& date)
+{
+	if (!date.isValid()) {
+		return QString();
+	}
+	int year;
+	int month;
+	int day;
+	date.getDate(&year, &month, &day);
+	if (year < 0 || year > 9999) {
+		return date.toString("yyyy-MM-dd");
+	}
+	QChar chars[10];
+	chars[0] = QLatin1Char('0' + year / 1000);
+	chars[1] = QLatin1Char('0' + (year / 100) % 10);
+	chars[2] = QLatin1Char('0' + (year / 10) % 10);
+	chars[3] = QLatin1Char('0' + year % 10);
+	chars[4] = QLatin1Char('-');
+	chars[5] = QLatin1Char('0' + month / 10);
+	chars[6] = QLatin1Char('0' + month % 10);
+	chars[7] = QLatin1Char('-');
+	chars[8] = QLatin1Char('0' + day / 10);
+	chars[9] = QLatin1Char('0' + day % 10);
+	return QString(chars, 10);
+}
+
+void DateCodec::appendIsoDate(QByteArray& buffer, const QDate& date)
+{
+	int year;
+	int month;
+	int day;
+	date.getDate(&year, &month, &day);
+	if (!date.isValid() || year < 0 || year > 9999) {
+		buffer.append(toIsoString(date).toLatin1());
+		return;
+	}
+	char chars[10];
+	chars[0] = '0' + year / 1000;
+	chars[1] = '0' + (year / 100) % 10;
+	chars[2] = '0' + (year / 10) % 10;
+	chars[3] = '0' + year % 10;
+	chars[4] = '-';
+	chars[5] = '0' + month / 10;
+	chars[6] = '0' + month % 10;
+	chars[7] = '-';
+	chars[8] = '0' + day / 10;
+	chars[9] = '0' + day % 10;
+	buffer.append(chars, 10);
+}
+
+QDate DateCodec::fromVariant(const QVariant& value)
+{
+	if (value.type() == QVariant::Date) {
+		return value.toDate();
+	}
+	return fromIsoString(value.toString());
+}
@@ -0,0 +1,33 @@
+#ifndef DATECODEC_HPP_
+#define DATECODEC_HPP_
+
+#include <QDate>
+#include <QString>
+#include <QByteArray>
+#include <QVariant>
+
+/*
+ * fixed format codec for dates declared as
+ * @DateFormatString("yyyy-MM-dd")
+ *
+ * QDate::fromString(value, format) and QDate::toString(format)
+ * parse the format pattern for each call -
+ * here the positions are fixed: yyyy-MM-dd
+ * values not matching the format exactly are invalid (QDate())
+ *
+ * binary caches store dates as julian day (see BinaryDataWriter)
+ * bench: BenchmarkRunner::runDateCodec() parses 1M values with both
+ * and reports dateCodec.fromIsoString / dateCodec.qDateFromString
+ */
+class DateCodec
+{
+public:
+	static QDate fromIsoString(const QString& value);
+	static QString toIsoString(const QDate& date);
+	// appends yyyy-MM-dd as ASCII
+	static void appendIsoDate(QByteArray& buffer, const QDate& date);
+	// QDate from binary caches or yyyy-MM-dd from JSON
+	static QDate fromVariant(const QVariant& value);
+};
+
+#endif /* DATECODEC_HPP_ */
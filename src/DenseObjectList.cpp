@@ -0,0 +1,152 @@
+#include "DenseObjectList.hpp"
+#include "MemoryUsage.hpp"
+
+DenseObjectList::DenseObjectList() :
+		mKeyFunction(0), mAttachFunction(0)
+{
+}
+
+void DenseObjectList::setKeyFunctions(KeyFunction keyFunction, AttachFunction attachFunction)
+{
+	mKeyFunction = keyFunction;
+	mAttachFunction = attachFunction;
+}
+
+DenseObjectList& DenseObjectList::operator=(const QList<QObject*>& objectList)
+{
+	clear();
+	reserve(objectList.size());
+	for (int i = 0; i < objectList.size(); ++i) {
+		append(objectList.at(i));
+	}
+	return *this;
+}
+
+void DenseObjectList::append(QObject* object)
+{
+	int index = mObjects.size();
+	mIndexOfObject.insert(object, index);
+	mObjects.append(object);
+	if (mKeyFunction) {
+		int key = mKeyFunction(object);
+		mKeys.append(key);
+		mIndexOfKey.insert(key, index);
+		mAttachFunction(object, this);
+	}
+}
+
+void DenseObjectList::reserve(const int& size)
+{
+	mObjects.reserve(size);
+	mIndexOfObject.reserve(size);
+	if (mKeyFunction) {
+		mKeys.reserve(size);
+		mIndexOfKey.reserve(size);
+	}
+}
+
+void DenseObjectList::removeAt(const int& index)
+{
+	if (index < 0 || index >= mObjects.size()) {
+		return;
+	}
+	QObject* object = mObjects.at(index);
+	mIndexOfObject.remove(object);
+	int last = mObjects.size() - 1;
+	if (mKeyFunction) {
+		mIndexOfKey.remove(mKeys.at(index), index);
+		mAttachFunction(object, 0);
+		if (index != last) {
+			mIndexOfKey.remove(mKeys.at(last), last);
+			mIndexOfKey.insert(mKeys.at(last), index);
+			mKeys[index] = mKeys.at(last);
+		}
+		mKeys.remove(last);
+	}
+	if (index != last) {
+		mObjects[index] = mObjects.at(last);
+		mIndexOfObject.insert(mObjects.at(index), index);
+	}
+	mObjects.removeLast();
+}
+
+bool DenseObjectList::removeOne(QObject* object)
+{
+	int index = indexOf(object);
+	if (index < 0) {
+		return false;
+	}
+	removeAt(index);
+	return true;
+}
+
+void DenseObjectList::clear()
+{
+	detachAll();
+	mObjects.clear();
+	mIndexOfObject.clear();
+	mKeys.clear();
+	mIndexOfKey.clear();
+}
+
+void DenseObjectList::detachAll()
+{
+	if (!mAttachFunction) {
+		return;
+	}
+	for (int i = 0; i < mObjects.size(); ++i) {
+		mAttachFunction(mObjects.at(i), 0);
+	}
+}
+
+bool DenseObjectList::contains(QObject* object) const
+{
+	return mIndexOfObject.contains(object);
+}
+
+int DenseObjectList::indexOf(QObject* object) const
+{
+	return mIndexOfObject.value(object, -1);
+}
+
+int DenseObjectList::indexOfKey(const int& key) const
+{
+	return mIndexOfKey.value(key, -1);
+}
+
+QObject* DenseObjectList::objectOfKey(const int& key) const
+{
+	int index = indexOfKey(key);
+	return index < 0 ? 0 : mObjects.at(index);
+}
+
+void DenseObjectList::keyChanged(QObject* object)
+{
+	int index = indexOf(object);
+	if (index < 0 || !mKeyFunction) {
+		return;
+	}
+	int key = mKeyFunction(object);
+	if (key == mKeys.at(index)) {
+		return;
+	}
+	mIndexOfKey.remove(mKeys.at(index), index);
+	mIndexOfKey.insert(key, index);
+	mKeys[index] = key;
+}
+
+/*
+ * objects still attached are owned by DataManager and deleted after the lists
+ * they don't call keyChanged() while deleted
+ */
+DenseObjectList::~DenseObjectList()
+{
+}
+
+qint64 DenseObjectList::memoryBytes() const
+{
+	return MemoryUsage::listBytes(mObjects.size())
+			+ MemoryUsage::hashBytes(mIndexOfObject.size(), sizeof(QObject*) + sizeof(int))
+			+ MemoryUsage::vectorBytes(mKeys.capacity(), sizeof(int))
+			+ MemoryUsage::hashBytes(mIndexOfKey.size(), sizeof(int) + sizeof(int));
+}
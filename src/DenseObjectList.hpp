@@ -0,0 +1,103 @@
+#ifndef DENSEOBJECTLIST_HPP_
+#define DENSEOBJECTLIST_HPP_
+
+#include <QList>
+#include <QHash>
+#include <QMultiHash>
+#include <QVector>
+
+class QObject;
+
+/*
+ * storage of the root DataObjects of DataManager (mAllOrder, mAllCustomer, ...)
+ *
+ * objects are kept dense in a QList<QObject*>: loops over at(i) and
+ * fills of GroupDataModel (objectList()) work as with a plain QList.
+ * a hash object -> index finds the position of an object.
+ * removing an object moves the last object into the free position -
+ * O(1) instead of searching and shifting the list,
+ * but the order of the objects changes: after a delete the last object
+ * has a new index in allOrder() / allCustomer() ..., in the QML list
+ * properties and in the cache file written next.
+ *
+ * with key functions the int domain key (Order nr, Customer id ...)
+ * of each object is indexed too: indexOfKey() is O(1).
+ * attached objects call keyChanged() from their key setter and fillFrom(),
+ * so the key index stays exact.
+ *
+ * there are no generation-checked handles: references and indexes
+ * of the DataObjects store pointers, removed objects are detached
+ * and deleted later, so a handle would have no reader.
+ */
+class DenseObjectList
+{
+public:
+	// domain key of an object of this list
+	typedef int (*KeyFunction)(QObject* object);
+	// tells the object the list to inform about key changes - 0: detached
+	typedef void (*AttachFunction)(QObject* object, DenseObjectList* list);
+
+	DenseObjectList();
+	virtual ~DenseObjectList();
+
+	// before the first append
+	void setKeyFunctions(KeyFunction keyFunction, AttachFunction attachFunction);
+
+	DenseObjectList& operator=(const QList<QObject*>& objectList);
+
+	// dense iteration
+	inline int size() const
+	{
+		return mObjects.size();
+	}
+	inline bool isEmpty() const
+	{
+		return mObjects.isEmpty();
+	}
+	inline QObject* at(const int& index) const
+	{
+		return mObjects.at(index);
+	}
+	// for GroupDataModel and other APIs expecting a QList
+	inline const QList<QObject*>& objectList() const
+	{
+		return mObjects;
+	}
+
+	void append(QObject* object);
+	void reserve(const int& size);
+	// O(1) - the last object moves to index
+	void removeAt(const int& index);
+	bool removeOne(QObject* object);
+	void clear();
+
+	bool contains(QObject* object) const;
+	// -1 if not stored
+	int indexOf(QObject* object) const;
+
+	// -1 if no object has this key - with equal keys: one of them
+	int indexOfKey(const int& key) const;
+	// 0 if no object has this key
+	QObject* objectOfKey(const int& key) const;
+	// called by an attached object after its key changed
+	void keyChanged(QObject* object);
+
+	// estimated heap bytes of the list and the indexes
+	qint64 memoryBytes() const;
+
+private:
+
+	void detachAll();
+
+	QList<QObject*> mObjects;
+	QHash<QObject*, int> mIndexOfObject;
+	KeyFunction mKeyFunction;
+	AttachFunction mAttachFunction;
+	// key of the object at the same index - the old key on keyChanged()
+	QVector<int> mKeys;
+	QMultiHash<int, int> mIndexOfKey;
+
+	Q_DISABLE_COPY(DenseObjectList)
+};
+
+#endif /* DENSEOBJECTLIST_HPP_ */
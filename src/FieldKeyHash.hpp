@@ -0,0 +1,31 @@
+#ifndef FIELDKEYHASH_HPP_
+#define FIELDKEYHASH_HPP_
+
+#include <QString>
+
+/*
+ * perfect hash for the property names (QVariantMap keys) of DataObjects
+ *
+ * for each DataObject length and first character of all its
+ * property names (own and foreign) are unique,
+ * so the fillFrom() methods walk the map once and dispatch each key
+ * with a switch over FIELD_KEY_HASH() and one QString compare,
+ * instead of one QVariantMap::value() tree lookup per property.
+ * adding a property with the same length and first character
+ * as an existing one needs another character in the hash.
+ */
+#define FIELD_KEY_HASH(length, firstChar) (((length) << 8) | (firstChar))
+
+inline int fieldKeyHash(const QString& key)
+{
+	if (key.isEmpty()) {
+		return 0;
+	}
+	ushort firstChar = key.at(0).unicode();
+	if (firstChar > 0xFF) {
+		return 0;
+	}
+	return FIELD_KEY_HASH(key.size(), firstChar);
+}
+
+#endif /* FIELDKEYHASH_HPP_ */
@@ -1,6 +1,10 @@
 #include "GeoAddress.hpp"
+#include "StringPool.hpp"
+#include "VariantMapWriter.hpp"
+#include "MemoryUsage.hpp"
 #include <QDebug>
 #include <quuid.h>
+#include <QStringList>
 
 // keys of QVariantMap used in this APP
 static const QString uuidKey = "uuid";
@@ -20,9 +24,8 @@ GeoAddress::GeoAddress(QObject *parent) :
         QObject(parent), mUuid(""), mCity(""), mCountry(""), mCountryCode(""), mCounty(""), mDistrict(
                 ""), mPostcode(""), mState(""), mStreet("")
 {
-    mWrappedGeoAddress = new QGeoAddress;
-    mAsText = mWrappedGeoAddress->text();
-    mIsEmpty = mWrappedGeoAddress->isEmpty();
+    mAsText = asText();
+    mIsEmpty = isEmpty();
     mUuid = QUuid::createUuid().toString();
     mUuid = mUuid.right(mUuid.length() - 1);
     mUuid = mUuid.left(mUuid.length() - 1);
@@ -40,40 +43,32 @@ void GeoAddress::fillFromMap(const QVariantMap& geoAddressMap)
     if (geoAddressMap.contains(uuidKey) && !geoAddressMap.value(uuidKey).toString().isEmpty()) {
         mUuid = geoAddressMap.value(uuidKey).toString();
     }
-    mWrappedGeoAddress->clear();
     if (geoAddressMap.contains(cityKey)) {
-        mCity = geoAddressMap.value(cityKey).toString();
-        mWrappedGeoAddress->setCity(mCity);
+        mCity = StringPool::interned(geoAddressMap.value(cityKey).toString());
     }
     if (geoAddressMap.contains(countryKey)) {
-        mCountry = geoAddressMap.value(countryKey).toString();
-        mWrappedGeoAddress->setCountry(mCountry);
+        mCountry = StringPool::interned(geoAddressMap.value(countryKey).toString());
     }
     if (geoAddressMap.contains(countryCodeKey)) {
-        mCountryCode = geoAddressMap.value(countryCodeKey).toString();
-        mWrappedGeoAddress->setCountryCode(mCountryCode);
+        mCountryCode = StringPool::interned(geoAddressMap.value(countryCodeKey).toString());
     }
     if (geoAddressMap.contains(countyKey)) {
         mCounty = geoAddressMap.value(countyKey).toString();
-        mWrappedGeoAddress->setCounty(mCounty);
     }
     if (geoAddressMap.contains(districtKey)) {
         mDistrict = geoAddressMap.value(districtKey).toString();
-        mWrappedGeoAddress->setDistrict(mDistrict);
     }
     if (geoAddressMap.contains(postcodeKey)) {
         mPostcode = geoAddressMap.value(postcodeKey).toString();
-        mWrappedGeoAddress->setPostcode(mPostcode);
     }
     if (geoAddressMap.contains(stateKey)) {
         mState = geoAddressMap.value(stateKey).toString();
-        mWrappedGeoAddress->setState(mState);
     }
     if (geoAddressMap.contains(streetKey)) {
         mStreet = geoAddressMap.value(streetKey).toString();
-        mWrappedGeoAddress->setStreet(mStreet);
     }
-    mAsText = mWrappedGeoAddress->text();
+    mAsText = asText();
+    mIsEmpty = isEmpty();
 }
 // to be compatible to normal DTOs
 void GeoAddress::fillFromForeignMap(const QVariantMap& geoAddressMap)
@@ -86,49 +81,21 @@ void GeoAddress::fillFromCacheMap(const QVariantMap& geoAddressMap)
     fillFromMap(geoAddressMap);
 }
 
-// SLOT
-void GeoAddress::onAddressReceived(QGeoAddress* address)
-{
-    if (address && !address->isEmpty()) {
-        if (address != mWrappedGeoAddress) {
-            mWrappedGeoAddress = address;
-            mCity.clear();
-            if (!address->city().isNull() && !address->city().isEmpty()) {
-                mCity = address->city();
-            }
-            mCountry.clear();
-            if (!address->country().isNull() && !address->country().isEmpty()) {
-                mCountry = address->country();
-            }
-            mCountryCode.clear();
-            if (!address->countryCode().isNull() && !address->countryCode().isEmpty()) {
-                mCountryCode = address->countryCode();
-            }
-            mCounty.clear();
-            if (!address->county().isNull() && !address->county().isEmpty()) {
-                mCounty = address->county();
-            }
-            mDistrict.clear();
-            if (!address->district().isNull() && !address->district().isEmpty()) {
-                mDistrict = address->district();
-            }
-            mPostcode.clear();
-            if (!address->postcode().isNull() && !address->postcode().isEmpty()) {
-                mPostcode = address->postcode();
-            }
-            mState.clear();
-            if (!address->state().isNull() && !address->state().isEmpty()) {
-                mState = address->state();
-            }
-            mStreet.clear();
-            if (!address->street().isNull() && !address->street().isEmpty()) {
-                mStreet = address->street();
-            }
-            emit addressChanged(this);
-            updateAsText();
-            updateIsEmpty();
-        }
-    }
+/*
+ * per ex. an address received from a geocoder
+ * see GeoConversion::fillGeoAddress()
+ */
+void GeoAddress::updateFromMap(const QVariantMap& geoAddressMap)
+{
+    setCity(geoAddressMap.value(cityKey).toString());
+    setCountry(geoAddressMap.value(countryKey).toString());
+    setCountryCode(geoAddressMap.value(countryCodeKey).toString());
+    setCounty(geoAddressMap.value(countyKey).toString());
+    setDistrict(geoAddressMap.value(districtKey).toString());
+    setPostcode(geoAddressMap.value(postcodeKey).toString());
+    setState(geoAddressMap.value(stateKey).toString());
+    setStreet(geoAddressMap.value(streetKey).toString());
+    emit addressChanged(this);
 }
 
 /*
@@ -139,7 +106,7 @@ bool GeoAddress::isValid()
     if (mUuid.isNull() || mUuid.isEmpty()) {
         return false;
     }
-    if (mWrappedGeoAddress->isEmpty()) {
+    if (isEmpty()) {
         return false;
     }
     if (mStreet.isEmpty() && mCity.isEmpty()) {
@@ -155,35 +122,46 @@ bool GeoAddress::isValid()
  */
 QVariantMap GeoAddress::toMap()
 {
-    QVariantMap geoAddressMap;
-    if (!mWrappedGeoAddress->isEmpty()) {
-        geoAddressMap.insert(uuidKey, mUuid);
+    VariantMapWriter writer;
+    writer.beginObject();
+    writeTo(&writer);
+    writer.endObject();
+    return writer.map();
+}
+
+/*
+ * writes all properties into the current object of writer
+ * nothing is written for an empty address
+ */
+void GeoAddress::writeTo(DataWriter* writer)
+{
+    if (!isEmpty()) {
+        writer->writeString(uuidKey, mUuid);
         if (!mCity.isEmpty()) {
-            geoAddressMap.insert(cityKey, mCity);
+            writer->writeString(cityKey, mCity);
         }
         if (!mCountry.isEmpty()) {
-            geoAddressMap.insert(countryKey, mCountry);
+            writer->writeString(countryKey, mCountry);
         }
         if (!mCountryCode.isEmpty()) {
-            geoAddressMap.insert(countryCodeKey, mCountryCode);
+            writer->writeString(countryCodeKey, mCountryCode);
         }
         if (!mCounty.isEmpty()) {
-            geoAddressMap.insert(countyKey, mCounty);
+            writer->writeString(countyKey, mCounty);
         }
         if (!mDistrict.isEmpty()) {
-            geoAddressMap.insert(districtKey, mDistrict);
+            writer->writeString(districtKey, mDistrict);
         }
         if (!mPostcode.isEmpty()) {
-            geoAddressMap.insert(postcodeKey, mPostcode);
+            writer->writeString(postcodeKey, mPostcode);
         }
         if (!mState.isEmpty()) {
-            geoAddressMap.insert(stateKey, mState);
+            writer->writeString(stateKey, mState);
         }
         if (!mStreet.isEmpty()) {
-            geoAddressMap.insert(streetKey, mStreet);
+            writer->writeString(streetKey, mStreet);
         }
     }
-    return geoAddressMap;
 }
 
 QString GeoAddress::uuid() const
@@ -206,7 +184,6 @@ void GeoAddress::setCity(QString city)
 {
     if (city != mCity) {
         mCity = city;
-        mWrappedGeoAddress->setCity(mCity);
         emit cityChanged(city);
         updateAsText();
         updateIsEmpty();
@@ -221,7 +198,6 @@ void GeoAddress::setCountry(QString country)
 {
     if (country != mCountry) {
         mCountry = country;
-        mWrappedGeoAddress->setCountry(mCountry);
         emit countryChanged(country);
         updateAsText();
         updateIsEmpty();
@@ -236,7 +212,6 @@ void GeoAddress::setCountryCode(QString countryCode)
 {
     if (countryCode != mCountryCode) {
         mCountryCode = countryCode;
-        mWrappedGeoAddress->setCountryCode(mCountryCode);
         emit countryCodeChanged(countryCode);
         updateAsText();
         updateIsEmpty();
@@ -251,7 +226,6 @@ void GeoAddress::setCounty(QString county)
 {
     if (county != mCounty) {
         mCounty = county;
-        mWrappedGeoAddress->setCounty(mCounty);
         emit countyChanged(county);
         updateAsText();
         updateIsEmpty();
@@ -266,7 +240,6 @@ void GeoAddress::setDistrict(QString district)
 {
     if (district != mDistrict) {
         mDistrict = district;
-        mWrappedGeoAddress->setDistrict(mDistrict);
         emit districtChanged(district);
         updateAsText();
         updateIsEmpty();
@@ -281,7 +254,6 @@ void GeoAddress::setPostcode(QString postcode)
 {
     if (postcode != mPostcode) {
         mPostcode = postcode;
-        mWrappedGeoAddress->setPostcode(mPostcode);
         emit postcodeChanged(postcode);
         updateAsText();
         updateIsEmpty();
@@ -296,7 +268,6 @@ void GeoAddress::setState(QString state)
 {
     if (state != mState) {
         mState = state;
-        mWrappedGeoAddress->setState(mState);
         emit stateChanged(state);
         updateAsText();
         updateIsEmpty();
@@ -311,42 +282,67 @@ void GeoAddress::setStreet(QString street)
 {
     if (street != mStreet) {
         mStreet = street;
-        mWrappedGeoAddress->setStreet(mStreet);
         emit streetChanged(street);
         updateAsText();
         updateIsEmpty();
     }
 }
 
+/*
+ * street, postcode city, district, county, state, country - empty parts are left out
+ * (QGeoAddress::text() of QtLocationSubset formats per country)
+ */
 QString GeoAddress::asText() const
 {
-    return mWrappedGeoAddress->text();
+    QStringList lines;
+    if (!mStreet.isEmpty()) {
+        lines.append(mStreet);
+    }
+    QString cityLine = QString("%1 %2").arg(mPostcode, mCity).trimmed();
+    if (!cityLine.isEmpty()) {
+        lines.append(cityLine);
+    }
+    if (!mDistrict.isEmpty()) {
+        lines.append(mDistrict);
+    }
+    if (!mCounty.isEmpty()) {
+        lines.append(mCounty);
+    }
+    if (!mState.isEmpty()) {
+        lines.append(mState);
+    }
+    if (!mCountry.isEmpty()) {
+        lines.append(mCountry);
+    } else if (!mCountryCode.isEmpty()) {
+        lines.append(mCountryCode);
+    }
+    return lines.join(", ");
 }
 
 void GeoAddress::updateAsText()
 {
-    if (mWrappedGeoAddress->text() != mAsText) {
-        mAsText = mWrappedGeoAddress->text();
+    if (asText() != mAsText) {
+        mAsText = asText();
         emit asTextChanged(mAsText);
     }
 }
 
 bool GeoAddress::isEmpty() const
 {
-    return mWrappedGeoAddress->isEmpty();
+    return mCity.isEmpty() && mCountry.isEmpty() && mCountryCode.isEmpty() && mCounty.isEmpty()
+            && mDistrict.isEmpty() && mPostcode.isEmpty() && mState.isEmpty() && mStreet.isEmpty();
 }
 
 void GeoAddress::updateIsEmpty()
 {
-    if (mWrappedGeoAddress->isEmpty() != mIsEmpty) {
-        mIsEmpty = mWrappedGeoAddress->isEmpty();
+    if (isEmpty() != mIsEmpty) {
+        mIsEmpty = isEmpty();
         emit isEmptyChanged(mIsEmpty);
     }
 }
 
 void GeoAddress::clear()
 {
-    mWrappedGeoAddress->clear();
     mCity.clear();
     mCountry.clear();
     mCountryCode.clear();
@@ -359,9 +355,15 @@ void GeoAddress::clear()
     updateIsEmpty();
 }
 
-QGeoAddress* GeoAddress::wrappedAddress()
-{
-    return mWrappedGeoAddress;
+// estimated memory of this GeoAddress
+void GeoAddress::addMemoryUsage(MemoryUsage* usage) const
+{
+    qint64 stringBytes = MemoryUsage::stringBytes(mUuid) + MemoryUsage::stringBytes(mCity)
+            + MemoryUsage::stringBytes(mCountry) + MemoryUsage::stringBytes(mCountryCode)
+            + MemoryUsage::stringBytes(mCounty) + MemoryUsage::stringBytes(mDistrict)
+            + MemoryUsage::stringBytes(mPostcode) + MemoryUsage::stringBytes(mState)
+            + MemoryUsage::stringBytes(mStreet) + MemoryUsage::stringBytes(mAsText);
+    usage->addObject(MemoryUsage::GEO_ADDRESS, MemoryUsage::objectBytes(sizeof(GeoAddress)), stringBytes);
 }
 
 GeoAddress::~GeoAddress()
@@ -3,10 +3,17 @@
 
 #include <QObject>
 #include <qvariant.h>
-#include <QtLocationSubset/QGeoAddress>
+#include "DataWriter.hpp"
 
-using namespace QtMobilitySubset;
+class MemoryUsage;
 
+/*
+ * address of a DataObject (per ex. Customer) as QObject for QML
+ *
+ * plain Qt - empty if no part of the address is set
+ * conversion from / to QGeoAddress of QtLocationSubset
+ * is in the Cascades adapter: ../GeoConversion.hpp
+ */
 class GeoAddress: public QObject
 {
 	Q_OBJECT
@@ -38,6 +45,8 @@ public:
 
 	Q_INVOKABLE
 	QVariantMap toMap();
+	void writeTo(DataWriter* writer);
+	void addMemoryUsage(MemoryUsage* usage) const;
 
 	QString uuid() const;
 	void setUuid(QString uuid);
@@ -64,7 +73,8 @@ public:
 	Q_INVOKABLE
 	void clear();
 
-	QGeoAddress* wrappedAddress();
+	// sets all parts (missing keys: empty) and emits addressChanged()
+	void updateFromMap(const QVariantMap& geoAddressMap);
 
 	virtual ~GeoAddress();
 
@@ -84,10 +94,6 @@ public:
 	void asTextChanged(QString asText);
 	void isEmptyChanged(bool isEmpty);
 
-	public slots:
-
-    void onAddressReceived(QGeoAddress* address);
-
 private:
 
 	QString mUuid;
@@ -105,9 +111,6 @@ private:
 	bool mIsEmpty;
 	void updateIsEmpty();
 
-	// wrapped
-    QGeoAddress* mWrappedGeoAddress;
-
 	Q_DISABLE_COPY (GeoAddress)
 };
 Q_DECLARE_METATYPE(GeoAddress*)
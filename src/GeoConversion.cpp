@@ -0,0 +1,66 @@
+#include "GeoConversion.hpp"
+#include "GeoCoordinate.hpp"
+#include "GeoAddress.hpp"
+
+#include <QVariantMap>
+#include <qnumeric.h>
+
+using namespace QtMobilitySubset;
+
+QGeoCoordinate GeoConversion::toQGeoCoordinate(const GeoCoordinate* coordinate)
+{
+	if (!coordinate || !coordinate->isValid()) {
+		return QGeoCoordinate();
+	}
+	if (coordinate->is3D()) {
+		return QGeoCoordinate(coordinate->latitude(), coordinate->longitude(), coordinate->altitude());
+	}
+	return QGeoCoordinate(coordinate->latitude(), coordinate->longitude());
+}
+
+void GeoConversion::fillGeoCoordinate(GeoCoordinate* coordinate, const QGeoCoordinate& geoCoordinate)
+{
+	if (!coordinate || !geoCoordinate.isValid()) {
+		return;
+	}
+	double altitude = qQNaN();
+	if (geoCoordinate.type() == QGeoCoordinate::Coordinate3D) {
+		altitude = geoCoordinate.altitude();
+	}
+	coordinate->updateCoordinate(geoCoordinate.latitude(), geoCoordinate.longitude(), altitude);
+}
+
+QGeoAddress GeoConversion::toQGeoAddress(const GeoAddress* address)
+{
+	QGeoAddress geoAddress;
+	if (!address) {
+		return geoAddress;
+	}
+	geoAddress.setCity(address->city());
+	geoAddress.setCountry(address->country());
+	geoAddress.setCountryCode(address->countryCode());
+	geoAddress.setCounty(address->county());
+	geoAddress.setDistrict(address->district());
+	geoAddress.setPostcode(address->postcode());
+	geoAddress.setState(address->state());
+	geoAddress.setStreet(address->street());
+	return geoAddress;
+}
+
+void GeoConversion::fillGeoAddress(GeoAddress* address, const QGeoAddress& geoAddress)
+{
+	if (!address || geoAddress.isEmpty()) {
+		return;
+	}
+	// same keys as GeoAddress::toMap()
+	QVariantMap geoAddressMap;
+	geoAddressMap.insert("city", geoAddress.city());
+	geoAddressMap.insert("country", geoAddress.country());
+	geoAddressMap.insert("countryCode", geoAddress.countryCode());
+	geoAddressMap.insert("county", geoAddress.county());
+	geoAddressMap.insert("district", geoAddress.district());
+	geoAddressMap.insert("postcode", geoAddress.postcode());
+	geoAddressMap.insert("state", geoAddress.state());
+	geoAddressMap.insert("street", geoAddress.street());
+	address->updateFromMap(geoAddressMap);
+}
@@ -0,0 +1,30 @@
+#ifndef GEOCONVERSION_HPP_
+#define GEOCONVERSION_HPP_
+
+#include <QtLocationSubset/QGeoCoordinate>
+#include <QtLocationSubset/QGeoAddress>
+
+class GeoCoordinate;
+class GeoAddress;
+
+/*
+ * GeoCoordinate / GeoAddress of the data layer <-> QtLocationSubset of BB10
+ *
+ * the data layer (core/core.pro) only uses plain Qt,
+ * location services, maps and geocoding of the app
+ * work with QGeoCoordinate and QGeoAddress - converted here.
+ * part of the Cascades adapter like CascadesDataManager
+ */
+class GeoConversion
+{
+public:
+	static QtMobilitySubset::QGeoCoordinate toQGeoCoordinate(const GeoCoordinate* coordinate);
+	// emits GeoCoordinate::coordinateChanged() - invalid geoCoordinate is ignored
+	static void fillGeoCoordinate(GeoCoordinate* coordinate, const QtMobilitySubset::QGeoCoordinate& geoCoordinate);
+
+	static QtMobilitySubset::QGeoAddress toQGeoAddress(const GeoAddress* address);
+	// emits GeoAddress::addressChanged() - empty geoAddress is ignored
+	static void fillGeoAddress(GeoAddress* address, const QtMobilitySubset::QGeoAddress& geoAddress);
+};
+
+#endif /* GEOCONVERSION_HPP_ */
@@ -1,6 +1,10 @@
 #include "GeoCoordinate.hpp"
+#include "VariantMapWriter.hpp"
+#include "MemoryUsage.hpp"
 #include <QDebug>
 #include <quuid.h>
+#include <qnumeric.h>
+#include <qmath.h>
 
 // keys of QVariantMap used in this APP
 static const QString uuidKey = "uuid";
@@ -8,15 +12,33 @@ static const QString latitudeKey = "latitude";
 static const QString longitudeKey = "longitude";
 static const QString altitudeKey = "altitude";
 
+static const double earthMeanRadiusMeters = 6371007.2;
+
+// degrees, minutes, seconds and hemisphere - as QGeoCoordinate::DegreesMinutesSecondsWithHemisphere
+static QString degreesMinutesSeconds(const double& value, const char* positive, const char* negative)
+{
+    double absValue = qAbs(value);
+    int degrees = (int) absValue;
+    double minutes = (absValue - degrees) * 60.0;
+    double seconds = (minutes - (int) minutes) * 60.0;
+    return QString("%1%2 %3' %4\" %5").arg(degrees).arg(QChar(0x00B0)).arg((int) minutes).arg(seconds, 0, 'f',
+            3).arg(QLatin1String(value >= 0 ? positive : negative));
+}
+
+static double toRadians(const double& degrees)
+{
+    return degrees * M_PI / 180.0;
+}
+
 /*
  * Default Constructor if GeoCoordinate not initialized from QVariantMap
  */
 GeoCoordinate::GeoCoordinate(QObject *parent) :
-        QObject(parent), mUuid(""), mLatitude(0.0), mLongitude(0.0), mAltitude(0.0)
+        QObject(parent), mUuid(""), mLatitude(0.0), mLongitude(0.0), mAltitude(0.0), mHasLatitude(false),
+                mHasLongitude(false), mHasAltitude(false)
 {
-    mWrappedGeoCoordinate = new QGeoCoordinate();
-    mAsText = mWrappedGeoCoordinate->toString();
-    mIsValid = mWrappedGeoCoordinate->isValid();
+    mAsText = asText();
+    mIsValid = isValid();
     mIs3D = is3D();
     mUuid = QUuid::createUuid().toString();
     mUuid = mUuid.right(mUuid.length() - 1);
@@ -46,7 +68,7 @@ void GeoCoordinate::fillFromMap(const QVariantMap& geoCoordinateMap)
             dValue = geoCoordinateMap.value(latitudeKey).toDouble(&ok);
             if (ok) {
                 mLatitude = dValue;
-                mWrappedGeoCoordinate->setLatitude(dValue);
+                mHasLatitude = true;
             }
 
         }
@@ -57,7 +79,7 @@ void GeoCoordinate::fillFromMap(const QVariantMap& geoCoordinateMap)
             dValue = geoCoordinateMap.value(longitudeKey).toDouble(&ok);
             if (ok) {
                 mLongitude = dValue;
-                mWrappedGeoCoordinate->setLongitude(dValue);
+                mHasLongitude = true;
             }
 
         }
@@ -68,7 +90,7 @@ void GeoCoordinate::fillFromMap(const QVariantMap& geoCoordinateMap)
             dValue = geoCoordinateMap.value(altitudeKey).toDouble(&ok);
             if (ok) {
                 mAltitude = dValue;
-                mWrappedGeoCoordinate->setAltitude(dValue);
+                mHasAltitude = true;
             }
         }
     }
@@ -86,21 +108,22 @@ void GeoCoordinate::fillFromCacheMap(const QVariantMap& geoCoordinateMap)
     fillFromMap(geoCoordinateMap);
 }
 
-// SLOT
-void GeoCoordinate::onCoordinateReceived(QGeoCoordinate* coordinate)
+/*
+ * per ex. a position received from location services
+ * see GeoConversion::fillGeoCoordinate()
+ */
+void GeoCoordinate::updateCoordinate(const double& latitude, const double& longitude, const double& altitude)
 {
-    if (coordinate && coordinate->isValid()) {
-        if (coordinate != mWrappedGeoCoordinate) {
-            mWrappedGeoCoordinate = coordinate;
-            mLatitude = coordinate->latitude();
-            mLongitude = coordinate->longitude();
-            if (coordinate->type() == QGeoCoordinate::Coordinate3D) {
-                mAltitude = coordinate->altitude();
-            }
-            emit coordinateChanged(this);
-            updateProperties();
-        }
+    setLatitude(latitude);
+    setLongitude(longitude);
+    if (qIsNaN(altitude)) {
+        mHasAltitude = false;
+        mAltitude = 0.0;
+    } else {
+        setAltitude(altitude);
     }
+    emit coordinateChanged(this);
+    updateProperties();
 }
 
 /*
@@ -110,16 +133,27 @@ void GeoCoordinate::onCoordinateReceived(QGeoCoordinate* coordinate)
  */
 QVariantMap GeoCoordinate::toMap()
 {
-    QVariantMap geoCoordinateMap;
-    if (mWrappedGeoCoordinate->isValid()) {
-        geoCoordinateMap.insert(uuidKey, mUuid);
-        geoCoordinateMap.insert(latitudeKey, mLatitude);
-        geoCoordinateMap.insert(longitudeKey, mLongitude);
-        if (mWrappedGeoCoordinate->type() == QGeoCoordinate::Coordinate3D) {
-            geoCoordinateMap.insert(altitudeKey, mAltitude);
+    VariantMapWriter writer;
+    writer.beginObject();
+    writeTo(&writer);
+    writer.endObject();
+    return writer.map();
+}
+
+/*
+ * writes all properties into the current object of writer
+ * nothing is written for an invalid coordinate
+ */
+void GeoCoordinate::writeTo(DataWriter* writer)
+{
+    if (isValid()) {
+        writer->writeString(uuidKey, mUuid);
+        writer->writeDouble(latitudeKey, mLatitude);
+        writer->writeDouble(longitudeKey, mLongitude);
+        if (is3D()) {
+            writer->writeDouble(altitudeKey, mAltitude);
         }
     }
-    return geoCoordinateMap;
 }
 
 QString GeoCoordinate::uuid() const
@@ -140,9 +174,9 @@ double GeoCoordinate::latitude() const
 }
 void GeoCoordinate::setLatitude(double latitude)
 {
-    if (latitude != mLatitude) {
+    if (latitude != mLatitude || !mHasLatitude) {
         mLatitude = latitude;
-        mWrappedGeoCoordinate->setLatitude(mLatitude);
+        mHasLatitude = true;
         emit latitudeChanged(latitude);
         updateProperties();
     }
@@ -154,9 +188,9 @@ double GeoCoordinate::longitude() const
 }
 void GeoCoordinate::setLongitude(double longitude)
 {
-    if (longitude != mLongitude) {
+    if (longitude != mLongitude || !mHasLongitude) {
         mLongitude = longitude;
-        mWrappedGeoCoordinate->setLongitude(mLongitude);
+        mHasLongitude = true;
         emit longitudeChanged(longitude);
         updateProperties();
     }
@@ -168,9 +202,9 @@ double GeoCoordinate::altitude() const
 }
 void GeoCoordinate::setAltitude(double altitude)
 {
-    if (altitude != mAltitude) {
+    if (altitude != mAltitude || !mHasAltitude) {
         mAltitude = altitude;
-        mWrappedGeoCoordinate->setAltitude(mAltitude);
+        mHasAltitude = true;
         emit altitudeChanged(altitude);
         updateProperties();
     }
@@ -178,31 +212,41 @@ void GeoCoordinate::setAltitude(double altitude)
 
 bool GeoCoordinate::is3D() const
 {
-    return mWrappedGeoCoordinate->type() == QGeoCoordinate::Coordinate3D;
+    return isValid() && mHasAltitude;
 }
 
 bool GeoCoordinate::isValid() const
 {
-    return mWrappedGeoCoordinate->isValid();
+    return mHasLatitude && mHasLongitude && mLatitude >= -90.0 && mLatitude <= 90.0 && mLongitude >= -180.0
+            && mLongitude <= 180.0;
 }
 
+// as QGeoCoordinate::toString(): empty if not valid
 QString GeoCoordinate::asText() const
 {
-    return mWrappedGeoCoordinate->toString();
+    if (!isValid()) {
+        return QString();
+    }
+    QString latitudeText = degreesMinutesSeconds(mLatitude, "N", "S");
+    QString longitudeText = degreesMinutesSeconds(mLongitude, "E", "W");
+    if (is3D()) {
+        return QString("%1, %2, %3m").arg(latitudeText, longitudeText, QString::number(mAltitude));
+    }
+    return QString("%1, %2").arg(latitudeText, longitudeText);
 }
 
 void GeoCoordinate::updateProperties()
 {
-    if (mWrappedGeoCoordinate->toString() != mAsText) {
-        mAsText = mWrappedGeoCoordinate->toString();
+    if (asText() != mAsText) {
+        mAsText = asText();
         emit asTextChanged(mAsText);
     }
     if (is3D() != mIs3D) {
         mIs3D = is3D();
         emit is3DChanged(mIs3D);
     }
-    if (mWrappedGeoCoordinate->isValid() != mIsValid) {
-        mIsValid = mWrappedGeoCoordinate->isValid();
+    if (isValid() != mIsValid) {
+        mIsValid = isValid();
         emit isValidChanged(mIsValid);
     }
 }
@@ -210,23 +254,38 @@ void GeoCoordinate::updateProperties()
 /**
  * Returns the distance (in meters) from this coordinate to the coordinate specified by other.
  * Altitude is not used in the calculation.
- *
+ * haversine on a sphere with the mean earth radius - as QGeoCoordinate::distanceTo()
+ * 0 if one of the coordinates is not valid
  */
 qreal GeoCoordinate::distanceTo(GeoCoordinate* otherCoordinate)
 {
-    return mWrappedGeoCoordinate->distanceTo(*otherCoordinate->wrappedCoordinate());
+    if (!otherCoordinate || !isValid() || !otherCoordinate->isValid()) {
+        return 0;
+    }
+    double deltaLatitude = toRadians(otherCoordinate->latitude() - mLatitude);
+    double deltaLongitude = toRadians(otherCoordinate->longitude() - mLongitude);
+    double haversine = qSin(deltaLatitude / 2) * qSin(deltaLatitude / 2)
+            + qCos(toRadians(mLatitude)) * qCos(toRadians(otherCoordinate->latitude())) * qSin(deltaLongitude / 2)
+                    * qSin(deltaLongitude / 2);
+    return earthMeanRadiusMeters * 2 * qAtan2(qSqrt(haversine), qSqrt(1 - haversine));
 }
 
-QGeoCoordinate* GeoCoordinate::wrappedCoordinate()
+void GeoCoordinate::clear()
 {
-    return mWrappedGeoCoordinate;
+    mLatitude = 0.0;
+    mLongitude = 0.0;
+    mAltitude = 0.0;
+    mHasLatitude = false;
+    mHasLongitude = false;
+    mHasAltitude = false;
+    updateProperties();
 }
 
-void GeoCoordinate::clear()
+// estimated memory of this GeoCoordinate
+void GeoCoordinate::addMemoryUsage(MemoryUsage* usage) const
 {
-    mWrappedGeoCoordinate = 0;
-    mWrappedGeoCoordinate = new QGeoCoordinate();
-    updateProperties();
+    usage->addObject(MemoryUsage::GEO_COORDINATE, MemoryUsage::objectBytes(sizeof(GeoCoordinate)),
+            MemoryUsage::stringBytes(mUuid) + MemoryUsage::stringBytes(mAsText));
 }
 
 GeoCoordinate::~GeoCoordinate()
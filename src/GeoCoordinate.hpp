@@ -3,10 +3,19 @@
 
 #include <QObject>
 #include <qvariant.h>
-#include <QtLocationSubset/QGeoCoordinate>
-
-using namespace QtMobilitySubset;
-
+#include "DataWriter.hpp"
+
+class MemoryUsage;
+
+/*
+ * coordinate of a DataObject (per ex. Customer) as QObject for QML
+ *
+ * plain Qt - same rules as QGeoCoordinate:
+ * valid if latitude (-90 .. 90) and longitude (-180 .. 180) are set,
+ * 3D if also the altitude is set, asText as QGeoCoordinate::toString()
+ * conversion from / to QGeoCoordinate of QtLocationSubset
+ * is in the Cascades adapter: ../GeoConversion.hpp
+ */
 class GeoCoordinate: public QObject
 {
     Q_OBJECT
@@ -29,6 +38,8 @@ public:
 
     Q_INVOKABLE
     QVariantMap toMap();
+    void writeTo(DataWriter* writer);
+    void addMemoryUsage(MemoryUsage* usage) const;
 
     QString uuid() const;
     void setUuid(QString uuid);
@@ -49,7 +60,8 @@ public:
     Q_INVOKABLE
     qreal distanceTo(GeoCoordinate* otherCoordinate);
 
-    QGeoCoordinate* wrappedCoordinate();
+    // sets all values and emits coordinateChanged() - altitude NaN: 2D
+    void updateCoordinate(const double& latitude, const double& longitude, const double& altitude);
 
     virtual ~GeoCoordinate();
 
@@ -64,20 +76,17 @@ public:
     QString asTextChanged(QString asText);
     void coordinateChanged(GeoCoordinate* coordinate);
 
-public slots:
-
-    void onCoordinateReceived(QGeoCoordinate* coordinate);
-
 private:
 
-    // wrapped
-    QGeoCoordinate* mWrappedGeoCoordinate;
-
     // persisted
     QString mUuid;
     double mLatitude;
     double mLongitude;
     double mAltitude;
+    // values set - a new or cleared coordinate is invalid
+    bool mHasLatitude;
+    bool mHasLongitude;
+    bool mHasAltitude;
 
     bool mIs3D;
     bool mIsValid;
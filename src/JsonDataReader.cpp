@@ -0,0 +1,366 @@
+#include "JsonDataReader.hpp"
+
+#include <QStringList>
+#include <limits.h>
+
+JsonDataReader::JsonDataReader(QIODevice* device, const int& bufferSize) :
+		DataReader(device, bufferSize), mInsideArray(false), mFinished(false), mIsFirst(true)
+{
+}
+
+bool JsonDataReader::readNext(QVariantMap& map)
+{
+	map.clear();
+	if (mFinished || mError) {
+		return false;
+	}
+	if (!mInsideArray) {
+		// empty file: no data
+		if (!skipWhitespace()) {
+			mFinished = true;
+			return false;
+		}
+		if (!expect('[')) {
+			return false;
+		}
+		mInsideArray = true;
+	}
+	if (!skipWhitespace()) {
+		setError("unexpected end of data: missing ]");
+		return false;
+	}
+	if (peekChar() == ']') {
+		getChar();
+		mFinished = true;
+		return false;
+	}
+	if (!mIsFirst) {
+		if (!expect(',') || !skipWhitespace()) {
+			return false;
+		}
+	}
+	mIsFirst = false;
+	if (peekChar() != '{') {
+		setError("top-level array must contain objects");
+		return false;
+	}
+	getChar();
+	return parseObject(map);
+}
+
+// false at end of data
+bool JsonDataReader::skipWhitespace()
+{
+	while (!atEnd()) {
+		char c = peekChar();
+		if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+			return true;
+		}
+		getChar();
+	}
+	return false;
+}
+
+bool JsonDataReader::expect(const char& c)
+{
+	if (!skipWhitespace() || getChar() != c) {
+		setError(QString("expected '%1'").arg(c));
+		return false;
+	}
+	return true;
+}
+
+bool JsonDataReader::parseValue(QVariant& value)
+{
+	if (!skipWhitespace()) {
+		setError("unexpected end of data: missing value");
+		return false;
+	}
+	char c = peekChar();
+	switch (c) {
+	case '{': {
+		getChar();
+		QVariantMap map;
+		if (!parseObject(map)) {
+			return false;
+		}
+		value = map;
+		return true;
+	}
+	case '[': {
+		getChar();
+		QVariantList list;
+		if (!parseArray(list)) {
+			return false;
+		}
+		value = list;
+		return true;
+	}
+	case '"': {
+		getChar();
+		QString string;
+		if (!parseString(string)) {
+			return false;
+		}
+		value = string;
+		return true;
+	}
+	case 't':
+		value = true;
+		return parseLiteral("true");
+	case 'f':
+		value = false;
+		return parseLiteral("false");
+	case 'n':
+		value = QVariant();
+		return parseLiteral("null");
+	default:
+		return parseNumber(value);
+	}
+}
+
+// '{' already consumed
+bool JsonDataReader::parseObject(QVariantMap& map)
+{
+	if (!skipWhitespace()) {
+		setError("unexpected end of data: missing }");
+		return false;
+	}
+	if (peekChar() == '}') {
+		getChar();
+		return true;
+	}
+	while (true) {
+		if (!expect('"')) {
+			return false;
+		}
+		QString key;
+		if (!parseString(key) || !expect(':')) {
+			return false;
+		}
+		QVariant value;
+		if (!parseValue(value)) {
+			return false;
+		}
+		map.insert(key, value);
+		if (!skipWhitespace()) {
+			setError("unexpected end of data: missing }");
+			return false;
+		}
+		char c = getChar();
+		if (c == '}') {
+			return true;
+		}
+		if (c != ',') {
+			setError("expected ',' or '}'");
+			return false;
+		}
+	}
+}
+
+// '[' already consumed
+bool JsonDataReader::parseArray(QVariantList& list)
+{
+	if (!skipWhitespace()) {
+		setError("unexpected end of data: missing ]");
+		return false;
+	}
+	if (peekChar() == ']') {
+		getChar();
+		return true;
+	}
+	while (true) {
+		QVariant value;
+		if (!parseValue(value)) {
+			return false;
+		}
+		list.append(value);
+		if (!skipWhitespace()) {
+			setError("unexpected end of data: missing ]");
+			return false;
+		}
+		char c = getChar();
+		if (c == ']') {
+			return true;
+		}
+		if (c != ',') {
+			setError("expected ',' or ']'");
+			return false;
+		}
+	}
+}
+
+/*
+ * opening '"' already consumed
+ * bytes are collected as UTF-8, \u escapes are encoded as UTF-8
+ */
+bool JsonDataReader::parseString(QString& value)
+{
+	mUtf8.clear();
+	bool ascii = true;
+	while (true) {
+		if (atEnd()) {
+			setError("unexpected end of data inside string");
+			return false;
+		}
+		char c = getChar();
+		if (c == '"') {
+			break;
+		}
+		if (c != '\\') {
+			if ((uchar) c >= 0x80) {
+				ascii = false;
+			}
+			mUtf8.append(c);
+			continue;
+		}
+		if (atEnd()) {
+			setError("unexpected end of data inside string");
+			return false;
+		}
+		c = getChar();
+		switch (c) {
+		case '"':
+		case '\\':
+		case '/':
+			mUtf8.append(c);
+			break;
+		case 'n':
+			mUtf8.append('\n');
+			break;
+		case 'r':
+			mUtf8.append('\r');
+			break;
+		case 't':
+			mUtf8.append('\t');
+			break;
+		case 'b':
+			mUtf8.append('\b');
+			break;
+		case 'f':
+			mUtf8.append('\f');
+			break;
+		case 'u': {
+			uint codePoint;
+			if (!parseHex4(codePoint)) {
+				return false;
+			}
+			// surrogate pair
+			if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+				uint low;
+				if (!parseLiteral("\\u") || !parseHex4(low)) {
+					return false;
+				}
+				codePoint = QChar::surrogateToUcs4(codePoint, low);
+			}
+			if (codePoint < 0x80) {
+				mUtf8.append((char) codePoint);
+			} else if (codePoint < 0x800) {
+				ascii = false;
+				mUtf8.append((char) (0xC0 | (codePoint >> 6)));
+				mUtf8.append((char) (0x80 | (codePoint & 0x3F)));
+			} else if (codePoint < 0x10000) {
+				ascii = false;
+				mUtf8.append((char) (0xE0 | (codePoint >> 12)));
+				mUtf8.append((char) (0x80 | ((codePoint >> 6) & 0x3F)));
+				mUtf8.append((char) (0x80 | (codePoint & 0x3F)));
+			} else {
+				ascii = false;
+				mUtf8.append((char) (0xF0 | (codePoint >> 18)));
+				mUtf8.append((char) (0x80 | ((codePoint >> 12) & 0x3F)));
+				mUtf8.append((char) (0x80 | ((codePoint >> 6) & 0x3F)));
+				mUtf8.append((char) (0x80 | (codePoint & 0x3F)));
+			}
+			break;
+		}
+		default:
+			setError("invalid escape in string");
+			return false;
+		}
+	}
+	value = ascii ? QString::fromLatin1(mUtf8.constData(), mUtf8.size()) : QString::fromUtf8(mUtf8.constData(), mUtf8.size());
+	return true;
+}
+
+/*
+ * integers as int (or qlonglong if too large)
+ * all other numbers as double
+ */
+bool JsonDataReader::parseNumber(QVariant& value)
+{
+	QByteArray number;
+	bool isDouble = false;
+	while (!atEnd()) {
+		char c = peekChar();
+		if ((c >= '0' && c <= '9') || c == '-' || c == '+') {
+			number.append(getChar());
+		} else if (c == '.' || c == 'e' || c == 'E') {
+			isDouble = true;
+			number.append(getChar());
+		} else {
+			break;
+		}
+	}
+	if (number.isEmpty()) {
+		setError("unexpected character");
+		return false;
+	}
+	bool ok = false;
+	if (!isDouble) {
+		qlonglong longValue = number.toLongLong(&ok);
+		if (ok) {
+			if (longValue >= INT_MIN && longValue <= INT_MAX) {
+				value = (int) longValue;
+			} else {
+				value = longValue;
+			}
+			return true;
+		}
+	}
+	double doubleValue = number.toDouble(&ok);
+	if (!ok) {
+		setError("invalid number");
+		return false;
+	}
+	value = doubleValue;
+	return true;
+}
+
+bool JsonDataReader::parseLiteral(const char* literal)
+{
+	for (const char* c = literal; *c; ++c) {
+		if (atEnd() || getChar() != *c) {
+			setError(QString("expected %1").arg(literal));
+			return false;
+		}
+	}
+	return true;
+}
+
+bool JsonDataReader::parseHex4(uint& codePoint)
+{
+	codePoint = 0;
+	for (int i = 0; i < 4; ++i) {
+		if (atEnd()) {
+			setError("unexpected end of data inside string");
+			return false;
+		}
+		char c = getChar();
+		codePoint <<= 4;
+		if (c >= '0' && c <= '9') {
+			codePoint |= c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			codePoint |= c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			codePoint |= c - 'A' + 10;
+		} else {
+			setError("invalid \\u escape");
+			return false;
+		}
+	}
+	return true;
+}
+
+JsonDataReader::~JsonDataReader()
+{
+}
@@ -0,0 +1,37 @@
+#ifndef JSONDATAREADER_HPP_
+#define JSONDATAREADER_HPP_
+
+#include "DataReader.hpp"
+
+/*
+ * incremental JSON parser
+ * the file is read in blocks, only one element
+ * of the top-level array is parsed at a time
+ */
+class JsonDataReader: public DataReader
+{
+public:
+	JsonDataReader(QIODevice* device, const int& bufferSize = 64 * 1024);
+	virtual ~JsonDataReader();
+
+	virtual bool readNext(QVariantMap& map);
+
+private:
+
+	bool skipWhitespace();
+	bool expect(const char& c);
+	bool parseValue(QVariant& value);
+	bool parseObject(QVariantMap& map);
+	bool parseArray(QVariantList& list);
+	bool parseString(QString& value);
+	bool parseNumber(QVariant& value);
+	bool parseLiteral(const char* literal);
+	bool parseHex4(uint& codePoint);
+
+	bool mInsideArray;
+	bool mFinished;
+	bool mIsFirst;
+	QByteArray mUtf8;
+};
+
+#endif /* JSONDATAREADER_HPP_ */
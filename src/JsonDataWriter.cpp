@@ -0,0 +1,206 @@
+#include "JsonDataWriter.hpp"
+#include "DateCodec.hpp"
+
+#include <QDebug>
+
+static const char hexDigits[] = "0123456789abcdef";
+
+JsonDataWriter::JsonDataWriter(QIODevice* device, const int& bufferSize) :
+		mDevice(device), mBufferSize(bufferSize), mError(false)
+{
+	mBuffer.reserve(mBufferSize + 1024);
+}
+
+void JsonDataWriter::beginObject(const QString& key)
+{
+	writeKey(key);
+	mBuffer.append('{');
+	mIsArray.append(false);
+	mIsFirst.append(true);
+}
+
+void JsonDataWriter::endObject()
+{
+	mBuffer.append('}');
+	mIsArray.pop_back();
+	mIsFirst.pop_back();
+	flushIfFull();
+}
+
+void JsonDataWriter::beginArray(const QString& key)
+{
+	writeKey(key);
+	mBuffer.append('[');
+	mIsArray.append(true);
+	mIsFirst.append(true);
+}
+
+void JsonDataWriter::endArray()
+{
+	mBuffer.append(']');
+	mIsArray.pop_back();
+	mIsFirst.pop_back();
+	flushIfFull();
+}
+
+void JsonDataWriter::writeInt(const QString& key, const int& value)
+{
+	writeKey(key);
+	mBuffer.append(QByteArray::number(value));
+}
+
+void JsonDataWriter::writeLongLong(const QString& key, const qint64& value)
+{
+	writeKey(key);
+	mBuffer.append(QByteArray::number(value));
+}
+
+void JsonDataWriter::writeBool(const QString& key, const bool& value)
+{
+	writeKey(key);
+	mBuffer.append(value ? "true" : "false");
+}
+
+void JsonDataWriter::writeDouble(const QString& key, const double& value)
+{
+	writeKey(key);
+	// NaN and Infinity are not valid JSON
+	if (value != value || value - value != 0) {
+		mBuffer.append("null");
+		return;
+	}
+	mBuffer.append(QByteArray::number(value, 'g', 15));
+}
+
+void JsonDataWriter::writeString(const QString& key, const QString& value)
+{
+	writeKey(key);
+	appendString(value);
+}
+
+void JsonDataWriter::writeDate(const QString& key, const QDate& value)
+{
+	writeKey(key);
+	if (!value.isValid()) {
+		mBuffer.append("null");
+		return;
+	}
+	mBuffer.append('"');
+	DateCodec::appendIsoDate(mBuffer, value);
+	mBuffer.append('"');
+}
+
+void JsonDataWriter::writeNull(const QString& key)
+{
+	writeKey(key);
+	mBuffer.append("null");
+}
+
+bool JsonDataWriter::flush()
+{
+	if (!mBuffer.isEmpty()) {
+		if (mDevice->write(mBuffer) != mBuffer.size()) {
+			qWarning() << "JsonDataWriter cannot write: " << mDevice->errorString();
+			mError = true;
+		}
+		mBuffer.clear();
+	}
+	return !mError;
+}
+
+bool JsonDataWriter::hasError() const
+{
+	return mError;
+}
+
+// separator and key - key is ignored inside arrays
+void JsonDataWriter::writeKey(const QString& key)
+{
+	if (mIsFirst.isEmpty()) {
+		return;
+	}
+	if (mIsFirst.last()) {
+		mIsFirst.last() = false;
+	} else {
+		mBuffer.append(',');
+	}
+	if (!mIsArray.last()) {
+		appendString(key);
+		mBuffer.append(':');
+	}
+}
+
+/*
+ * quoted and escaped string as UTF-8
+ * ASCII is appended directly, no QString::toUtf8() for each value
+ */
+void JsonDataWriter::appendString(const QString& value)
+{
+	mBuffer.append('"');
+	const QChar* data = value.constData();
+	const int size = value.size();
+	for (int i = 0; i < size; ++i) {
+		ushort c = data[i].unicode();
+		if (c < 0x80) {
+			switch (c) {
+			case '"':
+				mBuffer.append("\\\"");
+				break;
+			case '\\':
+				mBuffer.append("\\\\");
+				break;
+			case '\n':
+				mBuffer.append("\\n");
+				break;
+			case '\r':
+				mBuffer.append("\\r");
+				break;
+			case '\t':
+				mBuffer.append("\\t");
+				break;
+			case '\b':
+				mBuffer.append("\\b");
+				break;
+			case '\f':
+				mBuffer.append("\\f");
+				break;
+			default:
+				if (c < 0x20) {
+					mBuffer.append("\\u00");
+					mBuffer.append(hexDigits[c >> 4]);
+					mBuffer.append(hexDigits[c & 0xF]);
+				} else {
+					mBuffer.append((char) c);
+				}
+				break;
+			}
+		} else if (c < 0x800) {
+			mBuffer.append((char) (0xC0 | (c >> 6)));
+			mBuffer.append((char) (0x80 | (c & 0x3F)));
+		} else if (data[i].isHighSurrogate() && i + 1 < size && data[i + 1].isLowSurrogate()) {
+			uint codePoint = QChar::surrogateToUcs4(c, data[i + 1].unicode());
+			++i;
+			mBuffer.append((char) (0xF0 | (codePoint >> 18)));
+			mBuffer.append((char) (0x80 | ((codePoint >> 12) & 0x3F)));
+			mBuffer.append((char) (0x80 | ((codePoint >> 6) & 0x3F)));
+			mBuffer.append((char) (0x80 | (codePoint & 0x3F)));
+		} else {
+			mBuffer.append((char) (0xE0 | (c >> 12)));
+			mBuffer.append((char) (0x80 | ((c >> 6) & 0x3F)));
+			mBuffer.append((char) (0x80 | (c & 0x3F)));
+		}
+	}
+	mBuffer.append('"');
+}
+
+void JsonDataWriter::flushIfFull()
+{
+	if (mBuffer.size() >= mBufferSize) {
+		flush();
+	}
+}
+
+JsonDataWriter::~JsonDataWriter()
+{
+	flush();
+}
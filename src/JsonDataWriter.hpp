@@ -0,0 +1,54 @@
+#ifndef JSONDATAWRITER_HPP_
+#define JSONDATAWRITER_HPP_
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QVector>
+
+#include "DataWriter.hpp"
+
+/*
+ * DataWriter writing compact JSON (UTF-8) to a QIODevice
+ * output is buffered and written in blocks of bufferSize bytes
+ * call flush() at the end
+ */
+class JsonDataWriter: public DataWriter
+{
+public:
+	JsonDataWriter(QIODevice* device, const int& bufferSize = 64 * 1024);
+	virtual ~JsonDataWriter();
+
+	virtual void beginObject(const QString& key = QString());
+	virtual void endObject();
+	virtual void beginArray(const QString& key = QString());
+	virtual void endArray();
+
+	virtual void writeInt(const QString& key, const int& value);
+	virtual void writeLongLong(const QString& key, const qint64& value);
+	virtual void writeBool(const QString& key, const bool& value);
+	virtual void writeDouble(const QString& key, const double& value);
+	virtual void writeString(const QString& key, const QString& value);
+	virtual void writeDate(const QString& key, const QDate& value);
+	virtual void writeNull(const QString& key);
+
+	virtual bool flush();
+
+	bool hasError() const;
+
+private:
+
+	void writeKey(const QString& key);
+	void appendString(const QString& value);
+	void flushIfFull();
+
+	QIODevice* mDevice;
+	int mBufferSize;
+	QByteArray mBuffer;
+	// true for arrays, false for objects
+	QVector<bool> mIsArray;
+	// no value written yet into the current container
+	QVector<bool> mIsFirst;
+	bool mError;
+};
+
+#endif /* JSONDATAWRITER_HPP_ */
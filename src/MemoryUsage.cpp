@@ -0,0 +1,241 @@
+#include "MemoryUsage.hpp"
+#include "StringPool.hpp"
+#include "DataWriter.hpp"
+
+// same order as MemoryUsage::Type
+static const char* const typeNames[MemoryUsage::TYPE_COUNT] = {
+		"Order", "Item", "SubItem", "Info", "Customer", "GeoCoordinate", "GeoAddress", "Topic", "Department", "Tag",
+		"Xtras" };
+
+// malloc header and rounding
+static const int allocationOverhead = 2 * sizeof(void*);
+// QObjectPrivate behind d_ptr (Qt 4.8), allocated with each QObject
+static const int objectPrivateBytes = 14 * sizeof(void*);
+// header of QString / QVector / QList data
+static const int stringHeaderBytes = 24;
+static const int containerHeaderBytes = 16;
+
+MemoryUsage::MemoryUsage()
+{
+	for (int i = 0; i < TYPE_COUNT; ++i) {
+		mTypes[i].count = 0;
+		mTypes[i].objectBytes = 0;
+		mTypes[i].stringBytes = 0;
+		mTypes[i].listBytes = 0;
+		mTypes[i].pendingBytes = 0;
+	}
+}
+
+void MemoryUsage::addObject(const Type& type, const qint64& objectBytes, const qint64& stringBytes,
+		const qint64& listBytes, const qint64& pendingBytes)
+{
+	TypeUsage& usage = mTypes[type];
+	usage.count++;
+	usage.objectBytes += objectBytes;
+	usage.stringBytes += stringBytes;
+	usage.listBytes += listBytes;
+	usage.pendingBytes += pendingBytes;
+}
+
+void MemoryUsage::addCache(const QString& name, const qint64& bytes, const int& entries)
+{
+	CacheUsage& usage = mCaches[name];
+	usage.bytes += bytes;
+	usage.entries += entries;
+}
+
+qint64 MemoryUsage::typeBytes(const Type& type) const
+{
+	const TypeUsage& usage = mTypes[type];
+	return usage.objectBytes + usage.stringBytes + usage.listBytes + usage.pendingBytes;
+}
+
+qint64 MemoryUsage::totalBytes() const
+{
+	qint64 bytes = 0;
+	for (int i = 0; i < TYPE_COUNT; ++i) {
+		bytes += typeBytes((Type) i);
+	}
+	QMap<QString, CacheUsage>::const_iterator it;
+	for (it = mCaches.constBegin(); it != mCaches.constEnd(); ++it) {
+		bytes += it.value().bytes;
+	}
+	return bytes;
+}
+
+/*
+ * { "types": { "Order": { "count", "objectBytes", "stringBytes", "listBytes", "pendingBytes", "totalBytes" }, ... },
+ *   "caches": { "allOrder": { "entries", "bytes" }, ... },
+ *   "typesBytes", "cachesBytes", "totalBytes" }
+ */
+QVariantMap MemoryUsage::toMap() const
+{
+	QVariantMap typesMap;
+	qint64 typesBytes = 0;
+	for (int i = 0; i < TYPE_COUNT; ++i) {
+		const TypeUsage& usage = mTypes[i];
+		if (usage.count == 0) {
+			continue;
+		}
+		QVariantMap typeMap;
+		typeMap.insert("count", usage.count);
+		typeMap.insert("objectBytes", usage.objectBytes);
+		typeMap.insert("stringBytes", usage.stringBytes);
+		typeMap.insert("listBytes", usage.listBytes);
+		typeMap.insert("pendingBytes", usage.pendingBytes);
+		typeMap.insert("totalBytes", typeBytes((Type) i));
+		typesMap.insert(typeNames[i], typeMap);
+		typesBytes += typeBytes((Type) i);
+	}
+	QVariantMap cachesMap;
+	qint64 cachesBytes = 0;
+	QMap<QString, CacheUsage>::const_iterator it;
+	for (it = mCaches.constBegin(); it != mCaches.constEnd(); ++it) {
+		QVariantMap cacheMap;
+		cacheMap.insert("entries", it.value().entries);
+		cacheMap.insert("bytes", it.value().bytes);
+		cachesMap.insert(it.key(), cacheMap);
+		cachesBytes += it.value().bytes;
+	}
+	QVariantMap usageMap;
+	usageMap.insert("types", typesMap);
+	usageMap.insert("caches", cachesMap);
+	usageMap.insert("typesBytes", typesBytes);
+	usageMap.insert("cachesBytes", cachesBytes);
+	usageMap.insert("totalBytes", typesBytes + cachesBytes);
+	return usageMap;
+}
+
+QString MemoryUsage::typeName(const Type& type)
+{
+	return QString::fromLatin1(typeNames[type]);
+}
+
+qint64 MemoryUsage::objectBytes(const size_t& size)
+{
+	return size + objectPrivateBytes + 2 * allocationOverhead;
+}
+
+qint64 MemoryUsage::pooledObjectBytes(const size_t& size)
+{
+	return size + objectPrivateBytes + allocationOverhead;
+}
+
+/*
+ * 0 for empty strings (shared_null) and values of the shared StringPool:
+ * they are counted once by the cache "stringPool"
+ */
+qint64 MemoryUsage::stringBytes(const QString& value)
+{
+	if (value.isEmpty()) {
+		return 0;
+	}
+	StringPool* stringPool = StringPool::shared();
+	if (stringPool && stringPool->contains(value)) {
+		return 0;
+	}
+	return stringDataBytes(value);
+}
+
+qint64 MemoryUsage::stringDataBytes(const QString& value)
+{
+	if (value.isEmpty()) {
+		return 0;
+	}
+	return stringHeaderBytes + (value.capacity() + 1) * sizeof(QChar) + allocationOverhead;
+}
+
+qint64 MemoryUsage::stringListBytes(const QStringList& values)
+{
+	if (values.isEmpty()) {
+		return 0;
+	}
+	qint64 bytes = listBytes(values.size());
+	for (int i = 0; i < values.size(); ++i) {
+		bytes += stringBytes(values.at(i));
+	}
+	return bytes;
+}
+
+// QList of pointers or other small movable types
+qint64 MemoryUsage::listBytes(const int& size)
+{
+	if (size == 0) {
+		return 0;
+	}
+	return containerHeaderBytes + size * sizeof(void*) + allocationOverhead;
+}
+
+qint64 MemoryUsage::vectorBytes(const int& capacity, const size_t& valueSize)
+{
+	if (capacity == 0) {
+		return 0;
+	}
+	return containerHeaderBytes + capacity * valueSize + allocationOverhead;
+}
+
+// one node per entry, buckets about one pointer per entry
+qint64 MemoryUsage::hashBytes(const int& size, const size_t& keyValueSize)
+{
+	if (size == 0) {
+		return 0;
+	}
+	qint64 nodeBytes = sizeof(void*) + sizeof(uint) + keyValueSize + allocationOverhead;
+	return containerHeaderBytes + size * (nodeBytes + sizeof(void*));
+}
+
+/*
+ * a value kept as read from cache - per ex. positions of an Order not materialized yet
+ * only the heap behind the QVariant, not the QVariant itself
+ */
+qint64 MemoryUsage::variantBytes(const QVariant& value)
+{
+	switch (value.type()) {
+	case QVariant::Map: {
+		QVariantMap map = value.toMap();
+		qint64 nodeBytes = 3 * sizeof(void*) + sizeof(QString) + sizeof(QVariant) + allocationOverhead;
+		qint64 bytes = containerHeaderBytes + map.size() * nodeBytes;
+		QVariantMap::const_iterator it;
+		for (it = map.constBegin(); it != map.constEnd(); ++it) {
+			bytes += stringBytes(it.key()) + variantBytes(it.value());
+		}
+		return bytes + allocationOverhead;
+	}
+	case QVariant::List:
+		return variantListBytes(value.toList()) + allocationOverhead;
+	case QVariant::StringList:
+		return stringListBytes(value.toStringList()) + allocationOverhead;
+	case QVariant::String:
+		return stringBytes(value.toString());
+	case QVariant::Invalid:
+	case QVariant::Int:
+	case QVariant::UInt:
+	case QVariant::LongLong:
+	case QVariant::ULongLong:
+	case QVariant::Bool:
+	case QVariant::Double:
+	case QVariant::Date:
+		// stored inside the QVariant
+		return 0;
+	default:
+		// packed int array read from binary cache
+		if (value.userType() == qMetaTypeId<QVector<int> >()) {
+			QVector<int> values = value.value<QVector<int> >();
+			return vectorBytes(values.capacity(), sizeof(int)) + allocationOverhead;
+		}
+		return stringBytes(value.toString()) + allocationOverhead;
+	}
+}
+
+// QList<QVariant> stores each QVariant in its own allocation
+qint64 MemoryUsage::variantListBytes(const QVariantList& values)
+{
+	if (values.isEmpty()) {
+		return 0;
+	}
+	qint64 bytes = listBytes(values.size());
+	for (int i = 0; i < values.size(); ++i) {
+		bytes += sizeof(QVariant) + allocationOverhead + variantBytes(values.at(i));
+	}
+	return bytes;
+}
@@ -0,0 +1,87 @@
+#ifndef MEMORYUSAGE_HPP_
+#define MEMORYUSAGE_HPP_
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantMap>
+#include <QMap>
+#include <QVector>
+
+/*
+ * estimated heap bytes of the data layer per DataObject type and per cache
+ *
+ * estimates - not measured by the allocator:
+ *   object: the DataObject incl. QObjectPrivate and the allocation header
+ *   strings: QString payload - values of the shared StringPool are counted once, as cache
+ *   lists: QList / QVector storage of children, references and values
+ *   pending: cached maps of children not materialized yet
+ * each DataObject adds itself and its contained DataObjects: addMemoryUsage()
+ * referenced DataObjects (per ex. Customer of an Order) are counted as their own type.
+ * DataManager::memoryStatistics() collects all of them
+ */
+class MemoryUsage
+{
+public:
+	enum Type {
+		ORDER,
+		ITEM,
+		SUB_ITEM,
+		INFO,
+		CUSTOMER,
+		GEO_COORDINATE,
+		GEO_ADDRESS,
+		TOPIC,
+		DEPARTMENT,
+		TAG,
+		XTRAS,
+		TYPE_COUNT
+	};
+
+	MemoryUsage();
+
+	void addObject(const Type& type, const qint64& objectBytes, const qint64& stringBytes,
+			const qint64& listBytes = 0, const qint64& pendingBytes = 0);
+	void addCache(const QString& name, const qint64& bytes, const int& entries);
+
+	qint64 typeBytes(const Type& type) const;
+	qint64 totalBytes() const;
+	QVariantMap toMap() const;
+
+	static QString typeName(const Type& type);
+
+	// allocation of a QObject derived class
+	static qint64 objectBytes(const size_t& size);
+	// slot of a DataObjectPool - no allocation header
+	static qint64 pooledObjectBytes(const size_t& size);
+	static qint64 stringBytes(const QString& value);
+	// payload of the string, also if it is a value of the StringPool
+	static qint64 stringDataBytes(const QString& value);
+	static qint64 stringListBytes(const QStringList& values);
+	static qint64 listBytes(const int& size);
+	static qint64 vectorBytes(const int& capacity, const size_t& valueSize);
+	static qint64 hashBytes(const int& size, const size_t& keyValueSize);
+	static qint64 variantBytes(const QVariant& value);
+	static qint64 variantListBytes(const QVariantList& values);
+
+private:
+	struct TypeUsage
+	{
+		qint64 count;
+		qint64 objectBytes;
+		qint64 stringBytes;
+		qint64 listBytes;
+		qint64 pendingBytes;
+	};
+
+	struct CacheUsage
+	{
+		qint64 bytes;
+		int entries;
+	};
+
+	TypeUsage mTypes[TYPE_COUNT];
+	QMap<QString, CacheUsage> mCaches;
+};
+
+#endif /* MEMORYUSAGE_HPP_ */
@@ -0,0 +1,316 @@
+#include "OrderColumns.hpp"
+#include "AggregationKernels.hpp"
+#include "MemoryUsage.hpp"
+#include <QHash>
+#include "src-gen/Order.hpp"
+
+OrderColumns::OrderColumns()
+{
+}
+
+void OrderColumns::clear()
+{
+	for (int i = 0; i < mOrders.size(); ++i) {
+		mOrders.at(i)->setColumnRow(0, -1);
+	}
+	mOrders.clear();
+	mNr.clear();
+	mState.clear();
+	mOrderDate.clear();
+	mCustomerId.clear();
+	mDepId.clear();
+	mExpressOrder.clear();
+}
+
+void OrderColumns::rebuild(const QList<QObject*>& orderList)
+{
+	clear();
+	mOrders.reserve(orderList.size());
+	mNr.reserve(orderList.size());
+	mState.reserve(orderList.size());
+	mOrderDate.reserve(orderList.size());
+	mCustomerId.reserve(orderList.size());
+	mDepId.reserve(orderList.size());
+	mExpressOrder.reserve((orderList.size() + 31) / 32);
+	for (int i = 0; i < orderList.size(); ++i) {
+		append((Order*) orderList.at(i));
+	}
+}
+
+int OrderColumns::append(Order* order)
+{
+	int row = mOrders.size();
+	mOrders.append(order);
+	mNr.append(order->nr());
+	mState.append(order->state());
+	mOrderDate.append(julianDay(order->orderDate()));
+	mCustomerId.append(order->customerId());
+	mDepId.append(order->depId());
+	if ((row & 31) == 0) {
+		mExpressOrder.append(0);
+	}
+	setExpressOrder(row, order->expressOrder());
+	order->setColumnRow(this, row);
+	return row;
+}
+
+/*
+ * the last row moves into the removed one - as in DataManager::mAllOrder
+ */
+void OrderColumns::removeRow(const int& row)
+{
+	if (row < 0 || row >= mOrders.size()) {
+		return;
+	}
+	mOrders.at(row)->setColumnRow(0, -1);
+	int last = mOrders.size() - 1;
+	if (row != last) {
+		mOrders[row] = mOrders.at(last);
+		mNr[row] = mNr.at(last);
+		mState[row] = mState.at(last);
+		mOrderDate[row] = mOrderDate.at(last);
+		mCustomerId[row] = mCustomerId.at(last);
+		mDepId[row] = mDepId.at(last);
+		setExpressOrder(row, isExpressOrder(last));
+		mOrders.at(row)->setColumnRow(this, row);
+	}
+	mOrders.remove(last);
+	mNr.remove(last);
+	mState.remove(last);
+	mOrderDate.remove(last);
+	mCustomerId.remove(last);
+	mDepId.remove(last);
+	if ((last & 31) == 0) {
+		mExpressOrder.remove(mExpressOrder.size() - 1);
+	} else {
+		setExpressOrder(last, false);
+	}
+}
+
+void OrderColumns::update(const int& row, Order* order)
+{
+	setNr(row, order->nr());
+	setState(row, order->state());
+	setOrderDate(row, order->orderDate());
+	setExpressOrder(row, order->expressOrder());
+	setCustomerId(row, order->customerId());
+	setDepId(row, order->depId());
+}
+
+void OrderColumns::setNr(const int& row, const int& nr)
+{
+	mNr[row] = nr;
+}
+
+void OrderColumns::setState(const int& row, const int& state)
+{
+	mState[row] = state;
+}
+
+void OrderColumns::setOrderDate(const int& row, const QDate& orderDate)
+{
+	mOrderDate[row] = julianDay(orderDate);
+}
+
+void OrderColumns::setExpressOrder(const int& row, const bool& expressOrder)
+{
+	if (expressOrder) {
+		mExpressOrder[row >> 5] |= (1u << (row & 31));
+	} else {
+		mExpressOrder[row >> 5] &= ~(1u << (row & 31));
+	}
+}
+
+void OrderColumns::setCustomerId(const int& row, const int& customerId)
+{
+	mCustomerId[row] = customerId;
+}
+
+void OrderColumns::setDepId(const int& row, const int& depId)
+{
+	mDepId[row] = depId;
+}
+
+int OrderColumns::size() const
+{
+	return mOrders.size();
+}
+
+Order* OrderColumns::orderAt(const int& row) const
+{
+	return mOrders.at(row);
+}
+
+qint64 OrderColumns::memoryBytes() const
+{
+	return MemoryUsage::vectorBytes(mOrders.capacity(), sizeof(Order*))
+			+ MemoryUsage::vectorBytes(mNr.capacity(), sizeof(int))
+			+ MemoryUsage::vectorBytes(mState.capacity(), sizeof(int))
+			+ MemoryUsage::vectorBytes(mOrderDate.capacity(), sizeof(int))
+			+ MemoryUsage::vectorBytes(mCustomerId.capacity(), sizeof(int))
+			+ MemoryUsage::vectorBytes(mDepId.capacity(), sizeof(int))
+			+ MemoryUsage::vectorBytes(mExpressOrder.capacity(), sizeof(quint32));
+}
+
+const int* OrderColumns::nrColumn() const
+{
+	return mNr.constData();
+}
+
+const int* OrderColumns::stateColumn() const
+{
+	return mState.constData();
+}
+
+const int* OrderColumns::orderDateColumn() const
+{
+	return mOrderDate.constData();
+}
+
+const int* OrderColumns::customerIdColumn() const
+{
+	return mCustomerId.constData();
+}
+
+const int* OrderColumns::depIdColumn() const
+{
+	return mDepId.constData();
+}
+
+const quint32* OrderColumns::expressOrderColumn() const
+{
+	return mExpressOrder.constData();
+}
+
+int OrderColumns::countExpressOrders() const
+{
+	return AggregationKernels::countBits(mExpressOrder.constData(), mExpressOrder.size());
+}
+
+QVector<int> OrderColumns::stateCounts(const int& stateCount) const
+{
+	QVector<int> counts(stateCount, 0);
+	// NO_VALUE (-1) is out of range
+	AggregationKernels::countByValue(mState.constData(), mState.size(), 0, counts.data(), stateCount);
+	return counts;
+}
+
+QVector<int> OrderColumns::rowsByOrderDate(const int& fromJulianDay, const int& toJulianDay) const
+{
+	QVector<int> rows;
+	const int* orderDate = mOrderDate.constData();
+	int size = mOrderDate.size();
+	for (int i = 0; i < size; ++i) {
+		if (orderDate[i] >= fromJulianDay && orderDate[i] <= toJulianDay) {
+			rows.append(i);
+		}
+	}
+	return rows;
+}
+
+QVector<int> OrderColumns::rowsByState(const int& state) const
+{
+	QVector<int> rows;
+	const int* stateColumn = mState.constData();
+	int size = mState.size();
+	for (int i = 0; i < size; ++i) {
+		if (stateColumn[i] == state) {
+			rows.append(i);
+		}
+	}
+	return rows;
+}
+
+int OrderColumns::countByState(const int& state) const
+{
+	return AggregationKernels::countEqual(mState.constData(), mState.size(), state);
+}
+
+int OrderColumns::countByOrderDate(const int& fromJulianDay, const int& toJulianDay) const
+{
+	return AggregationKernels::countInRange(mOrderDate.constData(), mOrderDate.size(), fromJulianDay,
+			toJulianDay);
+}
+
+QVector<int> OrderColumns::stateCountsByDay(const int& fromJulianDay, const int& dayCount,
+		const int& stateCount) const
+{
+	if (dayCount <= 0 || stateCount <= 0) {
+		return QVector<int>();
+	}
+	QVector<int> counts(dayCount * stateCount, 0);
+	AggregationKernels::countByDayAndGroup(mOrderDate.constData(), mState.constData(), mState.size(),
+			fromJulianDay, dayCount, counts.data(), stateCount);
+	return counts;
+}
+
+QVector<int> OrderColumns::orderDateHistogram(const int& fromJulianDay, const int& bucketDays,
+		const int& bucketCount) const
+{
+	if (bucketDays <= 0 || bucketCount <= 0) {
+		return QVector<int>();
+	}
+	QVector<int> counts(bucketCount, 0);
+	AggregationKernels::histogram(mOrderDate.constData(), mOrderDate.size(), fromJulianDay, bucketDays,
+			counts.data(), bucketCount);
+	return counts;
+}
+
+QMap<int, int> OrderColumns::customerIdCounts() const
+{
+	return valueCounts(mCustomerId);
+}
+
+QMap<int, int> OrderColumns::depIdCounts() const
+{
+	return valueCounts(mDepId);
+}
+
+/*
+ * ids are mostly dense: count into an array over min .. max
+ * sparse ids (range much larger than the column) use a QHash
+ */
+QMap<int, int> OrderColumns::valueCounts(const QVector<int>& column)
+{
+	QMap<int, int> countMap;
+	int minValue;
+	int maxValue;
+	if (!AggregationKernels::minMax(column.constData(), column.size(), minValue, maxValue)) {
+		return countMap;
+	}
+	qint64 range = (qint64) maxValue - minValue + 1;
+	if (range <= 4096 || range <= (qint64) column.size() * 4) {
+		QVector<int> counts((int) range, 0);
+		AggregationKernels::countByValue(column.constData(), column.size(), minValue, counts.data(),
+				counts.size());
+		for (int i = 0; i < counts.size(); ++i) {
+			if (counts.at(i) > 0) {
+				countMap.insert(minValue + i, counts.at(i));
+			}
+		}
+		return countMap;
+	}
+	QHash<int, int> countHash;
+	const int* values = column.constData();
+	for (int i = 0; i < column.size(); ++i) {
+		countHash[values[i]]++;
+	}
+	QHash<int, int>::const_iterator it;
+	for (it = countHash.constBegin(); it != countHash.constEnd(); ++it) {
+		countMap.insert(it.key(), it.value());
+	}
+	return countMap;
+}
+
+// null or invalid dates: 0
+int OrderColumns::julianDay(const QDate& date)
+{
+	if (!date.isValid()) {
+		return 0;
+	}
+	return date.toJulianDay();
+}
+
+OrderColumns::~OrderColumns()
+{
+}
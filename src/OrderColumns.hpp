@@ -0,0 +1,100 @@
+#ifndef ORDERCOLUMNS_HPP_
+#define ORDERCOLUMNS_HPP_
+
+#include <QVector>
+#include <QList>
+#include <QDate>
+#include <QMap>
+
+class Order;
+class QObject;
+
+/*
+ * column arrays of the hot Order properties
+ *
+ * row i is the Order at position i of DataManager::mAllOrder.
+ * scans over state, orderDate, expressOrder ... run over
+ * contiguous ints instead of casting QObject* and calling getters.
+ *
+ * nr, state, customerId, depId: int
+ * orderDate: julian day (0: no date)
+ * expressOrder: one bit per row
+ *
+ * an attached Order knows its row and calls the set... methods
+ * from its setters and from fillFrom(), so the columns stay in sync.
+ * DataManager appends and removes rows together with mAllOrder.
+ */
+class OrderColumns
+{
+public:
+	OrderColumns();
+	virtual ~OrderColumns();
+
+	void clear();
+	void rebuild(const QList<QObject*>& orderList);
+	int append(Order* order);
+	// the last row moves into row - as in DataManager::mAllOrder
+	void removeRow(const int& row);
+	// all values of the row from the Order
+	void update(const int& row, Order* order);
+
+	void setNr(const int& row, const int& nr);
+	void setState(const int& row, const int& state);
+	void setOrderDate(const int& row, const QDate& orderDate);
+	void setExpressOrder(const int& row, const bool& expressOrder);
+	void setCustomerId(const int& row, const int& customerId);
+	void setDepId(const int& row, const int& depId);
+
+	int size() const;
+	Order* orderAt(const int& row) const;
+	// estimated heap bytes of all columns
+	qint64 memoryBytes() const;
+
+	inline bool isExpressOrder(const int& row) const
+	{
+		return (mExpressOrder.at(row >> 5) >> (row & 31)) & 1;
+	}
+
+	// contiguous columns - size() values
+	const int* nrColumn() const;
+	const int* stateColumn() const;
+	const int* orderDateColumn() const;
+	const int* customerIdColumn() const;
+	const int* depIdColumn() const;
+	// (size() + 31) / 32 words
+	const quint32* expressOrderColumn() const;
+
+	// aggregates
+	int countExpressOrders() const;
+	// counts[state] for states 0 .. stateCount-1
+	QVector<int> stateCounts(const int& stateCount) const;
+	// rows with orderDate from .. to (julian days, inclusive)
+	QVector<int> rowsByOrderDate(const int& fromJulianDay, const int& toJulianDay) const;
+	QVector<int> rowsByState(const int& state) const;
+	int countByState(const int& state) const;
+	int countByOrderDate(const int& fromJulianDay, const int& toJulianDay) const;
+	// counts[day * stateCount + state] for dayCount days from fromJulianDay
+	QVector<int> stateCountsByDay(const int& fromJulianDay, const int& dayCount, const int& stateCount) const;
+	// counts[bucket] of bucketCount buckets of bucketDays days from fromJulianDay
+	QVector<int> orderDateHistogram(const int& fromJulianDay, const int& bucketDays,
+			const int& bucketCount) const;
+	// value -> number of rows
+	QMap<int, int> customerIdCounts() const;
+	QMap<int, int> depIdCounts() const;
+
+	static int julianDay(const QDate& date);
+
+private:
+
+	static QMap<int, int> valueCounts(const QVector<int>& column);
+
+	QVector<Order*> mOrders;
+	QVector<int> mNr;
+	QVector<int> mState;
+	QVector<int> mOrderDate;
+	QVector<int> mCustomerId;
+	QVector<int> mDepId;
+	QVector<quint32> mExpressOrder;
+};
+
+#endif /* ORDERCOLUMNS_HPP_ */
@@ -0,0 +1,243 @@
+#include "OrderEviction.hpp"
+#include "src-gen/Order.hpp"
+#include "src-gen/DataManager.hpp"
+#include "DataLog.hpp"
+#include "DataTracer.hpp"
+
+#include <QVector>
+#include <QPair>
+#include <QtAlgorithms>
+
+OrderEviction::OrderEviction() :
+		mDataManager(0), mAccessTick(0), mMemoryLimit(0), mKeepRecent(20), mEvicting(false), mMaterializedTotal(0), mReleasedToCache(
+				0), mReleasedToMemory(0)
+{
+}
+
+void OrderEviction::setDataManager(DataManager* dataManager)
+{
+	mDataManager = dataManager;
+}
+
+/*
+ * access ticks of the Order are kept
+ */
+void OrderEviction::clear()
+{
+	mMaterializedBytes.clear();
+	mMaterializedTotal = 0;
+}
+
+void OrderEviction::rebuild(const QList<QObject*>& orderList)
+{
+	clear();
+	for (int i = 0; i < orderList.size(); ++i) {
+		addOrder((Order*) orderList.at(i));
+	}
+}
+
+void OrderEviction::addOrder(Order* order)
+{
+	order->setEviction(this);
+	if (order->hasMaterializedPositions()) {
+		positionsMaterialized(order, false);
+	}
+}
+
+void OrderEviction::removeOrder(Order* order)
+{
+	order->setEviction(0);
+	mMaterializedTotal -= mMaterializedBytes.take(order);
+}
+
+void OrderEviction::touch(Order* order)
+{
+	order->setLastAccess(++mAccessTick);
+}
+
+/*
+ * estimated once - later changes of the positions are not tracked
+ * above the limit the eviction is scheduled: the Order may be
+ * materialized inside a QML callback still using Items of other Order
+ */
+void OrderEviction::positionsMaterialized(Order* order, const bool& reloaded)
+{
+	qint64 bytes = order->positionsMemoryBytes();
+	mMaterializedTotal -= mMaterializedBytes.take(order);
+	mMaterializedBytes.insert(order, bytes);
+	mMaterializedTotal += bytes;
+	if (reloaded && mDataManager) {
+		mDataManager->dataMetrics()->increment(DataMetrics::RELOADED_POSITIONS);
+	}
+	if (mMemoryLimit > 0 && mMaterializedTotal > mMemoryLimit && mDataManager) {
+		mDataManager->scheduleOrderEviction();
+	}
+}
+
+void OrderEviction::positionsCleared(Order* order)
+{
+	mMaterializedTotal -= mMaterializedBytes.take(order);
+}
+
+// doesn't touch the Order: resolving is no access
+void OrderEviction::restoreReferences(Order* order)
+{
+	if (!mDataManager) {
+		return;
+	}
+	mDataManager->dataMetrics()->increment(DataMetrics::RELOADED_REFERENCES);
+	mDataManager->resolveOrderReferences(order);
+}
+
+bool OrderEviction::reloadPositions(Order* order)
+{
+	return mDataManager && mDataManager->readOrderPositionsFromCache(order);
+}
+
+void OrderEviction::setMemoryLimit(const qint64& bytes)
+{
+	mMemoryLimit = qMax((qint64) 0, bytes);
+	if (mMemoryLimit > 0 && mMaterializedTotal > mMemoryLimit) {
+		evictPositions(mMemoryLimit);
+	}
+}
+
+qint64 OrderEviction::memoryLimit() const
+{
+	return mMemoryLimit;
+}
+
+void OrderEviction::setKeepRecent(const int& keepRecent)
+{
+	mKeepRecent = qMax(0, keepRecent);
+}
+
+int OrderEviction::keepRecent() const
+{
+	return mKeepRecent;
+}
+
+/*
+ * a quarter below the limit, so not every materialized Order runs an eviction
+ */
+int OrderEviction::evictAboveLimit()
+{
+	if (mMemoryLimit <= 0 || mMaterializedTotal <= mMemoryLimit) {
+		return 0;
+	}
+	return evictPositions(mMemoryLimit - mMemoryLimit / 4);
+}
+
+/*
+ * targetBytes below 0 are handled as 0: all cold Order are evicted
+ */
+int OrderEviction::evictPositions(const qint64& targetBytes)
+{
+	qint64 target = qMax((qint64) 0, targetBytes);
+	if (mMaterializedTotal <= target || mEvicting) {
+		return 0;
+	}
+	TraceSpan span("evictPositions", "memory");
+	ScopedMetricsTimer evictTimer(mDataManager ? mDataManager->dataMetrics() : 0, DataMetrics::EVICT_ORDER);
+	mEvicting = true;
+	QList<Order*> orderList = mMaterializedBytes.keys();
+	quint64 recent = recentAccess(orderList);
+	// least recently used first
+	QList<QPair<quint64, Order*> > candidates;
+	for (int i = 0; i < orderList.size(); ++i) {
+		Order* order = orderList.at(i);
+		if (order->lastAccess() < recent) {
+			candidates.append(qMakePair(order->lastAccess(), order));
+		}
+	}
+	qSort(candidates);
+	int evicted = 0;
+	for (int i = 0; i < candidates.size() && mMaterializedTotal > target; ++i) {
+		Order* order = candidates.at(i).second;
+		mMaterializedTotal -= mMaterializedBytes.take(order);
+		bool reloadable = mDataManager && mDataManager->isOrderCacheChunk(order->cacheChunk());
+		if (order->releasePositions(reloadable)) {
+			evicted++;
+			if (order->hasPositionsInCache()) {
+				mReleasedToCache++;
+			} else {
+				mReleasedToMemory++;
+			}
+		}
+	}
+	mEvicting = false;
+	if (mDataManager) {
+		mDataManager->dataMetrics()->increment(DataMetrics::EVICTED_POSITIONS, evicted);
+	}
+	DATA_LOG(DATA_LOG_CACHE) << "evicted positions of Order #" << evicted << " materialized bytes: "
+			<< mMaterializedTotal;
+	return evicted;
+}
+
+int OrderEviction::evictReferences(const QList<QObject*>& orderList)
+{
+	TraceSpan span("evictReferences", "memory");
+	ScopedMetricsTimer evictTimer(mDataManager ? mDataManager->dataMetrics() : 0, DataMetrics::EVICT_ORDER);
+	QList<Order*> orders;
+	orders.reserve(orderList.size());
+	for (int i = 0; i < orderList.size(); ++i) {
+		orders.append((Order*) orderList.at(i));
+	}
+	quint64 recent = recentAccess(orders);
+	int evicted = 0;
+	for (int i = 0; i < orders.size(); ++i) {
+		Order* order = orders.at(i);
+		if (order->lastAccess() < recent && order->releaseReferences()) {
+			evicted++;
+		}
+	}
+	if (mDataManager) {
+		mDataManager->dataMetrics()->increment(DataMetrics::EVICTED_REFERENCES, evicted);
+	}
+	DATA_LOG(DATA_LOG_CACHE) << "evicted references of Order #" << evicted;
+	return evicted;
+}
+
+qint64 OrderEviction::materializedBytes() const
+{
+	return mMaterializedTotal;
+}
+
+QVariantMap OrderEviction::statistics() const
+{
+	QVariantMap statisticsMap;
+	statisticsMap.insert("materializedOrders", mMaterializedBytes.size());
+	statisticsMap.insert("materializedBytes", mMaterializedTotal);
+	statisticsMap.insert("memoryLimit", mMemoryLimit);
+	statisticsMap.insert("keepRecent", mKeepRecent);
+	statisticsMap.insert("accessTick", mAccessTick);
+	statisticsMap.insert("releasedToCache", mReleasedToCache);
+	statisticsMap.insert("releasedToMemory", mReleasedToMemory);
+	return statisticsMap;
+}
+
+/*
+ * lastAccess() of the keepRecent-th most recently accessed Order of orderList
+ * Order never accessed (0) are always cold
+ */
+quint64 OrderEviction::recentAccess(const QList<Order*>& orderList) const
+{
+	QVector<quint64> accessTicks;
+	for (int i = 0; i < orderList.size(); ++i) {
+		if (orderList.at(i)->lastAccess() > 0) {
+			accessTicks.append(orderList.at(i)->lastAccess());
+		}
+	}
+	if (mKeepRecent == 0 || accessTicks.isEmpty()) {
+		return mAccessTick + 1;
+	}
+	if (accessTicks.size() <= mKeepRecent) {
+		return 1;
+	}
+	qSort(accessTicks.begin(), accessTicks.end(), qGreater<quint64>());
+	return accessTicks.at(mKeepRecent - 1);
+}
+
+OrderEviction::~OrderEviction()
+{
+}
@@ -0,0 +1,95 @@
+#ifndef ORDEREVICTION_HPP_
+#define ORDEREVICTION_HPP_
+
+#include <QHash>
+#include <QList>
+#include <QVariantMap>
+
+class Order;
+class DataManager;
+class QObject;
+
+/*
+ * LRU of Order by last access - cold Order give back memory
+ *
+ * an attached Order is touched if QML or the API access its positions,
+ * DataManager touches Order found by nr or barcode.
+ * saving, indexing and resolving don't touch.
+ *
+ * Order with materialized positions are tracked with their
+ * estimated bytes (see MemoryUsage.hpp). above the memory limit
+ * least recently used Order delete their Items (Order::releasePositions()):
+ * unchanged positions are read again from their chunk of the
+ * Order cache file, changed ones are kept as compact binary.
+ * the limit is checked from the event loop (DataManager::scheduleOrderEviction()),
+ * never inside the materializePositions() of another Order.
+ * on memory pressure also the resolved ...AsDataObject pointers
+ * of cold Order are reset (Order::releaseReferences()).
+ * both are restored lazily on next access:
+ * positions by materializing them again,
+ * references by DataManager::resolveOrderReferences().
+ *
+ * the keepRecent most recently accessed Order are never evicted.
+ * DataManager adds and removes Order together with mAllOrder,
+ * evictions and reloads are counted in DataMetrics.
+ */
+class OrderEviction
+{
+public:
+	OrderEviction();
+	virtual ~OrderEviction();
+
+	// resolves released references again and records metrics
+	void setDataManager(DataManager* dataManager);
+
+	void clear();
+	void rebuild(const QList<QObject*>& orderList);
+
+	void addOrder(Order* order);
+	void removeOrder(Order* order);
+
+	void touch(Order* order);
+	// called by an attached Order after materializing its positions
+	void positionsMaterialized(Order* order, const bool& reloaded);
+	// called by an attached Order after its positions were cleared or replaced
+	void positionsCleared(Order* order);
+	// called by an attached Order accessing released references
+	void restoreReferences(Order* order);
+	// called by an attached Order with positions released to the cache file
+	bool reloadPositions(Order* order);
+
+	// estimated bytes of materialized positions - 0: no limit
+	void setMemoryLimit(const qint64& bytes);
+	qint64 memoryLimit() const;
+	void setKeepRecent(const int& keepRecent);
+	int keepRecent() const;
+
+	// least recently used first until materialized bytes <= targetBytes
+	// returns number of Order with released positions
+	int evictPositions(const qint64& targetBytes);
+	// above the memory limit: a quarter below the limit - from the event loop
+	int evictAboveLimit();
+	// all cold Order of orderList - returns number of Order with released references
+	int evictReferences(const QList<QObject*>& orderList);
+
+	qint64 materializedBytes() const;
+	QVariantMap statistics() const;
+
+private:
+
+	// Order accessed at or after this tick are recent
+	quint64 recentAccess(const QList<Order*>& orderList) const;
+
+	DataManager* mDataManager;
+	quint64 mAccessTick;
+	qint64 mMemoryLimit;
+	int mKeepRecent;
+	bool mEvicting;
+	// Order with materialized positions -> estimated bytes of the positions
+	QHash<Order*, qint64> mMaterializedBytes;
+	qint64 mMaterializedTotal;
+	qlonglong mReleasedToCache;
+	qlonglong mReleasedToMemory;
+};
+
+#endif /* ORDEREVICTION_HPP_ */
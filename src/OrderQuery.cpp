@@ -0,0 +1,404 @@
+#include "OrderQuery.hpp"
+#include "src-gen/Order.hpp"
+#include "src-gen/Tag.hpp"
+#include "DateCodec.hpp"
+#include "OrderColumns.hpp"
+
+#include <QtAlgorithms>
+#include <QDebug>
+#include <limits.h>
+
+/*
+ * compares two Orders by all sort keys of a query
+ */
+class OrderLessThan
+{
+public:
+	OrderLessThan(const QList<OrderQuery::SortKey>& sortKeys) :
+			mSortKeys(sortKeys)
+	{
+	}
+
+	bool operator()(Order* left, Order* right) const
+	{
+		for (int i = 0; i < mSortKeys.size(); ++i) {
+			int result = compare(mSortKeys.at(i).field, left, right);
+			if (result != 0) {
+				return mSortKeys.at(i).ascending ? result < 0 : result > 0;
+			}
+		}
+		return false;
+	}
+
+private:
+
+	template<typename T>
+	static int compareValues(const T& left, const T& right)
+	{
+		if (left < right) {
+			return -1;
+		}
+		if (right < left) {
+			return 1;
+		}
+		return 0;
+	}
+
+	static int compare(const OrderQuery::SortField& field, Order* left, Order* right)
+	{
+		switch (field) {
+		case OrderQuery::SORT_NR:
+			return compareValues(left->nr(), right->nr());
+		case OrderQuery::SORT_EXPRESS_ORDER:
+			return compareValues(left->expressOrder(), right->expressOrder());
+		case OrderQuery::SORT_TITLE:
+			return left->title().compare(right->title());
+		case OrderQuery::SORT_ORDER_DATE:
+			// julian day: null dates first
+			return compareValues(left->orderDate().toJulianDay(), right->orderDate().toJulianDay());
+		case OrderQuery::SORT_STATE:
+			return compareValues(left->state(), right->state());
+		case OrderQuery::SORT_CUSTOMER_ID:
+			return compareValues(left->customerId(), right->customerId());
+		case OrderQuery::SORT_DEP_ID:
+			return compareValues(left->depId(), right->depId());
+		}
+		return 0;
+	}
+
+	QList<OrderQuery::SortKey> mSortKeys;
+};
+
+// dates from QML are Date (QDateTime) or String yyyy-MM-dd
+static QDate dateFromVariant(const QVariant& value)
+{
+	if (value.type() == QVariant::DateTime) {
+		return value.toDateTime().date();
+	}
+	return DateCodec::fromVariant(value);
+}
+
+OrderQuery::OrderQuery() :
+		mHasNr(false), mNr(-1), mHasExpressOrder(false), mExpressOrder(false), mHasCustomerId(false), mCustomerId(
+				-1), mDepId(-1), mDepSubtree(false), mOffset(0), mLimit(-1)
+{
+}
+
+OrderQuery::OrderQuery(const QVariantMap& queryMap) :
+		mHasNr(false), mNr(-1), mHasExpressOrder(false), mExpressOrder(false), mHasCustomerId(false), mCustomerId(
+				-1), mDepId(-1), mDepSubtree(false), mOffset(0), mLimit(-1)
+{
+	if (queryMap.contains("nr")) {
+		setNr(queryMap.value("nr").toInt());
+	}
+	if (queryMap.contains("expressOrder")) {
+		setExpressOrder(queryMap.value("expressOrder").toBool());
+	}
+	if (queryMap.contains("state")) {
+		mStates.append(queryMap.value("state").toInt());
+	}
+	if (queryMap.contains("states")) {
+		QVariantList stateList = queryMap.value("states").toList();
+		for (int i = 0; i < stateList.size(); ++i) {
+			mStates.append(stateList.at(i).toInt());
+		}
+	}
+	if (queryMap.contains("orderDateFrom")) {
+		setOrderDateFrom(dateFromVariant(queryMap.value("orderDateFrom")));
+	}
+	if (queryMap.contains("orderDateTo")) {
+		setOrderDateTo(dateFromVariant(queryMap.value("orderDateTo")));
+	}
+	if (queryMap.contains("customerId")) {
+		setCustomerId(queryMap.value("customerId").toInt());
+	}
+	if (queryMap.contains("depId")) {
+		setDepId(queryMap.value("depId").toInt(), queryMap.value("depSubtree").toBool());
+	}
+	if (queryMap.contains("tags")) {
+		QStringList tagKeys = queryMap.value("tags").toStringList();
+		QVector<int> tagHandles;
+		// unknown uuid: -1 - no Order has this handle, so nothing matches
+		for (int i = 0; i < tagKeys.size(); ++i) {
+			tagHandles.append(Tag::findHandleForUuid(tagKeys.at(i)));
+		}
+		setTagHandles(tagHandles);
+	}
+	if (queryMap.contains("domains")) {
+		setDomains(queryMap.value("domains").toStringList());
+	}
+	QStringList sortBy = queryMap.value("sortBy").toStringList();
+	for (int i = 0; i < sortBy.size(); ++i) {
+		QString name = sortBy.at(i);
+		bool ascending = !name.startsWith("-");
+		if (!ascending) {
+			name = name.mid(1);
+		}
+		SortField field;
+		if (sortFieldFromName(name, field)) {
+			addSortKey(field, ascending);
+		} else {
+			qWarning() << "OrderQuery: cannot sort by " << name;
+		}
+	}
+	if (queryMap.contains("offset")) {
+		setOffset(queryMap.value("offset").toInt());
+	}
+	if (queryMap.contains("limit")) {
+		setLimit(queryMap.value("limit").toInt());
+	}
+}
+
+bool OrderQuery::sortFieldFromName(const QString& name, SortField& field)
+{
+	if (name == "nr") {
+		field = SORT_NR;
+	} else if (name == "expressOrder") {
+		field = SORT_EXPRESS_ORDER;
+	} else if (name == "title") {
+		field = SORT_TITLE;
+	} else if (name == "orderDate") {
+		field = SORT_ORDER_DATE;
+	} else if (name == "state") {
+		field = SORT_STATE;
+	} else if (name == "customerId") {
+		field = SORT_CUSTOMER_ID;
+	} else if (name == "depId") {
+		field = SORT_DEP_ID;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+void OrderQuery::setNr(const int& nr)
+{
+	mHasNr = true;
+	mNr = nr;
+}
+
+void OrderQuery::setExpressOrder(const bool& expressOrder)
+{
+	mHasExpressOrder = true;
+	mExpressOrder = expressOrder;
+}
+
+void OrderQuery::setStates(const QList<int>& states)
+{
+	mStates = states;
+}
+
+void OrderQuery::setOrderDateFrom(const QDate& from)
+{
+	mOrderDateFrom = from;
+}
+
+void OrderQuery::setOrderDateTo(const QDate& to)
+{
+	mOrderDateTo = to;
+}
+
+void OrderQuery::setCustomerId(const int& customerId)
+{
+	mHasCustomerId = true;
+	mCustomerId = customerId;
+}
+
+/*
+ * includeSubDepartments: DataManager replaces the depIds
+ * by the ids of the subtree
+ */
+void OrderQuery::setDepId(const int& depId, const bool& includeSubDepartments)
+{
+	mDepId = depId;
+	mDepSubtree = includeSubDepartments;
+	mDepIds.clear();
+	mDepIds.insert(depId);
+}
+
+void OrderQuery::setDepIds(const QSet<int>& depIds)
+{
+	mDepIds = depIds;
+}
+
+void OrderQuery::setTagHandles(const QVector<int>& tagHandles)
+{
+	mTagHandles = tagHandles;
+}
+
+void OrderQuery::setDomains(const QStringList& domains)
+{
+	mDomains = domains;
+}
+
+void OrderQuery::addSortKey(const SortField& field, const bool& ascending)
+{
+	SortKey sortKey;
+	sortKey.field = field;
+	sortKey.ascending = ascending;
+	mSortKeys.append(sortKey);
+}
+
+void OrderQuery::setOffset(const int& offset)
+{
+	mOffset = qMax(0, offset);
+}
+
+void OrderQuery::setLimit(const int& limit)
+{
+	mLimit = limit;
+}
+
+bool OrderQuery::hasNr() const
+{
+	return mHasNr;
+}
+
+int OrderQuery::nr() const
+{
+	return mNr;
+}
+
+bool OrderQuery::hasDepSubtree() const
+{
+	return mDepSubtree && mDepId != -1;
+}
+
+int OrderQuery::depId() const
+{
+	return mDepId;
+}
+
+/*
+ * cheap predicates first
+ */
+bool OrderQuery::matches(Order* order) const
+{
+	if (!order) {
+		return false;
+	}
+	if (mHasNr && order->nr() != mNr) {
+		return false;
+	}
+	if (mHasExpressOrder && order->expressOrder() != mExpressOrder) {
+		return false;
+	}
+	if (!mStates.isEmpty() && !mStates.contains(order->state())) {
+		return false;
+	}
+	if (mHasCustomerId && order->customerId() != mCustomerId) {
+		return false;
+	}
+	if (!mDepIds.isEmpty() && !mDepIds.contains(order->depId())) {
+		return false;
+	}
+	if (mOrderDateFrom.isValid() || mOrderDateTo.isValid()) {
+		QDate orderDate = order->orderDate();
+		if (!orderDate.isValid()) {
+			return false;
+		}
+		if (mOrderDateFrom.isValid() && orderDate < mOrderDateFrom) {
+			return false;
+		}
+		if (mOrderDateTo.isValid() && orderDate > mOrderDateTo) {
+			return false;
+		}
+	}
+	if (!mTagHandles.isEmpty()) {
+		// resolved Tags can be changed - handles are only valid before
+		QVector<int> orderTagHandles;
+		if (order->areTagsKeysResolved()) {
+			QList<Tag*> tags = order->tags();
+			for (int i = 0; i < tags.size(); ++i) {
+				orderTagHandles.append(tags.at(i)->handle());
+			}
+		} else {
+			orderTagHandles = order->tagsHandles();
+		}
+		for (int i = 0; i < mTagHandles.size(); ++i) {
+			if (!orderTagHandles.contains(mTagHandles.at(i))) {
+				return false;
+			}
+		}
+	}
+	if (!mDomains.isEmpty()) {
+		QStringList orderDomains = order->domainsStringList();
+		bool found = false;
+		for (int i = 0; i < mDomains.size() && !found; ++i) {
+			found = orderDomains.contains(mDomains.at(i));
+		}
+		if (!found) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * one pass over the column arrays - no Order* is touched
+ */
+QVector<int> OrderQuery::selectRows(const OrderColumns& columns) const
+{
+	const int* state = columns.stateColumn();
+	const int* orderDate = columns.orderDateColumn();
+	const int* customerId = columns.customerIdColumn();
+	const int* depId = columns.depIdColumn();
+	// states 0..31 as bit mask, others are checked by matches()
+	quint32 stateMask = 0;
+	bool useStateMask = !mStates.isEmpty();
+	for (int i = 0; i < mStates.size(); ++i) {
+		if ((unsigned) mStates.at(i) < 32) {
+			stateMask |= (1u << mStates.at(i));
+		} else {
+			useStateMask = false;
+		}
+	}
+	bool useOrderDate = mOrderDateFrom.isValid() || mOrderDateTo.isValid();
+	// julian day 0: Order without date never matches a range
+	int fromDay = mOrderDateFrom.isValid() ? OrderColumns::julianDay(mOrderDateFrom) : 1;
+	int toDay = mOrderDateTo.isValid() ? OrderColumns::julianDay(mOrderDateTo) : INT_MAX;
+	bool singleDepId = mDepIds.size() == 1;
+	int firstDepId = singleDepId ? *mDepIds.constBegin() : -1;
+	QVector<int> rows;
+	int size = columns.size();
+	for (int i = 0; i < size; ++i) {
+		if (mHasExpressOrder && columns.isExpressOrder(i) != mExpressOrder) {
+			continue;
+		}
+		if (useStateMask && ((unsigned) state[i] >= 32 || !((stateMask >> state[i]) & 1))) {
+			continue;
+		}
+		if (mHasCustomerId && customerId[i] != mCustomerId) {
+			continue;
+		}
+		if (useOrderDate && (orderDate[i] < fromDay || orderDate[i] > toDay)) {
+			continue;
+		}
+		if (!mDepIds.isEmpty() && (singleDepId ? depId[i] != firstDepId : !mDepIds.contains(depId[i]))) {
+			continue;
+		}
+		rows.append(i);
+	}
+	return rows;
+}
+
+QList<Order*> OrderQuery::run(const QList<Order*>& candidates) const
+{
+	QList<Order*> result;
+	for (int i = 0; i < candidates.size(); ++i) {
+		if (matches(candidates.at(i))) {
+			result.append(candidates.at(i));
+		}
+	}
+	if (!mSortKeys.isEmpty()) {
+		qStableSort(result.begin(), result.end(), OrderLessThan(mSortKeys));
+	}
+	if (mOffset == 0 && (mLimit < 0 || mLimit >= result.size())) {
+		return result;
+	}
+	return result.mid(mOffset, mLimit);
+}
+
+OrderQuery::~OrderQuery()
+{
+}
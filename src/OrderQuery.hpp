@@ -0,0 +1,104 @@
+#ifndef ORDERQUERY_HPP_
+#define ORDERQUERY_HPP_
+
+#include <QList>
+#include <QSet>
+#include <QVector>
+#include <QStringList>
+#include <QDate>
+#include <QVariantMap>
+
+class Order;
+class OrderColumns;
+
+/*
+ * filter, sort and paging over the in-memory Orders
+ *
+ * all predicates set must match:
+ *   nr, expressOrder, one of states, orderDate from / to (inclusive),
+ *   customerId, one of depIds, all tags (as Tag handles), any of domains
+ * sort keys are applied in the order added, then offset and limit.
+ *
+ * DataManager runs the query: a nr predicate uses the nr index,
+ * a department subtree is expanded into depIds before,
+ * otherwise selectRows() scans the column arrays first.
+ *
+ * from QML the query is a map, per ex.
+ *   { "expressOrder": true, "states": [1], "depId": 7, "depSubtree": true,
+ *     "orderDateFrom": "2014-01-01", "orderDateTo": "2014-03-31",
+ *     "sortBy": ["orderDate", "-nr"], "offset": 0, "limit": 50 }
+ * keys: nr, expressOrder, state, states, orderDateFrom, orderDateTo,
+ * customerId, depId, depSubtree, tags (uuids), domains, sortBy, offset, limit
+ * a '-' in front of a sort key sorts descending
+ */
+class OrderQuery
+{
+public:
+
+	enum SortField
+	{
+		SORT_NR, SORT_EXPRESS_ORDER, SORT_TITLE, SORT_ORDER_DATE, SORT_STATE, SORT_CUSTOMER_ID, SORT_DEP_ID
+	};
+
+	struct SortKey
+	{
+		SortField field;
+		bool ascending;
+	};
+
+	OrderQuery();
+	explicit OrderQuery(const QVariantMap& queryMap);
+	virtual ~OrderQuery();
+
+	void setNr(const int& nr);
+	void setExpressOrder(const bool& expressOrder);
+	void setStates(const QList<int>& states);
+	void setOrderDateFrom(const QDate& from);
+	void setOrderDateTo(const QDate& to);
+	void setCustomerId(const int& customerId);
+	void setDepId(const int& depId, const bool& includeSubDepartments);
+	void setDepIds(const QSet<int>& depIds);
+	void setTagHandles(const QVector<int>& tagHandles);
+	void setDomains(const QStringList& domains);
+
+	void addSortKey(const SortField& field, const bool& ascending = true);
+	void setOffset(const int& offset);
+	// -1: no limit
+	void setLimit(const int& limit);
+
+	bool hasNr() const;
+	int nr() const;
+	bool hasDepSubtree() const;
+	int depId() const;
+
+	bool matches(Order* order) const;
+	// rows passing all predicates on columns (expressOrder, states,
+	// customerId, depIds, orderDate) - candidates for run()
+	QVector<int> selectRows(const OrderColumns& columns) const;
+	// filters, sorts and pages the candidates
+	QList<Order*> run(const QList<Order*>& candidates) const;
+
+private:
+
+	static bool sortFieldFromName(const QString& name, SortField& field);
+
+	bool mHasNr;
+	int mNr;
+	bool mHasExpressOrder;
+	bool mExpressOrder;
+	QList<int> mStates;
+	QDate mOrderDateFrom;
+	QDate mOrderDateTo;
+	bool mHasCustomerId;
+	int mCustomerId;
+	int mDepId;
+	bool mDepSubtree;
+	QSet<int> mDepIds;
+	QVector<int> mTagHandles;
+	QStringList mDomains;
+	QList<SortKey> mSortKeys;
+	int mOffset;
+	int mLimit;
+};
+
+#endif /* ORDERQUERY_HPP_ */
@@ -0,0 +1,153 @@
+#include "OrderReferenceIndex.hpp"
+#include "src-gen/Order.hpp"
+#include "MemoryUsage.hpp"
+
+OrderReferenceIndex::OrderReferenceIndex() :
+		mBuilt(false), mTargetsDeleted(0), mOrdersInvalidated(0), mReferencesInvalidated(0), mTargetsReplaced(
+				0), mReferencesReleased(0)
+{
+}
+
+/*
+ * the index is built again on next invalidation
+ * counters are kept
+ */
+void OrderReferenceIndex::clear()
+{
+	mOrdersByTarget.clear();
+	mBuilt = false;
+}
+
+void OrderReferenceIndex::rebuild(const QList<QObject*>& orderList)
+{
+	clear();
+	mBuilt = true;
+	for (int i = 0; i < orderList.size(); ++i) {
+		addOrder((Order*) orderList.at(i));
+	}
+}
+
+bool OrderReferenceIndex::isBuilt() const
+{
+	return mBuilt;
+}
+
+void OrderReferenceIndex::addOrder(Order* order)
+{
+	order->setReferenceIndex(this);
+	if (!mBuilt) {
+		return;
+	}
+	QList<QObject*> targets = order->referencedObjects();
+	for (int i = 0; i < targets.size(); ++i) {
+		addReference(targets.at(i), order);
+	}
+}
+
+void OrderReferenceIndex::removeOrder(Order* order)
+{
+	order->setReferenceIndex(0);
+	if (!mBuilt) {
+		return;
+	}
+	QList<QObject*> targets = order->referencedObjects();
+	for (int i = 0; i < targets.size(); ++i) {
+		removeReference(targets.at(i), order);
+	}
+}
+
+void OrderReferenceIndex::addReference(QObject* target, Order* order)
+{
+	if (mBuilt && target) {
+		mOrdersByTarget[target].insert(order);
+	}
+}
+
+void OrderReferenceIndex::removeReference(QObject* target, Order* order)
+{
+	if (!mBuilt || !target) {
+		return;
+	}
+	QHash<QObject*, QSet<Order*> >::iterator it = mOrdersByTarget.find(target);
+	if (it == mOrdersByTarget.end()) {
+		return;
+	}
+	it.value().remove(order);
+	if (it.value().isEmpty()) {
+		mOrdersByTarget.erase(it);
+	}
+}
+
+int OrderReferenceIndex::invalidateReferencesTo(QObject* target)
+{
+	if (!mBuilt || !target) {
+		return 0;
+	}
+	mTargetsDeleted++;
+	QSet<Order*> orders = mOrdersByTarget.take(target);
+	int references = 0;
+	QSet<Order*>::const_iterator it;
+	for (it = orders.constBegin(); it != orders.constEnd(); ++it) {
+		references += (*it)->invalidateReferenceTo(target);
+	}
+	if (references > 0) {
+		mReferencesInvalidatedByType[target->metaObject()->className()] += references;
+	}
+	mOrdersInvalidated += orders.size();
+	mReferencesInvalidated += references;
+	return orders.size();
+}
+
+void OrderReferenceIndex::releaseReferencesTo(QObject* target, QSet<Order*>& releasedOrders)
+{
+	if (!mBuilt || !target) {
+		return;
+	}
+	mTargetsReplaced++;
+	QSet<Order*> orders = mOrdersByTarget.take(target);
+	QSet<Order*>::const_iterator it;
+	for (it = orders.constBegin(); it != orders.constEnd(); ++it) {
+		mReferencesReleased += (*it)->releaseReferenceTo(target);
+	}
+	releasedOrders.unite(orders);
+}
+
+QVariantMap OrderReferenceIndex::statistics() const
+{
+	QVariantMap statisticsMap;
+	statisticsMap.insert("built", mBuilt);
+	statisticsMap.insert("targets", mOrdersByTarget.size());
+	int references = 0;
+	QHash<QObject*, QSet<Order*> >::const_iterator it;
+	for (it = mOrdersByTarget.constBegin(); it != mOrdersByTarget.constEnd(); ++it) {
+		references += it.value().size();
+	}
+	statisticsMap.insert("references", references);
+	statisticsMap.insert("targetsDeleted", mTargetsDeleted);
+	statisticsMap.insert("ordersInvalidated", mOrdersInvalidated);
+	statisticsMap.insert("referencesInvalidated", mReferencesInvalidated);
+	statisticsMap.insert("targetsReplaced", mTargetsReplaced);
+	statisticsMap.insert("referencesReleased", mReferencesReleased);
+	QVariantMap byTypeMap;
+	QHash<QString, qlonglong>::const_iterator typeIt;
+	for (typeIt = mReferencesInvalidatedByType.constBegin(); typeIt != mReferencesInvalidatedByType.constEnd();
+			++typeIt) {
+		byTypeMap.insert(typeIt.key(), typeIt.value());
+	}
+	statisticsMap.insert("referencesInvalidatedByType", byTypeMap);
+	return statisticsMap;
+}
+
+qint64 OrderReferenceIndex::memoryBytes() const
+{
+	qint64 bytes = MemoryUsage::hashBytes(mOrdersByTarget.size(), sizeof(QObject*) + sizeof(QSet<Order*>));
+	QHash<QObject*, QSet<Order*> >::const_iterator it;
+	for (it = mOrdersByTarget.constBegin(); it != mOrdersByTarget.constEnd(); ++it) {
+		bytes += MemoryUsage::hashBytes(it.value().size(), sizeof(Order*));
+	}
+	return bytes;
+}
+
+OrderReferenceIndex::~OrderReferenceIndex()
+{
+}
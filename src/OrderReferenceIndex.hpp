@@ -0,0 +1,70 @@
+#ifndef ORDERREFERENCEINDEX_HPP_
+#define ORDERREFERENCEINDEX_HPP_
+
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+
+class Order;
+class QObject;
+
+/*
+ * referenced DataObject -> Order pointing to it
+ *
+ * Order resolve their lazy references (topicId, extras, customerId, depId)
+ * and tags to DataObject pointers. if a referenced Customer, Topic ...
+ * is deleted invalidateReferencesTo() resets the pointer
+ * and marks the reference invalid - only in the Order referencing it.
+ * if it is replaced by an object with the same key (replaceAll...)
+ * releaseReferencesTo() only resets the pointer and returns
+ * the Order to resolve again.
+ *
+ * the index is built on first invalidation.
+ * an attached Order calls addReference() / removeReference()
+ * whenever it resolves or resets a pointer.
+ * DataManager adds and removes Order together with mAllOrder.
+ *
+ * counters (see statistics()) show how often references
+ * were invalidated by deleting the referenced objects
+ */
+class OrderReferenceIndex
+{
+public:
+	OrderReferenceIndex();
+	virtual ~OrderReferenceIndex();
+
+	void clear();
+	void rebuild(const QList<QObject*>& orderList);
+	bool isBuilt() const;
+
+	void addOrder(Order* order);
+	void removeOrder(Order* order);
+
+	void addReference(QObject* target, Order* order);
+	void removeReference(QObject* target, Order* order);
+
+	// returns number of Order with invalidated references
+	int invalidateReferencesTo(QObject* target);
+	// appends Order with released references to releasedOrders
+	void releaseReferencesTo(QObject* target, QSet<Order*>& releasedOrders);
+
+	QVariantMap statistics() const;
+	// estimated heap bytes of target -> Order sets
+	qint64 memoryBytes() const;
+
+private:
+
+	bool mBuilt;
+	QHash<QObject*, QSet<Order*> > mOrdersByTarget;
+	qlonglong mTargetsDeleted;
+	qlonglong mOrdersInvalidated;
+	qlonglong mReferencesInvalidated;
+	qlonglong mTargetsReplaced;
+	qlonglong mReferencesReleased;
+	// class name of the deleted target -> invalidated references
+	QHash<QString, qlonglong> mReferencesInvalidatedByType;
+};
+
+#endif /* ORDERREFERENCEINDEX_HPP_ */
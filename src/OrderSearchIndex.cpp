@@ -0,0 +1,256 @@
+#include "OrderSearchIndex.hpp"
+#include "src-gen/Order.hpp"
+#include "MemoryUsage.hpp"
+
+OrderSearchIndex::OrderSearchIndex() :
+		mBuilt(false)
+{
+}
+
+/*
+ * the index is built again on next search
+ */
+void OrderSearchIndex::clear()
+{
+	mPostings.clear();
+	mOrderWords.clear();
+	mDirty.clear();
+	mBuilt = false;
+}
+
+void OrderSearchIndex::rebuild(const QList<QObject*>& orderList)
+{
+	clear();
+	mOrderWords.reserve(orderList.size());
+	for (int i = 0; i < orderList.size(); ++i) {
+		Order* order = (Order*) orderList.at(i);
+		order->setSearchIndex(this);
+		indexOrder(order);
+	}
+	mBuilt = true;
+}
+
+bool OrderSearchIndex::isBuilt() const
+{
+	return mBuilt;
+}
+
+void OrderSearchIndex::addOrder(Order* order)
+{
+	order->setSearchIndex(this);
+	if (mBuilt) {
+		indexOrder(order);
+	}
+}
+
+void OrderSearchIndex::removeOrder(Order* order)
+{
+	order->setSearchIndex(0);
+	mDirty.remove(order);
+	unindexOrder(order);
+}
+
+void OrderSearchIndex::markDirty(Order* order)
+{
+	if (mBuilt) {
+		mDirty.insert(order);
+	}
+}
+
+QList<Order*> OrderSearchIndex::search(const QString& text, const int& limit)
+{
+	QList<Order*> orderList;
+	QStringList searchWords = words(text);
+	if (searchWords.isEmpty() || limit == 0) {
+		return orderList;
+	}
+	indexDirtyOrders();
+	QHash<Order*, int> scores = prefixScores(searchWords.first());
+	for (int i = 1; i < searchWords.size() && !scores.isEmpty(); ++i) {
+		QHash<Order*, int> wordScores = prefixScores(searchWords.at(i));
+		QHash<Order*, int>::iterator it = scores.begin();
+		while (it != scores.end()) {
+			int wordScore = wordScores.value(it.key(), 0);
+			if (wordScore == 0) {
+				it = scores.erase(it);
+			} else {
+				it.value() += wordScore;
+				++it;
+			}
+		}
+	}
+	// bucket by score: scores are small sums of weights
+	QMap<int, QMap<int, QList<Order*> > > ranking;
+	QHash<Order*, int>::const_iterator it;
+	for (it = scores.constBegin(); it != scores.constEnd(); ++it) {
+		ranking[-it.value()][it.key()->nr()].append(it.key());
+	}
+	QMap<int, QMap<int, QList<Order*> > >::const_iterator scoreIt;
+	for (scoreIt = ranking.constBegin(); scoreIt != ranking.constEnd(); ++scoreIt) {
+		QMap<int, QList<Order*> >::const_iterator nrIt;
+		for (nrIt = scoreIt.value().constBegin(); nrIt != scoreIt.value().constEnd(); ++nrIt) {
+			orderList.append(nrIt.value());
+			if (limit > 0 && orderList.size() >= limit) {
+				return orderList.mid(0, limit);
+			}
+		}
+	}
+	return orderList;
+}
+
+int OrderSearchIndex::wordCount() const
+{
+	return mPostings.size();
+}
+
+/*
+ * QMap nodes are counted like QHash nodes - close enough for an estimate
+ * the words of mOrderWords share their data with the keys of mPostings
+ */
+qint64 OrderSearchIndex::memoryBytes() const
+{
+	qint64 bytes = MemoryUsage::hashBytes(mPostings.size(), sizeof(QString) + sizeof(QHash<Order*, int>));
+	QMap<QString, QHash<Order*, int> >::const_iterator it;
+	for (it = mPostings.constBegin(); it != mPostings.constEnd(); ++it) {
+		bytes += MemoryUsage::stringDataBytes(it.key());
+		bytes += MemoryUsage::hashBytes(it.value().size(), sizeof(Order*) + sizeof(int));
+	}
+	bytes += MemoryUsage::hashBytes(mOrderWords.size(), sizeof(Order*) + sizeof(QStringList));
+	QHash<Order*, QStringList>::const_iterator wordsIt;
+	for (wordsIt = mOrderWords.constBegin(); wordsIt != mOrderWords.constEnd(); ++wordsIt) {
+		bytes += MemoryUsage::listBytes(wordsIt.value().size());
+	}
+	return bytes + MemoryUsage::hashBytes(mDirty.size(), sizeof(Order*));
+}
+
+/*
+ * case folded words of letters and digits
+ */
+QStringList OrderSearchIndex::words(const QString& text)
+{
+	QStringList wordList;
+	QString word;
+	for (int i = 0; i < text.size(); ++i) {
+		QChar c = text.at(i);
+		if (c.isLetterOrNumber()) {
+			word.append(c);
+		} else if (!word.isEmpty()) {
+			wordList.append(word.toCaseFolded());
+			word.clear();
+		}
+	}
+	if (!word.isEmpty()) {
+		wordList.append(word.toCaseFolded());
+	}
+	return wordList;
+}
+
+void OrderSearchIndex::indexOrder(Order* order)
+{
+	unindexOrder(order);
+	QStringList orderWords;
+	addText(order, order->title(), TITLE_WEIGHT, orderWords);
+	QStringList names;
+	QStringList descriptions;
+	QStringList barcodes;
+	// pending positions are read from their maps
+	order->collectSearchText(names, descriptions, barcodes);
+	for (int i = 0; i < names.size(); ++i) {
+		addText(order, names.at(i), ITEM_NAME_WEIGHT, orderWords);
+	}
+	for (int i = 0; i < descriptions.size(); ++i) {
+		addText(order, descriptions.at(i), DESCRIPTION_WEIGHT, orderWords);
+	}
+	for (int i = 0; i < barcodes.size(); ++i) {
+		QString barcode = barcodes.at(i).trimmed().toCaseFolded();
+		QStringList barcodeWords = words(barcode);
+		// "4711-0815" can be found as 47110815 and as 0815
+		if (barcodeWords.size() > 1) {
+			addWord(order, barcodeWords.join(""), BARCODE_WEIGHT, orderWords);
+		}
+		for (int w = 0; w < barcodeWords.size(); ++w) {
+			addWord(order, barcodeWords.at(w), BARCODE_WEIGHT, orderWords);
+		}
+	}
+	mOrderWords.insert(order, orderWords);
+}
+
+void OrderSearchIndex::unindexOrder(Order* order)
+{
+	QHash<Order*, QStringList>::iterator it = mOrderWords.find(order);
+	if (it == mOrderWords.end()) {
+		return;
+	}
+	const QStringList& orderWords = it.value();
+	for (int i = 0; i < orderWords.size(); ++i) {
+		QMap<QString, QHash<Order*, int> >::iterator postingIt = mPostings.find(orderWords.at(i));
+		if (postingIt == mPostings.end()) {
+			continue;
+		}
+		postingIt.value().remove(order);
+		if (postingIt.value().isEmpty()) {
+			mPostings.erase(postingIt);
+		}
+	}
+	mOrderWords.erase(it);
+}
+
+void OrderSearchIndex::addText(Order* order, const QString& text, const int& weight,
+		QStringList& orderWords)
+{
+	if (text.isEmpty()) {
+		return;
+	}
+	QStringList textWords = words(text);
+	for (int i = 0; i < textWords.size(); ++i) {
+		addWord(order, textWords.at(i), weight, orderWords);
+	}
+}
+
+void OrderSearchIndex::addWord(Order* order, const QString& word, const int& weight,
+		QStringList& orderWords)
+{
+	QMap<QString, QHash<Order*, int> >::iterator postingIt = mPostings.find(word);
+	if (postingIt == mPostings.end()) {
+		postingIt = mPostings.insert(word, QHash<Order*, int>());
+	}
+	QHash<Order*, int>::iterator it = postingIt.value().find(order);
+	if (it == postingIt.value().end()) {
+		postingIt.value().insert(order, weight);
+		// share the key of the map
+		orderWords.append(postingIt.key());
+	} else {
+		it.value() += weight;
+	}
+}
+
+void OrderSearchIndex::indexDirtyOrders()
+{
+	QSet<Order*>::const_iterator it;
+	for (it = mDirty.constBegin(); it != mDirty.constEnd(); ++it) {
+		indexOrder(*it);
+	}
+	mDirty.clear();
+}
+
+QHash<Order*, int> OrderSearchIndex::prefixScores(const QString& prefix) const
+{
+	QHash<Order*, int> scores;
+	QMap<QString, QHash<Order*, int> >::const_iterator postingIt = mPostings.lowerBound(prefix);
+	for (; postingIt != mPostings.constEnd() && postingIt.key().startsWith(prefix); ++postingIt) {
+		int factor = postingIt.key().size() == prefix.size() ? 2 : 1;
+		QHash<Order*, int>::const_iterator it;
+		for (it = postingIt.value().constBegin(); it != postingIt.value().constEnd(); ++it) {
+			int score = it.value() * factor;
+			int& best = scores[it.key()];
+			if (score > best) {
+				best = score;
+			}
+		}
+	}
+	return scores;
+}
+
+OrderSearchIndex::~OrderSearchIndex()
+{
+}
@@ -0,0 +1,77 @@
+#ifndef ORDERSEARCHINDEX_HPP_
+#define ORDERSEARCHINDEX_HPP_
+
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QStringList>
+
+class Order;
+class QObject;
+
+/*
+ * inverted index over the free text of Order:
+ * Order title, Item name, SubItem description and barcode
+ *
+ * text is split into words (letters and digits) and case folded,
+ * barcodes are also indexed as a whole.
+ * every word of a search text matches as prefix,
+ * an Order must match all words of the search text.
+ *
+ * score of an Order: sum of the field weights of the matching words,
+ * exact word matches count twice.
+ *
+ * the index is built on first search.
+ * an attached Order calls markDirty() from the setters of its text
+ * and if positions or subItems are changed - dirty Order are
+ * indexed again before the next search.
+ * DataManager adds and removes Order together with mAllOrder.
+ */
+class OrderSearchIndex
+{
+public:
+	OrderSearchIndex();
+	virtual ~OrderSearchIndex();
+
+	static const int TITLE_WEIGHT = 8;
+	static const int BARCODE_WEIGHT = 6;
+	static const int ITEM_NAME_WEIGHT = 4;
+	static const int DESCRIPTION_WEIGHT = 2;
+
+	void clear();
+	void rebuild(const QList<QObject*>& orderList);
+	bool isBuilt() const;
+
+	void addOrder(Order* order);
+	void removeOrder(Order* order);
+	void markDirty(Order* order);
+
+	// best matches first, equal score: ascending nr
+	QList<Order*> search(const QString& text, const int& limit);
+
+	int wordCount() const;
+	// estimated heap bytes of postings, words per Order and dirty Order
+	qint64 memoryBytes() const;
+
+	static QStringList words(const QString& text);
+
+private:
+
+	void indexOrder(Order* order);
+	void unindexOrder(Order* order);
+	void addText(Order* order, const QString& text, const int& weight, QStringList& orderWords);
+	void addWord(Order* order, const QString& word, const int& weight, QStringList& orderWords);
+	void indexDirtyOrders();
+	// best score per Order of all words starting with prefix
+	QHash<Order*, int> prefixScores(const QString& prefix) const;
+
+	bool mBuilt;
+	// word -> Order containing the word -> summed field weights
+	QMap<QString, QHash<Order*, int> > mPostings;
+	// words of each indexed Order - to remove them again
+	QHash<Order*, QStringList> mOrderWords;
+	QSet<Order*> mDirty;
+};
+
+#endif /* ORDERSEARCHINDEX_HPP_ */
@@ -0,0 +1,213 @@
+#include "StringPool.hpp"
+#include "MemoryUsage.hpp"
+
+#include <QMutexLocker>
+
+static StringPool* sharedStringPool = 0;
+// QString::Data header (ref, alloc, size, data, flags) of a duplicate
+static const int stringHeaderBytes = 24;
+
+StringPool::StringPool() :
+        mLookups(0), mHits(0), mBytesSaved(0)
+{
+}
+
+/*
+ * returns the shared copy of value
+ * the first value seen becomes the shared one
+ */
+QString StringPool::intern(const QString& value)
+{
+    if (value.isEmpty()) {
+        return value;
+    }
+    QMutexLocker locker(&mMutex);
+    return mValues.at(internLocked(value));
+}
+
+QStringList StringPool::intern(const QStringList& values)
+{
+    QStringList internedList;
+    if (values.isEmpty()) {
+        return internedList;
+    }
+    internedList.reserve(values.size());
+    QMutexLocker locker(&mMutex);
+    for (int i = 0; i < values.size(); ++i) {
+        const QString& value = values.at(i);
+        if (value.isEmpty()) {
+            internedList << value;
+        } else {
+            internedList << mValues.at(internLocked(value));
+        }
+    }
+    return internedList;
+}
+
+/*
+ * dense handle (0...size()-1) of value, interns if not known yet
+ * empty values have handle -1
+ */
+int StringPool::handle(const QString& value)
+{
+    if (value.isEmpty()) {
+        return -1;
+    }
+    QMutexLocker locker(&mMutex);
+    return internLocked(value);
+}
+
+/*
+ * for lookups with values from outside (queries, QML):
+ * unknown values must not grow the pool
+ */
+int StringPool::findHandle(const QString& value) const
+{
+    if (value.isEmpty()) {
+        return -1;
+    }
+    QMutexLocker locker(&mMutex);
+    return mHandles.value(value, -1);
+}
+
+QString StringPool::value(const int& handle) const
+{
+    QMutexLocker locker(&mMutex);
+    if (handle < 0 || handle >= mValues.size()) {
+        return QString();
+    }
+    return mValues.at(handle);
+}
+
+bool StringPool::contains(const QString& value) const
+{
+    QMutexLocker locker(&mMutex);
+    return mHandles.contains(value);
+}
+
+int StringPool::size() const
+{
+    QMutexLocker locker(&mMutex);
+    return mValues.size();
+}
+
+/*
+ * forget all values - handles given out before are invalid
+ * strings already interned stay valid (implicitly shared)
+ */
+void StringPool::clear()
+{
+    QMutexLocker locker(&mMutex);
+    mHandles.clear();
+    mValues.clear();
+    mLookups = 0;
+    mHits = 0;
+    mBytesSaved = 0;
+}
+
+/*
+ * drops all values only referenced from the pool itself
+ * and gives the remaining values new dense handles -
+ * handles given out before are invalid (like clear())
+ * returns the number of values dropped
+ */
+int StringPool::compact()
+{
+    QMutexLocker locker(&mMutex);
+    // without the keys of mHandles a value used nowhere else is detached
+    mHandles.clear();
+    QVector<QString> usedValues;
+    usedValues.reserve(mValues.size());
+    for (int i = 0; i < mValues.size(); ++i) {
+        if (!mValues.at(i).isDetached()) {
+            mHandles.insert(mValues.at(i), usedValues.size());
+            usedValues.append(mValues.at(i));
+        }
+    }
+    int dropped = mValues.size() - usedValues.size();
+    mValues = usedValues;
+    return dropped;
+}
+
+/*
+ * bytesSaved: storage of all values not duplicated because
+ * an equal string was already interned
+ */
+QVariantMap StringPool::statistics() const
+{
+    QMutexLocker locker(&mMutex);
+    QVariantMap statisticsMap;
+    qlonglong bytesUsed = 0;
+    for (int i = 0; i < mValues.size(); ++i) {
+        bytesUsed += mValues.at(i).size() * sizeof(QChar);
+    }
+    statisticsMap.insert("values", mValues.size());
+    statisticsMap.insert("lookups", mLookups);
+    statisticsMap.insert("hits", mHits);
+    statisticsMap.insert("bytesUsed", bytesUsed);
+    statisticsMap.insert("bytesSaved", mBytesSaved);
+    return statisticsMap;
+}
+
+// keys of mHandles share their data with mValues
+qint64 StringPool::memoryBytes() const
+{
+    QMutexLocker locker(&mMutex);
+    qint64 bytes = MemoryUsage::vectorBytes(mValues.capacity(), sizeof(QString));
+    for (int i = 0; i < mValues.size(); ++i) {
+        bytes += MemoryUsage::stringDataBytes(mValues.at(i));
+    }
+    return bytes + MemoryUsage::hashBytes(mHandles.size(), sizeof(QString) + sizeof(int));
+}
+
+int StringPool::internLocked(const QString& value)
+{
+    mLookups++;
+    QHash<QString, int>::const_iterator it = mHandles.constFind(value);
+    if (it != mHandles.constEnd()) {
+        mHits++;
+        // the duplicate is dropped by the caller -
+        // nothing saved if value already is the interned string
+        if (value.constData() != it.key().constData()) {
+            mBytesSaved += value.size() * sizeof(QChar) + stringHeaderBytes;
+        }
+        return it.value();
+    }
+    int handle = mValues.size();
+    mValues.append(value);
+    mHandles.insert(value, handle);
+    return handle;
+}
+
+StringPool* StringPool::shared()
+{
+    return sharedStringPool;
+}
+
+void StringPool::setShared(StringPool* stringPool)
+{
+    sharedStringPool = stringPool;
+}
+
+QString StringPool::interned(const QString& value)
+{
+    if (!sharedStringPool) {
+        return value;
+    }
+    return sharedStringPool->intern(value);
+}
+
+QStringList StringPool::interned(const QStringList& values)
+{
+    if (!sharedStringPool) {
+        return values;
+    }
+    return sharedStringPool->intern(values);
+}
+
+StringPool::~StringPool()
+{
+    if (sharedStringPool == this) {
+        sharedStringPool = 0;
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef STRINGPOOL_HPP_
+#define STRINGPOOL_HPP_
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QVariantMap>
+
+/*
+ * interning table for repeated QString values
+ *
+ * some properties repeat the same few values across thousands of
+ * DataObjects: Tag uuids referenced from Orders, domains,
+ * Topic classification, Tag color, GeoAddress country / city ...
+ * intern() returns a shallow copy of the first equal string seen,
+ * so all DataObjects share one storage and comparing two interned
+ * strings stops at the data pointer.
+ * handle() gives a dense int for a value - compare ints instead of strings.
+ *
+ * DataManager owns the pool and makes it the shared one
+ * and compacts it after deleting DataObjects (replaceAll..., delete...),
+ * so values no DataObject uses anymore don't stay forever.
+ * the fillFrom... methods of the DataObjects use StringPool::interned(),
+ * without a shared pool (per ex. DataObjects used standalone)
+ * the values are returned unchanged.
+ */
+class StringPool
+{
+public:
+    StringPool();
+    virtual ~StringPool();
+
+    QString intern(const QString& value);
+    QStringList intern(const QStringList& values);
+
+    int handle(const QString& value);
+    // -1 if value was never interned - doesn't intern
+    int findHandle(const QString& value) const;
+    QString value(const int& handle) const;
+    bool contains(const QString& value) const;
+    int size() const;
+
+    void clear();
+    int compact();
+
+    QVariantMap statistics() const;
+    // estimated heap bytes of the values and the lookup table
+    qint64 memoryBytes() const;
+
+    static StringPool* shared();
+    static void setShared(StringPool* stringPool);
+
+    static QString interned(const QString& value);
+    static QStringList interned(const QStringList& values);
+
+private:
+
+    int internLocked(const QString& value);
+
+    mutable QMutex mMutex;
+    QHash<QString, int> mHandles;
+    QVector<QString> mValues;
+    qlonglong mLookups;
+    qlonglong mHits;
+    qlonglong mBytesSaved;
+
+    Q_DISABLE_COPY(StringPool)
+};
+
+#endif /* STRINGPOOL_HPP_ */
@@ -0,0 +1,115 @@
+#include "VariantMapWriter.hpp"
+#include "DateCodec.hpp"
+
+VariantMapWriter::VariantMapWriter()
+{
+}
+
+void VariantMapWriter::beginObject(const QString& key)
+{
+	Frame frame;
+	frame.isArray = false;
+	frame.key = key;
+	mFrames.append(frame);
+}
+
+void VariantMapWriter::endObject()
+{
+	if (mFrames.isEmpty()) {
+		return;
+	}
+	Frame frame = mFrames.takeLast();
+	addValue(frame.key, frame.map);
+}
+
+void VariantMapWriter::beginArray(const QString& key)
+{
+	Frame frame;
+	frame.isArray = true;
+	frame.key = key;
+	mFrames.append(frame);
+}
+
+void VariantMapWriter::endArray()
+{
+	if (mFrames.isEmpty()) {
+		return;
+	}
+	Frame frame = mFrames.takeLast();
+	addValue(frame.key, frame.list);
+}
+
+void VariantMapWriter::writeInt(const QString& key, const int& value)
+{
+	addValue(key, value);
+}
+
+void VariantMapWriter::writeLongLong(const QString& key, const qint64& value)
+{
+	addValue(key, value);
+}
+
+void VariantMapWriter::writeBool(const QString& key, const bool& value)
+{
+	addValue(key, value);
+}
+
+void VariantMapWriter::writeDouble(const QString& key, const double& value)
+{
+	addValue(key, value);
+}
+
+void VariantMapWriter::writeString(const QString& key, const QString& value)
+{
+	addValue(key, value);
+}
+
+void VariantMapWriter::writeDate(const QString& key, const QDate& value)
+{
+	addValue(key, DateCodec::toIsoString(value));
+}
+
+void VariantMapWriter::writeNull(const QString& key)
+{
+	addValue(key, QVariant());
+}
+
+// Maps always contained QStringList - not a QVariantList of QString
+void VariantMapWriter::writeStringList(const QString& key, const QStringList& values)
+{
+	addValue(key, values);
+}
+
+// already a QVariant tree - no need to walk it
+void VariantMapWriter::writeVariant(const QString& key, const QVariant& value)
+{
+	addValue(key, value);
+}
+
+QVariantMap VariantMapWriter::map() const
+{
+	return mResult.toMap();
+}
+
+QVariantList VariantMapWriter::list() const
+{
+	return mResult.toList();
+}
+
+void VariantMapWriter::addValue(const QString& key, const QVariant& value)
+{
+	if (mFrames.isEmpty()) {
+		mResult = value;
+		return;
+	}
+	Frame& frame = mFrames.last();
+	if (frame.isArray) {
+		frame.list.append(value);
+	} else {
+		frame.map.insert(key, value);
+	}
+}
+
+VariantMapWriter::~VariantMapWriter()
+{
+}
@@ -0,0 +1,55 @@
+#ifndef VARIANTMAPWRITER_HPP_
+#define VARIANTMAPWRITER_HPP_
+
+#include <QVariantMap>
+#include <QVariantList>
+
+#include "DataWriter.hpp"
+
+/*
+ * DataWriter building QVariantMap / QVariantList
+ * used by toMap(), toForeignMap(), toCacheMap()
+ */
+class VariantMapWriter: public DataWriter
+{
+public:
+	VariantMapWriter();
+	virtual ~VariantMapWriter();
+
+	virtual void beginObject(const QString& key = QString());
+	virtual void endObject();
+	virtual void beginArray(const QString& key = QString());
+	virtual void endArray();
+
+	virtual void writeInt(const QString& key, const int& value);
+	virtual void writeLongLong(const QString& key, const qint64& value);
+	virtual void writeBool(const QString& key, const bool& value);
+	virtual void writeDouble(const QString& key, const double& value);
+	virtual void writeString(const QString& key, const QString& value);
+	virtual void writeDate(const QString& key, const QDate& value);
+	virtual void writeNull(const QString& key);
+	virtual void writeStringList(const QString& key, const QStringList& values);
+	virtual void writeVariant(const QString& key, const QVariant& value);
+
+	// the outermost object or array written
+	QVariantMap map() const;
+	QVariantList list() const;
+
+private:
+
+	struct Frame
+	{
+		bool isArray;
+		// key of this container inside the parent object
+		QString key;
+		QVariantMap map;
+		QVariantList list;
+	};
+
+	void addValue(const QString& key, const QVariant& value);
+
+	QList<Frame> mFrames;
+	QVariant mResult;
+};
+
+#endif /* VARIANTMAPWRITER_HPP_ */
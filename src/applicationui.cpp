@@ -24,7 +24,7 @@
 using namespace bb::cascades;
 
 ApplicationUI::ApplicationUI() :
-        QObject(),  mDataManager(new DataManager(this))
+        QObject(),  mDataManager(new CascadesDataManager(this))
 {
     // prepare the localization
     m_pTranslator = new QTranslator(this);
@@ -19,7 +19,7 @@
 
 #include <QObject>
 
-#include "src-gen/DataManager.hpp"
+#include "CascadesDataManager.hpp"
 
 namespace bb
 {
@@ -51,7 +51,7 @@ private:
     QTranslator* m_pTranslator;
     bb::cascades::LocaleHandler* m_pLocaleHandler;
 
-    DataManager* mDataManager;
+    CascadesDataManager* mDataManager;
 
 };
 
@@ -19,6 +19,7 @@
 #include <QLocale>
 #include <QTranslator>
 #include "applicationui.hpp"
+#include "DataTracer.hpp"
 
 #include <Qt/qdeclarativedebug.h>
 
@@ -27,6 +28,8 @@ using namespace bb::cascades;
 Q_DECL_EXPORT int main(int argc, char **argv)
 {
     Application app(argc, argv);
+    // opt-in startup trace: DATA_TRACE_FILE=/path/trace.json
+    DataTracer::startFromEnvironment();
 
     // Create the Application UI object, this is where the main.qml file
     // is loaded and the application scene is set.
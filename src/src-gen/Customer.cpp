@@ -1,6 +1,11 @@
 #include "Customer.hpp"
 #include <QDebug>
 #include <quuid.h>
+#include "../VariantMapWriter.hpp"
+#include "../DataTracer.hpp"
+#include "../MemoryUsage.hpp"
+#include "../DenseObjectList.hpp"
+#include "../FieldKeyHash.hpp"
 
 // keys of QVariantMap used in this APP
 static const QString idKey = "id";
@@ -14,11 +19,43 @@ static const QString companyNameForeignKey = "companyName";
 static const QString coordinateForeignKey = "coordinate";
 static const QString geoAddressForeignKey = "geoAddress";
 
+// property ids dispatched by customerField()
+enum CustomerField
+{
+	NO_FIELD,
+	ID_FIELD,
+	COMPANY_NAME_FIELD,
+	COORDINATE_FIELD,
+	GEO_ADDRESS_FIELD
+};
+
+/*
+ * maps a key of customerMap to the property id
+ * switch over the perfect hash from FieldKeyHash.hpp,
+ * then only one compare with the expected key
+ */
+static int customerField(const QString& key, const DataWriter::KeyNaming& keyNaming)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	switch (fieldKeyHash(key)) {
+	case FIELD_KEY_HASH(2, 'i'):
+		return key == (foreign ? idForeignKey : idKey) ? ID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(11, 'c'):
+		return key == (foreign ? companyNameForeignKey : companyNameKey) ? COMPANY_NAME_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(10, 'c'):
+		return key == (foreign ? coordinateForeignKey : coordinateKey) ? COORDINATE_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(10, 'g'):
+		return key == (foreign ? geoAddressForeignKey : geoAddressKey) ? GEO_ADDRESS_FIELD : NO_FIELD;
+	default:
+		return NO_FIELD;
+	}
+}
+
 /*
  * Default Constructor if Customer not initialized from QVariantMap
  */
 Customer::Customer(QObject *parent) :
-        QObject(parent), mId(-1), mCompanyName("")
+        QObject(parent), mId(-1), mCompanyName(""), mRootList(0)
 {
 	// set Types of DataObject* to NULL:
 	mCoordinate = 0;
@@ -36,30 +73,7 @@ Customer::Customer(QObject *parent) :
  */
 void Customer::fillFromMap(const QVariantMap& customerMap)
 {
-	mId = customerMap.value(idKey).toInt();
-	mCompanyName = customerMap.value(companyNameKey).toString();
-	// mCoordinate points to GeoCoordinate*
-	if (customerMap.contains(coordinateKey)) {
-		QVariantMap coordinateMap;
-		coordinateMap = customerMap.value(coordinateKey).toMap();
-		if (!coordinateMap.isEmpty()) {
-			mCoordinate = 0;
-			mCoordinate = new GeoCoordinate();
-			mCoordinate->setParent(this);
-			mCoordinate->fillFromMap(coordinateMap);
-		}
-	}
-	// mGeoAddress points to GeoAddress*
-	if (customerMap.contains(geoAddressKey)) {
-		QVariantMap geoAddressMap;
-		geoAddressMap = customerMap.value(geoAddressKey).toMap();
-		if (!geoAddressMap.isEmpty()) {
-			mGeoAddress = 0;
-			mGeoAddress = new GeoAddress();
-			mGeoAddress->setParent(this);
-			mGeoAddress->fillFromMap(geoAddressMap);
-		}
-	}
+	fillFrom(customerMap, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -70,30 +84,7 @@ void Customer::fillFromMap(const QVariantMap& customerMap)
  */
 void Customer::fillFromForeignMap(const QVariantMap& customerMap)
 {
-	mId = customerMap.value(idForeignKey).toInt();
-	mCompanyName = customerMap.value(companyNameForeignKey).toString();
-	// mCoordinate points to GeoCoordinate*
-	if (customerMap.contains(coordinateForeignKey)) {
-		QVariantMap coordinateMap;
-		coordinateMap = customerMap.value(coordinateForeignKey).toMap();
-		if (!coordinateMap.isEmpty()) {
-			mCoordinate = 0;
-			mCoordinate = new GeoCoordinate();
-			mCoordinate->setParent(this);
-			mCoordinate->fillFromForeignMap(coordinateMap);
-		}
-	}
-	// mGeoAddress points to GeoAddress*
-	if (customerMap.contains(geoAddressForeignKey)) {
-		QVariantMap geoAddressMap;
-		geoAddressMap = customerMap.value(geoAddressForeignKey).toMap();
-		if (!geoAddressMap.isEmpty()) {
-			mGeoAddress = 0;
-			mGeoAddress = new GeoAddress();
-			mGeoAddress->setParent(this);
-			mGeoAddress->fillFromForeignMap(geoAddressMap);
-		}
-	}
+	fillFrom(customerMap, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -104,27 +95,72 @@ void Customer::fillFromForeignMap(const QVariantMap& customerMap)
  */
 void Customer::fillFromCacheMap(const QVariantMap& customerMap)
 {
-	mId = customerMap.value(idKey).toInt();
-	mCompanyName = customerMap.value(companyNameKey).toString();
-	// mCoordinate points to GeoCoordinate*
-	if (customerMap.contains(coordinateKey)) {
-		QVariantMap coordinateMap;
-		coordinateMap = customerMap.value(coordinateKey).toMap();
-		if (!coordinateMap.isEmpty()) {
-			mCoordinate = new GeoCoordinate();
-			mCoordinate->setParent(this);
-			mCoordinate->fillFromCacheMap(coordinateMap);
+	fillFrom(customerMap, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+}
+
+/*
+ * initialize Customer from QVariantMap
+ * walks customerMap only once: each key is dispatched by customerField()
+ * keyNaming: own property names or names from Server API
+ * transientPolicy WITHOUT_TRANSIENT ignores transient values (cache)
+ * corresponding export method: writeTo()
+ */
+void Customer::fillFrom(const QVariantMap& customerMap, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	TraceSpan span("Customer::fillFrom", "dto");
+	// properties not contained in customerMap get default values
+	mId = 0;
+	mCompanyName = QString();
+	QVariantMap::const_iterator it;
+	for (it = customerMap.constBegin(); it != customerMap.constEnd(); ++it) {
+		switch (customerField(it.key(), keyNaming)) {
+		case ID_FIELD:
+			mId = it.value().toInt();
+			break;
+		case COMPANY_NAME_FIELD:
+			mCompanyName = it.value().toString();
+			break;
+		case COORDINATE_FIELD: {
+			// mCoordinate points to GeoCoordinate*
+			QVariantMap coordinateMap;
+			coordinateMap = it.value().toMap();
+			if (!coordinateMap.isEmpty()) {
+				mCoordinate = new GeoCoordinate();
+				mCoordinate->setParent(this);
+				if (keyNaming == DataWriter::FOREIGN_KEYS) {
+					mCoordinate->fillFromForeignMap(coordinateMap);
+				} else if (transientPolicy == DataWriter::WITHOUT_TRANSIENT) {
+					mCoordinate->fillFromCacheMap(coordinateMap);
+				} else {
+					mCoordinate->fillFromMap(coordinateMap);
+				}
+			}
+			break;
 		}
-	}
-	// mGeoAddress points to GeoAddress*
-	if (customerMap.contains(geoAddressKey)) {
-		QVariantMap geoAddressMap;
-		geoAddressMap = customerMap.value(geoAddressKey).toMap();
-		if (!geoAddressMap.isEmpty()) {
-			mGeoAddress = new GeoAddress();
-			mGeoAddress->setParent(this);
-			mGeoAddress->fillFromCacheMap(geoAddressMap);
+		case GEO_ADDRESS_FIELD: {
+			// mGeoAddress points to GeoAddress*
+			QVariantMap geoAddressMap;
+			geoAddressMap = it.value().toMap();
+			if (!geoAddressMap.isEmpty()) {
+				mGeoAddress = new GeoAddress();
+				mGeoAddress->setParent(this);
+				if (keyNaming == DataWriter::FOREIGN_KEYS) {
+					mGeoAddress->fillFromForeignMap(geoAddressMap);
+				} else if (transientPolicy == DataWriter::WITHOUT_TRANSIENT) {
+					mGeoAddress->fillFromCacheMap(geoAddressMap);
+				} else {
+					mGeoAddress->fillFromMap(geoAddressMap);
+				}
+			}
+			break;
 		}
+		default:
+			break;
+		}
+	}
+	if (mRootList) {
+		mRootList->keyChanged(this);
 	}
 }
 
@@ -150,20 +186,11 @@ bool Customer::isValid()
  */
 QVariantMap Customer::toMap()
 {
-	QVariantMap customerMap;
-	customerMap.insert(idKey, mId);
-	customerMap.insert(companyNameKey, mCompanyName);
-	// mCoordinate points to GeoCoordinate*
-	if (mCoordinate) {
-	if (mCoordinate->isValid()) {
-		customerMap.insert(coordinateKey, mCoordinate->toMap());
-	}
-	}
-	// mGeoAddress points to GeoAddress*
-	if (mGeoAddress) {
-	customerMap.insert(geoAddressKey, mGeoAddress->toMap());
-	}
-	return customerMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 /*
@@ -173,20 +200,11 @@ QVariantMap Customer::toMap()
  */
 QVariantMap Customer::toForeignMap()
 {
-	QVariantMap customerMap;
-	customerMap.insert(idForeignKey, mId);
-	customerMap.insert(companyNameForeignKey, mCompanyName);
-	// mCoordinate points to GeoCoordinate*
-	if (mCoordinate) {
-		if (mCoordinate->isValid()) {
-			customerMap.insert(coordinateForeignKey, mCoordinate->toMap());
-		}
-	}
-	// mGeoAddress points to GeoAddress*
-	if (mGeoAddress) {
-		customerMap.insert(geoAddressForeignKey, mGeoAddress->toMap());
-	}
-	return customerMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 
@@ -197,9 +215,38 @@ QVariantMap Customer::toForeignMap()
  */
 QVariantMap Customer::toCacheMap()
 {
-	// no transient properties found from data model
-	// use default toMao()
-	return toMap();
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+	writer.endObject();
+	return writer.map();
+}
+
+/*
+ * writes all properties into the current object of writer
+ * used by toMap(), toForeignMap(), toCacheMap() and to write caches
+ * keyNaming: own property names or names from Server API
+ * no transient properties found from data model
+ */
+void Customer::writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	Q_UNUSED(transientPolicy);
+	writer->writeInt(foreign ? idForeignKey : idKey, mId);
+	writer->writeString(foreign ? companyNameForeignKey : companyNameKey, mCompanyName);
+	// mCoordinate points to GeoCoordinate*
+	if (mCoordinate && mCoordinate->isValid()) {
+		writer->beginObject(foreign ? coordinateForeignKey : coordinateKey);
+		mCoordinate->writeTo(writer);
+		writer->endObject();
+	}
+	// mGeoAddress points to GeoAddress*
+	if (mGeoAddress) {
+		writer->beginObject(foreign ? geoAddressForeignKey : geoAddressKey);
+		mGeoAddress->writeTo(writer);
+		writer->endObject();
+	}
 }
 // ATT 
 // Mandatory: id
@@ -213,9 +260,16 @@ void Customer::setId(int id)
 {
 	if (id != mId) {
 		mId = id;
+		if (mRootList) {
+			mRootList->keyChanged(this);
+		}
 		emit idChanged(id);
 	}
 }
+void Customer::setRootList(DenseObjectList* rootList)
+{
+	mRootList = rootList;
+}
 // ATT 
 // Optional: companyName
 QString Customer::companyName() const
@@ -306,6 +360,19 @@ bool Customer::hasGeoAddress()
 }
 
 
+// estimated memory of this Customer, its GeoCoordinate and GeoAddress
+void Customer::addMemoryUsage(MemoryUsage* usage) const
+{
+	usage->addObject(MemoryUsage::CUSTOMER, MemoryUsage::objectBytes(sizeof(Customer)),
+			MemoryUsage::stringBytes(mCompanyName));
+	if (mCoordinate) {
+		mCoordinate->addMemoryUsage(usage);
+	}
+	if (mGeoAddress) {
+		mGeoAddress->addMemoryUsage(usage);
+	}
+}
+
 Customer::~Customer()
 {
 	// place cleanUp code here
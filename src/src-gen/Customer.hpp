@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <qvariant.h>
+#include "../DataWriter.hpp"
 // #include <QtLocationSubset/QGeoCoordinate>
 // #include <QtLocationSubset/QGeoAddress>
 
@@ -12,6 +13,9 @@
 
 // using namespace QtMobilitySubset;	
 
+class MemoryUsage;
+class DenseObjectList;
+
 class Customer: public QObject
 {
 	Q_OBJECT
@@ -29,6 +33,8 @@ public:
 	void fillFromMap(const QVariantMap& customerMap);
 	void fillFromForeignMap(const QVariantMap& customerMap);
 	void fillFromCacheMap(const QVariantMap& customerMap);
+	void fillFrom(const QVariantMap& customerMap, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
 	
 	void prepareNew();
 	
@@ -39,6 +45,13 @@ public:
 	QVariantMap toForeignMap();
 	QVariantMap toCacheMap();
 
+	void writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
+
+	void addMemoryUsage(MemoryUsage* usage) const;
+	// root list of DataManager - informed if the id changes
+	void setRootList(DenseObjectList* rootList);
+
 	int id() const;
 	void setId(int id);
 	QString companyName() const;
@@ -81,6 +94,8 @@ private:
 	GeoCoordinate* mCoordinate;
 	GeoAddress* mGeoAddress;
 
+	DenseObjectList* mRootList;
+
 	Q_DISABLE_COPY (Customer)
 };
 Q_DECLARE_METATYPE(Customer*)
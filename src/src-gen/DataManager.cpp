@@ -1,11 +1,24 @@
 #include <QObject>
 
 #include "DataManager.hpp"
-
-#include <bb/cascades/Application>
-#include <bb/cascades/AbstractPane>
-#include <bb/data/JsonDataAccess>
-#include <bb/cascades/GroupDataModel>
+#include "../DataObjectPool.hpp"
+#include "../JsonDataWriter.hpp"
+#include "../BinaryDataWriter.hpp"
+#include "../DataReader.hpp"
+#include "../ChunkedCache.hpp"
+#include "../OrderQuery.hpp"
+#include "../OrderColumns.hpp"
+#include "../DataLog.hpp"
+#include "../DataTracer.hpp"
+#include "../MemoryUsage.hpp"
+#include "../OrderEviction.hpp"
+
+#include <QtConcurrentRun>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QFuture>
+#include <QBuffer>
+#include <QThread>
 
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlRecord>
@@ -20,6 +33,10 @@ static QString dataPath(const QString& fileName)
 {
     return QDir::currentPath() + "/data/" + fileName;
 }
+// the names stay .json also for binary caches (setUseBinaryCache()):
+// DataReader::create() detects the format from the first bytes,
+// so switching the format needs no migration and the JSON files
+// from assets/datamodel are found by the same name
 static QString cacheOrder = "cacheOrder.json";
 static QString cacheCustomer = "cacheCustomer.json";
 static QString cacheTopic = "cacheTopic.json";
@@ -29,11 +46,50 @@ static QString cacheDepartment = "cacheDepartment.json";
 static QString cacheTag = "cacheTag.json";
 static QString cacheXtras = "cacheXtras.json";
 
-using namespace bb::cascades;
-using namespace bb::data;
+// domain keys of the root lists - see DenseObjectList::setKeyFunctions()
+static int orderKey(QObject* object)
+{
+    return ((Order*) object)->nr();
+}
+static void attachOrder(QObject* object, DenseObjectList* list)
+{
+    ((Order*) object)->setRootList(list);
+}
+static int customerKey(QObject* object)
+{
+    return ((Customer*) object)->id();
+}
+static void attachCustomer(QObject* object, DenseObjectList* list)
+{
+    ((Customer*) object)->setRootList(list);
+}
+static int topicKey(QObject* object)
+{
+    return ((Topic*) object)->id();
+}
+static void attachTopic(QObject* object, DenseObjectList* list)
+{
+    ((Topic*) object)->setRootList(list);
+}
+static int departmentKey(QObject* object)
+{
+    return ((Department*) object)->id();
+}
+static void attachDepartment(QObject* object, DenseObjectList* list)
+{
+    ((Department*) object)->setRootList(list);
+}
+static int xtrasKey(QObject* object)
+{
+    return ((Xtras*) object)->id();
+}
+static void attachXtras(QObject* object, DenseObjectList* list)
+{
+    ((Xtras*) object)->setRootList(list);
+}
 
 DataManager::DataManager(QObject *parent) :
-        QObject(parent)
+        QObject(parent), mUseBinaryCache(false), mRecordsPerCacheChunk(2000)
 {
     // ApplicationUI is parent of DataManager
     // DataManager is parent of all root DataObjects
@@ -46,6 +102,18 @@ DataManager::DataManager(QObject *parent) :
     // Tag
     // Xtras
 
+    // fillFrom... methods of all DataObjects intern repeated values
+    StringPool::setShared(&mStringPool);
+    // released references of cold Order are resolved again by DataManager
+    mOrderEviction.setDataManager(this);
+    // find... and delete...By... of the domain key without scanning
+    mAllOrder.setKeyFunctions(&orderKey, &attachOrder);
+    mAllCustomer.setKeyFunctions(&customerKey, &attachCustomer);
+    mAllTopic.setKeyFunctions(&topicKey, &attachTopic);
+    // children are found by id too: the flat list is indexed, not the roots
+    mAllDepartmentFlat.setKeyFunctions(&departmentKey, &attachDepartment);
+    mAllXtras.setKeyFunctions(&xtrasKey, &attachXtras);
+
     // register all DataObjects to get access to properties from QML:
 	qmlRegisterType<Order>("org.ekkescorner.data", 1, 0, "Order");
 	qmlRegisterType<Item>("org.ekkescorner.data", 1, 0, "Item");
@@ -56,7 +124,8 @@ DataManager::DataManager(QObject *parent) :
 	qmlRegisterType<Department>("org.ekkescorner.data", 1, 0, "Department");
 	qmlRegisterType<Tag>("org.ekkescorner.data", 1, 0, "Tag");
 	qmlRegisterType<Xtras>("org.ekkescorner.data", 1, 0, "Xtras");
-	// QGeo... classes wrapped as QObject* to be able to access via Q_PROPERTY
+	// Geo... value types as QObject* to be able to access via Q_PROPERTY
+	// QtLocationSubset conversion: GeoConversion (Cascades adapter)
 	qmlRegisterType<GeoCoordinate>("org.ekkescorner.data", 1, 0, "GeoCoordinate");
 	qmlRegisterType<GeoAddress>("org.ekkescorner.data", 1, 0, "GeoAddress");
 	// register all ENUMs to get access from QML
@@ -65,9 +134,32 @@ DataManager::DataManager(QObject *parent) :
 	// QTimer
 	qmlRegisterType<QTimer>("org.ekkescorner.common", 1, 0, "QTimer");
 
-	// no auto exit: we must persist the cache before
-    bb::Application::instance()->setAutoExit(false);
-    bool res = QObject::connect(bb::Application::instance(), SIGNAL(manualExit()), this, SLOT(onManualExit()));
+    bool res;
+    // Order must not keep pointers to deleted Customer, Topic, Department, Tag or Xtras
+    res = QObject::connect(this, SIGNAL(deletedFromAllCustomer(Customer*)), this,
+            SLOT(onDeletedFromAllCustomer(Customer*)));
+    Q_ASSERT(res);
+    res = QObject::connect(this, SIGNAL(deletedFromAllTopic(Topic*)), this,
+            SLOT(onDeletedFromAllTopic(Topic*)));
+    Q_ASSERT(res);
+    res = QObject::connect(this, SIGNAL(deletedFromAllDepartment(Department*)), this,
+            SLOT(onDeletedFromAllDepartment(Department*)));
+    Q_ASSERT(res);
+    res = QObject::connect(this, SIGNAL(deletedFromAllTag(Tag*)), this,
+            SLOT(onDeletedFromAllTag(Tag*)));
+    Q_ASSERT(res);
+    res = QObject::connect(this, SIGNAL(deletedFromAllXtras(Xtras*)), this,
+            SLOT(onDeletedFromAllXtras(Xtras*)));
+    Q_ASSERT(res);
+    res = QObject::connect(&mMetricsTimer, SIGNAL(timeout()), this, SLOT(onMetricsSnapshotTimeout()));
+    Q_ASSERT(res);
+    mOrderEvictionTimer.setSingleShot(true);
+    mOrderEvictionTimer.setInterval(0);
+    res = QObject::connect(&mOrderEvictionTimer, SIGNAL(timeout()), this, SLOT(onOrderEvictionTimeout()));
+    Q_ASSERT(res);
+    mDeleteLaterTimer.setSingleShot(true);
+    mDeleteLaterTimer.setInterval(0);
+    res = QObject::connect(&mDeleteLaterTimer, SIGNAL(timeout()), this, SLOT(onDeleteLaterTimeout()));
     Q_ASSERT(res);
 
 
@@ -79,19 +171,150 @@ DataManager::DataManager(QObject *parent) :
  * called from main.qml with delay using QTimer
  * Data with 2PhaseInit Caching Policy will only
  * load priority records needed to resolve from others
+ *
+ * caches are independent until references are resolved:
+ * reading, parsing and creating DataObjects run concurrently
+ * on the global QThreadPool. Tag is read from SQLite meanwhile
+ * here, because the database connection belongs to this thread.
+ * roots are parented to DataManager on this thread,
+ * Order references are resolved after all of their targets are in.
+ * wall time of all stages: "initStages" of metrics()
  */
 void DataManager::init()
 {
+    TraceSpan span("init", "init");
+    QElapsedTimer initTimer;
+    initTimer.start();
+    mInitStages.clear();
+    QElapsedTimer timer;
+    timer.start();
 	// SQL init the sqlite database
 	mDatabaseAvailable = initDatabase();
-	qDebug() << "SQLite created or opened ? " << mDatabaseAvailable;
-
-    initOrderFromCache();
-    initCustomerFromCache();
-    initTopicFromCache();
-    initDepartmentFromCache();
+	DATA_LOG(DATA_LOG_SQL) << "SQLite created or opened ? " << mDatabaseAvailable;
+    mMetrics.record(DataMetrics::INIT_DATABASE, timer.nsecsElapsed());
+    recordInitStage("initDatabase", timer);
+
+    QFuture<QList<QObject*> > orderFuture = QtConcurrent::run(this, &DataManager::readOrderFromCache);
+    QFuture<QList<QObject*> > customerFuture = QtConcurrent::run(this, &DataManager::readCustomerFromCache);
+    QFuture<QList<QObject*> > topicFuture = QtConcurrent::run(this, &DataManager::readTopicFromCache);
+    QFuture<QList<QObject*> > departmentFuture = QtConcurrent::run(this,
+            &DataManager::readDepartmentFromCache);
+    QFuture<QList<QObject*> > xtrasFuture = QtConcurrent::run(this, &DataManager::readXtrasFromCache);
+
+    timer.restart();
     initTagFromSqlCache();
-    initXtrasFromCache();
+    recordInitStage("readTag", timer);
+
+    // result() waits until the cache is read
+    mAllCustomer = customerFuture.result();
+    adoptRootDataObjects(mAllCustomer.objectList());
+    mAllTopic = topicFuture.result();
+    adoptRootDataObjects(mAllTopic.objectList());
+    mAllDepartment = departmentFuture.result();
+    adoptRootDataObjects(mAllDepartment.objectList());
+    fillDepartmentFlat();
+    mAllXtras = xtrasFuture.result();
+    adoptRootDataObjects(mAllXtras.objectList());
+    mAllOrder = orderFuture.result();
+    adoptRootDataObjects(mAllOrder.objectList());
+    rebuildOrderIndexes();
+    DATA_LOG(DATA_LOG_INIT) << "created Order* #" << mAllOrder.size() << " Customer* #" << mAllCustomer.size()
+            << " Topic* #" << mAllTopic.size() << " Department* #" << mAllDepartment.size()
+            << " Xtras* #" << mAllXtras.size();
+
+    // Order depends on Topic, Xtras, Customer, Department and Tag
+    timer.restart();
+    resolveReferencesForAllOrder();
+    recordInitStage("resolveOrder", timer);
+    recordInitStage("total", initTimer);
+    mMetrics.record(DataMetrics::INIT, initTimer.nsecsElapsed());
+    DATA_LOG(DATA_LOG_INIT) << "init stages [ms]: " << mInitStages;
+}
+
+/*
+ * DataManager must be parent of all root DTOs
+ * objects must already live in the thread of DataManager
+ */
+void DataManager::adoptRootDataObjects(const QList<QObject*>& rootList)
+{
+    for (int i = 0; i < rootList.size(); ++i) {
+        rootList.at(i)->setParent(this);
+    }
+}
+
+/*
+ * stores the wall time of an init stage
+ * called from the reading threads, so it's synchronized
+ */
+void DataManager::recordInitStage(const QString& stage, const QElapsedTimer& timer)
+{
+    QMutexLocker locker(&mInitStagesMutex);
+    mInitStages.insert(stage, timer.elapsed());
+}
+
+/*
+ * timers and counters of init, parse, resolve, find..., DataModel fills,
+ * SQL batches and cache saves since the last resetMetrics()
+ * see DataMetrics::snapshot()
+ * "initStages": wall time in ms of the stages of the last init() - not reset,
+ * read... stages are running concurrently
+ */
+QVariantMap DataManager::metrics()
+{
+    QVariantMap metricsMap = mMetrics.snapshot();
+    QMutexLocker locker(&mInitStagesMutex);
+    metricsMap.insert("initStages", mInitStages);
+    return metricsMap;
+}
+
+void DataManager::resetMetrics()
+{
+    mMetrics.reset();
+}
+
+/*
+ * emits metricsSnapshot() every msecs
+ * 0 stops
+ */
+void DataManager::setMetricsSnapshotInterval(const int& msecs)
+{
+    if (msecs <= 0) {
+        mMetricsTimer.stop();
+        return;
+    }
+    mMetricsTimer.start(msecs);
+}
+
+void DataManager::onMetricsSnapshotTimeout()
+{
+    emit metricsSnapshot(metrics());
+}
+
+// to record from outside (per ex. CascadesDataManager)
+DataMetrics* DataManager::dataMetrics()
+{
+    return &mMetrics;
+}
+
+/*
+ * records spans of init, caches, SQL, resolve and DTO fills
+ * as Chrome trace-event JSON - written by stopTrace()
+ * see DataTracer.hpp
+ */
+bool DataManager::startTrace(const QString& fileName)
+{
+    return DataTracer::start(fileName);
+}
+
+bool DataManager::stopTrace()
+{
+    return DataTracer::stop();
+}
+
+// instant event on the timeline - per ex. QML timers
+void DataManager::traceMark(const QString& name)
+{
+    DataTracer::mark(name, "qml");
 }
 
 
@@ -104,6 +327,7 @@ void DataManager::init()
  */
 bool DataManager::initDatabase()
 {
+    TraceSpan span("initDatabase", "sql");
     mChunkSize = 10000;
     QString pathname;
     pathname = dataPath(dbName);
@@ -115,7 +339,7 @@ bool DataManager::initDatabase()
             // copy file from assets to data
             bool copyOk = assetDataFile.copy(pathname);
             if (!copyOk) {
-                qDebug() << "cannot copy dataAssetsPath(fileName) to dataPath(fileName)";
+                DATA_LOG(DATA_LOG_CACHE) << "cannot copy dataAssetsPath(fileName) to dataPath(fileName)";
             }
         }
     }
@@ -128,7 +352,7 @@ bool DataManager::initDatabase()
         qWarning() << "Cannot open " << dbName << ":" << error.text();
         return false;
     }
-    qDebug() << "Database opened: " << dbName;
+    DATA_LOG(DATA_LOG_SQL) << "Database opened: " << dbName;
     return true;
 }
 
@@ -137,6 +361,253 @@ void DataManager::setChunkSize(const int& newChunkSize)
     mChunkSize = newChunkSize;
 }
 
+/**
+ * statistics of the pools used for cascaded DataObjects
+ * (Item, SubItem, Info) - see DataObjectPool.hpp
+ */
+QVariantMap DataManager::dataObjectPoolStatistics()
+{
+    QVariantMap statisticsMap;
+    statisticsMap.insert("Item", DataObjectPool<Item>::instance()->statistics());
+    statisticsMap.insert("SubItem", DataObjectPool<SubItem>::instance()->statistics());
+    statisticsMap.insert("Info", DataObjectPool<Info>::instance()->statistics());
+    return statisticsMap;
+}
+
+/**
+ * frees pool chunks without living DataObjects
+ * per ex. after deleting many Orders
+ */
+void DataManager::trimDataObjectPools()
+{
+    DataObjectPool<Item>::instance()->trim();
+    DataObjectPool<SubItem>::instance()->trim();
+    DataObjectPool<Info>::instance()->trim();
+}
+
+/**
+ * statistics of interned values (Tag uuids, domains, classification, ...)
+ * bytesSaved: storage not duplicated
+ */
+QVariantMap DataManager::stringPoolStatistics()
+{
+    return mStringPool.statistics();
+}
+
+/**
+ * estimated heap bytes per DataObject type and per cache - see MemoryUsage.hpp
+ * all root DataObjects add themselves and their children,
+ * caches are the lists of all root DataObjects, indexes, StringPool
+ * and the reserved but unused slots of the DataObjectPools
+ */
+QVariantMap DataManager::memoryStatistics()
+{
+    TraceSpan span("memoryStatistics", "memory");
+    MemoryUsage usage;
+    for (int i = 0; i < mAllOrder.size(); ++i) {
+        ((Order*) mAllOrder.at(i))->addMemoryUsage(&usage);
+    }
+    for (int i = 0; i < mAllCustomer.size(); ++i) {
+        ((Customer*) mAllCustomer.at(i))->addMemoryUsage(&usage);
+    }
+    for (int i = 0; i < mAllTopic.size(); ++i) {
+        ((Topic*) mAllTopic.at(i))->addMemoryUsage(&usage);
+    }
+    for (int i = 0; i < mAllDepartment.size(); ++i) {
+        ((Department*) mAllDepartment.at(i))->addMemoryUsage(&usage);
+    }
+    for (int i = 0; i < mAllTag.size(); ++i) {
+        ((Tag*) mAllTag.at(i))->addMemoryUsage(&usage);
+    }
+    for (int i = 0; i < mAllXtras.size(); ++i) {
+        ((Xtras*) mAllXtras.at(i))->addMemoryUsage(&usage);
+    }
+    usage.addCache("allOrder", mAllOrder.memoryBytes(), mAllOrder.size());
+    usage.addCache("allCustomer", mAllCustomer.memoryBytes(), mAllCustomer.size());
+    usage.addCache("allTopic", mAllTopic.memoryBytes(), mAllTopic.size());
+    usage.addCache("allDepartment", mAllDepartment.memoryBytes(), mAllDepartment.size());
+    usage.addCache("allTag", mAllTag.memoryBytes(), mAllTag.size());
+    usage.addCache("allXtras", mAllXtras.memoryBytes(), mAllXtras.size());
+    usage.addCache("allDepartmentFlat", mAllDepartmentFlat.memoryBytes(), mAllDepartmentFlat.size());
+    usage.addCache("orderColumns", mOrderColumns.memoryBytes(), mOrderColumns.size());
+    usage.addCache("orderSearchIndex", mOrderSearchIndex.memoryBytes(), mOrderSearchIndex.wordCount());
+    usage.addCache("barcodeIndex", mBarcodeIndex.memoryBytes(), mBarcodeIndex.barcodeCount());
+    usage.addCache("orderReferenceIndex", mOrderReferenceIndex.memoryBytes(),
+            mOrderReferenceIndex.statistics().value("references").toInt());
+    usage.addCache("tagByHandle", MemoryUsage::vectorBytes(mTagByHandle.capacity(), sizeof(Tag*)),
+            mTagByHandle.size());
+    usage.addCache("stringPool", mStringPool.memoryBytes(), mStringPool.size());
+    // live slots are counted by Item, SubItem, Info
+    QVariantMap poolStatistics = dataObjectPoolStatistics();
+    QVariantMap::const_iterator it;
+    for (it = poolStatistics.constBegin(); it != poolStatistics.constEnd(); ++it) {
+        QVariantMap pool = it.value().toMap();
+        qint64 unusedBytes = pool.value("bytesReserved").toLongLong()
+                - pool.value("live").toLongLong() * pool.value("slotSize").toLongLong();
+        usage.addCache("pool" + it.key(), qMax((qint64) 0, unusedBytes), pool.value("chunks").toInt());
+    }
+    return usage.toMap();
+}
+
+/**
+ * estimated bytes of materialized positions above which positions of
+ * least recently used Order are released - 0: no limit
+ * see OrderEviction.hpp
+ */
+void DataManager::setOrderMemoryLimit(const int& kiloBytes)
+{
+    mOrderEviction.setMemoryLimit((qint64) kiloBytes * 1024);
+}
+
+// the count most recently accessed Order are never evicted
+void DataManager::setOrderKeepRecent(const int& count)
+{
+    mOrderEviction.setKeepRecent(count);
+}
+
+/**
+ * releases the positions of all cold Order,
+ * withReferences also their resolved ...AsDataObject pointers
+ * both are restored on next access
+ * returns number of released positions and references
+ */
+int DataManager::evictColdOrders(const bool& withReferences)
+{
+    int evicted = mOrderEviction.evictPositions(0);
+    if (withReferences) {
+        evicted += mOrderEviction.evictReferences(mAllOrder.objectList());
+    }
+    return evicted;
+}
+
+// evictions and reloads are counted in metrics()
+QVariantMap DataManager::orderEvictionStatistics()
+{
+    return mOrderEviction.statistics();
+}
+
+/*
+ * an Order was materialized above the memory limit
+ * evicting right now could delete Items of another Order
+ * used by the QML callback materializing this Order
+ */
+void DataManager::scheduleOrderEviction()
+{
+    if (!mOrderEvictionTimer.isActive()) {
+        mOrderEvictionTimer.start();
+    }
+}
+
+void DataManager::onOrderEvictionTimeout()
+{
+    mOrderEviction.evictAboveLimit();
+}
+
+// false if the Order cache file was not read or written in chunks
+bool DataManager::isOrderCacheChunk(const int& chunk) const
+{
+    return chunk >= 0 && chunk < mOrderCacheChunks.size();
+}
+
+/*
+ * positions of an Order released to the cache file
+ * parses the chunk containing the Order
+ * returns false if the Order was not found
+ */
+bool DataManager::readOrderPositionsFromCache(Order* order)
+{
+    if (!isOrderCacheChunk(order->cacheChunk())) {
+        return false;
+    }
+    TraceSpan span("readOrderPositionsFromCache", "cache");
+    QByteArray chunkData = ChunkedCache::readChunk(dataPath(cacheOrder), mOrderCacheChunks.at(order->cacheChunk()));
+    if (chunkData.isEmpty()) {
+        return false;
+    }
+    QBuffer chunkBuffer(&chunkData);
+    chunkBuffer.open(QIODevice::ReadOnly);
+    QScopedPointer<DataReader> reader(DataReader::create(&chunkBuffer));
+    QVariantMap cacheMap;
+    while (reader->readNext(cacheMap)) {
+        if (Order::nrOfCacheMap(cacheMap) == order->nr()) {
+            order->restorePositionsFromCacheMap(cacheMap);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * positions released to the cache file are read back as pending maps
+ * before the cache file is written again or all positions are indexed
+ * each chunk is parsed once
+ */
+void DataManager::restoreOrderPositionsFromCache()
+{
+    QHash<int, QHash<int, Order*> > ordersByChunk;
+    for (int i = 0; i < mAllOrder.size(); ++i) {
+        Order* order;
+        order = (Order*) mAllOrder.at(i);
+        if (order->hasPositionsInCache()) {
+            ordersByChunk[order->cacheChunk()].insert(order->nr(), order);
+        }
+    }
+    if (ordersByChunk.isEmpty()) {
+        return;
+    }
+    TraceSpan span("restoreOrderPositionsFromCache", "cache");
+    QString fileName = dataPath(cacheOrder);
+    QHash<int, QHash<int, Order*> >::iterator it;
+    for (it = ordersByChunk.begin(); it != ordersByChunk.end(); ++it) {
+        QHash<int, Order*>& orders = it.value();
+        QByteArray chunkData;
+        if (isOrderCacheChunk(it.key())) {
+            chunkData = ChunkedCache::readChunk(fileName, mOrderCacheChunks.at(it.key()));
+        }
+        if (!chunkData.isEmpty()) {
+            QBuffer chunkBuffer(&chunkData);
+            chunkBuffer.open(QIODevice::ReadOnly);
+            QScopedPointer<DataReader> reader(DataReader::create(&chunkBuffer));
+            QVariantMap cacheMap;
+            while (!orders.isEmpty() && reader->readNext(cacheMap)) {
+                Order* order = orders.take(Order::nrOfCacheMap(cacheMap));
+                if (order) {
+                    order->restorePositionsFromCacheMap(cacheMap);
+                }
+            }
+        }
+        if (!orders.isEmpty()) {
+            qWarning() << "released positions not found in cache - Order #" << orders.size();
+            // positions are lost - the Order must not wait for them
+            QHash<int, Order*>::const_iterator lost;
+            for (lost = orders.constBegin(); lost != orders.constEnd(); ++lost) {
+                lost.value()->restorePositionsFromCacheMap(QVariantMap());
+            }
+        }
+    }
+}
+
+/**
+ * logs a summary of memoryStatistics() and emits memoryStatisticsReported()
+ * CascadesDataManager calls it if the OS reports low memory
+ */
+void DataManager::reportMemoryStatistics(const QString& reason)
+{
+    QVariantMap statistics = memoryStatistics();
+    qWarning() << "## DataManager ## memory (" << reason << ") total:"
+            << statistics.value("totalBytes").toLongLong() / 1024 << "KB DataObjects:"
+            << statistics.value("typesBytes").toLongLong() / 1024 << "KB caches:"
+            << statistics.value("cachesBytes").toLongLong() / 1024 << "KB";
+    QVariantMap typesMap = statistics.value("types").toMap();
+    QVariantMap::const_iterator it;
+    for (it = typesMap.constBegin(); it != typesMap.constEnd(); ++it) {
+        QVariantMap typeMap = it.value().toMap();
+        DATA_LOG(DATA_LOG_CACHE) << "  " << it.key() << "#" << typeMap.value("count").toLongLong()
+                << typeMap.value("totalBytes").toLongLong() / 1024 << "KB";
+    }
+    emit memoryStatisticsReported(reason, statistics);
+}
+
 /**
  * tune PRAGMA synchronous and journal_mode for better speed with bulk import
  * see https://www.sqlite.org/pragma.html
@@ -193,7 +664,7 @@ void DataManager::bulkImport(const bool& tuneJournalAndSync)
             syncMode = query.value(0).toString();
             break;
     }
-    qDebug() << "PRAGMA current values - " << "journal: " << journalMode << " synchronous: " << syncMode;
+    DATA_LOG(DATA_LOG_SQL) << "PRAGMA current values - " << "journal: " << journalMode << " synchronous: " << syncMode;
     //
     query.clear();
     if (tuneJournalAndSync) {
@@ -218,7 +689,7 @@ void DataManager::bulkImport(const bool& tuneJournalAndSync)
         qWarning() << "NO RESULT PRAGMA journal_mode";
         return;
     }
-    qDebug() << "PRAGMA NEW VALUE journal_mode: " << query.value(0).toString();
+    DATA_LOG(DATA_LOG_SQL) << "PRAGMA NEW VALUE journal_mode: " << query.value(0).toString();
     //
     query.clear();
     if (tuneJournalAndSync) {
@@ -257,11 +728,12 @@ void DataManager::bulkImport(const bool& tuneJournalAndSync)
             syncMode = query.value(0).toString();
             break;
     }
-    qDebug() << "PRAGMA synchronous NEW VALUE: " << syncMode;
+    DATA_LOG(DATA_LOG_SQL) << "PRAGMA synchronous NEW VALUE: " << syncMode;
 }
 
 void DataManager::finish()
 {
+    TraceSpan span("finish", "cache");
     saveOrderToCache();
     saveCustomerToCache();
     saveTopicToCache();
@@ -270,6 +742,50 @@ void DataManager::finish()
     saveXtrasToCache();
 }
 
+/*
+ * parses one chunk of the Order cache into Order* without parent
+ * runs on the chunk pool of readOrderFromCache(),
+ * each task fills its own orderList
+ */
+class OrderChunkTask: public QRunnable
+{
+public:
+    OrderChunkTask(const QString& fileName, const ChunkedCache::Chunk& chunk, QThread* targetThread,
+            QList<QObject*>* orderList) :
+            mFileName(fileName), mChunk(chunk), mTargetThread(targetThread), mOrderList(orderList)
+    {
+    }
+
+    void run()
+    {
+        TraceSpan span("decodeOrderChunk", "cache");
+        QByteArray chunkData = ChunkedCache::readChunk(mFileName, mChunk);
+        if (chunkData.isEmpty()) {
+            return;
+        }
+        QBuffer chunkBuffer(&chunkData);
+        chunkBuffer.open(QIODevice::ReadOnly);
+        QScopedPointer<DataReader> reader(DataReader::create(&chunkBuffer));
+        // records are checked against the chunk size by ChunkedCache::readTable()
+        mOrderList->reserve(mChunk.records);
+        QVariantMap cacheMap;
+        while (reader->readNext(cacheMap)) {
+            Order* order = new Order();
+            order->fillFromCacheMap(cacheMap);
+            if (order->thread() != mTargetThread) {
+                order->moveToThread(mTargetThread);
+            }
+            mOrderList->append(order);
+        }
+    }
+
+private:
+    QString mFileName;
+    ChunkedCache::Chunk mChunk;
+    QThread* mTargetThread;
+    QList<QObject*>* mOrderList;
+};
+
 /*
  * reads Maps of Order in from JSON cache
  * creates List of Order*  from QVariantList
@@ -277,21 +793,92 @@ void DataManager::finish()
  */
 void DataManager::initOrderFromCache()
 {
-	qDebug() << "start initOrderFromCache";
-    mAllOrder.clear();
-    QVariantList cacheList;
-    cacheList = readFromCache(cacheOrder);
-    qDebug() << "read Order from cache #" << cacheList.size();
-    for (int i = 0; i < cacheList.size(); ++i) {
-        QVariantMap cacheMap;
-        cacheMap = cacheList.at(i).toMap();
+	DATA_LOG(DATA_LOG_CACHE) << "start initOrderFromCache";
+    mAllOrder = readOrderFromCache();
+    // Important: DataManager must be parent of all root DTOs
+    adoptRootDataObjects(mAllOrder.objectList());
+    rebuildOrderIndexes();
+    DATA_LOG(DATA_LOG_CACHE) << "created Order* #" << mAllOrder.size();
+}
+
+/*
+ * reads Order from cache and creates Order* without parent
+ * runs on any thread: created objects are moved to the thread of DataManager
+ */
+QList<QObject*> DataManager::readOrderFromCache()
+{
+    TraceSpan span("readOrderFromCache", "cache");
+    QElapsedTimer timer;
+    timer.start();
+    ScopedMetricsTimer parseTimer(&mMetrics, DataMetrics::PARSE_ORDER);
+    QList<QObject*> orderList;
+    QFile cacheFile;
+    if (!openCacheFile(cacheOrder, cacheFile)) {
+        return orderList;
+    }
+    if (ChunkedCache::isChunked(&cacheFile)) {
+        // chunks are parsed in parallel - this thread waits
+        QVector<ChunkedCache::Chunk> chunks;
+        if (!ChunkedCache::readTable(&cacheFile, chunks)) {
+            return orderList;
+        }
+        // own pool: this runs on a thread of the global pool, the other cache readers
+        // hold threads there - mapping onto it could wait for them or starve them
+        QVector<QList<QObject*> > chunkLists(chunks.size());
+        QThreadPool chunkPool;
+        for (int i = 0; i < chunks.size(); ++i) {
+            chunkPool.start(new OrderChunkTask(cacheFile.fileName(), chunks.at(i), thread(), &chunkLists[i]));
+        }
+        chunkPool.waitForDone();
+        // results are in chunk order = order written
+        for (int i = 0; i < chunkLists.size(); ++i) {
+            const QList<QObject*>& chunkList = chunkLists.at(i);
+            for (int o = 0; o < chunkList.size(); ++o) {
+                ((Order*) chunkList.at(o))->setCacheChunk(i);
+            }
+            orderList.append(chunkList);
+        }
+        mOrderCacheChunks = chunks;
+        DATA_LOG(DATA_LOG_CACHE) << "Order* read from chunks #" << chunks.size();
+        mMetrics.increment(DataMetrics::PARSED_RECORDS, orderList.size());
+        recordInitStage("readOrder", timer);
+        return orderList;
+    }
+    // stream: only one Order map in memory
+    QScopedPointer<DataReader> reader(DataReader::create(&cacheFile));
+    QVariantMap cacheMap;
+    while (reader->readNext(cacheMap)) {
         Order* order = new Order();
-        // Important: DataManager must be parent of all root DTOs
-        order->setParent(this);
         order->fillFromCacheMap(cacheMap);
-        mAllOrder.append(order);
+        if (order->thread() != thread()) {
+            order->moveToThread(thread());
+        }
+        orderList.append(order);
+    }
+    setOrderCacheChunk(orderList, cacheFile.size());
+    mMetrics.increment(DataMetrics::PARSED_RECORDS, orderList.size());
+    recordInitStage("readOrder", timer);
+    return orderList;
+}
+
+/*
+ * a cache file not written in chunks is one chunk
+ * if not larger than a chunk: reading it again is cheap
+ */
+void DataManager::setOrderCacheChunk(const QList<QObject*>& orderList, const qint64& fileSize)
+{
+    mOrderCacheChunks.clear();
+    bool oneChunk = mRecordsPerCacheChunk > 0 && orderList.size() <= mRecordsPerCacheChunk;
+    if (oneChunk) {
+        ChunkedCache::Chunk chunk;
+        chunk.offset = 0;
+        chunk.size = (int) fileSize;
+        chunk.records = orderList.size();
+        mOrderCacheChunks.append(chunk);
+    }
+    for (int i = 0; i < orderList.size(); ++i) {
+        ((Order*) orderList.at(i))->setCacheChunk(oneChunk ? 0 : -1);
     }
-    qDebug() << "created Order* #" << mAllOrder.size();
 }
 
 
@@ -302,28 +889,90 @@ void DataManager::initOrderFromCache()
  */
 void DataManager::saveOrderToCache()
 {
-    QVariantList cacheList;
-    qDebug() << "now caching Order* #" << mAllOrder.size();
+    TraceSpan span("saveOrderToCache", "cache");
+    ScopedMetricsTimer saveTimer(&mMetrics, DataMetrics::SAVE_ORDER);
+    DATA_LOG(DATA_LOG_CACHE) << "now caching Order* #" << mAllOrder.size();
+    // positions released to the cache file must be read before it's overwritten
+    restoreOrderPositionsFromCache();
+    mOrderCacheChunks.clear();
+    QFile cacheFile(dataPath(cacheOrder));
+    if (!cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "cannot open cache to write: " << cacheFile.fileName();
+        return;
+    }
+    if (mRecordsPerCacheChunk > 0 && mAllOrder.size() > mRecordsPerCacheChunk) {
+        saveOrderToChunkedCache(cacheFile);
+        return;
+    }
+    QScopedPointer<DataWriter> writer(createCacheWriter(&cacheFile));
+    writer->beginArray();
     for (int i = 0; i < mAllOrder.size(); ++i) {
         Order* order;
         order = (Order*)mAllOrder.at(i);
-        QVariantMap cacheMap;
-        cacheMap = order->toCacheMap();
-        cacheList.append(cacheMap);
+        writer->beginObject();
+        order->writeTo(writer.data(), DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+        writer->endObject();
+    }
+    writer->endArray();
+    if (!writer->flush()) {
+        qWarning() << "Order* NOT written to cache";
+        setOrderCacheChunk(QList<QObject*>(), 0);
+        return;
+    }
+    setOrderCacheChunk(mAllOrder.objectList(), cacheFile.size());
+    mMetrics.increment(DataMetrics::SAVED_RECORDS, mAllOrder.size());
+    DATA_LOG(DATA_LOG_CACHE) << "Order* written to cache #" << mAllOrder.size();
+}
+
+/*
+ * large Order caches are split into chunks of mRecordsPerCacheChunk
+ * each chunk is a complete JSON or binary array (see ChunkedCache.hpp)
+ * so readOrderFromCache() can parse them in parallel
+ */
+void DataManager::saveOrderToChunkedCache(QFile& cacheFile)
+{
+    int chunkCount = (mAllOrder.size() + mRecordsPerCacheChunk - 1) / mRecordsPerCacheChunk;
+    ChunkedCache chunkedCache(&cacheFile, chunkCount);
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        int fromPos = chunk * mRecordsPerCacheChunk;
+        int toPos = qMin(fromPos + mRecordsPerCacheChunk, mAllOrder.size());
+        chunkedCache.beginChunk();
+        QScopedPointer<DataWriter> writer(createCacheWriter(&cacheFile));
+        writer->beginArray();
+        for (int i = fromPos; i < toPos; ++i) {
+            Order* order;
+            order = (Order*)mAllOrder.at(i);
+            order->setCacheChunk(chunk);
+            writer->beginObject();
+            order->writeTo(writer.data(), DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+            writer->endObject();
+        }
+        writer->endArray();
+        if (!writer->flush()) {
+            qWarning() << "Order* NOT written to cache";
+            return;
+        }
+        chunkedCache.endChunk(toPos - fromPos);
+    }
+    if (!chunkedCache.finish()) {
+        qWarning() << "Order* NOT written to cache";
+        return;
     }
-    qDebug() << "Order* converted to JSON cache #" << cacheList.size();
-    writeToCache(cacheOrder, cacheList);
+    // chunk indexes of the Order are valid only with the offset table
+    mOrderCacheChunks = chunkedCache.chunks();
+    mMetrics.increment(DataMetrics::SAVED_RECORDS, mAllOrder.size());
+    DATA_LOG(DATA_LOG_CACHE) << "Order* written to cache #" << mAllOrder.size() << " chunks: " << chunkCount;
 }
 
 
 void DataManager::resolveOrderReferences(Order* order)
 {
 	if (!order) {
-        qDebug() << "cannot resolveOrderReferences with order NULL";
+        DATA_LOG(DATA_LOG_RESOLVE) << "cannot resolveOrderReferences with order NULL";
         return;
     }
     if(order->isAllResolved()) {
-	    qDebug() << "nothing to do: all is resolved";
+	    DATA_LOG(DATA_LOG_RESOLVE) << "nothing to do: all is resolved";
 	    return;
 	}
     if (order->hasTopicId() && !order->isTopicIdResolvedAsDataObject()) {
@@ -332,7 +981,8 @@ void DataManager::resolveOrderReferences(Order* order)
     	if (topicId) {
     		order->resolveTopicIdAsDataObject(topicId);
     	} else {
-    		qDebug() << "markTopicIdAsInvalid: " << order->topicId();
+    		DATA_LOG(DATA_LOG_RESOLVE) << "markTopicIdAsInvalid: " << order->topicId();
+    		mMetrics.increment(DataMetrics::RESOLVE_INVALID);
     		order->markTopicIdAsInvalid();
     	}
     }
@@ -342,7 +992,8 @@ void DataManager::resolveOrderReferences(Order* order)
     	if (extras) {
     		order->resolveExtrasAsDataObject(extras);
     	} else {
-    		qDebug() << "markExtrasAsInvalid: " << order->extras();
+    		DATA_LOG(DATA_LOG_RESOLVE) << "markExtrasAsInvalid: " << order->extras();
+    		mMetrics.increment(DataMetrics::RESOLVE_INVALID);
     		order->markExtrasAsInvalid();
     	}
     }
@@ -352,7 +1003,8 @@ void DataManager::resolveOrderReferences(Order* order)
     	if (customerId) {
     		order->resolveCustomerIdAsDataObject(customerId);
     	} else {
-    		qDebug() << "markCustomerIdAsInvalid: " << order->customerId();
+    		DATA_LOG(DATA_LOG_RESOLVE) << "markCustomerIdAsInvalid: " << order->customerId();
+    		mMetrics.increment(DataMetrics::RESOLVE_INVALID);
     		order->markCustomerIdAsInvalid();
     	}
     }
@@ -362,17 +1014,20 @@ void DataManager::resolveOrderReferences(Order* order)
     	if (depId) {
     		order->resolveDepIdAsDataObject(depId);
     	} else {
-    		qDebug() << "markDepIdAsInvalid: " << order->depId();
+    		DATA_LOG(DATA_LOG_RESOLVE) << "markDepIdAsInvalid: " << order->depId();
+    		mMetrics.increment(DataMetrics::RESOLVE_INVALID);
     		order->markDepIdAsInvalid();
     	}
     }
     if (!order->areTagsKeysResolved()) {
         order->resolveTagsKeys(
-                listOfTagForKeys(order->tagsKeys()));
+                listOfTagForHandles(order->tagsHandles()));
     }
 }
 void DataManager::resolveReferencesForAllOrder()
 {
+    TraceSpan span("resolveReferencesForAllOrder", "resolve");
+    ScopedMetricsTimer resolveTimer(&mMetrics, DataMetrics::RESOLVE_ORDER);
     for (int i = 0; i < mAllOrder.size(); ++i) {
         Order* order;
         order = (Order*)mAllOrder.at(i);
@@ -420,7 +1075,7 @@ QVariantList DataManager::orderAsQVariantList()
 
 QList<QObject*> DataManager::allOrder()
 {
-    return mAllOrder;
+    return mAllOrder.objectList();
 }
 
 QDeclarativeListProperty<Order> DataManager::orderPropertyList()
@@ -438,9 +1093,8 @@ void DataManager::appendToOrderProperty(
 {
     DataManager *dataManagerObject = qobject_cast<DataManager *>(orderList->object);
     if (dataManagerObject) {
-        order->setParent(dataManagerObject);
-        dataManagerObject->mAllOrder.append(order);
-        emit dataManagerObject->addedToAllOrder(order);
+        // keeps nr index, columns and search indexes in sync
+        dataManagerObject->insertOrder(order);
     } else {
         qWarning() << "cannot append Order* to mAllOrder "
                 << "Object is not of type DataManager*";
@@ -478,15 +1132,8 @@ void DataManager::clearOrderProperty(
 {
     DataManager *dataManager = qobject_cast<DataManager *>(orderList->object);
     if (dataManager) {
-        for (int i = 0; i < dataManager->mAllOrder.size(); ++i) {
-            Order* order;
-            order = (Order*) dataManager->mAllOrder.at(i);
-			emit dataManager->deletedFromAllOrderByNr(order->nr());
-			emit dataManager->deletedFromAllOrder(order);
-            order->deleteLater();
-            order = 0;
-        }
-        dataManager->mAllOrder.clear();
+        // keeps nr index, columns and search indexes in sync
+        dataManager->deleteOrder();
     } else {
         qWarning() << "cannot clear mAllOrder " << "Object is not of type DataManager*";
     }
@@ -495,18 +1142,11 @@ void DataManager::clearOrderProperty(
 /**
  * deletes all Order
  * and clears the list
+ * with one batchDeletedFromAllOrder signal, deleted later together
  */
 void DataManager::deleteOrder()
 {
-    for (int i = 0; i < mAllOrder.size(); ++i) {
-        Order* order;
-        order = (Order*) mAllOrder.at(i);
-        emit deletedFromAllOrderByNr(order->nr());
-		emit deletedFromAllOrder(order);
-        order->deleteLater();
-        order = 0;
-     }
-     mAllOrder.clear();
+    replaceAllOrders(QList<Order*>());
 }
 
 /**
@@ -533,7 +1173,7 @@ Order* DataManager::createOrder()
 void DataManager::undoCreateOrder(Order* order)
 {
     if (order) {
-        qDebug() << "undoCreateOrder " << order->nr();
+        DATA_LOG(DATA_LOG_DTO) << "undoCreateOrder " << order->nr();
         order->deleteLater();
         order = 0;
     }
@@ -544,6 +1184,11 @@ void DataManager::insertOrder(Order* order)
     // Important: DataManager must be parent of all root DTOs
     order->setParent(this);
     mAllOrder.append(order);
+    mOrderColumns.append(order);
+    mOrderSearchIndex.addOrder(order);
+    mBarcodeIndex.addOrder(order);
+    mOrderReferenceIndex.addOrder(order);
+    mOrderEviction.addOrder(order);
     emit addedToAllOrder(order);
 }
 
@@ -558,6 +1203,11 @@ void DataManager::insertOrderFromMap(const QVariantMap& orderMap,
         order->fillFromMap(orderMap);
     }
     mAllOrder.append(order);
+    mOrderColumns.append(order);
+    mOrderSearchIndex.addOrder(order);
+    mBarcodeIndex.addOrder(order);
+    mOrderReferenceIndex.addOrder(order);
+    mOrderEviction.addOrder(order);
     emit addedToAllOrder(order);
 }
 
@@ -568,6 +1218,11 @@ bool DataManager::deleteOrder(Order* order)
     if (!ok) {
         return ok;
     }
+    mOrderColumns.removeRow(order->columnRow());
+    mOrderSearchIndex.removeOrder(order);
+    mBarcodeIndex.removeOrder(order);
+    mOrderReferenceIndex.removeOrder(order);
+    mOrderEviction.removeOrder(order);
     emit deletedFromAllOrderByNr(order->nr());
     emit deletedFromAllOrder(order);
     order->deleteLater();
@@ -578,116 +1233,509 @@ bool DataManager::deleteOrder(Order* order)
 
 bool DataManager::deleteOrderByNr(const int& nr)
 {
+    int i = mAllOrder.indexOfKey(nr);
+    if (i < 0) {
+        return false;
+    }
+    Order* order;
+    order = (Order*) mAllOrder.at(i);
+    mAllOrder.removeAt(i);
+    mOrderColumns.removeRow(i);
+    mOrderSearchIndex.removeOrder(order);
+    mBarcodeIndex.removeOrder(order);
+    mOrderReferenceIndex.removeOrder(order);
+    mOrderEviction.removeOrder(order);
+    emit deletedFromAllOrderByNr(nr);
+    emit deletedFromAllOrder(order);
+    order->deleteLater();
+    order = 0;
+    return true;
+}
+
+/*
+ * int keys as sorted ranges: [[from, to], ...]
+ * per ex. 1,2,3,7,8 -> [[1, 3], [7, 8]]
+ */
+static QVariantList keyRanges(QList<int> keyList)
+{
+    QVariantList rangeList;
+    qSort(keyList);
+    int i = 0;
+    while (i < keyList.size()) {
+        int from = keyList.at(i);
+        int to = from;
+        while (++i < keyList.size() && keyList.at(i) <= to + 1) {
+            to = keyList.at(i);
+        }
+        QVariantList range;
+        range << from << to;
+        rangeList.append(QVariant(range));
+    }
+    return rangeList;
+}
+
+/*
+ * one timer event for all objects instead of a DeferredDelete event for each
+ * the objects stay children of DataManager until they are deleted:
+ * QML may still use them in this event loop.
+ * reparenting them first wouldn't be cheaper - every detach searches
+ * children() of DataManager from the front, as the delete does
+ */
+void DataManager::deleteAllLater(const QList<QObject*>& objectList)
+{
+    if (objectList.isEmpty()) {
+        return;
+    }
+    mDeleteLaterList.append(objectList);
+    if (!mDeleteLaterTimer.isActive()) {
+        mDeleteLaterTimer.start();
+    }
+}
+
+void DataManager::onDeleteLaterTimeout()
+{
+    QList<QObject*> deleteList;
+    deleteList.swap(mDeleteLaterList);
+    qDeleteAll(deleteList);
+    // strings only the deleted DataObjects used
+    mStringPool.compact();
+}
+
+/**
+ * inserts all Order with one batchAddedToAllOrder signal
+ * instead of addedToAllOrder for each Order
+ */
+void DataManager::insertOrders(const QList<Order*>& orderList)
+{
+    if (orderList.isEmpty()) {
+        return;
+    }
+    QList<int> keyList;
+    keyList.reserve(orderList.size());
+    mAllOrder.reserve(mAllOrder.size() + orderList.size());
+    for (int i = 0; i < orderList.size(); ++i) {
+        Order* order = orderList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        order->setParent(this);
+        mAllOrder.append(order);
+        mOrderColumns.append(order);
+        mOrderSearchIndex.addOrder(order);
+        mBarcodeIndex.addOrder(order);
+        mOrderReferenceIndex.addOrder(order);
+        mOrderEviction.addOrder(order);
+        keyList.append(order->nr());
+    }
+    emit batchAddedToAllOrder(keyRanges(keyList));
+}
+
+/**
+ * deletes all Order with nr in nrList - one pass over all Order to find them
+ * with one batchDeletedFromAllOrder signal
+ * instead of deletedFromAllOrder... for each Order
+ * returns the number of deleted Order
+ */
+int DataManager::deleteOrders(const QVariantList& nrList)
+{
+    QSet<int> nrSet;
+    for (int i = 0; i < nrList.size(); ++i) {
+        nrSet.insert(nrList.at(i).toInt());
+    }
+    QList<QObject*> deleteList;
+    QList<int> keyList;
     for (int i = 0; i < mAllOrder.size(); ++i) {
         Order* order;
         order = (Order*) mAllOrder.at(i);
-        if (order->nr() == nr) {
-            mAllOrder.removeAt(i);
-            emit deletedFromAllOrderByNr(nr);
-            emit deletedFromAllOrder(order);
-            order->deleteLater();
-            order = 0;
-            return true;
+        if (nrSet.contains(order->nr())) {
+            mOrderSearchIndex.removeOrder(order);
+            mBarcodeIndex.removeOrder(order);
+            mOrderReferenceIndex.removeOrder(order);
+            mOrderEviction.removeOrder(order);
+            deleteList.append(order);
+            keyList.append(order->nr());
         }
     }
-    return false;
+    if (deleteList.isEmpty()) {
+        return 0;
+    }
+    for (int i = 0; i < deleteList.size(); ++i) {
+        Order* order;
+        order = (Order*) deleteList.at(i);
+        // same row as in mAllOrder: both move their last entry into the gap
+        mOrderColumns.removeRow(order->columnRow());
+        mAllOrder.removeOne(order);
+    }
+    emit batchDeletedFromAllOrder(keyRanges(keyList));
+    deleteAllLater(deleteList);
+    return deleteList.size();
 }
 
-void DataManager::fillOrderDataModel(QString objectName)
-{
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-    	GroupDataModel* dataModel = dataModelList.last();
-    	if (dataModel) {
-        	QList<QObject*> theList;
-        	for (int i = 0; i < mAllOrder.size(); ++i) {
-            	theList.append(mAllOrder.at(i));
-        	}
-        	dataModel->clear();
-        	dataModel->insertList(theList);
-        	return;
-    	}
+/**
+ * replaces all Order - per ex. after reload from server
+ * emits batchDeletedFromAllOrder for the old and batchAddedToAllOrder for the new Order
+ */
+void DataManager::replaceAllOrders(const QList<Order*>& orderList)
+{
+    QList<QObject*> deleteList = mAllOrder.objectList();
+    QList<int> keyList;
+    keyList.reserve(deleteList.size());
+    for (int i = 0; i < deleteList.size(); ++i) {
+        Order* order;
+        order = (Order*) deleteList.at(i);
+        mOrderSearchIndex.removeOrder(order);
+        mBarcodeIndex.removeOrder(order);
+        mOrderReferenceIndex.removeOrder(order);
+        mOrderEviction.removeOrder(order);
+        keyList.append(order->nr());
     }
-    qDebug() << "NO GRP DATA FOUND Order for " << objectName;
+    mAllOrder.clear();
+    QList<int> addedKeyList;
+    addedKeyList.reserve(orderList.size());
+    mAllOrder.reserve(orderList.size());
+    for (int i = 0; i < orderList.size(); ++i) {
+        Order* order = orderList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        order->setParent(this);
+        mAllOrder.append(order);
+        addedKeyList.append(order->nr());
+    }
+    rebuildOrderIndexes();
+    if (!keyList.isEmpty()) {
+        emit batchDeletedFromAllOrder(keyRanges(keyList));
+    }
+    if (!addedKeyList.isEmpty()) {
+        emit batchAddedToAllOrder(keyRanges(addedKeyList));
+    }
+    deleteAllLater(deleteList);
 }
-/**
- * removing and re-inserting a single item of a DataModel
- * this will cause the ListView to redraw or recalculate all values for this ListItem
- * we do this, because only changing properties won't call List functions
+
+// nr is DomainKey
+// the nr index of mAllOrder is exact: Order::setNr() and fillFrom() update it
+Order* DataManager::findOrderByNr(const int& nr){
+    Order* order;
+    order = (Order*) mAllOrder.objectOfKey(nr);
+    if (order) {
+        mMetrics.increment(DataMetrics::FIND_HIT);
+        mOrderEviction.touch(order);
+        return order;
+    }
+    DATA_LOG(DATA_LOG_FIND) << "no Order found for nr " << nr;
+    mMetrics.increment(DataMetrics::FIND_MISS);
+    return 0;
+}
+
+// column arrays and indexes of all Order - the nr index is kept by mAllOrder
+void DataManager::rebuildOrderIndexes()
+{
+    TraceSpan span("rebuildOrderIndexes", "index");
+    mOrderColumns.rebuild(mAllOrder.objectList());
+    // built again on next search / barcode lookup
+    mOrderSearchIndex.clear();
+    mBarcodeIndex.clear();
+    mOrderReferenceIndex.clear();
+    mOrderEviction.rebuild(mAllOrder.objectList());
+}
+
+/*
+ * runs the query over all Order
+ * nr predicate: only the Order found by nr is checked
+ * department subtree: depId and all children
  */
-void DataManager::replaceItemInOrderDataModel(QString objectName,
-        Order* listItem)
+QList<Order*> DataManager::queryOrder(OrderQuery query)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                dataModel->insert(listItem);
-                return;
-            }
-            qDebug() << "Order Object not found and not replaced in " << objectName;
+    if (query.hasDepSubtree()) {
+        query.setDepIds(departmentSubtreeIds(query.depId()));
+    }
+    QList<Order*> candidates;
+    if (query.hasNr()) {
+        Order* order = findOrderByNr(query.nr());
+        if (order) {
+            candidates.append(order);
+        }
+    } else {
+        // column predicates scan the column arrays
+        QVector<int> rows = query.selectRows(mOrderColumns);
+        candidates.reserve(rows.size());
+        for (int i = 0; i < rows.size(); ++i) {
+            candidates.append(mOrderColumns.orderAt(rows.at(i)));
         }
-        return;
     }
-    qDebug() << "no DataModel found for " << objectName;
+    return query.run(candidates);
 }
 
-void DataManager::removeItemFromOrderDataModel(QString objectName, Order* listItem)
+/**
+ * keys (nr) of Order containing all words of text
+ * in title, position names, subItem descriptions or barcodes
+ * words match as prefix - best matches first
+ * limit: max number of keys, -1: all
+ */
+QVariantList DataManager::searchOrders(const QString& text, const int& limit)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                return;
-            }
-            qDebug() << "Order Object not found and not removed from " << objectName;
+    if (!mOrderSearchIndex.isBuilt()) {
+        // one parse per chunk instead of one per Order
+        restoreOrderPositionsFromCache();
+        mOrderSearchIndex.rebuild(mAllOrder.objectList());
+    }
+    QList<Order*> orderList = mOrderSearchIndex.search(text, limit);
+    QVariantList keyList;
+    for (int i = 0; i < orderList.size(); ++i) {
+        keyList.append(orderList.at(i)->nr());
+    }
+    return keyList;
+}
+
+/**
+ * SubItem with this barcode - 0 if not found
+ * only positions and subItems of the Order containing the barcode
+ * are created, use item() and item()->order() to get the owners
+ */
+SubItem* DataManager::findSubItemByBarcode(const QString& barcode)
+{
+    if (!mBarcodeIndex.isBuilt()) {
+        restoreOrderPositionsFromCache();
+        mBarcodeIndex.rebuild(mAllOrder.objectList());
+    }
+    SubItem* subItem = mBarcodeIndex.findSubItem(barcode);
+    mMetrics.increment(subItem ? DataMetrics::FIND_HIT : DataMetrics::FIND_MISS);
+    return subItem;
+}
+
+/**
+ * Order containing the SubItem with this barcode - 0 if not found
+ */
+Order* DataManager::findOrderByBarcode(const QString& barcode)
+{
+    SubItem* subItem = findSubItemByBarcode(barcode);
+    if (!subItem || !subItem->item() || !subItem->item()->order()) {
+        return 0;
+    }
+    Order* order = subItem->item()->order();
+    mOrderEviction.touch(order);
+    return order;
+}
+
+/*
+ * a referenced object will be deleted: Order pointing to it
+ * get their reference reset and marked invalid
+ * first call indexes the resolved references of all Order
+ */
+void DataManager::invalidateOrderReferencesTo(QObject* target)
+{
+    if (!mOrderReferenceIndex.isBuilt()) {
+        mOrderReferenceIndex.rebuild(mAllOrder.objectList());
+    }
+    mOrderReferenceIndex.invalidateReferencesTo(target);
+}
+
+/*
+ * a referenced object will be replaced by one with the same key (replaceAll...):
+ * Order pointing to it get their reference reset, but not marked invalid
+ * resolveReleasedOrderReferences() resolves them against the new objects
+ */
+void DataManager::releaseOrderReferencesTo(QObject* target, QSet<Order*>& releasedOrders)
+{
+    if (!mOrderReferenceIndex.isBuilt()) {
+        mOrderReferenceIndex.rebuild(mAllOrder.objectList());
+    }
+    mOrderReferenceIndex.releaseReferencesTo(target, releasedOrders);
+}
+
+// keys missing in the new objects are marked invalid now
+// find...ById look up the key index of the new root list - no scan per Order
+void DataManager::resolveReleasedOrderReferences(const QSet<Order*>& releasedOrders)
+{
+    QSet<Order*>::const_iterator it;
+    for (it = releasedOrders.constBegin(); it != releasedOrders.constEnd(); ++it) {
+        resolveOrderReferences(*it);
+    }
+}
+
+void DataManager::onDeletedFromAllCustomer(Customer* customer)
+{
+    invalidateOrderReferencesTo(customer);
+}
+
+void DataManager::onDeletedFromAllTopic(Topic* topic)
+{
+    invalidateOrderReferencesTo(topic);
+}
+
+// children are deleted with their parent Department
+void DataManager::onDeletedFromAllDepartment(Department* department)
+{
+    invalidateOrderReferencesTo(department);
+    QList<QObject*> children = department->allDepartmentChildren();
+    for (int i = 0; i < children.size(); ++i) {
+        invalidateOrderReferencesTo(children.at(i));
+    }
+}
+
+void DataManager::onDeletedFromAllTag(Tag* tag)
+{
+    invalidateOrderReferencesTo(tag);
+}
+
+void DataManager::onDeletedFromAllXtras(Xtras* xtras)
+{
+    invalidateOrderReferencesTo(xtras);
+}
+
+/**
+ * counters of references from Order to deleted or replaced objects
+ * references: resolved references currently tracked
+ * targetsDeleted, ordersInvalidated, referencesInvalidated (ByType)
+ * targetsReplaced, referencesReleased: resolved again by replaceAll...
+ */
+QVariantMap DataManager::orderReferenceStatistics()
+{
+    return mOrderReferenceIndex.statistics();
+}
+
+static const char* stateNames[] = { "NEW", "CONFIRMED", "DELIVERED", "CLOSED" };
+
+/**
+ * number of Order per state - scans the state column
+ * key: state as String (NEW, CONFIRMED, ...)
+ */
+QVariantMap DataManager::orderStateCounts()
+{
+    QVariantMap stateCountMap;
+    QVector<int> counts = mOrderColumns.stateCounts(OrderState::CLOSED + 1);
+    for (int state = 0; state < counts.size(); ++state) {
+        stateCountMap.insert(stateNames[state], counts.at(state));
+    }
+    return stateCountMap;
+}
+
+int DataManager::orderExpressCount()
+{
+    return mOrderColumns.countExpressOrders();
+}
+
+/**
+ * number of Order per state for each day from .. to
+ * one map per day: orderDate and the counts per state (NEW, CONFIRMED, ...)
+ * days without Order are included with 0 counts
+ */
+QVariantList DataManager::orderStateCountsByDay(const QDate& fromDate, const QDate& toDate)
+{
+    QVariantList dayList;
+    if (!fromDate.isValid() || !toDate.isValid() || fromDate > toDate) {
+        return dayList;
+    }
+    int stateCount = OrderState::CLOSED + 1;
+    int dayCount = fromDate.daysTo(toDate) + 1;
+    QVector<int> counts = mOrderColumns.stateCountsByDay(OrderColumns::julianDay(fromDate), dayCount,
+            stateCount);
+    dayList.reserve(dayCount);
+    for (int day = 0; day < dayCount; ++day) {
+        QVariantMap dayMap;
+        dayMap.insert("orderDate", fromDate.addDays(day));
+        for (int state = 0; state < stateCount; ++state) {
+            dayMap.insert(stateNames[state], counts.at(day * stateCount + state));
         }
-        return;
+        dayList.append(dayMap);
+    }
+    return dayList;
+}
+
+/**
+ * number of Order per bucket of bucketDays days from .. to
+ * one map per bucket: fromDate, toDate (inclusive), count
+ * the last bucket ends at toDate
+ */
+QVariantList DataManager::orderDateHistogram(const QDate& fromDate, const QDate& toDate,
+        const int& bucketDays)
+{
+    QVariantList bucketList;
+    if (!fromDate.isValid() || !toDate.isValid() || fromDate > toDate || bucketDays <= 0) {
+        return bucketList;
+    }
+    int dayCount = fromDate.daysTo(toDate) + 1;
+    int bucketCount = (dayCount + bucketDays - 1) / bucketDays;
+    QVector<int> counts = mOrderColumns.orderDateHistogram(OrderColumns::julianDay(fromDate), bucketDays,
+            bucketCount);
+    // orders after toDate inside the last bucket
+    int overflowFrom = OrderColumns::julianDay(toDate) + 1;
+    int overflowTo = OrderColumns::julianDay(fromDate) + bucketCount * bucketDays - 1;
+    if (overflowTo >= overflowFrom) {
+        counts[bucketCount - 1] -= mOrderColumns.countByOrderDate(overflowFrom, overflowTo);
+    }
+    bucketList.reserve(bucketCount);
+    for (int bucket = 0; bucket < bucketCount; ++bucket) {
+        QDate bucketFrom = fromDate.addDays(bucket * bucketDays);
+        QDate bucketTo = bucketFrom.addDays(bucketDays - 1);
+        QVariantMap bucketMap;
+        bucketMap.insert("fromDate", bucketFrom);
+        bucketMap.insert("toDate", bucketTo > toDate ? toDate : bucketTo);
+        bucketMap.insert("count", counts.at(bucket));
+        bucketList.append(bucketMap);
+    }
+    return bucketList;
+}
+
+/**
+ * number of Order per Department
+ * key: Department id as String
+ * withSubtree: each Department counts the Order of all its children too
+ * Order without Department are counted at key -1
+ */
+QVariantMap DataManager::orderCountsByDepartment(const bool& withSubtree)
+{
+    QVariantMap countMap;
+    QMap<int, int> depIdCounts = mOrderColumns.depIdCounts();
+    if (!withSubtree) {
+        QMap<int, int>::const_iterator it;
+        for (it = depIdCounts.constBegin(); it != depIdCounts.constEnd(); ++it) {
+            countMap.insert(QString::number(it.key()), it.value());
+        }
+        return countMap;
+    }
+    for (int i = 0; i < mAllDepartmentFlat.size(); ++i) {
+        Department* department;
+        department = (Department*) mAllDepartmentFlat.at(i);
+        int count = 0;
+        QSet<int> idSet = departmentSubtreeIds(department->id());
+        QSet<int>::const_iterator it;
+        for (it = idSet.constBegin(); it != idSet.constEnd(); ++it) {
+            count += depIdCounts.value(*it);
+        }
+        countMap.insert(QString::number(department->id()), count);
+    }
+    if (depIdCounts.contains(-1)) {
+        countMap.insert("-1", depIdCounts.value(-1));
     }
-    qDebug() << "no DataModel found for " << objectName;
+    return countMap;
 }
 
-void DataManager::insertItemIntoOrderDataModel(QString objectName, Order* listItem)
+/**
+ * number of Order per Customer
+ * key: Customer id as String
+ */
+QVariantMap DataManager::orderCountsByCustomer()
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            dataModel->insert(listItem);
-        }
-        return;
+    QVariantMap countMap;
+    QMap<int, int> customerIdCounts = mOrderColumns.customerIdCounts();
+    QMap<int, int>::const_iterator it;
+    for (it = customerIdCounts.constBegin(); it != customerIdCounts.constEnd(); ++it) {
+        countMap.insert(QString::number(it.key()), it.value());
     }
-    qDebug() << "no DataModel found for " << objectName;
+    return countMap;
 }
 
-// nr is DomainKey
-Order* DataManager::findOrderByNr(const int& nr){
-    for (int i = 0; i < mAllOrder.size(); ++i) {
-        Order* order;
-        order = (Order*)mAllOrder.at(i);
-        if(order->nr() == nr){
-            return order;
-        }
+/**
+ * keys (nr) of all Order matching the query map
+ * see OrderQuery.hpp for the keys of the map
+ */
+QVariantList DataManager::queryOrderKeys(const QVariantMap& queryMap)
+{
+    QList<Order*> orderList = queryOrder(OrderQuery(queryMap));
+    QVariantList keyList;
+    for (int i = 0; i < orderList.size(); ++i) {
+        keyList.append(orderList.at(i)->nr());
     }
-    qDebug() << "no Order found for nr " << nr;
-    return 0;
+    return keyList;
 }
+
 /*
  * reads Maps of Customer in from JSON cache
  * creates List of Customer*  from QVariantList
@@ -695,21 +1743,42 @@ Order* DataManager::findOrderByNr(const int& nr){
  */
 void DataManager::initCustomerFromCache()
 {
-	qDebug() << "start initCustomerFromCache";
-    mAllCustomer.clear();
-    QVariantList cacheList;
-    cacheList = readFromCache(cacheCustomer);
-    qDebug() << "read Customer from cache #" << cacheList.size();
-    for (int i = 0; i < cacheList.size(); ++i) {
-        QVariantMap cacheMap;
-        cacheMap = cacheList.at(i).toMap();
+	DATA_LOG(DATA_LOG_CACHE) << "start initCustomerFromCache";
+    mAllCustomer = readCustomerFromCache();
+    // Important: DataManager must be parent of all root DTOs
+    adoptRootDataObjects(mAllCustomer.objectList());
+    DATA_LOG(DATA_LOG_CACHE) << "created Customer* #" << mAllCustomer.size();
+}
+
+/*
+ * reads Customer from cache and creates Customer* without parent
+ * runs on any thread: created objects are moved to the thread of DataManager
+ */
+QList<QObject*> DataManager::readCustomerFromCache()
+{
+    TraceSpan span("readCustomerFromCache", "cache");
+    QElapsedTimer timer;
+    timer.start();
+    ScopedMetricsTimer parseTimer(&mMetrics, DataMetrics::PARSE_CUSTOMER);
+    QList<QObject*> customerList;
+    QFile cacheFile;
+    if (!openCacheFile(cacheCustomer, cacheFile)) {
+        return customerList;
+    }
+    // stream: only one Customer map in memory
+    QScopedPointer<DataReader> reader(DataReader::create(&cacheFile));
+    QVariantMap cacheMap;
+    while (reader->readNext(cacheMap)) {
         Customer* customer = new Customer();
-        // Important: DataManager must be parent of all root DTOs
-        customer->setParent(this);
         customer->fillFromCacheMap(cacheMap);
-        mAllCustomer.append(customer);
+        if (customer->thread() != thread()) {
+            customer->moveToThread(thread());
+        }
+        customerList.append(customer);
     }
-    qDebug() << "created Customer* #" << mAllCustomer.size();
+    mMetrics.increment(DataMetrics::PARSED_RECORDS, customerList.size());
+    recordInitStage("readCustomer", timer);
+    return customerList;
 }
 
 
@@ -720,17 +1789,30 @@ void DataManager::initCustomerFromCache()
  */
 void DataManager::saveCustomerToCache()
 {
-    QVariantList cacheList;
-    qDebug() << "now caching Customer* #" << mAllCustomer.size();
+    TraceSpan span("saveCustomerToCache", "cache");
+    ScopedMetricsTimer saveTimer(&mMetrics, DataMetrics::SAVE_CUSTOMER);
+    DATA_LOG(DATA_LOG_CACHE) << "now caching Customer* #" << mAllCustomer.size();
+    QFile cacheFile(dataPath(cacheCustomer));
+    if (!cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "cannot open cache to write: " << cacheFile.fileName();
+        return;
+    }
+    QScopedPointer<DataWriter> writer(createCacheWriter(&cacheFile));
+    writer->beginArray();
     for (int i = 0; i < mAllCustomer.size(); ++i) {
         Customer* customer;
         customer = (Customer*)mAllCustomer.at(i);
-        QVariantMap cacheMap;
-        cacheMap = customer->toCacheMap();
-        cacheList.append(cacheMap);
+        writer->beginObject();
+        customer->writeTo(writer.data(), DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+        writer->endObject();
+    }
+    writer->endArray();
+    if (!writer->flush()) {
+        qWarning() << "Customer* NOT written to cache";
+        return;
     }
-    qDebug() << "Customer* converted to JSON cache #" << cacheList.size();
-    writeToCache(cacheCustomer, cacheList);
+    mMetrics.increment(DataMetrics::SAVED_RECORDS, mAllCustomer.size());
+    DATA_LOG(DATA_LOG_CACHE) << "Customer* written to cache #" << mAllCustomer.size();
 }
 
 /**
@@ -774,7 +1856,7 @@ QVariantList DataManager::customerAsQVariantList()
 
 QList<QObject*> DataManager::allCustomer()
 {
-    return mAllCustomer;
+    return mAllCustomer.objectList();
 }
 
 QDeclarativeListProperty<Customer> DataManager::customerPropertyList()
@@ -832,15 +1914,8 @@ void DataManager::clearCustomerProperty(
 {
     DataManager *dataManager = qobject_cast<DataManager *>(customerList->object);
     if (dataManager) {
-        for (int i = 0; i < dataManager->mAllCustomer.size(); ++i) {
-            Customer* customer;
-            customer = (Customer*) dataManager->mAllCustomer.at(i);
-			emit dataManager->deletedFromAllCustomerById(customer->id());
-			emit dataManager->deletedFromAllCustomer(customer);
-            customer->deleteLater();
-            customer = 0;
-        }
-        dataManager->mAllCustomer.clear();
+        // one batch signal and one deferred delete for all Customer
+        dataManager->deleteCustomer();
     } else {
         qWarning() << "cannot clear mAllCustomer " << "Object is not of type DataManager*";
     }
@@ -849,18 +1924,11 @@ void DataManager::clearCustomerProperty(
 /**
  * deletes all Customer
  * and clears the list
+ * with one batchDeletedFromAllCustomer signal, deleted later together
  */
 void DataManager::deleteCustomer()
 {
-    for (int i = 0; i < mAllCustomer.size(); ++i) {
-        Customer* customer;
-        customer = (Customer*) mAllCustomer.at(i);
-        emit deletedFromAllCustomerById(customer->id());
-		emit deletedFromAllCustomer(customer);
-        customer->deleteLater();
-        customer = 0;
-     }
-     mAllCustomer.clear();
+    replaceAllCustomers(QList<Customer*>());
 }
 
 /**
@@ -887,7 +1955,7 @@ Customer* DataManager::createCustomer()
 void DataManager::undoCreateCustomer(Customer* customer)
 {
     if (customer) {
-        qDebug() << "undoCreateCustomer " << customer->id();
+        DATA_LOG(DATA_LOG_DTO) << "undoCreateCustomer " << customer->id();
         customer->deleteLater();
         customer = 0;
     }
@@ -932,141 +2000,137 @@ bool DataManager::deleteCustomer(Customer* customer)
 
 bool DataManager::deleteCustomerById(const int& id)
 {
-    for (int i = 0; i < mAllCustomer.size(); ++i) {
-        Customer* customer;
-        customer = (Customer*) mAllCustomer.at(i);
-        if (customer->id() == id) {
-            mAllCustomer.removeAt(i);
-            emit deletedFromAllCustomerById(id);
-            emit deletedFromAllCustomer(customer);
-            customer->deleteLater();
-            customer = 0;
-            return true;
-        }
+    int i = mAllCustomer.indexOfKey(id);
+    if (i < 0) {
+        return false;
     }
-    return false;
+    Customer* customer;
+    customer = (Customer*) mAllCustomer.at(i);
+    mAllCustomer.removeAt(i);
+    emit deletedFromAllCustomerById(id);
+    emit deletedFromAllCustomer(customer);
+    customer->deleteLater();
+    customer = 0;
+    return true;
 }
 
-void DataManager::fillCustomerDataModel(QString objectName)
-{
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-    	GroupDataModel* dataModel = dataModelList.last();
-    	if (dataModel) {
-        	QList<QObject*> theList;
-        	for (int i = 0; i < mAllCustomer.size(); ++i) {
-            	theList.append(mAllCustomer.at(i));
-        	}
-        	dataModel->clear();
-        	dataModel->insertList(theList);
-        	return;
-    	}
-    }
-    qDebug() << "NO GRP DATA FOUND Customer for " << objectName;
-}
 /**
- * removing and re-inserting a single item of a DataModel
- * this will cause the ListView to redraw or recalculate all values for this ListItem
- * we do this, because only changing properties won't call List functions
+ * inserts all Customer with one batchAddedToAllCustomer signal
+ * instead of addedToAllCustomer for each Customer
  */
-void DataManager::replaceItemInCustomerDataModel(QString objectName,
-        Customer* listItem)
+void DataManager::insertCustomers(const QList<Customer*>& customerList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                dataModel->insert(listItem);
-                return;
-            }
-            qDebug() << "Customer Object not found and not replaced in " << objectName;
-        }
+    if (customerList.isEmpty()) {
         return;
     }
-    qDebug() << "no DataModel found for " << objectName;
+    QList<int> keyList;
+    keyList.reserve(customerList.size());
+    mAllCustomer.reserve(mAllCustomer.size() + customerList.size());
+    for (int i = 0; i < customerList.size(); ++i) {
+        Customer* customer = customerList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        customer->setParent(this);
+        mAllCustomer.append(customer);
+        keyList.append(customer->id());
+    }
+    emit batchAddedToAllCustomer(keyRanges(keyList));
 }
 
-void DataManager::removeItemFromCustomerDataModel(QString objectName, Customer* listItem)
+/**
+ * deletes all Customer with id in idList - one pass over all Customer
+ * with one batchDeletedFromAllCustomer signal
+ * instead of deletedFromAllCustomer... for each Customer
+ * returns the number of deleted Customer
+ */
+int DataManager::deleteCustomers(const QVariantList& idList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                return;
-            }
-            qDebug() << "Customer Object not found and not removed from " << objectName;
+    QSet<int> idSet;
+    for (int i = 0; i < idList.size(); ++i) {
+        idSet.insert(idList.at(i).toInt());
+    }
+    QList<QObject*> deleteList;
+    QList<int> keyList;
+    for (int i = 0; i < mAllCustomer.size(); ++i) {
+        Customer* customer;
+        customer = (Customer*) mAllCustomer.at(i);
+        if (idSet.contains(customer->id())) {
+            invalidateOrderReferencesTo(customer);
+            deleteList.append(customer);
+            keyList.append(customer->id());
         }
-        return;
     }
-    qDebug() << "no DataModel found for " << objectName;
+    if (deleteList.isEmpty()) {
+        return 0;
+    }
+    for (int i = 0; i < deleteList.size(); ++i) {
+        mAllCustomer.removeOne(deleteList.at(i));
+    }
+    emit batchDeletedFromAllCustomer(keyRanges(keyList));
+    deleteAllLater(deleteList);
+    return deleteList.size();
 }
 
-void DataManager::insertItemIntoCustomerDataModel(QString objectName, Customer* listItem)
+/**
+ * replaces all Customer - per ex. after reload from server
+ * Order referencing the old Customer are resolved against the new ones
+ * emits batchDeletedFromAllCustomer for the old and batchAddedToAllCustomer for the new Customer
+ */
+void DataManager::replaceAllCustomers(const QList<Customer*>& customerList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            dataModel->insert(listItem);
-        }
-        return;
+    QSet<Order*> releasedOrders;
+    QList<QObject*> deleteList = mAllCustomer.objectList();
+    QList<int> keyList;
+    keyList.reserve(deleteList.size());
+    for (int i = 0; i < deleteList.size(); ++i) {
+        Customer* customer;
+        customer = (Customer*) deleteList.at(i);
+        releaseOrderReferencesTo(customer, releasedOrders);
+        keyList.append(customer->id());
+    }
+    mAllCustomer.clear();
+    QList<int> addedKeyList;
+    addedKeyList.reserve(customerList.size());
+    mAllCustomer.reserve(customerList.size());
+    for (int i = 0; i < customerList.size(); ++i) {
+        Customer* customer = customerList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        customer->setParent(this);
+        mAllCustomer.append(customer);
+        addedKeyList.append(customer->id());
     }
-    qDebug() << "no DataModel found for " << objectName;
+    resolveReleasedOrderReferences(releasedOrders);
+    if (!keyList.isEmpty()) {
+        emit batchDeletedFromAllCustomer(keyRanges(keyList));
+    }
+    if (!addedKeyList.isEmpty()) {
+        emit batchAddedToAllCustomer(keyRanges(addedKeyList));
+    }
+    deleteAllLater(deleteList);
 }
 
-void DataManager::fillCustomerDataModelByCompanyName(QString objectName, const QString& companyName)
+QList<QObject*> DataManager::listOfCustomerForCompanyName(const QString& companyName)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            QList<QObject*> theList;
-            for (int i = 0; i < mAllCustomer.size(); ++i) {
-                Customer* customer;
-                customer = (Customer*) mAllCustomer.at(i);
-                if (customer->companyName() == companyName) {
-                    theList.append(mAllCustomer.at(i));
-                }
-            }
-            dataModel->clear();
-            dataModel->insertList(theList);
-            qDebug() << "fillCustomerDataModelByCompanyName " << companyName << " (" << objectName << ") #"
-                    << theList.size();
-            return;
+    QList<QObject*> theList;
+    for (int i = 0; i < mAllCustomer.size(); ++i) {
+        Customer* customer;
+        customer = (Customer*) mAllCustomer.at(i);
+        if (customer->companyName() == companyName) {
+            theList.append(customer);
         }
     }
-    qDebug() << "NO GRP DATA FOUND Customer for " << objectName;
+    return theList;
 }
 
 // nr is DomainKey
 Customer* DataManager::findCustomerById(const int& id){
-    for (int i = 0; i < mAllCustomer.size(); ++i) {
-        Customer* customer;
-        customer = (Customer*)mAllCustomer.at(i);
-        if(customer->id() == id){
-            return customer;
-        }
+    Customer* customer;
+    customer = (Customer*) mAllCustomer.objectOfKey(id);
+    if (customer) {
+        mMetrics.increment(DataMetrics::FIND_HIT);
+        return customer;
     }
-    qDebug() << "no Customer found for id " << id;
+    DATA_LOG(DATA_LOG_FIND) << "no Customer found for id " << id;
+    mMetrics.increment(DataMetrics::FIND_MISS);
     return 0;
 }
 /*
@@ -1076,21 +2140,42 @@ Customer* DataManager::findCustomerById(const int& id){
  */
 void DataManager::initTopicFromCache()
 {
-	qDebug() << "start initTopicFromCache";
-    mAllTopic.clear();
-    QVariantList cacheList;
-    cacheList = readFromCache(cacheTopic);
-    qDebug() << "read Topic from cache #" << cacheList.size();
-    for (int i = 0; i < cacheList.size(); ++i) {
-        QVariantMap cacheMap;
-        cacheMap = cacheList.at(i).toMap();
+	DATA_LOG(DATA_LOG_CACHE) << "start initTopicFromCache";
+    mAllTopic = readTopicFromCache();
+    // Important: DataManager must be parent of all root DTOs
+    adoptRootDataObjects(mAllTopic.objectList());
+    DATA_LOG(DATA_LOG_CACHE) << "created Topic* #" << mAllTopic.size();
+}
+
+/*
+ * reads Topic from cache and creates Topic* without parent
+ * runs on any thread: created objects are moved to the thread of DataManager
+ */
+QList<QObject*> DataManager::readTopicFromCache()
+{
+    TraceSpan span("readTopicFromCache", "cache");
+    QElapsedTimer timer;
+    timer.start();
+    ScopedMetricsTimer parseTimer(&mMetrics, DataMetrics::PARSE_TOPIC);
+    QList<QObject*> topicList;
+    QFile cacheFile;
+    if (!openCacheFile(cacheTopic, cacheFile)) {
+        return topicList;
+    }
+    // stream: only one Topic map in memory
+    QScopedPointer<DataReader> reader(DataReader::create(&cacheFile));
+    QVariantMap cacheMap;
+    while (reader->readNext(cacheMap)) {
         Topic* topic = new Topic();
-        // Important: DataManager must be parent of all root DTOs
-        topic->setParent(this);
         topic->fillFromCacheMap(cacheMap);
-        mAllTopic.append(topic);
+        if (topic->thread() != thread()) {
+            topic->moveToThread(thread());
+        }
+        topicList.append(topic);
     }
-    qDebug() << "created Topic* #" << mAllTopic.size();
+    mMetrics.increment(DataMetrics::PARSED_RECORDS, topicList.size());
+    recordInitStage("readTopic", timer);
+    return topicList;
 }
 
 
@@ -1101,17 +2186,30 @@ void DataManager::initTopicFromCache()
  */
 void DataManager::saveTopicToCache()
 {
-    QVariantList cacheList;
-    qDebug() << "now caching Topic* #" << mAllTopic.size();
+    TraceSpan span("saveTopicToCache", "cache");
+    ScopedMetricsTimer saveTimer(&mMetrics, DataMetrics::SAVE_TOPIC);
+    DATA_LOG(DATA_LOG_CACHE) << "now caching Topic* #" << mAllTopic.size();
+    QFile cacheFile(dataPath(cacheTopic));
+    if (!cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "cannot open cache to write: " << cacheFile.fileName();
+        return;
+    }
+    QScopedPointer<DataWriter> writer(createCacheWriter(&cacheFile));
+    writer->beginArray();
     for (int i = 0; i < mAllTopic.size(); ++i) {
         Topic* topic;
         topic = (Topic*)mAllTopic.at(i);
-        QVariantMap cacheMap;
-        cacheMap = topic->toCacheMap();
-        cacheList.append(cacheMap);
+        writer->beginObject();
+        topic->writeTo(writer.data(), DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+        writer->endObject();
     }
-    qDebug() << "Topic* converted to JSON cache #" << cacheList.size();
-    writeToCache(cacheTopic, cacheList);
+    writer->endArray();
+    if (!writer->flush()) {
+        qWarning() << "Topic* NOT written to cache";
+        return;
+    }
+    mMetrics.increment(DataMetrics::SAVED_RECORDS, mAllTopic.size());
+    DATA_LOG(DATA_LOG_CACHE) << "Topic* written to cache #" << mAllTopic.size();
 }
 
 /**
@@ -1155,7 +2253,7 @@ QVariantList DataManager::topicAsQVariantList()
 
 QList<QObject*> DataManager::allTopic()
 {
-    return mAllTopic;
+    return mAllTopic.objectList();
 }
 
 QDeclarativeListProperty<Topic> DataManager::topicPropertyList()
@@ -1213,15 +2311,8 @@ void DataManager::clearTopicProperty(
 {
     DataManager *dataManager = qobject_cast<DataManager *>(topicList->object);
     if (dataManager) {
-        for (int i = 0; i < dataManager->mAllTopic.size(); ++i) {
-            Topic* topic;
-            topic = (Topic*) dataManager->mAllTopic.at(i);
-			emit dataManager->deletedFromAllTopicByUuid(topic->uuid());
-			emit dataManager->deletedFromAllTopic(topic);
-            topic->deleteLater();
-            topic = 0;
-        }
-        dataManager->mAllTopic.clear();
+        // one batch signal and one deferred delete for all Topic
+        dataManager->deleteTopic();
     } else {
         qWarning() << "cannot clear mAllTopic " << "Object is not of type DataManager*";
     }
@@ -1230,18 +2321,11 @@ void DataManager::clearTopicProperty(
 /**
  * deletes all Topic
  * and clears the list
+ * with one batchDeletedFromAllTopic signal, deleted later together
  */
 void DataManager::deleteTopic()
 {
-    for (int i = 0; i < mAllTopic.size(); ++i) {
-        Topic* topic;
-        topic = (Topic*) mAllTopic.at(i);
-        emit deletedFromAllTopicByUuid(topic->uuid());
-		emit deletedFromAllTopic(topic);
-        topic->deleteLater();
-        topic = 0;
-     }
-     mAllTopic.clear();
+    replaceAllTopics(QList<Topic*>());
 }
 
 /**
@@ -1268,7 +2352,7 @@ Topic* DataManager::createTopic()
 void DataManager::undoCreateTopic(Topic* topic)
 {
     if (topic) {
-        qDebug() << "undoCreateTopic " << topic->id();
+        DATA_LOG(DATA_LOG_DTO) << "undoCreateTopic " << topic->id();
         topic->deleteLater();
         topic = 0;
     }
@@ -1313,7 +2397,7 @@ bool DataManager::deleteTopic(Topic* topic)
 bool DataManager::deleteTopicByUuid(const QString& uuid)
 {
     if (uuid.isNull() || uuid.isEmpty()) {
-        qDebug() << "cannot delete Topic from empty uuid";
+        DATA_LOG(DATA_LOG_DTO) << "cannot delete Topic from empty uuid";
         return false;
     }
     for (int i = 0; i < mAllTopic.size(); ++i) {
@@ -1333,129 +2417,143 @@ bool DataManager::deleteTopicByUuid(const QString& uuid)
 
 bool DataManager::deleteTopicById(const int& id)
 {
-    for (int i = 0; i < mAllTopic.size(); ++i) {
-        Topic* topic;
-        topic = (Topic*) mAllTopic.at(i);
-        if (topic->id() == id) {
-            mAllTopic.removeAt(i);
-            emit deletedFromAllTopicById(id);
-            emit deletedFromAllTopic(topic);
-            topic->deleteLater();
-            topic = 0;
-            return true;
-        }
+    int i = mAllTopic.indexOfKey(id);
+    if (i < 0) {
+        return false;
     }
-    return false;
+    Topic* topic;
+    topic = (Topic*) mAllTopic.at(i);
+    mAllTopic.removeAt(i);
+    emit deletedFromAllTopicById(id);
+    emit deletedFromAllTopic(topic);
+    topic->deleteLater();
+    topic = 0;
+    return true;
 }
 
-void DataManager::fillTopicDataModel(QString objectName)
-{
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-    	GroupDataModel* dataModel = dataModelList.last();
-    	if (dataModel) {
-        	QList<QObject*> theList;
-        	for (int i = 0; i < mAllTopic.size(); ++i) {
-            	theList.append(mAllTopic.at(i));
-        	}
-        	dataModel->clear();
-        	dataModel->insertList(theList);
-        	return;
-    	}
-    }
-    qDebug() << "NO GRP DATA FOUND Topic for " << objectName;
-}
 /**
- * removing and re-inserting a single item of a DataModel
- * this will cause the ListView to redraw or recalculate all values for this ListItem
- * we do this, because only changing properties won't call List functions
+ * inserts all Topic with one batchAddedToAllTopic signal
+ * instead of addedToAllTopic for each Topic
  */
-void DataManager::replaceItemInTopicDataModel(QString objectName,
-        Topic* listItem)
+void DataManager::insertTopics(const QList<Topic*>& topicList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                dataModel->insert(listItem);
-                return;
-            }
-            qDebug() << "Topic Object not found and not replaced in " << objectName;
-        }
+    if (topicList.isEmpty()) {
         return;
     }
-    qDebug() << "no DataModel found for " << objectName;
+    QStringList keyList;
+    keyList.reserve(topicList.size());
+    mAllTopic.reserve(mAllTopic.size() + topicList.size());
+    for (int i = 0; i < topicList.size(); ++i) {
+        Topic* topic = topicList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        topic->setParent(this);
+        mAllTopic.append(topic);
+        keyList.append(topic->uuid());
+    }
+    emit batchAddedToAllTopic(keyList);
 }
 
-void DataManager::removeItemFromTopicDataModel(QString objectName, Topic* listItem)
+/**
+ * deletes all Topic with uuid in uuidList - one pass over all Topic
+ * with one batchDeletedFromAllTopic signal
+ * instead of deletedFromAllTopic... for each Topic
+ * returns the number of deleted Topic
+ */
+int DataManager::deleteTopics(const QVariantList& uuidList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                return;
-            }
-            qDebug() << "Topic Object not found and not removed from " << objectName;
+    QSet<QString> uuidSet;
+    for (int i = 0; i < uuidList.size(); ++i) {
+        uuidSet.insert(uuidList.at(i).toString());
+    }
+    QList<QObject*> deleteList;
+    QStringList keyList;
+    for (int i = 0; i < mAllTopic.size(); ++i) {
+        Topic* topic;
+        topic = (Topic*) mAllTopic.at(i);
+        if (uuidSet.contains(topic->uuid())) {
+            invalidateOrderReferencesTo(topic);
+            deleteList.append(topic);
+            keyList.append(topic->uuid());
         }
-        return;
     }
-    qDebug() << "no DataModel found for " << objectName;
+    if (deleteList.isEmpty()) {
+        return 0;
+    }
+    for (int i = 0; i < deleteList.size(); ++i) {
+        mAllTopic.removeOne(deleteList.at(i));
+    }
+    emit batchDeletedFromAllTopic(keyList);
+    deleteAllLater(deleteList);
+    return deleteList.size();
 }
 
-void DataManager::insertItemIntoTopicDataModel(QString objectName, Topic* listItem)
+/**
+ * replaces all Topic - per ex. after reload from server
+ * Order referencing the old Topic are resolved against the new ones
+ * emits batchDeletedFromAllTopic for the old and batchAddedToAllTopic for the new Topic
+ */
+void DataManager::replaceAllTopics(const QList<Topic*>& topicList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            dataModel->insert(listItem);
-        }
-        return;
+    QSet<Order*> releasedOrders;
+    QList<QObject*> deleteList = mAllTopic.objectList();
+    QStringList keyList;
+    keyList.reserve(deleteList.size());
+    for (int i = 0; i < deleteList.size(); ++i) {
+        Topic* topic;
+        topic = (Topic*) deleteList.at(i);
+        releaseOrderReferencesTo(topic, releasedOrders);
+        keyList.append(topic->uuid());
     }
-    qDebug() << "no DataModel found for " << objectName;
+    mAllTopic.clear();
+    QStringList addedKeyList;
+    addedKeyList.reserve(topicList.size());
+    mAllTopic.reserve(topicList.size());
+    for (int i = 0; i < topicList.size(); ++i) {
+        Topic* topic = topicList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        topic->setParent(this);
+        mAllTopic.append(topic);
+        addedKeyList.append(topic->uuid());
+    }
+    resolveReleasedOrderReferences(releasedOrders);
+    if (!keyList.isEmpty()) {
+        emit batchDeletedFromAllTopic(keyList);
+    }
+    if (!addedKeyList.isEmpty()) {
+        emit batchAddedToAllTopic(addedKeyList);
+    }
+    deleteAllLater(deleteList);
 }
+
 Topic* DataManager::findTopicByUuid(const QString& uuid){
     if (uuid.isNull() || uuid.isEmpty()) {
-        qDebug() << "cannot find Topic from empty uuid";
+        DATA_LOG(DATA_LOG_FIND) << "cannot find Topic from empty uuid";
+        mMetrics.increment(DataMetrics::FIND_MISS);
         return 0;
     }
     for (int i = 0; i < mAllTopic.size(); ++i) {
         Topic* topic;
         topic = (Topic*)mAllTopic.at(i);
         if(topic->uuid() == uuid){
+            mMetrics.increment(DataMetrics::FIND_HIT);
             return topic;
         }
     }
-    qDebug() << "no Topic found for uuid " << uuid;
+    DATA_LOG(DATA_LOG_FIND) << "no Topic found for uuid " << uuid;
+    mMetrics.increment(DataMetrics::FIND_MISS);
     return 0;
 }
 
 // nr is DomainKey
 Topic* DataManager::findTopicById(const int& id){
-    for (int i = 0; i < mAllTopic.size(); ++i) {
-        Topic* topic;
-        topic = (Topic*)mAllTopic.at(i);
-        if(topic->id() == id){
-            return topic;
-        }
+    Topic* topic;
+    topic = (Topic*) mAllTopic.objectOfKey(id);
+    if (topic) {
+        mMetrics.increment(DataMetrics::FIND_HIT);
+        return topic;
     }
-    qDebug() << "no Topic found for id " << id;
+    DATA_LOG(DATA_LOG_FIND) << "no Topic found for id " << id;
+    mMetrics.increment(DataMetrics::FIND_MISS);
     return 0;
 }
 /*
@@ -1465,25 +2563,77 @@ Topic* DataManager::findTopicById(const int& id){
  */
 void DataManager::initDepartmentFromCache()
 {
-	qDebug() << "start initDepartmentFromCache";
-    mAllDepartment.clear();
-    mAllDepartmentFlat.clear();
-    QVariantList cacheList;
-    cacheList = readFromCache(cacheDepartment);
-    qDebug() << "read Department from cache #" << cacheList.size();
-    for (int i = 0; i < cacheList.size(); ++i) {
-        QVariantMap cacheMap;
-        cacheMap = cacheList.at(i).toMap();
+	DATA_LOG(DATA_LOG_CACHE) << "start initDepartmentFromCache";
+    mAllDepartment = readDepartmentFromCache();
+    // Important: DataManager must be parent of all root DTOs
+    adoptRootDataObjects(mAllDepartment.objectList());
+    fillDepartmentFlat();
+    DATA_LOG(DATA_LOG_CACHE) << "created Tree of Department* #" << mAllDepartment.size();
+    DATA_LOG(DATA_LOG_CACHE) << "created Flat list of Department* #" << mAllDepartmentFlat.size();
+}
+
+/*
+ * reads Department from cache and creates Department* without parent
+ * runs on any thread: created objects are moved to the thread of DataManager
+ */
+QList<QObject*> DataManager::readDepartmentFromCache()
+{
+    TraceSpan span("readDepartmentFromCache", "cache");
+    QElapsedTimer timer;
+    timer.start();
+    ScopedMetricsTimer parseTimer(&mMetrics, DataMetrics::PARSE_DEPARTMENT);
+    QList<QObject*> departmentList;
+    QFile cacheFile;
+    if (!openCacheFile(cacheDepartment, cacheFile)) {
+        return departmentList;
+    }
+    // stream: only one Department map in memory
+    QScopedPointer<DataReader> reader(DataReader::create(&cacheFile));
+    QVariantMap cacheMap;
+    while (reader->readNext(cacheMap)) {
         Department* department = new Department();
-        // Important: DataManager must be parent of all root DTOs
-        department->setParent(this);
         department->fillFromCacheMap(cacheMap);
-        mAllDepartment.append(department);
+        if (department->thread() != thread()) {
+            department->moveToThread(thread());
+        }
+        departmentList.append(department);
+    }
+    mMetrics.increment(DataMetrics::PARSED_RECORDS, departmentList.size());
+    recordInitStage("readDepartment", timer);
+    return departmentList;
+}
+
+/*
+ * flat list of all Department* of the tree (in memory only)
+ */
+void DataManager::fillDepartmentFlat()
+{
+    TraceSpan span("fillDepartmentFlat", "index");
+    mAllDepartmentFlat.clear();
+    for (int i = 0; i < mAllDepartment.size(); ++i) {
+        Department* department;
+        department = (Department*) mAllDepartment.at(i);
         mAllDepartmentFlat.append(department);
-        mAllDepartmentFlat.append(department->allDepartmentChildren());
+        QList<QObject*> children = department->allDepartmentChildren();
+        for (int c = 0; c < children.size(); ++c) {
+            mAllDepartmentFlat.append(children.at(c));
+        }
     }
-    qDebug() << "created Tree of Department* #" << mAllDepartment.size();
-    qDebug() << "created Flat list of Department* #" << mAllDepartmentFlat.size();
+}
+
+// id of the Department and of all its children
+QSet<int> DataManager::departmentSubtreeIds(const int& id)
+{
+    QSet<int> idSet;
+    idSet.insert(id);
+    Department* department = findDepartmentById(id);
+    if (department) {
+        QList<QObject*> children = department->allDepartmentChildren();
+        for (int i = 0; i < children.size(); ++i) {
+            idSet.insert(((Department*) children.at(i))->id());
+        }
+    }
+    return idSet;
 }
 
 
@@ -1495,17 +2645,30 @@ void DataManager::initDepartmentFromCache()
  */
 void DataManager::saveDepartmentToCache()
 {
-    QVariantList cacheList;
-    qDebug() << "now caching Department* #" << mAllDepartment.size();
+    TraceSpan span("saveDepartmentToCache", "cache");
+    ScopedMetricsTimer saveTimer(&mMetrics, DataMetrics::SAVE_DEPARTMENT);
+    DATA_LOG(DATA_LOG_CACHE) << "now caching Department* #" << mAllDepartment.size();
+    QFile cacheFile(dataPath(cacheDepartment));
+    if (!cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "cannot open cache to write: " << cacheFile.fileName();
+        return;
+    }
+    QScopedPointer<DataWriter> writer(createCacheWriter(&cacheFile));
+    writer->beginArray();
     for (int i = 0; i < mAllDepartment.size(); ++i) {
         Department* department;
         department = (Department*)mAllDepartment.at(i);
-        QVariantMap cacheMap;
-        cacheMap = department->toCacheMap();
-        cacheList.append(cacheMap);
+        writer->beginObject();
+        department->writeTo(writer.data(), DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+        writer->endObject();
+    }
+    writer->endArray();
+    if (!writer->flush()) {
+        qWarning() << "Department* NOT written to cache";
+        return;
     }
-    qDebug() << "Department* converted to JSON cache #" << cacheList.size();
-    writeToCache(cacheDepartment, cacheList);
+    mMetrics.increment(DataMetrics::SAVED_RECORDS, mAllDepartment.size());
+    DATA_LOG(DATA_LOG_CACHE) << "Department* written to cache #" << mAllDepartment.size();
 }
 
 /**
@@ -1549,7 +2712,13 @@ QVariantList DataManager::departmentAsQVariantList()
 
 QList<QObject*> DataManager::allDepartment()
 {
-    return mAllDepartment;
+    return mAllDepartment.objectList();
+}
+
+// all Department of the tree - roots and children
+QList<QObject*> DataManager::allDepartmentFlat()
+{
+    return mAllDepartmentFlat.objectList();
 }
 
 QDeclarativeListProperty<Department> DataManager::departmentPropertyList()
@@ -1607,15 +2776,8 @@ void DataManager::clearDepartmentProperty(
 {
     DataManager *dataManager = qobject_cast<DataManager *>(departmentList->object);
     if (dataManager) {
-        for (int i = 0; i < dataManager->mAllDepartment.size(); ++i) {
-            Department* department;
-            department = (Department*) dataManager->mAllDepartment.at(i);
-			emit dataManager->deletedFromAllDepartmentByUuid(department->uuid());
-			emit dataManager->deletedFromAllDepartment(department);
-            department->deleteLater();
-            department = 0;
-        }
-        dataManager->mAllDepartment.clear();
+        // one batch signal and one deferred delete for all Department
+        dataManager->deleteDepartment();
     } else {
         qWarning() << "cannot clear mAllDepartment " << "Object is not of type DataManager*";
     }
@@ -1624,18 +2786,11 @@ void DataManager::clearDepartmentProperty(
 /**
  * deletes all Department
  * and clears the list
+ * with one batchDeletedFromAllDepartment signal, deleted later together
  */
 void DataManager::deleteDepartment()
 {
-    for (int i = 0; i < mAllDepartment.size(); ++i) {
-        Department* department;
-        department = (Department*) mAllDepartment.at(i);
-        emit deletedFromAllDepartmentByUuid(department->uuid());
-		emit deletedFromAllDepartment(department);
-        department->deleteLater();
-        department = 0;
-     }
-     mAllDepartment.clear();
+    replaceAllDepartments(QList<Department*>());
 }
 
 /**
@@ -1662,7 +2817,7 @@ Department* DataManager::createDepartment()
 void DataManager::undoCreateDepartment(Department* department)
 {
     if (department) {
-        qDebug() << "undoCreateDepartment " << department->id();
+        DATA_LOG(DATA_LOG_DTO) << "undoCreateDepartment " << department->id();
         department->deleteLater();
         department = 0;
     }
@@ -1710,7 +2865,7 @@ bool DataManager::deleteDepartment(Department* department)
 bool DataManager::deleteDepartmentByUuid(const QString& uuid)
 {
     if (uuid.isNull() || uuid.isEmpty()) {
-        qDebug() << "cannot delete Department from empty uuid";
+        DATA_LOG(DATA_LOG_DTO) << "cannot delete Department from empty uuid";
         return false;
     }
     for (int i = 0; i < mAllDepartment.size(); ++i) {
@@ -1729,152 +2884,152 @@ bool DataManager::deleteDepartmentByUuid(const QString& uuid)
     return false;
 }
 
+// only roots are deleted - children are found by id, but belong to their parent
 bool DataManager::deleteDepartmentById(const int& id)
 {
-    for (int i = 0; i < mAllDepartment.size(); ++i) {
-        Department* department;
-        department = (Department*) mAllDepartment.at(i);
-        if (department->id() == id) {
-            mAllDepartment.removeAt(i);
-            mAllDepartmentFlat.removeOne(department);
-            emit deletedFromAllDepartmentById(id);
-            emit deletedFromAllDepartment(department);
-            department->deleteLater();
-            department = 0;
-            return true;
-        }
-    }
-    return false;
-}
-
-void DataManager::fillDepartmentTreeDataModel(QString objectName)
-{
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-    	GroupDataModel* dataModel = dataModelList.last();
-    	if (dataModel) {
-        	QList<QObject*> theList;
-        	for (int i = 0; i < mAllDepartment.size(); ++i) {
-            	theList.append(mAllDepartment.at(i));
-        	}
-        	dataModel->clear();
-        	dataModel->insertList(theList);
-        	return;
-    	}
-    }
-    qDebug() << "NO GRP DATA FOUND Department for " << objectName;
-}
-void DataManager::fillDepartmentFlatDataModel(QString objectName)
-{
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-    	GroupDataModel* dataModel = dataModelList.last();
-    	if (dataModel) {
-        	QList<QObject*> theList;
-        	for (int i = 0; i < mAllDepartmentFlat.size(); ++i) {
-            	theList.append(mAllDepartmentFlat.at(i));
-        	}
-        	dataModel->clear();
-        	dataModel->insertList(theList);
-        	return;
-    	}
+    Department* department;
+    department = (Department*) mAllDepartmentFlat.objectOfKey(id);
+    if (!department || !mAllDepartment.removeOne(department)) {
+        return false;
     }
-    qDebug() << "NO GRP DATA FOUND Department for " << objectName;
+    mAllDepartmentFlat.removeOne(department);
+    emit deletedFromAllDepartmentById(id);
+    emit deletedFromAllDepartment(department);
+    department->deleteLater();
+    department = 0;
+    return true;
 }
+
 /**
- * removing and re-inserting a single item of a DataModel
- * this will cause the ListView to redraw or recalculate all values for this ListItem
- * we do this, because only changing properties won't call List functions
+ * inserts all Department with one batchAddedToAllDepartment signal
+ * instead of addedToAllDepartment for each Department
  */
-void DataManager::replaceItemInDepartmentDataModel(QString objectName,
-        Department* listItem)
+void DataManager::insertDepartments(const QList<Department*>& departmentList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                dataModel->insert(listItem);
-                return;
-            }
-            qDebug() << "Department Object not found and not replaced in " << objectName;
-        }
+    if (departmentList.isEmpty()) {
         return;
     }
-    qDebug() << "no DataModel found for " << objectName;
+    QStringList keyList;
+    keyList.reserve(departmentList.size());
+    mAllDepartment.reserve(mAllDepartment.size() + departmentList.size());
+    for (int i = 0; i < departmentList.size(); ++i) {
+        Department* department = departmentList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        department->setParent(this);
+        mAllDepartment.append(department);
+        keyList.append(department->uuid());
+    }
+    fillDepartmentFlat();
+    emit batchAddedToAllDepartment(keyList);
 }
 
-void DataManager::removeItemFromDepartmentDataModel(QString objectName, Department* listItem)
+/**
+ * deletes all Department with uuid in uuidList - one pass over all Department
+ * with one batchDeletedFromAllDepartment signal
+ * instead of deletedFromAllDepartment... for each Department
+ * returns the number of deleted Department
+ */
+int DataManager::deleteDepartments(const QVariantList& uuidList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                return;
-            }
-            qDebug() << "Department Object not found and not removed from " << objectName;
+    QSet<QString> uuidSet;
+    for (int i = 0; i < uuidList.size(); ++i) {
+        uuidSet.insert(uuidList.at(i).toString());
+    }
+    QList<QObject*> deleteList;
+    QStringList keyList;
+    for (int i = 0; i < mAllDepartment.size(); ++i) {
+        Department* department;
+        department = (Department*) mAllDepartment.at(i);
+        if (uuidSet.contains(department->uuid())) {
+            onDeletedFromAllDepartment(department);
+            deleteList.append(department);
+            keyList.append(department->uuid());
         }
-        return;
     }
-    qDebug() << "no DataModel found for " << objectName;
+    if (deleteList.isEmpty()) {
+        return 0;
+    }
+    for (int i = 0; i < deleteList.size(); ++i) {
+        mAllDepartment.removeOne(deleteList.at(i));
+    }
+    fillDepartmentFlat();
+    emit batchDeletedFromAllDepartment(keyList);
+    deleteAllLater(deleteList);
+    return deleteList.size();
 }
 
-void DataManager::insertItemIntoDepartmentDataModel(QString objectName, Department* listItem)
+/**
+ * replaces all Department - per ex. after reload from server
+ * Order referencing the old Department are resolved against the new ones
+ * emits batchDeletedFromAllDepartment for the old and batchAddedToAllDepartment for the new Department
+ */
+void DataManager::replaceAllDepartments(const QList<Department*>& departmentList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            dataModel->insert(listItem);
+    QSet<Order*> releasedOrders;
+    QList<QObject*> deleteList = mAllDepartment.objectList();
+    QStringList keyList;
+    keyList.reserve(deleteList.size());
+    for (int i = 0; i < deleteList.size(); ++i) {
+        Department* department;
+        department = (Department*) deleteList.at(i);
+        releaseOrderReferencesTo(department, releasedOrders);
+        QList<QObject*> children = department->allDepartmentChildren();
+        for (int c = 0; c < children.size(); ++c) {
+            releaseOrderReferencesTo(children.at(c), releasedOrders);
         }
-        return;
+        keyList.append(department->uuid());
     }
-    qDebug() << "no DataModel found for " << objectName;
+    mAllDepartment.clear();
+    QStringList addedKeyList;
+    addedKeyList.reserve(departmentList.size());
+    mAllDepartment.reserve(departmentList.size());
+    for (int i = 0; i < departmentList.size(); ++i) {
+        Department* department = departmentList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        department->setParent(this);
+        mAllDepartment.append(department);
+        addedKeyList.append(department->uuid());
+    }
+    fillDepartmentFlat();
+    resolveReleasedOrderReferences(releasedOrders);
+    if (!keyList.isEmpty()) {
+        emit batchDeletedFromAllDepartment(keyList);
+    }
+    if (!addedKeyList.isEmpty()) {
+        emit batchAddedToAllDepartment(addedKeyList);
+    }
+    deleteAllLater(deleteList);
 }
+
 Department* DataManager::findDepartmentByUuid(const QString& uuid){
     if (uuid.isNull() || uuid.isEmpty()) {
-        qDebug() << "cannot find Department from empty uuid";
+        DATA_LOG(DATA_LOG_FIND) << "cannot find Department from empty uuid";
+        mMetrics.increment(DataMetrics::FIND_MISS);
         return 0;
     }
     for (int i = 0; i < mAllDepartmentFlat.size(); ++i) {
         Department* department;
         department = (Department*)mAllDepartmentFlat.at(i);
         if(department->uuid() == uuid){
+            mMetrics.increment(DataMetrics::FIND_HIT);
             return department;
         }
     }
-    qDebug() << "no Department found for uuid " << uuid;
+    DATA_LOG(DATA_LOG_FIND) << "no Department found for uuid " << uuid;
+    mMetrics.increment(DataMetrics::FIND_MISS);
     return 0;
 }
 
 // nr is DomainKey
 Department* DataManager::findDepartmentById(const int& id){
-    for (int i = 0; i < mAllDepartmentFlat.size(); ++i) {
-        Department* department;
-        department = (Department*)mAllDepartmentFlat.at(i);
-        if(department->id() == id){
-            return department;
-        }
+    Department* department;
+    department = (Department*) mAllDepartmentFlat.objectOfKey(id);
+    if (department) {
+        mMetrics.increment(DataMetrics::FIND_HIT);
+        return department;
     }
-    qDebug() << "no Department found for id " << id;
+    DATA_LOG(DATA_LOG_FIND) << "no Department found for id " << id;
+    mMetrics.increment(DataMetrics::FIND_MISS);
     return 0;
 }
 /*
@@ -1884,21 +3039,28 @@ Department* DataManager::findDepartmentById(const int& id){
  */
 void DataManager::initTagFromCache()
 {
-	qDebug() << "start initTagFromCache";
+    TraceSpan span("initTagFromCache", "cache");
+	DATA_LOG(DATA_LOG_CACHE) << "start initTagFromCache";
+    ScopedMetricsTimer parseTimer(&mMetrics, DataMetrics::PARSE_TAG);
     mAllTag.clear();
-    QVariantList cacheList;
-    cacheList = readFromCache(cacheTag);
-    qDebug() << "read Tag from cache #" << cacheList.size();
-    for (int i = 0; i < cacheList.size(); ++i) {
-        QVariantMap cacheMap;
-        cacheMap = cacheList.at(i).toMap();
+    mTagByHandle.clear();
+    QFile cacheFile;
+    if (!openCacheFile(cacheTag, cacheFile)) {
+        return;
+    }
+    // stream: only one Tag map in memory
+    QScopedPointer<DataReader> reader(DataReader::create(&cacheFile));
+    QVariantMap cacheMap;
+    while (reader->readNext(cacheMap)) {
         Tag* tag = new Tag();
         // Important: DataManager must be parent of all root DTOs
         tag->setParent(this);
         tag->fillFromCacheMap(cacheMap);
         mAllTag.append(tag);
+        addToTagByHandle(tag);
     }
-    qDebug() << "created Tag* #" << mAllTag.size();
+    mMetrics.increment(DataMetrics::PARSED_RECORDS, mAllTag.size());
+    DATA_LOG(DATA_LOG_CACHE) << "created Tag* #" << mAllTag.size();
 }
 
 /*
@@ -1907,15 +3069,18 @@ void DataManager::initTagFromCache()
  */
 void DataManager::initTagFromSqlCache()
 {
-	qDebug() << "start initTag From S Q L Cache";
+    TraceSpan span("initTagFromSqlCache", "sql");
+	DATA_LOG(DATA_LOG_SQL) << "start initTag From S Q L Cache";
+    ScopedMetricsTimer parseTimer(&mMetrics, DataMetrics::PARSE_TAG);
 	mAllTag.clear();
+	mTagByHandle.clear();
     QString sqlQuery = "SELECT * FROM tag";
     QSqlQuery query (mDatabase);
     query.setForwardOnly(true);
     query.prepare(sqlQuery);
     bool success = query.exec();
     if(!success) {
-    	qDebug() << "NO SUCCESS query tag";
+    	DATA_LOG(DATA_LOG_SQL) << "NO SUCCESS query tag";
     	return;
     }
     QSqlRecord record = query.record();
@@ -1927,8 +3092,11 @@ void DataManager::initTagFromSqlCache()
     		tag->setParent(this);
     		tag->fillFromSqlQuery(query);
     		mAllTag.append(tag);
+    		addToTagByHandle(tag);
     	}
-    qDebug() << "read from SQLite and created Tag* #" << mAllTag.size();
+    mMetrics.increment(DataMetrics::PARSED_RECORDS, mAllTag.size());
+    mMetrics.increment(DataMetrics::SQL_ROWS, mAllTag.size());
+    DATA_LOG(DATA_LOG_SQL) << "read from SQLite and created Tag* #" << mAllTag.size();
 }
 
 /*
@@ -1939,17 +3107,30 @@ void DataManager::initTagFromSqlCache()
  */
 void DataManager::saveTagToCache()
 {
-    QVariantList cacheList;
-    qDebug() << "now caching Tag* #" << mAllTag.size();
+    TraceSpan span("saveTagToCache", "cache");
+    ScopedMetricsTimer saveTimer(&mMetrics, DataMetrics::SAVE_TAG);
+    DATA_LOG(DATA_LOG_CACHE) << "now caching Tag* #" << mAllTag.size();
+    QFile cacheFile(dataPath(cacheTag));
+    if (!cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "cannot open cache to write: " << cacheFile.fileName();
+        return;
+    }
+    QScopedPointer<DataWriter> writer(createCacheWriter(&cacheFile));
+    writer->beginArray();
     for (int i = 0; i < mAllTag.size(); ++i) {
         Tag* tag;
         tag = (Tag*)mAllTag.at(i);
-        QVariantMap cacheMap;
-        cacheMap = tag->toCacheMap();
-        cacheList.append(cacheMap);
+        writer->beginObject();
+        tag->writeTo(writer.data(), DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+        writer->endObject();
     }
-    qDebug() << "Tag* converted to JSON cache #" << cacheList.size();
-    writeToCache(cacheTag, cacheList);
+    writer->endArray();
+    if (!writer->flush()) {
+        qWarning() << "Tag* NOT written to cache";
+        return;
+    }
+    mMetrics.increment(DataMetrics::SAVED_RECORDS, mAllTag.size());
+    DATA_LOG(DATA_LOG_CACHE) << "Tag* written to cache #" << mAllTag.size();
 }
 
 /*
@@ -1962,7 +3143,9 @@ void DataManager::saveTagToCache()
  */
 void DataManager::saveTagToSqlCache()
 {
-    qDebug() << "now caching Tag* #" << mAllTag.size();
+    TraceSpan span("saveTagToSqlCache", "sql");
+    ScopedMetricsTimer saveTimer(&mMetrics, DataMetrics::SAVE_TAG);
+    DATA_LOG(DATA_LOG_CACHE) << "now caching Tag* #" << mAllTag.size();
     bulkImport(true);
     bool success = false;
     QSqlQuery query (mDatabase);
@@ -1973,7 +3156,7 @@ void DataManager::saveTagToSqlCache()
         bulkImport(false);
         return;
     }
-    qDebug() << "table DROPPED tag";
+    DATA_LOG(DATA_LOG_SQL) << "table DROPPED tag";
     // create table
     query.clear();
     query.prepare(Tag::createTableCommand());
@@ -1983,9 +3166,9 @@ void DataManager::saveTagToSqlCache()
         bulkImport(false);
         return;
     }
-    qDebug() << "table CREATED tag";
+    DATA_LOG(DATA_LOG_SQL) << "table CREATED tag";
 
-	qDebug() << "BEGIN INSERT chunks of tag";
+	DATA_LOG(DATA_LOG_SQL) << "BEGIN INSERT chunks of tag";
     //
     QVariantList uuidList, nameList, valueList, colorList;
     QString insertSQL = Tag::createParameterizedInsertPosBinding();
@@ -1994,14 +3177,15 @@ void DataManager::saveTagToSqlCache()
         laps ++;
     }
     int count = 0;
-    qDebug() << "chunks of " << mChunkSize << " laps: " << laps;
+    DATA_LOG(DATA_LOG_SQL) << "chunks of " << mChunkSize << " laps: " << laps;
     int fromPos = 0;
     int toPos = mChunkSize;
     if(toPos > mAllTag.size()) {
         toPos = mAllTag.size();
     }
     while (count < laps) {
-    	//
+    	ScopedMetricsTimer batchTimer(&mMetrics, DataMetrics::SQL_BATCH);
+    	TraceSpan batchSpan("insertTagBatch", "sql");
     	query.clear();
     	query.prepare("BEGIN TRANSACTION");
     	success = query.exec();
@@ -2033,6 +3217,7 @@ void DataManager::saveTagToSqlCache()
         	bulkImport(false);
         	return;
     	}
+    	mMetrics.increment(DataMetrics::SQL_ROWS, toPos - fromPos);
     	query.clear();
     	query.prepare("END TRANSACTION");
     	success = query.exec();
@@ -2049,7 +3234,7 @@ void DataManager::saveTagToSqlCache()
             toPos = mAllTag.size();
         }
     }
-    qDebug() << "END INSERT chunks of tag";
+    DATA_LOG(DATA_LOG_SQL) << "END INSERT chunks of tag";
     bulkImport(false);
 }
 /**
@@ -2059,29 +3244,97 @@ void DataManager::saveTagToSqlCache()
 QList<Tag*> DataManager::listOfTagForKeys(
         QStringList keyList)
 {
-    QList<Tag*> listOfData;
     keyList.removeDuplicates();
-    if (keyList.isEmpty()) {
-        return listOfData;
+    QVector<int> handleList;
+    handleList.reserve(keyList.size());
+    for (int i = 0; i < keyList.size(); ++i) {
+        if (keyList.at(i).isEmpty()) {
+            continue;
+        }
+        // keys from outside: unknown uuids are not registered
+        int handle = Tag::findHandleForUuid(keyList.at(i));
+        if (handle < 0) {
+            DATA_LOG(DATA_LOG_FIND) << "unknown Tag uuid " << keyList.at(i);
+            continue;
+        }
+        handleList.append(handle);
     }
-    for (int i = 0; i < mAllTag.size(); ++i) {
+    return listOfTagForHandles(handleList);
+}
+
+/**
+* converts a list of Tag handles in to a list of Tag*
+* handles are array positions - no String compare
+*/
+QList<Tag*> DataManager::listOfTagForHandles(
+        const QVector<int>& handleList)
+{
+    QList<Tag*> listOfData;
+    QStringList missingKeys;
+    for (int i = 0; i < handleList.size(); ++i) {
         Tag* tag;
-        tag = (Tag*) mAllTag.at(i);
-        if (keyList.contains(tag->uuid())) {
+        tag = findTagByHandle(handleList.at(i));
+        if (!tag) {
+            missingKeys << Tag::uuidForHandle(handleList.at(i));
+            continue;
+        }
+        if (!listOfData.contains(tag)) {
             listOfData.append(tag);
-            keyList.removeOne(tag->uuid());
-            if(keyList.isEmpty()){
-                break;
-            }
         }
     }
-    if (keyList.isEmpty()) {
-        return listOfData;
+    if (!missingKeys.isEmpty()) {
+        qWarning() << "not all keys found for Tag: " << missingKeys.join(", ");
     }
-    qWarning() << "not all keys found for Tag: " << keyList.join(", ");
     return listOfData;
 }
 
+Tag* DataManager::findTagByHandle(const int& handle)
+{
+    if (handle < 0 || handle >= mTagByHandle.size()) {
+        return 0;
+    }
+    return mTagByHandle.at(handle);
+}
+
+/*
+ * the Tag follows changes of its uuid (see onTagHandleChanged())
+ */
+void DataManager::addToTagByHandle(Tag* tag)
+{
+    int handle = tag->handle();
+    if (handle < 0) {
+        return;
+    }
+    if (handle >= mTagByHandle.size()) {
+        mTagByHandle.resize(handle + 1);
+    }
+    mTagByHandle[handle] = tag;
+    QObject::connect(tag, SIGNAL(handleChanged(Tag*, int)), this, SLOT(onTagHandleChanged(Tag*, int)),
+            Qt::UniqueConnection);
+}
+
+void DataManager::removeFromTagByHandle(Tag* tag)
+{
+    int handle = tag->handle();
+    if (handle >= 0 && handle < mTagByHandle.size() && mTagByHandle.at(handle) == tag) {
+        mTagByHandle[handle] = 0;
+    }
+    QObject::disconnect(tag, SIGNAL(handleChanged(Tag*, int)), this, SLOT(onTagHandleChanged(Tag*, int)));
+}
+
+/*
+ * uuid of a Tag changed: move it from the old to the new handle
+ * Tags no longer indexed (per ex. after clearing the list) are ignored
+ */
+void DataManager::onTagHandleChanged(Tag* tag, int oldHandle)
+{
+    if (oldHandle < 0 || oldHandle >= mTagByHandle.size() || mTagByHandle.at(oldHandle) != tag) {
+        return;
+    }
+    mTagByHandle[oldHandle] = 0;
+    addToTagByHandle(tag);
+}
+
 QVariantList DataManager::tagAsQVariantList()
 {
     QVariantList tagList;
@@ -2093,7 +3346,7 @@ QVariantList DataManager::tagAsQVariantList()
 
 QList<QObject*> DataManager::allTag()
 {
-    return mAllTag;
+    return mAllTag.objectList();
 }
 
 QDeclarativeListProperty<Tag> DataManager::tagPropertyList()
@@ -2113,6 +3366,7 @@ void DataManager::appendToTagProperty(
     if (dataManagerObject) {
         tag->setParent(dataManagerObject);
         dataManagerObject->mAllTag.append(tag);
+        dataManagerObject->addToTagByHandle(tag);
         emit dataManagerObject->addedToAllTag(tag);
     } else {
         qWarning() << "cannot append Tag* to mAllTag "
@@ -2151,15 +3405,8 @@ void DataManager::clearTagProperty(
 {
     DataManager *dataManager = qobject_cast<DataManager *>(tagList->object);
     if (dataManager) {
-        for (int i = 0; i < dataManager->mAllTag.size(); ++i) {
-            Tag* tag;
-            tag = (Tag*) dataManager->mAllTag.at(i);
-			emit dataManager->deletedFromAllTagByUuid(tag->uuid());
-			emit dataManager->deletedFromAllTag(tag);
-            tag->deleteLater();
-            tag = 0;
-        }
-        dataManager->mAllTag.clear();
+        // one batch signal and one deferred delete for all Tag
+        dataManager->deleteTag();
     } else {
         qWarning() << "cannot clear mAllTag " << "Object is not of type DataManager*";
     }
@@ -2168,18 +3415,11 @@ void DataManager::clearTagProperty(
 /**
  * deletes all Tag
  * and clears the list
+ * with one batchDeletedFromAllTag signal, deleted later together
  */
 void DataManager::deleteTag()
 {
-    for (int i = 0; i < mAllTag.size(); ++i) {
-        Tag* tag;
-        tag = (Tag*) mAllTag.at(i);
-        emit deletedFromAllTagByUuid(tag->uuid());
-		emit deletedFromAllTag(tag);
-        tag->deleteLater();
-        tag = 0;
-     }
-     mAllTag.clear();
+    replaceAllTags(QList<Tag*>());
 }
 
 /**
@@ -2206,7 +3446,7 @@ Tag* DataManager::createTag()
 void DataManager::undoCreateTag(Tag* tag)
 {
     if (tag) {
-        qDebug() << "undoCreateTag " << tag->uuid();
+        DATA_LOG(DATA_LOG_DTO) << "undoCreateTag " << tag->uuid();
         tag->deleteLater();
         tag = 0;
     }
@@ -2217,6 +3457,7 @@ void DataManager::insertTag(Tag* tag)
     // Important: DataManager must be parent of all root DTOs
     tag->setParent(this);
     mAllTag.append(tag);
+    addToTagByHandle(tag);
     emit addedToAllTag(tag);
 }
 
@@ -2231,6 +3472,7 @@ void DataManager::insertTagFromMap(const QVariantMap& tagMap,
         tag->fillFromMap(tagMap);
     }
     mAllTag.append(tag);
+    addToTagByHandle(tag);
     emit addedToAllTag(tag);
 }
 
@@ -2241,6 +3483,7 @@ bool DataManager::deleteTag(Tag* tag)
     if (!ok) {
         return ok;
     }
+    removeFromTagByHandle(tag);
     emit deletedFromAllTagByUuid(tag->uuid());
     emit deletedFromAllTag(tag);
     tag->deleteLater();
@@ -2251,120 +3494,138 @@ bool DataManager::deleteTag(Tag* tag)
 bool DataManager::deleteTagByUuid(const QString& uuid)
 {
     if (uuid.isNull() || uuid.isEmpty()) {
-        qDebug() << "cannot delete Tag from empty uuid";
+        DATA_LOG(DATA_LOG_DTO) << "cannot delete Tag from empty uuid";
         return false;
     }
-    for (int i = 0; i < mAllTag.size(); ++i) {
-        Tag* tag;
-        tag = (Tag*) mAllTag.at(i);
-        if (tag->uuid() == uuid) {
-            mAllTag.removeAt(i);
-            emit deletedFromAllTagByUuid(uuid);
-            emit deletedFromAllTag(tag);
-            tag->deleteLater();
-            tag = 0;
-            return true;
-        }
+    // mTagByHandle follows uuid changes (see onTagHandleChanged())
+    Tag* tag;
+    tag = findTagByHandle(Tag::findHandleForUuid(uuid));
+    if (!tag || !mAllTag.removeOne(tag)) {
+        return false;
     }
-    return false;
+    removeFromTagByHandle(tag);
+    emit deletedFromAllTagByUuid(uuid);
+    emit deletedFromAllTag(tag);
+    tag->deleteLater();
+    tag = 0;
+    return true;
 }
 
 
-void DataManager::fillTagDataModel(QString objectName)
-{
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-    	GroupDataModel* dataModel = dataModelList.last();
-    	if (dataModel) {
-        	QList<QObject*> theList;
-        	for (int i = 0; i < mAllTag.size(); ++i) {
-            	theList.append(mAllTag.at(i));
-        	}
-        	dataModel->clear();
-        	dataModel->insertList(theList);
-        	return;
-    	}
-    }
-    qDebug() << "NO GRP DATA FOUND Tag for " << objectName;
-}
 /**
- * removing and re-inserting a single item of a DataModel
- * this will cause the ListView to redraw or recalculate all values for this ListItem
- * we do this, because only changing properties won't call List functions
+ * inserts all Tag with one batchAddedToAllTag signal
+ * instead of addedToAllTag for each Tag
  */
-void DataManager::replaceItemInTagDataModel(QString objectName,
-        Tag* listItem)
+void DataManager::insertTags(const QList<Tag*>& tagList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                dataModel->insert(listItem);
-                return;
-            }
-            qDebug() << "Tag Object not found and not replaced in " << objectName;
-        }
+    if (tagList.isEmpty()) {
         return;
     }
-    qDebug() << "no DataModel found for " << objectName;
+    QStringList keyList;
+    keyList.reserve(tagList.size());
+    mAllTag.reserve(mAllTag.size() + tagList.size());
+    for (int i = 0; i < tagList.size(); ++i) {
+        Tag* tag = tagList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        tag->setParent(this);
+        mAllTag.append(tag);
+        addToTagByHandle(tag);
+        keyList.append(tag->uuid());
+    }
+    emit batchAddedToAllTag(keyList);
 }
 
-void DataManager::removeItemFromTagDataModel(QString objectName, Tag* listItem)
+/**
+ * deletes all Tag with uuid in uuidList - one pass over all Tag
+ * with one batchDeletedFromAllTag signal
+ * instead of deletedFromAllTag... for each Tag
+ * returns the number of deleted Tag
+ */
+int DataManager::deleteTags(const QVariantList& uuidList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                return;
-            }
-            qDebug() << "Tag Object not found and not removed from " << objectName;
+    QSet<QString> uuidSet;
+    for (int i = 0; i < uuidList.size(); ++i) {
+        uuidSet.insert(uuidList.at(i).toString());
+    }
+    QList<QObject*> deleteList;
+    QStringList keyList;
+    for (int i = 0; i < mAllTag.size(); ++i) {
+        Tag* tag;
+        tag = (Tag*) mAllTag.at(i);
+        if (uuidSet.contains(tag->uuid())) {
+            removeFromTagByHandle(tag);
+            invalidateOrderReferencesTo(tag);
+            deleteList.append(tag);
+            keyList.append(tag->uuid());
         }
-        return;
     }
-    qDebug() << "no DataModel found for " << objectName;
+    if (deleteList.isEmpty()) {
+        return 0;
+    }
+    for (int i = 0; i < deleteList.size(); ++i) {
+        mAllTag.removeOne(deleteList.at(i));
+    }
+    emit batchDeletedFromAllTag(keyList);
+    deleteAllLater(deleteList);
+    return deleteList.size();
 }
 
-void DataManager::insertItemIntoTagDataModel(QString objectName, Tag* listItem)
+/**
+ * replaces all Tag - per ex. after reload from server
+ * Order referencing the old Tag are resolved against the new ones
+ * emits batchDeletedFromAllTag for the old and batchAddedToAllTag for the new Tag
+ */
+void DataManager::replaceAllTags(const QList<Tag*>& tagList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            dataModel->insert(listItem);
-        }
-        return;
+    QSet<Order*> releasedOrders;
+    QList<QObject*> deleteList = mAllTag.objectList();
+    QStringList keyList;
+    keyList.reserve(deleteList.size());
+    for (int i = 0; i < deleteList.size(); ++i) {
+        Tag* tag;
+        tag = (Tag*) deleteList.at(i);
+        releaseOrderReferencesTo(tag, releasedOrders);
+        removeFromTagByHandle(tag);
+        keyList.append(tag->uuid());
+    }
+    mAllTag.clear();
+    QStringList addedKeyList;
+    addedKeyList.reserve(tagList.size());
+    mAllTag.reserve(tagList.size());
+    for (int i = 0; i < tagList.size(); ++i) {
+        Tag* tag = tagList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        tag->setParent(this);
+        mAllTag.append(tag);
+        addedKeyList.append(tag->uuid());
+    }
+    for (int i = 0; i < mAllTag.size(); ++i) {
+        addToTagByHandle((Tag*) mAllTag.at(i));
+    }
+    resolveReleasedOrderReferences(releasedOrders);
+    if (!keyList.isEmpty()) {
+        emit batchDeletedFromAllTag(keyList);
     }
-    qDebug() << "no DataModel found for " << objectName;
+    if (!addedKeyList.isEmpty()) {
+        emit batchAddedToAllTag(addedKeyList);
+    }
+    deleteAllLater(deleteList);
 }
+
 Tag* DataManager::findTagByUuid(const QString& uuid){
     if (uuid.isNull() || uuid.isEmpty()) {
-        qDebug() << "cannot find Tag from empty uuid";
+        DATA_LOG(DATA_LOG_FIND) << "cannot find Tag from empty uuid";
+        mMetrics.increment(DataMetrics::FIND_MISS);
         return 0;
     }
-    for (int i = 0; i < mAllTag.size(); ++i) {
-        Tag* tag;
-        tag = (Tag*)mAllTag.at(i);
-        if(tag->uuid() == uuid){
-            return tag;
-        }
+    Tag* tag;
+    tag = findTagByHandle(Tag::findHandleForUuid(uuid));
+    if (tag) {
+        mMetrics.increment(DataMetrics::FIND_HIT);
+        return tag;
     }
-    qDebug() << "no Tag found for uuid " << uuid;
+    DATA_LOG(DATA_LOG_FIND) << "no Tag found for uuid " << uuid;
+    mMetrics.increment(DataMetrics::FIND_MISS);
     return 0;
 }
 
@@ -2375,21 +3636,42 @@ Tag* DataManager::findTagByUuid(const QString& uuid){
  */
 void DataManager::initXtrasFromCache()
 {
-	qDebug() << "start initXtrasFromCache";
-    mAllXtras.clear();
-    QVariantList cacheList;
-    cacheList = readFromCache(cacheXtras);
-    qDebug() << "read Xtras from cache #" << cacheList.size();
-    for (int i = 0; i < cacheList.size(); ++i) {
-        QVariantMap cacheMap;
-        cacheMap = cacheList.at(i).toMap();
+	DATA_LOG(DATA_LOG_CACHE) << "start initXtrasFromCache";
+    mAllXtras = readXtrasFromCache();
+    // Important: DataManager must be parent of all root DTOs
+    adoptRootDataObjects(mAllXtras.objectList());
+    DATA_LOG(DATA_LOG_CACHE) << "created Xtras* #" << mAllXtras.size();
+}
+
+/*
+ * reads Xtras from cache and creates Xtras* without parent
+ * runs on any thread: created objects are moved to the thread of DataManager
+ */
+QList<QObject*> DataManager::readXtrasFromCache()
+{
+    TraceSpan span("readXtrasFromCache", "cache");
+    QElapsedTimer timer;
+    timer.start();
+    ScopedMetricsTimer parseTimer(&mMetrics, DataMetrics::PARSE_XTRAS);
+    QList<QObject*> xtrasList;
+    QFile cacheFile;
+    if (!openCacheFile(cacheXtras, cacheFile)) {
+        return xtrasList;
+    }
+    // stream: only one Xtras map in memory
+    QScopedPointer<DataReader> reader(DataReader::create(&cacheFile));
+    QVariantMap cacheMap;
+    while (reader->readNext(cacheMap)) {
         Xtras* xtras = new Xtras();
-        // Important: DataManager must be parent of all root DTOs
-        xtras->setParent(this);
         xtras->fillFromCacheMap(cacheMap);
-        mAllXtras.append(xtras);
+        if (xtras->thread() != thread()) {
+            xtras->moveToThread(thread());
+        }
+        xtrasList.append(xtras);
     }
-    qDebug() << "created Xtras* #" << mAllXtras.size();
+    mMetrics.increment(DataMetrics::PARSED_RECORDS, xtrasList.size());
+    recordInitStage("readXtras", timer);
+    return xtrasList;
 }
 
 
@@ -2400,17 +3682,30 @@ void DataManager::initXtrasFromCache()
  */
 void DataManager::saveXtrasToCache()
 {
-    QVariantList cacheList;
-    qDebug() << "now caching Xtras* #" << mAllXtras.size();
+    TraceSpan span("saveXtrasToCache", "cache");
+    ScopedMetricsTimer saveTimer(&mMetrics, DataMetrics::SAVE_XTRAS);
+    DATA_LOG(DATA_LOG_CACHE) << "now caching Xtras* #" << mAllXtras.size();
+    QFile cacheFile(dataPath(cacheXtras));
+    if (!cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "cannot open cache to write: " << cacheFile.fileName();
+        return;
+    }
+    QScopedPointer<DataWriter> writer(createCacheWriter(&cacheFile));
+    writer->beginArray();
     for (int i = 0; i < mAllXtras.size(); ++i) {
         Xtras* xtras;
         xtras = (Xtras*)mAllXtras.at(i);
-        QVariantMap cacheMap;
-        cacheMap = xtras->toCacheMap();
-        cacheList.append(cacheMap);
+        writer->beginObject();
+        xtras->writeTo(writer.data(), DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+        writer->endObject();
     }
-    qDebug() << "Xtras* converted to JSON cache #" << cacheList.size();
-    writeToCache(cacheXtras, cacheList);
+    writer->endArray();
+    if (!writer->flush()) {
+        qWarning() << "Xtras* NOT written to cache";
+        return;
+    }
+    mMetrics.increment(DataMetrics::SAVED_RECORDS, mAllXtras.size());
+    DATA_LOG(DATA_LOG_CACHE) << "Xtras* written to cache #" << mAllXtras.size();
 }
 
 /**
@@ -2454,7 +3749,7 @@ QVariantList DataManager::xtrasAsQVariantList()
 
 QList<QObject*> DataManager::allXtras()
 {
-    return mAllXtras;
+    return mAllXtras.objectList();
 }
 
 QDeclarativeListProperty<Xtras> DataManager::xtrasPropertyList()
@@ -2512,15 +3807,8 @@ void DataManager::clearXtrasProperty(
 {
     DataManager *dataManager = qobject_cast<DataManager *>(xtrasList->object);
     if (dataManager) {
-        for (int i = 0; i < dataManager->mAllXtras.size(); ++i) {
-            Xtras* xtras;
-            xtras = (Xtras*) dataManager->mAllXtras.at(i);
-			emit dataManager->deletedFromAllXtrasById(xtras->id());
-			emit dataManager->deletedFromAllXtras(xtras);
-            xtras->deleteLater();
-            xtras = 0;
-        }
-        dataManager->mAllXtras.clear();
+        // one batch signal and one deferred delete for all Xtras
+        dataManager->deleteXtras();
     } else {
         qWarning() << "cannot clear mAllXtras " << "Object is not of type DataManager*";
     }
@@ -2529,18 +3817,11 @@ void DataManager::clearXtrasProperty(
 /**
  * deletes all Xtras
  * and clears the list
+ * with one batchDeletedFromAllXtras signal, deleted later together
  */
 void DataManager::deleteXtras()
 {
-    for (int i = 0; i < mAllXtras.size(); ++i) {
-        Xtras* xtras;
-        xtras = (Xtras*) mAllXtras.at(i);
-        emit deletedFromAllXtrasById(xtras->id());
-		emit deletedFromAllXtras(xtras);
-        xtras->deleteLater();
-        xtras = 0;
-     }
-     mAllXtras.clear();
+    replaceAllXtrasList(QList<Xtras*>());
 }
 
 /**
@@ -2567,7 +3848,7 @@ Xtras* DataManager::createXtras()
 void DataManager::undoCreateXtras(Xtras* xtras)
 {
     if (xtras) {
-        qDebug() << "undoCreateXtras " << xtras->id();
+        DATA_LOG(DATA_LOG_DTO) << "undoCreateXtras " << xtras->id();
         xtras->deleteLater();
         xtras = 0;
     }
@@ -2612,125 +3893,133 @@ bool DataManager::deleteXtras(Xtras* xtras)
 
 bool DataManager::deleteXtrasById(const int& id)
 {
-    for (int i = 0; i < mAllXtras.size(); ++i) {
-        Xtras* xtras;
-        xtras = (Xtras*) mAllXtras.at(i);
-        if (xtras->id() == id) {
-            mAllXtras.removeAt(i);
-            emit deletedFromAllXtrasById(id);
-            emit deletedFromAllXtras(xtras);
-            xtras->deleteLater();
-            xtras = 0;
-            return true;
-        }
+    int i = mAllXtras.indexOfKey(id);
+    if (i < 0) {
+        return false;
     }
-    return false;
+    Xtras* xtras;
+    xtras = (Xtras*) mAllXtras.at(i);
+    mAllXtras.removeAt(i);
+    emit deletedFromAllXtrasById(id);
+    emit deletedFromAllXtras(xtras);
+    xtras->deleteLater();
+    xtras = 0;
+    return true;
 }
 
-void DataManager::fillXtrasDataModel(QString objectName)
-{
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-    	GroupDataModel* dataModel = dataModelList.last();
-    	if (dataModel) {
-        	QList<QObject*> theList;
-        	for (int i = 0; i < mAllXtras.size(); ++i) {
-            	theList.append(mAllXtras.at(i));
-        	}
-        	dataModel->clear();
-        	dataModel->insertList(theList);
-        	return;
-    	}
-    }
-    qDebug() << "NO GRP DATA FOUND Xtras for " << objectName;
-}
 /**
- * removing and re-inserting a single item of a DataModel
- * this will cause the ListView to redraw or recalculate all values for this ListItem
- * we do this, because only changing properties won't call List functions
+ * inserts all Xtras with one batchAddedToAllXtras signal
+ * instead of addedToAllXtras for each Xtras
  */
-void DataManager::replaceItemInXtrasDataModel(QString objectName,
-        Xtras* listItem)
+void DataManager::insertXtrasList(const QList<Xtras*>& xtrasList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                dataModel->insert(listItem);
-                return;
-            }
-            qDebug() << "Xtras Object not found and not replaced in " << objectName;
-        }
+    if (xtrasList.isEmpty()) {
         return;
     }
-    qDebug() << "no DataModel found for " << objectName;
+    QList<int> keyList;
+    keyList.reserve(xtrasList.size());
+    mAllXtras.reserve(mAllXtras.size() + xtrasList.size());
+    for (int i = 0; i < xtrasList.size(); ++i) {
+        Xtras* xtras = xtrasList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        xtras->setParent(this);
+        mAllXtras.append(xtras);
+        keyList.append(xtras->id());
+    }
+    emit batchAddedToAllXtras(keyRanges(keyList));
 }
 
-void DataManager::removeItemFromXtrasDataModel(QString objectName, Xtras* listItem)
+/**
+ * deletes all Xtras with id in idList - one pass over all Xtras
+ * with one batchDeletedFromAllXtras signal
+ * instead of deletedFromAllXtras... for each Xtras
+ * returns the number of deleted Xtras
+ */
+int DataManager::deleteXtrasList(const QVariantList& idList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            bool exists = dataModel->remove(listItem);
-            if (exists) {
-                return;
-            }
-            qDebug() << "Xtras Object not found and not removed from " << objectName;
+    QSet<int> idSet;
+    for (int i = 0; i < idList.size(); ++i) {
+        idSet.insert(idList.at(i).toInt());
+    }
+    QList<QObject*> deleteList;
+    QList<int> keyList;
+    for (int i = 0; i < mAllXtras.size(); ++i) {
+        Xtras* xtras;
+        xtras = (Xtras*) mAllXtras.at(i);
+        if (idSet.contains(xtras->id())) {
+            invalidateOrderReferencesTo(xtras);
+            deleteList.append(xtras);
+            keyList.append(xtras->id());
         }
-        return;
     }
-    qDebug() << "no DataModel found for " << objectName;
+    if (deleteList.isEmpty()) {
+        return 0;
+    }
+    for (int i = 0; i < deleteList.size(); ++i) {
+        mAllXtras.removeOne(deleteList.at(i));
+    }
+    emit batchDeletedFromAllXtras(keyRanges(keyList));
+    deleteAllLater(deleteList);
+    return deleteList.size();
 }
 
-void DataManager::insertItemIntoXtrasDataModel(QString objectName, Xtras* listItem)
+/**
+ * replaces all Xtras - per ex. after reload from server
+ * Order referencing the old Xtras are resolved against the new ones
+ * emits batchDeletedFromAllXtras for the old and batchAddedToAllXtras for the new Xtras
+ */
+void DataManager::replaceAllXtrasList(const QList<Xtras*>& xtrasList)
 {
-    // using dynamic created Pages / Lists it's a good idea to use findChildren ... last()
-    // probably there are GroupDataModels not deleted yet from previous destroyed Pages
-    QList<GroupDataModel*> dataModelList = Application::instance()->scene()->findChildren<
-            GroupDataModel*>(objectName);
-    if (dataModelList.size() > 0) {
-        GroupDataModel* dataModel = dataModelList.last();
-        if (dataModel) {
-            dataModel->insert(listItem);
-        }
-        return;
+    QSet<Order*> releasedOrders;
+    QList<QObject*> deleteList = mAllXtras.objectList();
+    QList<int> keyList;
+    keyList.reserve(deleteList.size());
+    for (int i = 0; i < deleteList.size(); ++i) {
+        Xtras* xtras;
+        xtras = (Xtras*) deleteList.at(i);
+        releaseOrderReferencesTo(xtras, releasedOrders);
+        keyList.append(xtras->id());
+    }
+    mAllXtras.clear();
+    QList<int> addedKeyList;
+    addedKeyList.reserve(xtrasList.size());
+    mAllXtras.reserve(xtrasList.size());
+    for (int i = 0; i < xtrasList.size(); ++i) {
+        Xtras* xtras = xtrasList.at(i);
+        // Important: DataManager must be parent of all root DTOs
+        xtras->setParent(this);
+        mAllXtras.append(xtras);
+        addedKeyList.append(xtras->id());
+    }
+    resolveReleasedOrderReferences(releasedOrders);
+    if (!keyList.isEmpty()) {
+        emit batchDeletedFromAllXtras(keyRanges(keyList));
     }
-    qDebug() << "no DataModel found for " << objectName;
+    if (!addedKeyList.isEmpty()) {
+        emit batchAddedToAllXtras(keyRanges(addedKeyList));
+    }
+    deleteAllLater(deleteList);
 }
 
 // nr is DomainKey
 Xtras* DataManager::findXtrasById(const int& id){
-    for (int i = 0; i < mAllXtras.size(); ++i) {
-        Xtras* xtras;
-        xtras = (Xtras*)mAllXtras.at(i);
-        if(xtras->id() == id){
-            return xtras;
-        }
+    Xtras* xtras;
+    xtras = (Xtras*) mAllXtras.objectOfKey(id);
+    if (xtras) {
+        mMetrics.increment(DataMetrics::FIND_HIT);
+        return xtras;
     }
-    qDebug() << "no Xtras found for id " << id;
+    DATA_LOG(DATA_LOG_FIND) << "no Xtras found for id " << id;
+    mMetrics.increment(DataMetrics::FIND_MISS);
     return 0;
 }
 
 /*
- * reads data in from stored cache
+ * opens the stored cache to read
  * if no cache found tries to get data from assets/datamodel
  */
-QVariantList DataManager::readFromCache(QString& fileName)
+bool DataManager::openCacheFile(QString& fileName, QFile& cacheFile)
 {
-    JsonDataAccess jda;
-    QVariantList cacheList;
     QFile dataFile(dataPath(fileName));
     if (!dataFile.exists()) {
         QFile assetDataFile(dataAssetsPath(fileName));
@@ -2738,32 +4027,72 @@ QVariantList DataManager::readFromCache(QString& fileName)
             // copy file from assets to data
             bool copyOk = assetDataFile.copy(dataPath(fileName));
             if (!copyOk) {
-                qDebug() << "cannot copy dataAssetsPath(fileName) to dataPath(fileName)";
+                DATA_LOG(DATA_LOG_CACHE) << "cannot copy dataAssetsPath(fileName) to dataPath(fileName)";
                 // no cache, no assets - empty list
-                return cacheList;
+                return false;
             }
         } else {
             // no cache, no assets - empty list
-            return cacheList;
+            return false;
         }
     }
-    cacheList = jda.load(dataPath(fileName)).toList();
+    cacheFile.setFileName(dataPath(fileName));
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "cannot open cache to read: " << cacheFile.fileName();
+        return false;
+    }
+    return true;
+}
+
+/*
+ * reads data in from stored cache as one QVariantList
+ * caches of DataObjects are streamed by the init...FromCache() methods
+ */
+QVariantList DataManager::readFromCache(QString& fileName)
+{
+    QVariantList cacheList;
+    QFile cacheFile;
+    if (!openCacheFile(fileName, cacheFile)) {
+        return cacheList;
+    }
+    QScopedPointer<DataReader> reader(DataReader::create(&cacheFile));
+    QVariantMap cacheMap;
+    while (reader->readNext(cacheMap)) {
+        cacheList.append(cacheMap);
+    }
     return cacheList;
 }
 
-void DataManager::writeToCache(QString& fileName, QVariantList& data)
+/*
+ * DataWriter to stream DataObjects into the cache file
+ * no QVariantMaps / QVariantList are created
+ */
+DataWriter* DataManager::createCacheWriter(QIODevice* device)
+{
+    if (mUseBinaryCache) {
+        return new BinaryDataWriter(device);
+    }
+    return new JsonDataWriter(device);
+}
+
+/**
+ * caches are written as JSON (default) or binary
+ * reading detects the format, so existing caches stay readable
+ * and file names don't change
+ */
+void DataManager::setUseBinaryCache(const bool& useBinaryCache)
 {
-    QString filePath;
-    filePath = dataPath(fileName);
-    JsonDataAccess jda;
-    jda.save(data, filePath);
+    mUseBinaryCache = useBinaryCache;
 }
 
-void DataManager::onManualExit()
+/**
+ * Order caches with more records are written in chunks
+ * of recordsPerCacheChunk, parsed in parallel while reading
+ * 0: never write chunks
+ */
+void DataManager::setRecordsPerCacheChunk(const int& recordsPerCacheChunk)
 {
-    qDebug() << "## DataManager ## MANUAL EXIT";
-    finish();
-    bb::Application::instance()->exit(0);
+    mRecordsPerCacheChunk = recordsPerCacheChunk;
 }
 
 DataManager::~DataManager()
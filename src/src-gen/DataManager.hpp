@@ -4,6 +4,9 @@
 #include <qobject.h>
 #include <QStringList>
 #include <QtSql/QtSql>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QTimer>
 
 #include "Order.hpp"
 #include "Item.hpp"
@@ -16,7 +19,18 @@
 #include "Xtras.hpp"
 #include "../GeoCoordinate.hpp"
 #include  "../GeoAddress.hpp"
-
+#include "../StringPool.hpp"
+#include "../OrderQuery.hpp"
+#include "../OrderColumns.hpp"
+#include "../OrderSearchIndex.hpp"
+#include "../BarcodeIndex.hpp"
+#include "../DenseObjectList.hpp"
+#include "../OrderReferenceIndex.hpp"
+#include "../DataMetrics.hpp"
+#include "../OrderEviction.hpp"
+#include "../ChunkedCache.hpp"
+
+// plain Qt - the Cascades GroupDataModel glue is in ../CascadesDataManager.hpp
 class DataManager: public QObject
 {
 Q_OBJECT
@@ -35,18 +49,11 @@ public:
     Q_INVOKABLE
     void init();
 
-	
-	Q_INVOKABLE
-	void fillOrderDataModel(QString objectName);
-
-	Q_INVOKABLE
-	void replaceItemInOrderDataModel(QString objectName, Order* listItem);
-
-	Q_INVOKABLE
-	void removeItemFromOrderDataModel(QString objectName, Order* listItem);
+    // writes all caches - called on exit
+    void finish();
+    // Tag is read-only: only written if Tags are imported
+    void saveTagToSqlCache();
 
-	Q_INVOKABLE
-	void insertItemIntoOrderDataModel(QString objectName, Order* listItem);
 
 	Q_INVOKABLE
 	void resolveOrderReferences(Order* order);
@@ -87,27 +94,57 @@ public:
 	Q_INVOKABLE
 	bool deleteOrderByNr(const int& nr);
 
+	void insertOrders(const QList<Order*>& orderList);
+
+	Q_INVOKABLE
+	int deleteOrders(const QVariantList& nrList);
+
+	void replaceAllOrders(const QList<Order*>& orderList);
+
 	Q_INVOKABLE
     Order* findOrderByNr(const int& nr);
-	
+
+	QList<Order*> queryOrder(OrderQuery query);
+
+	Q_INVOKABLE
+	QVariantList queryOrderKeys(const QVariantMap& queryMap);
+
+	Q_INVOKABLE
+	QVariantList searchOrders(const QString& text, const int& limit);
+
+	Q_INVOKABLE
+	SubItem* findSubItemByBarcode(const QString& barcode);
+
+	Q_INVOKABLE
+	Order* findOrderByBarcode(const QString& barcode);
+
+	Q_INVOKABLE
+	QVariantMap orderReferenceStatistics();
+
+	Q_INVOKABLE
+	QVariantMap orderStateCounts();
+
 	Q_INVOKABLE
-	void fillCustomerDataModel(QString objectName);
+	int orderExpressCount();
 
 	Q_INVOKABLE
-	void replaceItemInCustomerDataModel(QString objectName, Customer* listItem);
+	QVariantList orderStateCountsByDay(const QDate& fromDate, const QDate& toDate);
 
 	Q_INVOKABLE
-	void removeItemFromCustomerDataModel(QString objectName, Customer* listItem);
+	QVariantList orderDateHistogram(const QDate& fromDate, const QDate& toDate, const int& bucketDays);
 
 	Q_INVOKABLE
-	void insertItemIntoCustomerDataModel(QString objectName, Customer* listItem);
+	QVariantMap orderCountsByDepartment(const bool& withSubtree);
 
 	Q_INVOKABLE
-	void fillCustomerDataModelByCompanyName(QString objectName, const QString& companyName);
+	QVariantMap orderCountsByCustomer();
 
 	Q_INVOKABLE
 	QList<Customer*> listOfCustomerForKeys(QStringList keyList);
 
+	Q_INVOKABLE
+	QList<QObject*> listOfCustomerForCompanyName(const QString& companyName);
+
 	Q_INVOKABLE
 	QVariantList customerAsQVariantList();
 
@@ -138,20 +175,15 @@ public:
 	Q_INVOKABLE
 	bool deleteCustomerById(const int& id);
 
-	Q_INVOKABLE
-    Customer* findCustomerById(const int& id);
-	
-	Q_INVOKABLE
-	void fillTopicDataModel(QString objectName);
+	void insertCustomers(const QList<Customer*>& customerList);
 
 	Q_INVOKABLE
-	void replaceItemInTopicDataModel(QString objectName, Topic* listItem);
+	int deleteCustomers(const QVariantList& idList);
 
-	Q_INVOKABLE
-	void removeItemFromTopicDataModel(QString objectName, Topic* listItem);
+	void replaceAllCustomers(const QList<Customer*>& customerList);
 
 	Q_INVOKABLE
-	void insertItemIntoTopicDataModel(QString objectName, Topic* listItem);
+    Customer* findCustomerById(const int& id);
 
 	Q_INVOKABLE
 	QList<Topic*> listOfTopicForKeys(QStringList keyList);
@@ -192,23 +224,15 @@ public:
 	Q_INVOKABLE
 	bool deleteTopicById(const int& id);
 
-	Q_INVOKABLE
-    Topic* findTopicById(const int& id);
-	
-	Q_INVOKABLE
-	void fillDepartmentTreeDataModel(QString objectName);
-
-	Q_INVOKABLE
-	void fillDepartmentFlatDataModel(QString objectName);
+	void insertTopics(const QList<Topic*>& topicList);
 
 	Q_INVOKABLE
-	void replaceItemInDepartmentDataModel(QString objectName, Department* listItem);
+	int deleteTopics(const QVariantList& uuidList);
 
-	Q_INVOKABLE
-	void removeItemFromDepartmentDataModel(QString objectName, Department* listItem);
+	void replaceAllTopics(const QList<Topic*>& topicList);
 
 	Q_INVOKABLE
-	void insertItemIntoDepartmentDataModel(QString objectName, Department* listItem);
+    Topic* findTopicById(const int& id);
 
 	Q_INVOKABLE
 	QList<Department*> listOfDepartmentForKeys(QStringList keyList);
@@ -219,6 +243,9 @@ public:
 	Q_INVOKABLE
 	QList<QObject*> allDepartment();
 
+	Q_INVOKABLE
+	QList<QObject*> allDepartmentFlat();
+
 	Q_INVOKABLE
 	void deleteDepartment();
 
@@ -249,24 +276,24 @@ public:
 	Q_INVOKABLE
 	bool deleteDepartmentById(const int& id);
 
-	Q_INVOKABLE
-    Department* findDepartmentById(const int& id);
-	
-	Q_INVOKABLE
-	void fillTagDataModel(QString objectName);
+	void insertDepartments(const QList<Department*>& departmentList);
 
 	Q_INVOKABLE
-	void replaceItemInTagDataModel(QString objectName, Tag* listItem);
+	int deleteDepartments(const QVariantList& uuidList);
 
-	Q_INVOKABLE
-	void removeItemFromTagDataModel(QString objectName, Tag* listItem);
+	void replaceAllDepartments(const QList<Department*>& departmentList);
 
 	Q_INVOKABLE
-	void insertItemIntoTagDataModel(QString objectName, Tag* listItem);
+    Department* findDepartmentById(const int& id);
 
 	Q_INVOKABLE
 	QList<Tag*> listOfTagForKeys(QStringList keyList);
 
+	QList<Tag*> listOfTagForHandles(const QVector<int>& handleList);
+
+	Q_INVOKABLE
+	Tag* findTagByHandle(const int& handle);
+
 	Q_INVOKABLE
 	QVariantList tagAsQVariantList();
 
@@ -297,20 +324,15 @@ public:
 	Q_INVOKABLE
 	bool deleteTagByUuid(const QString& uuid);
 
-	Q_INVOKABLE
-	Tag* findTagByUuid(const QString& uuid);
-	
-	Q_INVOKABLE
-	void fillXtrasDataModel(QString objectName);
+	void insertTags(const QList<Tag*>& tagList);
 
 	Q_INVOKABLE
-	void replaceItemInXtrasDataModel(QString objectName, Xtras* listItem);
+	int deleteTags(const QVariantList& uuidList);
 
-	Q_INVOKABLE
-	void removeItemFromXtrasDataModel(QString objectName, Xtras* listItem);
+	void replaceAllTags(const QList<Tag*>& tagList);
 
 	Q_INVOKABLE
-	void insertItemIntoXtrasDataModel(QString objectName, Xtras* listItem);
+	Tag* findTagByUuid(const QString& uuid);
 
 	Q_INVOKABLE
 	QList<Xtras*> listOfXtrasForKeys(QStringList keyList);
@@ -345,12 +367,77 @@ public:
 	Q_INVOKABLE
 	bool deleteXtrasById(const int& id);
 
+	void insertXtrasList(const QList<Xtras*>& xtrasList);
+
+	Q_INVOKABLE
+	int deleteXtrasList(const QVariantList& idList);
+
+	void replaceAllXtrasList(const QList<Xtras*>& xtrasList);
+
 	Q_INVOKABLE
     Xtras* findXtrasById(const int& id);
 
 	Q_INVOKABLE
 	void setChunkSize(const int& newChunkSize);
 
+	Q_INVOKABLE
+	void setUseBinaryCache(const bool& useBinaryCache);
+
+	Q_INVOKABLE
+	void setRecordsPerCacheChunk(const int& recordsPerCacheChunk);
+
+	Q_INVOKABLE
+	QVariantMap dataObjectPoolStatistics();
+
+	Q_INVOKABLE
+	void trimDataObjectPools();
+
+	Q_INVOKABLE
+	QVariantMap stringPoolStatistics();
+
+	Q_INVOKABLE
+	QVariantMap memoryStatistics();
+
+	Q_INVOKABLE
+	void reportMemoryStatistics(const QString& reason);
+
+	Q_INVOKABLE
+	void setOrderMemoryLimit(const int& kiloBytes);
+
+	Q_INVOKABLE
+	void setOrderKeepRecent(const int& count);
+
+	Q_INVOKABLE
+	int evictColdOrders(const bool& withReferences);
+
+	Q_INVOKABLE
+	QVariantMap orderEvictionStatistics();
+
+	// called by OrderEviction
+	void scheduleOrderEviction();
+	bool isOrderCacheChunk(const int& chunk) const;
+	bool readOrderPositionsFromCache(Order* order);
+
+	Q_INVOKABLE
+	QVariantMap metrics();
+
+	Q_INVOKABLE
+	void resetMetrics();
+
+	Q_INVOKABLE
+	void setMetricsSnapshotInterval(const int& msecs);
+
+	DataMetrics* dataMetrics();
+
+	Q_INVOKABLE
+	bool startTrace(const QString& fileName);
+
+	Q_INVOKABLE
+	bool stopTrace();
+
+	Q_INVOKABLE
+	void traceMark(const QString& name);
+
     void initOrderFromCache();
     void initCustomerFromCache();
     void initTopicFromCache();
@@ -359,37 +446,97 @@ public:
     void initTagFromSqlCache();
     void initXtrasFromCache();
 
+    QList<QObject*> readOrderFromCache();
+    QList<QObject*> readCustomerFromCache();
+    QList<QObject*> readTopicFromCache();
+    QList<QObject*> readDepartmentFromCache();
+    QList<QObject*> readXtrasFromCache();
+
 Q_SIGNALS:
 
 	void addedToAllOrder(Order* order);
 	void deletedFromAllOrderByNr(int nr);
 	void deletedFromAllOrder(Order* order);
+	void batchAddedToAllOrder(QVariantList nrRanges);
+	void batchDeletedFromAllOrder(QVariantList nrRanges);
 	void addedToAllCustomer(Customer* customer);
 	void deletedFromAllCustomerById(int id);
 	void deletedFromAllCustomer(Customer* customer);
+	void batchAddedToAllCustomer(QVariantList idRanges);
+	void batchDeletedFromAllCustomer(QVariantList idRanges);
 	void addedToAllTopic(Topic* topic);
 	void deletedFromAllTopicByUuid(QString uuid);
 	void deletedFromAllTopicById(int id);
 	void deletedFromAllTopic(Topic* topic);
+	void batchAddedToAllTopic(QStringList uuids);
+	void batchDeletedFromAllTopic(QStringList uuids);
 	void addedToAllDepartment(Department* department);
 	void deletedFromAllDepartmentByUuid(QString uuid);
 	void deletedFromAllDepartmentById(int id);
 	void deletedFromAllDepartment(Department* department);
+	void batchAddedToAllDepartment(QStringList uuids);
+	void batchDeletedFromAllDepartment(QStringList uuids);
 	void addedToAllTag(Tag* tag);
 	void deletedFromAllTagByUuid(QString uuid);
 	void deletedFromAllTag(Tag* tag);
+	void batchAddedToAllTag(QStringList uuids);
+	void batchDeletedFromAllTag(QStringList uuids);
 	void addedToAllXtras(Xtras* xtras);
 	void deletedFromAllXtrasById(int id);
 	void deletedFromAllXtras(Xtras* xtras);
+	void batchAddedToAllXtras(QVariantList idRanges);
+	void batchDeletedFromAllXtras(QVariantList idRanges);
+	// metrics() every setMetricsSnapshotInterval() ms
+	void metricsSnapshot(QVariantMap metrics);
+	// memoryStatistics() from reportMemoryStatistics() - per ex. on low memory
+	void memoryStatisticsReported(QString reason, QVariantMap statistics);
     
-public slots:
-    void onManualExit();
+private slots:
+    // reset resolved references of Order to deleted objects
+    void onDeletedFromAllCustomer(Customer* customer);
+    void onDeletedFromAllTopic(Topic* topic);
+    void onDeletedFromAllDepartment(Department* department);
+    void onDeletedFromAllTag(Tag* tag);
+    void onDeletedFromAllXtras(Xtras* xtras);
+    // uuid of a Tag changed
+    void onTagHandleChanged(Tag* tag, int oldHandle);
+    void onMetricsSnapshotTimeout();
+    void onOrderEvictionTimeout();
+    void onDeleteLaterTimeout();
 
 private:
 
+	// shared storage of repeated values (Tag uuids, domains, ...)
+	StringPool mStringPool;
+
 	// DataObject stored in List of QObject*
 	// GroupDataModel only supports QObject*
-    QList<QObject*> mAllOrder;
+    // indexed by nr (domain key) - see findOrderByNr()
+    DenseObjectList mAllOrder;
+    // hot properties of all Order as column arrays - row = position in mAllOrder
+    OrderColumns mOrderColumns;
+    // words of title, positions and subItems - built on first search
+    OrderSearchIndex mOrderSearchIndex;
+    // SubItem barcode -> Order - built on first lookup
+    BarcodeIndex mBarcodeIndex;
+    // referenced Customer, Topic ... -> Order - built on first delete of a referenced object
+    OrderReferenceIndex mOrderReferenceIndex;
+    // LRU of accessed Order - releases positions and references of cold Order
+    OrderEviction mOrderEviction;
+    // single shot: the memory limit is checked from the event loop
+    QTimer mOrderEvictionTimer;
+    // chunks of the Order cache file - positions of cold Order are read again from there
+    QVector<ChunkedCache::Chunk> mOrderCacheChunks;
+    void restoreOrderPositionsFromCache();
+    void setOrderCacheChunk(const QList<QObject*>& orderList, const qint64& fileSize);
+    void invalidateOrderReferencesTo(QObject* target);
+    void releaseOrderReferencesTo(QObject* target, QSet<Order*>& releasedOrders);
+    void resolveReleasedOrderReferences(const QSet<Order*>& releasedOrders);
+    void rebuildOrderIndexes();
+    void deleteAllLater(const QList<QObject*>& objectList);
+    // objects of bulk deletes - deleted together from the event loop
+    QList<QObject*> mDeleteLaterList;
+    QTimer mDeleteLaterTimer;
     // implementation for QDeclarativeListProperty to use
     // QML functions for List of All Order*
     static void appendToOrderProperty(
@@ -401,7 +548,7 @@ private:
     	QDeclarativeListProperty<Order> *orderList, int pos);
     static void clearOrderProperty(
     	QDeclarativeListProperty<Order> *orderList);
-    QList<QObject*> mAllCustomer;
+    DenseObjectList mAllCustomer;
     // implementation for QDeclarativeListProperty to use
     // QML functions for List of All Customer*
     static void appendToCustomerProperty(
@@ -413,7 +560,7 @@ private:
     	QDeclarativeListProperty<Customer> *customerList, int pos);
     static void clearCustomerProperty(
     	QDeclarativeListProperty<Customer> *customerList);
-    QList<QObject*> mAllTopic;
+    DenseObjectList mAllTopic;
     // implementation for QDeclarativeListProperty to use
     // QML functions for List of All Topic*
     static void appendToTopicProperty(
@@ -425,7 +572,7 @@ private:
     	QDeclarativeListProperty<Topic> *topicList, int pos);
     static void clearTopicProperty(
     	QDeclarativeListProperty<Topic> *topicList);
-    QList<QObject*> mAllDepartment;
+    DenseObjectList mAllDepartment;
     // implementation for QDeclarativeListProperty to use
     // QML functions for List of All Department*
     static void appendToDepartmentProperty(
@@ -437,8 +584,13 @@ private:
     	QDeclarativeListProperty<Department> *departmentList, int pos);
     static void clearDepartmentProperty(
     	QDeclarativeListProperty<Department> *departmentList);
-    QList<QObject*> mAllDepartmentFlat;
-    QList<QObject*> mAllTag;
+    // roots and children - indexed by id
+    DenseObjectList mAllDepartmentFlat;
+    DenseObjectList mAllTag;
+    // Tag* at position Tag::handle() - resolves lazy arrays by index
+    QVector<Tag*> mTagByHandle;
+    void addToTagByHandle(Tag* tag);
+    void removeFromTagByHandle(Tag* tag);
     // implementation for QDeclarativeListProperty to use
     // QML functions for List of All Tag*
     static void appendToTagProperty(
@@ -450,7 +602,7 @@ private:
     	QDeclarativeListProperty<Tag> *tagList, int pos);
     static void clearTagProperty(
     	QDeclarativeListProperty<Tag> *tagList);
-    QList<QObject*> mAllXtras;
+    DenseObjectList mAllXtras;
     // implementation for QDeclarativeListProperty to use
     // QML functions for List of All Xtras*
     static void appendToXtrasProperty(
@@ -464,11 +616,11 @@ private:
     	QDeclarativeListProperty<Xtras> *xtrasList);
 
     void saveOrderToCache();
+    void saveOrderToChunkedCache(QFile& cacheFile);
     void saveCustomerToCache();
     void saveTopicToCache();
     void saveDepartmentToCache();
     void saveTagToCache();
-    	void saveTagToSqlCache();
     void saveXtrasToCache();
 
 // S Q L
@@ -478,9 +630,21 @@ private:
     void bulkImport(const bool& tuneJournalAndSync);
     int mChunkSize;
 
+	bool openCacheFile(QString& fileName, QFile& cacheFile);
 	QVariantList readFromCache(QString& fileName);
-	void writeToCache(QString& fileName, QVariantList& data);
-	void finish();
+	bool mUseBinaryCache;
+	int mRecordsPerCacheChunk;
+	void adoptRootDataObjects(const QList<QObject*>& rootList);
+	void fillDepartmentFlat();
+	QSet<int> departmentSubtreeIds(const int& id);
+	// wall time of init stages - read... stages run concurrently - "initStages" of metrics()
+	QVariantMap mInitStages;
+	QMutex mInitStagesMutex;
+	void recordInitStage(const QString& stage, const QElapsedTimer& timer);
+	// timers and counters of the hot paths - see metrics()
+	DataMetrics mMetrics;
+	QTimer mMetricsTimer;
+	DataWriter* createCacheWriter(QIODevice* device);
 };
 
 #endif /* DATAMANAGER_HPP_ */
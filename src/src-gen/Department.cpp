@@ -1,6 +1,12 @@
 #include "Department.hpp"
 #include <QDebug>
 #include <quuid.h>
+#include "../VariantMapWriter.hpp"
+#include "../DataTracer.hpp"
+#include "../MemoryUsage.hpp"
+#include "../DenseObjectList.hpp"
+#include "../DataLog.hpp"
+#include "../FieldKeyHash.hpp"
 #include "Department.hpp"
 
 // keys of QVariantMap used in this APP
@@ -17,11 +23,43 @@ static const QString nameForeignKey = "name";
 // no key for parentDep
 static const QString childrenForeignKey = "children";
 
+// property ids dispatched by departmentField()
+enum DepartmentField
+{
+	NO_FIELD,
+	ID_FIELD,
+	UUID_FIELD,
+	NAME_FIELD,
+	CHILDREN_FIELD
+};
+
+/*
+ * maps a key of departmentMap to the property id
+ * switch over the perfect hash from FieldKeyHash.hpp,
+ * then only one compare with the expected key
+ */
+static int departmentField(const QString& key, const DataWriter::KeyNaming& keyNaming)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	switch (fieldKeyHash(key)) {
+	case FIELD_KEY_HASH(2, 'i'):
+		return key == (foreign ? idForeignKey : idKey) ? ID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(4, 'u'):
+		return key == (foreign ? uuidForeignKey : uuidKey) ? UUID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(4, 'n'):
+		return key == (foreign ? nameForeignKey : nameKey) ? NAME_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(8, 'c'):
+		return key == (foreign ? childrenForeignKey : childrenKey) ? CHILDREN_FIELD : NO_FIELD;
+	default:
+		return NO_FIELD;
+	}
+}
+
 /*
  * Default Constructor if Department not initialized from QVariantMap
  */
 Department::Department(QObject *parent) :
-        QObject(parent), mId(-1), mUuid(""), mName("")
+        QObject(parent), mId(-1), mUuid(""), mName(""), mRootList(0)
 {
 }
 
@@ -34,27 +72,7 @@ Department::Department(QObject *parent) :
  */
 void Department::fillFromMap(const QVariantMap& departmentMap)
 {
-	mId = departmentMap.value(idKey).toInt();
-	mUuid = departmentMap.value(uuidKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mName = departmentMap.value(nameKey).toString();
-	// mParentDep is parent (Department* containing Department)
-	// mChildren is List of Department*
-	QVariantList childrenList;
-	childrenList = departmentMap.value(childrenKey).toList();
-	mChildren.clear();
-	for (int i = 0; i < childrenList.size(); ++i) {
-		QVariantMap childrenMap;
-		childrenMap = childrenList.at(i).toMap();
-		Department* department = new Department();
-		department->setParent(this);
-		department->fillFromMap(childrenMap);
-		mChildren.append(department);
-	}
+	fillFrom(departmentMap, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -65,27 +83,7 @@ void Department::fillFromMap(const QVariantMap& departmentMap)
  */
 void Department::fillFromForeignMap(const QVariantMap& departmentMap)
 {
-	mId = departmentMap.value(idForeignKey).toInt();
-	mUuid = departmentMap.value(uuidForeignKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mName = departmentMap.value(nameForeignKey).toString();
-	// mParentDep is parent (Department* containing Department)
-	// mChildren is List of Department*
-	QVariantList childrenList;
-	childrenList = departmentMap.value(childrenForeignKey).toList();
-	mChildren.clear();
-	for (int i = 0; i < childrenList.size(); ++i) {
-		QVariantMap childrenMap;
-		childrenMap = childrenList.at(i).toMap();
-		Department* department = new Department();
-		department->setParent(this);
-		department->fillFromForeignMap(childrenMap);
-		mChildren.append(department);
-	}
+	fillFrom(departmentMap, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -96,26 +94,62 @@ void Department::fillFromForeignMap(const QVariantMap& departmentMap)
  */
 void Department::fillFromCacheMap(const QVariantMap& departmentMap)
 {
-	mId = departmentMap.value(idKey).toInt();
-	mUuid = departmentMap.value(uuidKey).toString();
+	fillFrom(departmentMap, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+}
+
+/*
+ * initialize Department from QVariantMap
+ * walks departmentMap only once: each key is dispatched by departmentField()
+ * keyNaming: own property names or names from Server API
+ * transientPolicy WITHOUT_TRANSIENT ignores transient values (cache)
+ * corresponding export method: writeTo()
+ */
+void Department::fillFrom(const QVariantMap& departmentMap, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	TraceSpan span("Department::fillFrom", "dto");
+	// properties not contained in departmentMap get default values
+	mId = 0;
+	mUuid = QString();
+	mName = QString();
+	mChildren.clear();
+	QVariantMap::const_iterator it;
+	for (it = departmentMap.constBegin(); it != departmentMap.constEnd(); ++it) {
+		switch (departmentField(it.key(), keyNaming)) {
+		case ID_FIELD:
+			mId = it.value().toInt();
+			break;
+		case UUID_FIELD:
+			mUuid = it.value().toString();
+			break;
+		case NAME_FIELD:
+			mName = it.value().toString();
+			break;
+		case CHILDREN_FIELD: {
+			// mChildren is List of Department*
+			QVariantList childrenList;
+			childrenList = it.value().toList();
+			for (int i = 0; i < childrenList.size(); ++i) {
+				QVariantMap childrenMap;
+				childrenMap = childrenList.at(i).toMap();
+				Department* department = new Department();
+				department->setParent(this);
+				department->fillFrom(childrenMap, keyNaming, transientPolicy);
+				mChildren.append(department);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
 	if (mUuid.isEmpty()) {
 		mUuid = QUuid::createUuid().toString();
 		mUuid = mUuid.right(mUuid.length() - 1);
 		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mName = departmentMap.value(nameKey).toString();
-	// mParentDep is parent (Department* containing Department)
-	// mChildren is List of Department*
-	QVariantList childrenList;
-	childrenList = departmentMap.value(childrenKey).toList();
-	mChildren.clear();
-	for (int i = 0; i < childrenList.size(); ++i) {
-		QVariantMap childrenMap;
-		childrenMap = childrenList.at(i).toMap();
-		Department* department = new Department();
-		department->setParent(this);
-		department->fillFromCacheMap(childrenMap);
-		mChildren.append(department);
+	}
+	if (mRootList) {
+		mRootList->keyChanged(this);
 	}
 }
 
@@ -147,14 +181,11 @@ bool Department::isValid()
  */
 QVariantMap Department::toMap()
 {
-	QVariantMap departmentMap;
-	departmentMap.insert(idKey, mId);
-	departmentMap.insert(uuidKey, mUuid);
-	departmentMap.insert(nameKey, mName);
-	// mParentDep points to Department* containing Department
-	// mChildren points to Department*
-	departmentMap.insert(childrenKey, childrenAsQVariantList());
-	return departmentMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 /*
@@ -164,14 +195,11 @@ QVariantMap Department::toMap()
  */
 QVariantMap Department::toForeignMap()
 {
-	QVariantMap departmentMap;
-	departmentMap.insert(idForeignKey, mId);
-	departmentMap.insert(uuidForeignKey, mUuid);
-	departmentMap.insert(nameForeignKey, mName);
-	// mParentDep points to Department* containing Department
-	// mChildren points to Department*
-	departmentMap.insert(childrenForeignKey, childrenAsQVariantList());
-	return departmentMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 
@@ -182,9 +210,35 @@ QVariantMap Department::toForeignMap()
  */
 QVariantMap Department::toCacheMap()
 {
-	// no transient properties found from data model
-	// use default toMao()
-	return toMap();
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+	writer.endObject();
+	return writer.map();
+}
+
+/*
+ * writes all properties into the current object of writer
+ * used by toMap(), toForeignMap(), toCacheMap() and to write caches
+ * keyNaming: own property names or names from Server API
+ * no transient properties found from data model
+ */
+void Department::writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	writer->writeInt(foreign ? idForeignKey : idKey, mId);
+	writer->writeString(foreign ? uuidForeignKey : uuidKey, mUuid);
+	writer->writeString(foreign ? nameForeignKey : nameKey, mName);
+	// mParentDep points to Department* containing Department
+	// mChildren points to Department*
+	writer->beginArray(foreign ? childrenForeignKey : childrenKey);
+	for (int i = 0; i < mChildren.size(); ++i) {
+		writer->beginObject();
+		mChildren.at(i)->writeTo(writer, keyNaming, transientPolicy);
+		writer->endObject();
+	}
+	writer->endArray();
 }
 // ATT 
 // Mandatory: id
@@ -198,9 +252,16 @@ void Department::setId(int id)
 {
 	if (id != mId) {
 		mId = id;
+		if (mRootList) {
+			mRootList->keyChanged(this);
+		}
 		emit idChanged(id);
 	}
 }
+void Department::setRootList(DenseObjectList* rootList)
+{
+	mRootList = rootList;
+}
 // ATT 
 // Optional: uuid
 QString Department::uuid() const
@@ -288,7 +349,7 @@ bool Department::removeFromChildren(Department* department)
     bool ok = false;
     ok = mChildren.removeOne(department);
     if (!ok) {
-    	qDebug() << "Department* not found in children";
+    	DATA_LOG(DATA_LOG_DTO) << "Department* not found in children";
     	return false;
     }
     emit removedFromChildrenByUuid(department->uuid());
@@ -325,7 +386,7 @@ bool Department::removeFromChildrenByUuid(const QString& uuid)
         	return true;
         }
     }
-    qDebug() << "uuid not found in children: " << uuid;
+    DATA_LOG(DATA_LOG_DTO) << "uuid not found in children: " << uuid;
     return false;
 }
 
@@ -343,7 +404,7 @@ bool Department::removeFromChildrenById(const int& id)
         	return true;
         }
     }
-    qDebug() << "id not found in children: " << id;
+    DATA_LOG(DATA_LOG_DTO) << "id not found in children: " << id;
     return false;
 }
 int Department::childrenCount()
@@ -441,6 +502,17 @@ QList<QObject*> Department::allDepartmentChildren(){
     return allChildren;
 }
 
+// estimated memory of this Department and its children
+void Department::addMemoryUsage(MemoryUsage* usage) const
+{
+	qint64 stringBytes = MemoryUsage::stringBytes(mUuid) + MemoryUsage::stringBytes(mName);
+	usage->addObject(MemoryUsage::DEPARTMENT, MemoryUsage::objectBytes(sizeof(Department)), stringBytes,
+			MemoryUsage::listBytes(mChildren.size()));
+	for (int i = 0; i < mChildren.size(); ++i) {
+		mChildren.at(i)->addMemoryUsage(usage);
+	}
+}
+
 Department::~Department()
 {
 	// place cleanUp code here
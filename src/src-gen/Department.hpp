@@ -4,12 +4,16 @@
 #include <QObject>
 #include <qvariant.h>
 #include <QDeclarativeListProperty>
+#include "../DataWriter.hpp"
 
 
 // forward declaration to avoid circular dependencies
 class Department;
 
 
+class MemoryUsage;
+class DenseObjectList;
+
 class Department: public QObject
 {
 	Q_OBJECT
@@ -29,6 +33,8 @@ public:
 	void fillFromMap(const QVariantMap& departmentMap);
 	void fillFromForeignMap(const QVariantMap& departmentMap);
 	void fillFromCacheMap(const QVariantMap& departmentMap);
+	void fillFrom(const QVariantMap& departmentMap, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
 	
 	void prepareNew();
 	
@@ -39,6 +45,13 @@ public:
 	QVariantMap toForeignMap();
 	QVariantMap toCacheMap();
 
+	void writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
+
+	void addMemoryUsage(MemoryUsage* usage) const;
+	// root list of DataManager - informed if the id changes
+	void setRootList(DenseObjectList* rootList);
+
 	int id() const;
 	void setId(int id);
 	QString uuid() const;
@@ -118,6 +131,8 @@ private:
 	static Department* atChildrenProperty(QDeclarativeListProperty<Department> *childrenList, int pos);
 	static void clearChildrenProperty(QDeclarativeListProperty<Department> *childrenList);
 
+	DenseObjectList* mRootList;
+
 	Q_DISABLE_COPY (Department)
 };
 Q_DECLARE_METATYPE(Department*)
@@ -1,6 +1,11 @@
 #include "Info.hpp"
 #include <QDebug>
 #include <quuid.h>
+#include "../VariantMapWriter.hpp"
+#include "../DataTracer.hpp"
+#include "../MemoryUsage.hpp"
+#include "../FieldKeyHash.hpp"
+#include "../DataObjectPool.hpp"
 #include "Order.hpp"
 
 // keys of QVariantMap used in this APP
@@ -13,6 +18,32 @@ static const QString uuidForeignKey = "uuid";
 static const QString remarksForeignKey = "remarks";
 // no key for order
 
+// property ids dispatched by infoField()
+enum InfoField
+{
+	NO_FIELD,
+	UUID_FIELD,
+	REMARKS_FIELD
+};
+
+/*
+ * maps a key of infoMap to the property id
+ * switch over the perfect hash from FieldKeyHash.hpp,
+ * then only one compare with the expected key
+ */
+static int infoField(const QString& key, const DataWriter::KeyNaming& keyNaming)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	switch (fieldKeyHash(key)) {
+	case FIELD_KEY_HASH(4, 'u'):
+		return key == (foreign ? uuidForeignKey : uuidKey) ? UUID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(7, 'r'):
+		return key == (foreign ? remarksForeignKey : remarksKey) ? REMARKS_FIELD : NO_FIELD;
+	default:
+		return NO_FIELD;
+	}
+}
+
 /*
  * Default Constructor if Info not initialized from QVariantMap
  */
@@ -30,14 +61,7 @@ Info::Info(QObject *parent) :
  */
 void Info::fillFromMap(const QVariantMap& infoMap)
 {
-	mUuid = infoMap.value(uuidKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mRemarks = infoMap.value(remarksKey).toString();
-	// mOrder is parent (Order* containing Info)
+	fillFrom(infoMap, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -48,14 +72,7 @@ void Info::fillFromMap(const QVariantMap& infoMap)
  */
 void Info::fillFromForeignMap(const QVariantMap& infoMap)
 {
-	mUuid = infoMap.value(uuidForeignKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mRemarks = infoMap.value(remarksForeignKey).toString();
-	// mOrder is parent (Order* containing Info)
+	fillFrom(infoMap, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -66,14 +83,41 @@ void Info::fillFromForeignMap(const QVariantMap& infoMap)
  */
 void Info::fillFromCacheMap(const QVariantMap& infoMap)
 {
-	mUuid = infoMap.value(uuidKey).toString();
+	fillFrom(infoMap, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+}
+
+/*
+ * initialize Info from QVariantMap
+ * walks infoMap only once: each key is dispatched by infoField()
+ * keyNaming: own property names or names from Server API
+ * transientPolicy WITHOUT_TRANSIENT ignores transient values (cache)
+ * corresponding export method: writeTo()
+ */
+void Info::fillFrom(const QVariantMap& infoMap, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	TraceSpan span("Info::fillFrom", "dto");
+	// properties not contained in infoMap get default values
+	mUuid = QString();
+	mRemarks = QString();
+	QVariantMap::const_iterator it;
+	for (it = infoMap.constBegin(); it != infoMap.constEnd(); ++it) {
+		switch (infoField(it.key(), keyNaming)) {
+		case UUID_FIELD:
+			mUuid = it.value().toString();
+			break;
+		case REMARKS_FIELD:
+			mRemarks = it.value().toString();
+			break;
+		default:
+			break;
+		}
+	}
 	if (mUuid.isEmpty()) {
 		mUuid = QUuid::createUuid().toString();
 		mUuid = mUuid.right(mUuid.length() - 1);
 		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mRemarks = infoMap.value(remarksKey).toString();
-	// mOrder is parent (Order* containing Info)
+	}
 }
 
 void Info::prepareNew()
@@ -101,11 +145,11 @@ bool Info::isValid()
  */
 QVariantMap Info::toMap()
 {
-	QVariantMap infoMap;
-	infoMap.insert(uuidKey, mUuid);
-	infoMap.insert(remarksKey, mRemarks);
-	// mOrder points to Order* containing Info
-	return infoMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 /*
@@ -115,11 +159,11 @@ QVariantMap Info::toMap()
  */
 QVariantMap Info::toForeignMap()
 {
-	QVariantMap infoMap;
-	infoMap.insert(uuidForeignKey, mUuid);
-	infoMap.insert(remarksForeignKey, mRemarks);
-	// mOrder points to Order* containing Info
-	return infoMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 
@@ -130,9 +174,27 @@ QVariantMap Info::toForeignMap()
  */
 QVariantMap Info::toCacheMap()
 {
-	// no transient properties found from data model
-	// use default toMao()
-	return toMap();
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+	writer.endObject();
+	return writer.map();
+}
+
+/*
+ * writes all properties into the current object of writer
+ * used by toMap(), toForeignMap(), toCacheMap() and to write caches
+ * keyNaming: own property names or names from Server API
+ * no transient properties found from data model
+ */
+void Info::writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	Q_UNUSED(transientPolicy);
+	writer->writeString(foreign ? uuidForeignKey : uuidKey, mUuid);
+	writer->writeString(foreign ? remarksForeignKey : remarksKey, mRemarks);
+	// mOrder points to Order* containing Info
 }
 // ATT 
 // Mandatory: uuid
@@ -173,6 +235,16 @@ Order* Info::order() const
 }
 
 
+// cascaded DataObjects are allocated from a typed pool
+DATA_OBJECT_POOL_OPERATORS_IMPL(Info)
+
+// estimated memory of this Info
+void Info::addMemoryUsage(MemoryUsage* usage) const
+{
+	qint64 stringBytes = MemoryUsage::stringBytes(mUuid) + MemoryUsage::stringBytes(mRemarks);
+	usage->addObject(MemoryUsage::INFO, MemoryUsage::pooledObjectBytes(sizeof(Info)), stringBytes);
+}
+
 Info::~Info()
 {
 	// place cleanUp code here
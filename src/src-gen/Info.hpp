@@ -3,12 +3,16 @@
 
 #include <QObject>
 #include <qvariant.h>
+#include "../DataWriter.hpp"
+#include "../DataObjectPool.hpp"
 
 
 // forward declaration to avoid circular dependencies
 class Order;
 
 
+class MemoryUsage;
+
 class Info: public QObject
 {
 	Q_OBJECT
@@ -25,6 +29,8 @@ public:
 	void fillFromMap(const QVariantMap& infoMap);
 	void fillFromForeignMap(const QVariantMap& infoMap);
 	void fillFromCacheMap(const QVariantMap& infoMap);
+	void fillFrom(const QVariantMap& infoMap, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
 	
 	void prepareNew();
 	
@@ -35,6 +41,11 @@ public:
 	QVariantMap toForeignMap();
 	QVariantMap toCacheMap();
 
+	void writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
+
+	void addMemoryUsage(MemoryUsage* usage) const;
+
 	QString uuid() const;
 	void setUuid(QString uuid);
 	QString remarks() const;
@@ -46,6 +57,9 @@ public:
 
 	virtual ~Info();
 
+	// Info is a cascaded DataObject: memory comes from DataObjectPool<Info>
+	DATA_OBJECT_POOL_OPERATORS
+
 	Q_SIGNALS:
 
 	void uuidChanged(QString uuid);
@@ -1,6 +1,12 @@
 #include "Item.hpp"
 #include <QDebug>
 #include <quuid.h>
+#include "../VariantMapWriter.hpp"
+#include "../DataTracer.hpp"
+#include "../MemoryUsage.hpp"
+#include "../DataLog.hpp"
+#include "../FieldKeyHash.hpp"
+#include "../DataObjectPool.hpp"
 #include "Order.hpp"
 
 // keys of QVariantMap used in this APP
@@ -19,12 +25,50 @@ static const QString quantityForeignKey = "quantity";
 // no key for order
 static const QString subItemsForeignKey = "subItems";
 
+// property ids dispatched by itemField()
+enum ItemField
+{
+	NO_FIELD,
+	UUID_FIELD,
+	POS_NR_FIELD,
+	NAME_FIELD,
+	QUANTITY_FIELD,
+	SUB_ITEMS_FIELD
+};
+
+/*
+ * maps a key of itemMap to the property id
+ * switch over the perfect hash from FieldKeyHash.hpp,
+ * then only one compare with the expected key
+ */
+static int itemField(const QString& key, const DataWriter::KeyNaming& keyNaming)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	switch (fieldKeyHash(key)) {
+	case FIELD_KEY_HASH(4, 'u'):
+		return key == (foreign ? uuidForeignKey : uuidKey) ? UUID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(5, 'p'):
+		return key == (foreign ? posNrForeignKey : posNrKey) ? POS_NR_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(4, 'n'):
+		return key == (foreign ? nameForeignKey : nameKey) ? NAME_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(8, 'q'):
+		return key == (foreign ? quantityForeignKey : quantityKey) ? QUANTITY_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(8, 's'):
+		return key == (foreign ? subItemsForeignKey : subItemsKey) ? SUB_ITEMS_FIELD : NO_FIELD;
+	default:
+		return NO_FIELD;
+	}
+}
+
 /*
  * Default Constructor if Item not initialized from QVariantMap
  */
 Item::Item(QObject *parent) :
         QObject(parent), mUuid(""), mPosNr(-1), mName(""), mQuantity(-1.0)
 {
+	// subItems are created on first access
+	mSubItemsPendingKeyNaming = DataWriter::OWN_KEYS;
+	mSubItemsPendingTransientPolicy = DataWriter::WITH_TRANSIENT;
 }
 
 /*
@@ -36,28 +80,7 @@ Item::Item(QObject *parent) :
  */
 void Item::fillFromMap(const QVariantMap& itemMap)
 {
-	mUuid = itemMap.value(uuidKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mPosNr = itemMap.value(posNrKey).toInt();
-	mName = itemMap.value(nameKey).toString();
-	mQuantity = itemMap.value(quantityKey).toDouble();
-	// mOrder is parent (Order* containing Item)
-	// mSubItems is List of SubItem*
-	QVariantList subItemsList;
-	subItemsList = itemMap.value(subItemsKey).toList();
-	mSubItems.clear();
-	for (int i = 0; i < subItemsList.size(); ++i) {
-		QVariantMap subItemsMap;
-		subItemsMap = subItemsList.at(i).toMap();
-		SubItem* subItem = new SubItem();
-		subItem->setParent(this);
-		subItem->fillFromMap(subItemsMap);
-		mSubItems.append(subItem);
-	}
+	fillFrom(itemMap, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -68,28 +91,7 @@ void Item::fillFromMap(const QVariantMap& itemMap)
  */
 void Item::fillFromForeignMap(const QVariantMap& itemMap)
 {
-	mUuid = itemMap.value(uuidForeignKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mPosNr = itemMap.value(posNrForeignKey).toInt();
-	mName = itemMap.value(nameForeignKey).toString();
-	mQuantity = itemMap.value(quantityForeignKey).toDouble();
-	// mOrder is parent (Order* containing Item)
-	// mSubItems is List of SubItem*
-	QVariantList subItemsList;
-	subItemsList = itemMap.value(subItemsForeignKey).toList();
-	mSubItems.clear();
-	for (int i = 0; i < subItemsList.size(); ++i) {
-		QVariantMap subItemsMap;
-		subItemsMap = subItemsList.at(i).toMap();
-		SubItem* subItem = new SubItem();
-		subItem->setParent(this);
-		subItem->fillFromForeignMap(subItemsMap);
-		mSubItems.append(subItem);
-	}
+	fillFrom(itemMap, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -100,27 +102,56 @@ void Item::fillFromForeignMap(const QVariantMap& itemMap)
  */
 void Item::fillFromCacheMap(const QVariantMap& itemMap)
 {
-	mUuid = itemMap.value(uuidKey).toString();
+	fillFrom(itemMap, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+}
+
+/*
+ * initialize Item from QVariantMap
+ * walks itemMap only once: each key is dispatched by itemField()
+ * keyNaming: own property names or names from Server API
+ * transientPolicy WITHOUT_TRANSIENT ignores transient values (cache)
+ * corresponding export method: writeTo()
+ */
+void Item::fillFrom(const QVariantMap& itemMap, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	TraceSpan span("Item::fillFrom", "dto");
+	// properties not contained in itemMap get default values
+	mUuid = QString();
+	mPosNr = 0;
+	mName = QString();
+	mQuantity = 0.0;
+	mSubItems.clear();
+	mSubItemsPending.clear();
+	QVariantMap::const_iterator it;
+	for (it = itemMap.constBegin(); it != itemMap.constEnd(); ++it) {
+		switch (itemField(it.key(), keyNaming)) {
+		case UUID_FIELD:
+			mUuid = it.value().toString();
+			break;
+		case POS_NR_FIELD:
+			mPosNr = it.value().toInt();
+			break;
+		case NAME_FIELD:
+			mName = it.value().toString();
+			break;
+		case QUANTITY_FIELD:
+			mQuantity = it.value().toDouble();
+			break;
+		case SUB_ITEMS_FIELD:
+			// mSubItems is List of SubItem* - created on first access
+			mSubItemsPending = it.value().toList();
+			mSubItemsPendingKeyNaming = keyNaming;
+			mSubItemsPendingTransientPolicy = transientPolicy;
+			break;
+		default:
+			break;
+		}
+	}
 	if (mUuid.isEmpty()) {
 		mUuid = QUuid::createUuid().toString();
 		mUuid = mUuid.right(mUuid.length() - 1);
 		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mPosNr = itemMap.value(posNrKey).toInt();
-	mName = itemMap.value(nameKey).toString();
-	mQuantity = itemMap.value(quantityKey).toDouble();
-	// mOrder is parent (Order* containing Item)
-	// mSubItems is List of SubItem*
-	QVariantList subItemsList;
-	subItemsList = itemMap.value(subItemsKey).toList();
-	mSubItems.clear();
-	for (int i = 0; i < subItemsList.size(); ++i) {
-		QVariantMap subItemsMap;
-		subItemsMap = subItemsList.at(i).toMap();
-		SubItem* subItem = new SubItem();
-		subItem->setParent(this);
-		subItem->fillFromCacheMap(subItemsMap);
-		mSubItems.append(subItem);
 	}
 }
 
@@ -158,15 +189,11 @@ bool Item::isValid()
  */
 QVariantMap Item::toMap()
 {
-	QVariantMap itemMap;
-	itemMap.insert(uuidKey, mUuid);
-	itemMap.insert(posNrKey, mPosNr);
-	itemMap.insert(nameKey, mName);
-	itemMap.insert(quantityKey, mQuantity);
-	// mOrder points to Order* containing Item
-	// mSubItems points to SubItem*
-	itemMap.insert(subItemsKey, subItemsAsQVariantList());
-	return itemMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 /*
@@ -176,15 +203,11 @@ QVariantMap Item::toMap()
  */
 QVariantMap Item::toForeignMap()
 {
-	QVariantMap itemMap;
-	itemMap.insert(uuidForeignKey, mUuid);
-	itemMap.insert(posNrForeignKey, mPosNr);
-	itemMap.insert(nameForeignKey, mName);
-	itemMap.insert(quantityForeignKey, mQuantity);
-	// mOrder points to Order* containing Item
-	// mSubItems points to SubItem*
-	itemMap.insert(subItemsForeignKey, subItemsAsQVariantList());
-	return itemMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 
@@ -195,9 +218,128 @@ QVariantMap Item::toForeignMap()
  */
 QVariantMap Item::toCacheMap()
 {
-	// no transient properties found from data model
-	// use default toMao()
-	return toMap();
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+	writer.endObject();
+	return writer.map();
+}
+
+/*
+ * writes all properties into the current object of writer
+ * used by toMap(), toForeignMap(), toCacheMap() and to write caches
+ * keyNaming: own property names or names from Server API
+ * no transient properties found from data model
+ */
+void Item::writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	writer->writeString(foreign ? uuidForeignKey : uuidKey, mUuid);
+	writer->writeInt(foreign ? posNrForeignKey : posNrKey, mPosNr);
+	writer->writeString(foreign ? nameForeignKey : nameKey, mName);
+	writer->writeDouble(foreign ? quantityForeignKey : quantityKey, mQuantity);
+	// mOrder points to Order* containing Item
+	// mSubItems points to SubItem*
+	if (!mSubItemsPending.isEmpty() && mSubItemsPendingKeyNaming == keyNaming) {
+		// not materialized: write the maps as read (SubItem has no transient properties)
+		writeSubItemMapsTo(writer, foreign ? subItemsForeignKey : subItemsKey, mSubItemsPending, keyNaming);
+	} else {
+		materializeSubItems();
+		writer->beginArray(foreign ? subItemsForeignKey : subItemsKey);
+		for (int i = 0; i < mSubItems.size(); ++i) {
+			writer->beginObject();
+			mSubItems.at(i)->writeTo(writer, keyNaming, transientPolicy);
+			writer->endObject();
+		}
+		writer->endArray();
+	}
+}
+
+/*
+ * writes an itemMap not yet materialized
+ * only keys of Item properties - unknown keys of the source are dropped
+ */
+void Item::writeMapTo(DataWriter* writer, const QVariantMap& itemMap, const DataWriter::KeyNaming& keyNaming)
+{
+	QVariantMap::const_iterator it;
+	for (it = itemMap.constBegin(); it != itemMap.constEnd(); ++it) {
+		switch (itemField(it.key(), keyNaming)) {
+		case NO_FIELD:
+			break;
+		case SUB_ITEMS_FIELD:
+			writeSubItemMapsTo(writer, it.key(), it.value().toList(), keyNaming);
+			break;
+		default:
+			writer->writeVariant(it.key(), it.value());
+			break;
+		}
+	}
+}
+
+void Item::writeSubItemMapsTo(DataWriter* writer, const QString& key, const QVariantList& subItemMaps,
+		const DataWriter::KeyNaming& keyNaming)
+{
+	writer->beginArray(key);
+	for (int i = 0; i < subItemMaps.size(); ++i) {
+		writer->beginObject();
+		SubItem::writeMapTo(writer, subItemMaps.at(i).toMap(), keyNaming);
+		writer->endObject();
+	}
+	writer->endArray();
+}
+
+/*
+ * text for the search index
+ * pending subItems are read from their maps
+ */
+void Item::collectSearchText(QStringList& names, QStringList& descriptions, QStringList& barcodes)
+{
+	if (!mName.isEmpty()) {
+		names.append(mName);
+	}
+	for (int i = 0; i < mSubItemsPending.size(); ++i) {
+		SubItem::collectSearchText(mSubItemsPending.at(i).toMap(), mSubItemsPendingKeyNaming, descriptions,
+				barcodes);
+	}
+	for (int i = 0; i < mSubItems.size(); ++i) {
+		QString description = mSubItems.at(i)->description();
+		if (!description.isEmpty()) {
+			descriptions.append(description);
+		}
+		QString barcode = mSubItems.at(i)->barcode();
+		if (!barcode.isEmpty()) {
+			barcodes.append(barcode);
+		}
+	}
+}
+
+/*
+ * text for the search index from a map not yet materialized
+ */
+void Item::collectSearchText(const QVariantMap& itemMap, const DataWriter::KeyNaming& keyNaming,
+		QStringList& names, QStringList& descriptions, QStringList& barcodes)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	QString name = itemMap.value(foreign ? nameForeignKey : nameKey).toString();
+	if (!name.isEmpty()) {
+		names.append(name);
+	}
+	QVariantList subItemsList = itemMap.value(foreign ? subItemsForeignKey : subItemsKey).toList();
+	for (int i = 0; i < subItemsList.size(); ++i) {
+		SubItem::collectSearchText(subItemsList.at(i).toMap(), keyNaming, descriptions, barcodes);
+	}
+}
+
+/*
+ * the Order containing this Item must be indexed again
+ */
+void Item::invalidateSearchText()
+{
+	Order* containingOrder = order();
+	if (containingOrder) {
+		containingOrder->invalidateSearchText();
+	}
 }
 // ATT 
 // Mandatory: uuid
@@ -240,6 +382,7 @@ void Item::setName(QString name)
 	if (name != mName) {
 		mName = name;
 		emit nameChanged(name);
+		invalidateSearchText();
 	}
 }
 // ATT 
@@ -269,6 +412,7 @@ Order* Item::order() const
 // Optional: subItems
 QVariantList Item::subItemsAsQVariantList()
 {
+	materializeSubItems();
 	QVariantList subItemsList;
 	for (int i = 0; i < mSubItems.size(); ++i) {
         subItemsList.append((mSubItems.at(i))->toMap());
@@ -306,19 +450,23 @@ void Item::undoCreateElementOfSubItems(SubItem* subItem)
 }
 void Item::addToSubItems(SubItem* subItem)
 {
+	materializeSubItems();
     mSubItems.append(subItem);
     emit addedToSubItems(subItem);
+    invalidateSearchText();
 }
 
 bool Item::removeFromSubItems(SubItem* subItem)
 {
+	materializeSubItems();
     bool ok = false;
     ok = mSubItems.removeOne(subItem);
     if (!ok) {
-    	qDebug() << "SubItem* not found in subItems";
+    	DATA_LOG(DATA_LOG_DTO) << "SubItem* not found in subItems";
     	return false;
     }
     emit removedFromSubItemsByUuid(subItem->uuid());
+    invalidateSearchText();
     // subItems are contained - so we must delete them
     subItem->deleteLater();
     subItem = 0;
@@ -326,49 +474,78 @@ bool Item::removeFromSubItems(SubItem* subItem)
 }
 void Item::clearSubItems()
 {
+	materializeSubItems();
     for (int i = mSubItems.size(); i > 0; --i) {
         removeFromSubItems(mSubItems.last());
     }
 }
 void Item::addToSubItemsFromMap(const QVariantMap& subItemMap)
 {
+	materializeSubItems();
     SubItem* subItem = new SubItem();
     subItem->setParent(this);
     subItem->fillFromMap(subItemMap);
     mSubItems.append(subItem);
     emit addedToSubItems(subItem);
+    invalidateSearchText();
 }
 bool Item::removeFromSubItemsByUuid(const QString& uuid)
 {
+	materializeSubItems();
     for (int i = 0; i < mSubItems.size(); ++i) {
     	SubItem* subItem;
         subItem = mSubItems.at(i);
         if (subItem->uuid() == uuid) {
         	mSubItems.removeAt(i);
         	emit removedFromSubItemsByUuid(uuid);
+        	invalidateSearchText();
         	// subItems are contained - so we must delete them
         	subItem->deleteLater();
         	subItem = 0;
         	return true;
         }
     }
-    qDebug() << "uuid not found in subItems: " << uuid;
+    DATA_LOG(DATA_LOG_DTO) << "uuid not found in subItems: " << uuid;
     return false;
 }
 
+/*
+ * subItems from cache or map are kept as read until first access:
+ * list screens only need the properties of Item
+ */
+void Item::materializeSubItems()
+{
+	if (mSubItemsPending.isEmpty()) {
+		return;
+	}
+	for (int i = 0; i < mSubItemsPending.size(); ++i) {
+		SubItem* subItem = new SubItem();
+		subItem->setParent(this);
+		subItem->fillFrom(mSubItemsPending.at(i).toMap(), mSubItemsPendingKeyNaming, mSubItemsPendingTransientPolicy);
+		mSubItems.append(subItem);
+	}
+	mSubItemsPending.clear();
+}
+
+/*
+ * doesn't materialize the subItems
+ */
 int Item::subItemsCount()
 {
-    return mSubItems.size();
+    return mSubItems.size() + mSubItemsPending.size();
 }
 QList<SubItem*> Item::subItems()
 {
+	materializeSubItems();
 	return mSubItems;
 }
 void Item::setSubItems(QList<SubItem*> subItems) 
 {
+	materializeSubItems();
 	if (subItems != mSubItems) {
 		mSubItems = subItems;
 		emit subItemsChanged(subItems);
+		invalidateSearchText();
 	}
 }
 /**
@@ -393,8 +570,10 @@ void Item::appendToSubItemsProperty(QDeclarativeListProperty<SubItem> *subItemsL
     Item *itemObject = qobject_cast<Item *>(subItemsList->object);
     if (itemObject) {
 		subItem->setParent(itemObject);
+        itemObject->materializeSubItems();
         itemObject->mSubItems.append(subItem);
         emit itemObject->addedToSubItems(subItem);
+        itemObject->invalidateSearchText();
     } else {
         qWarning() << "cannot append SubItem* to subItems " << "Object is not of type Item*";
     }
@@ -403,7 +582,7 @@ int Item::subItemsPropertyCount(QDeclarativeListProperty<SubItem> *subItemsList)
 {
     Item *item = qobject_cast<Item *>(subItemsList->object);
     if (item) {
-        return item->mSubItems.size();
+        return item->subItemsCount();
     } else {
         qWarning() << "cannot get size subItems " << "Object is not of type Item*";
     }
@@ -413,6 +592,7 @@ SubItem* Item::atSubItemsProperty(QDeclarativeListProperty<SubItem> *subItemsLis
 {
     Item *item = qobject_cast<Item *>(subItemsList->object);
     if (item) {
+        item->materializeSubItems();
         if (item->mSubItems.size() > pos) {
             return item->mSubItems.at(pos);
         }
@@ -432,12 +612,28 @@ void Item::clearSubItemsProperty(QDeclarativeListProperty<SubItem> *subItemsList
             item->mSubItems.at(i)->deleteLater();
         }
         item->mSubItems.clear();
+        item->mSubItemsPending.clear();
+        item->invalidateSearchText();
     } else {
         qWarning() << "cannot clear subItems " << "Object is not of type Item*";
     }
 }
 
 
+// cascaded DataObjects are allocated from a typed pool
+DATA_OBJECT_POOL_OPERATORS_IMPL(Item)
+
+// estimated memory of this Item and its SubItems
+void Item::addMemoryUsage(MemoryUsage* usage) const
+{
+	qint64 stringBytes = MemoryUsage::stringBytes(mUuid) + MemoryUsage::stringBytes(mName);
+	usage->addObject(MemoryUsage::ITEM, MemoryUsage::pooledObjectBytes(sizeof(Item)), stringBytes,
+			MemoryUsage::listBytes(mSubItems.size()), MemoryUsage::variantListBytes(mSubItemsPending));
+	for (int i = 0; i < mSubItems.size(); ++i) {
+		mSubItems.at(i)->addMemoryUsage(usage);
+	}
+}
+
 Item::~Item()
 {
 	// place cleanUp code here
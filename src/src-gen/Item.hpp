@@ -3,7 +3,10 @@
 
 #include <QObject>
 #include <qvariant.h>
+#include <QStringList>
 #include <QDeclarativeListProperty>
+#include "../DataWriter.hpp"
+#include "../DataObjectPool.hpp"
 
 
 // forward declaration to avoid circular dependencies
@@ -11,6 +14,8 @@ class Order;
 #include "SubItem.hpp"
 
 
+class MemoryUsage;
+
 class Item: public QObject
 {
 	Q_OBJECT
@@ -31,6 +36,8 @@ public:
 	void fillFromMap(const QVariantMap& itemMap);
 	void fillFromForeignMap(const QVariantMap& itemMap);
 	void fillFromCacheMap(const QVariantMap& itemMap);
+	void fillFrom(const QVariantMap& itemMap, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
 	
 	void prepareNew();
 	
@@ -41,6 +48,22 @@ public:
 	QVariantMap toForeignMap();
 	QVariantMap toCacheMap();
 
+	void writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
+
+	void addMemoryUsage(MemoryUsage* usage) const;
+
+	// text for the search index (see OrderSearchIndex.hpp)
+	void collectSearchText(QStringList& names, QStringList& descriptions, QStringList& barcodes);
+	static void writeMapTo(DataWriter* writer, const QVariantMap& itemMap,
+			const DataWriter::KeyNaming& keyNaming);
+	static void writeSubItemMapsTo(DataWriter* writer, const QString& key, const QVariantList& subItemMaps,
+			const DataWriter::KeyNaming& keyNaming);
+
+	static void collectSearchText(const QVariantMap& itemMap, const DataWriter::KeyNaming& keyNaming,
+			QStringList& names, QStringList& descriptions, QStringList& barcodes);
+	void invalidateSearchText();
+
 	QString uuid() const;
 	void setUuid(QString uuid);
 	int posNr() const;
@@ -89,6 +112,9 @@ public:
 
 	virtual ~Item();
 
+	// Item is a cascaded DataObject: memory comes from DataObjectPool<Item>
+	DATA_OBJECT_POOL_OPERATORS
+
 	Q_SIGNALS:
 
 	void uuidChanged(QString uuid);
@@ -110,6 +136,11 @@ private:
 	double mQuantity;
 	// no MEMBER mOrder it's the parent
 	QList<SubItem*> mSubItems;
+	// subItems as read (maps) until first access - see materializeSubItems()
+	QVariantList mSubItemsPending;
+	DataWriter::KeyNaming mSubItemsPendingKeyNaming;
+	DataWriter::TransientPolicy mSubItemsPendingTransientPolicy;
+	void materializeSubItems();
 	// implementation for QDeclarativeListProperty to use
 	// QML functions for List of SubItem*
 	static void appendToSubItemsProperty(QDeclarativeListProperty<SubItem> *subItemsList,
@@ -1,6 +1,22 @@
 #include "Order.hpp"
 #include <QDebug>
+#include <QBuffer>
 #include <quuid.h>
+#include "../VariantMapWriter.hpp"
+#include "../BinaryDataWriter.hpp"
+#include "../DataReader.hpp"
+#include "../DataTracer.hpp"
+#include "../MemoryUsage.hpp"
+#include "../DenseObjectList.hpp"
+#include "../DataLog.hpp"
+#include "../FieldKeyHash.hpp"
+#include "../StringPool.hpp"
+#include "../DateCodec.hpp"
+#include "../OrderColumns.hpp"
+#include "../OrderSearchIndex.hpp"
+#include "../BarcodeIndex.hpp"
+#include "../OrderReferenceIndex.hpp"
+#include "../OrderEviction.hpp"
 
 // keys of QVariantMap used in this APP
 static const QString nrKey = "nr";
@@ -34,6 +50,68 @@ static const QString depIdForeignKey = "depId";
 static const QString tagsForeignKey = "tags";
 static const QString domainsForeignKey = "domains";
 
+// property ids dispatched by orderField()
+enum OrderField
+{
+	NO_FIELD,
+	NR_FIELD,
+	EXPRESS_ORDER_FIELD,
+	TITLE_FIELD,
+	ORDER_DATE_FIELD,
+	STATE_FIELD,
+	PROCESSING_STATE_FIELD,
+	POSITIONS_FIELD,
+	INFO_FIELD,
+	TOPIC_ID_FIELD,
+	EXTRAS_FIELD,
+	CUSTOMER_ID_FIELD,
+	DEP_ID_FIELD,
+	TAGS_FIELD,
+	DOMAINS_FIELD
+};
+
+/*
+ * maps a key of orderMap to the property id
+ * switch over the perfect hash from FieldKeyHash.hpp,
+ * then only one compare with the expected key
+ */
+static int orderField(const QString& key, const DataWriter::KeyNaming& keyNaming)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	switch (fieldKeyHash(key)) {
+	case FIELD_KEY_HASH(2, 'n'):
+		return key == (foreign ? nrForeignKey : nrKey) ? NR_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(12, 'e'):
+		return key == (foreign ? expressOrderForeignKey : expressOrderKey) ? EXPRESS_ORDER_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(5, 't'):
+		return key == (foreign ? titleForeignKey : titleKey) ? TITLE_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(9, 'o'):
+		return key == (foreign ? orderDateForeignKey : orderDateKey) ? ORDER_DATE_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(5, 's'):
+		return key == (foreign ? stateForeignKey : stateKey) ? STATE_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(15, 'p'):
+		return key == (foreign ? processingStateForeignKey : processingStateKey) ? PROCESSING_STATE_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(9, 'p'):
+		return key == (foreign ? positionsForeignKey : positionsKey) ? POSITIONS_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(4, 'i'):
+		return key == (foreign ? infoForeignKey : infoKey) ? INFO_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(7, 't'):
+		return key == (foreign ? topicIdForeignKey : topicIdKey) ? TOPIC_ID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(6, 'e'):
+		return key == (foreign ? extrasForeignKey : extrasKey) ? EXTRAS_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(10, 'c'):
+		return key == (foreign ? customerIdForeignKey : customerIdKey) ? CUSTOMER_ID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(5, 'd'):
+		return key == (foreign ? depIdForeignKey : depIdKey) ? DEP_ID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(4, 't'):
+		return key == (foreign ? tagsForeignKey : tagsKey) ? TAGS_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(7, 'd'):
+		return key == (foreign ? domainsForeignKey : domainsKey) ? DOMAINS_FIELD : NO_FIELD;
+	default:
+		return NO_FIELD;
+	}
+}
+
 /*
  * Default Constructor if Order not initialized from QVariantMap
  */
@@ -42,6 +120,24 @@ Order::Order(QObject *parent) :
 {
 	// set Types of DataObject* to NULL:
 	mInfo = 0;
+	// not attached to the columns of DataManager yet
+	mColumns = 0;
+	mColumnRow = -1;
+	mRootList = 0;
+	mSearchIndex = 0;
+	mBarcodeIndex = 0;
+	mReferenceIndex = 0;
+	mEviction = 0;
+	mLastAccess = 0;
+	mPositionsReleased = false;
+	mReferencesReleased = false;
+	mCacheChunk = -1;
+	mPositionsReleasedCount = 0;
+	mPositionsFromCache = false;
+	// positions are created on first access
+	mPositionsPendingKeyNaming = DataWriter::OWN_KEYS;
+	mPositionsPendingTransientPolicy = DataWriter::WITH_TRANSIENT;
+	mPositionsPendingFromCache = false;
 	// lazy references:
 	mTopicId = -1;
 	mTopicIdAsDataObject = 0;
@@ -86,196 +182,425 @@ bool Order::isAllResolved()
 }
 
 /*
- * initialize Order from QVariantMap
- * Map got from JsonDataAccess or so
- * includes also transient values
- * uses own property names
- * corresponding export method: toMap()
+ * row in the column arrays of DataManager (see OrderColumns.hpp)
+ * set by OrderColumns - columns 0: not attached
  */
-void Order::fillFromMap(const QVariantMap& orderMap)
+void Order::setColumnRow(OrderColumns* columns, const int& row)
 {
-	mNr = orderMap.value(nrKey).toInt();
-	mExpressOrder = orderMap.value(expressOrderKey).toBool();
-	mTitle = orderMap.value(titleKey).toString();
-	if (orderMap.contains(orderDateKey)) {
-		// always getting the Date as a String (from server or JSON)
-		QString orderDateAsString = orderMap.value(orderDateKey).toString();
-		mOrderDate = QDate::fromString(orderDateAsString, "yyyy-MM-dd");
-		if (!mOrderDate.isValid()) {
-			mOrderDate = QDate();
-			qDebug() << "mOrderDate is not valid for String: " << orderDateAsString;
-		}
+	mColumns = columns;
+	mColumnRow = row;
+}
+
+int Order::columnRow() const
+{
+	return mColumnRow;
+}
+
+void Order::setRootList(DenseObjectList* rootList)
+{
+	mRootList = rootList;
+}
+
+/*
+ * set by OrderSearchIndex - 0: not attached
+ */
+void Order::setSearchIndex(OrderSearchIndex* searchIndex)
+{
+	mSearchIndex = searchIndex;
+}
+
+/*
+ * set by BarcodeIndex - 0: not attached
+ */
+void Order::setBarcodeIndex(BarcodeIndex* barcodeIndex)
+{
+	mBarcodeIndex = barcodeIndex;
+}
+
+void Order::invalidateSearchText()
+{
+	if (mSearchIndex) {
+		mSearchIndex->markDirty(this);
 	}
-	// ENUM
-	if (orderMap.contains(stateKey)) {
-		bool* ok;
-		ok = false;
-		orderMap.value(stateKey).toInt(ok);
-		if (ok) {
-			mState = orderMap.value(stateKey).toInt();
-		} else {
-			mState = stateStringToInt(orderMap.value(stateKey).toString());
-		}
-	} else {
-		mState = OrderState::NO_VALUE;
+	if (mBarcodeIndex) {
+		mBarcodeIndex->markDirty(this);
 	}
-	// mProcessingState is transient
-	if (orderMap.contains(processingStateKey)) {
-		mProcessingState = orderMap.value(processingStateKey).toInt();
+}
+
+/*
+ * set by OrderReferenceIndex - 0: not attached
+ */
+void Order::setReferenceIndex(OrderReferenceIndex* referenceIndex)
+{
+	mReferenceIndex = referenceIndex;
+}
+
+// resolved lazy references and tags
+QList<QObject*> Order::referencedObjects() const
+{
+	QList<QObject*> targets;
+	if (mTopicIdAsDataObject) {
+		targets.append(mTopicIdAsDataObject);
 	}
-	// mInfo points to Info*
-	if (orderMap.contains(infoKey)) {
-		QVariantMap infoMap;
-		infoMap = orderMap.value(infoKey).toMap();
-		if (!infoMap.isEmpty()) {
-			mInfo = 0;
-			mInfo = new Info();
-			mInfo->setParent(this);
-			mInfo->fillFromMap(infoMap);
-		}
+	if (mExtrasAsDataObject) {
+		targets.append(mExtrasAsDataObject);
 	}
-	// topicId lazy pointing to Topic* (domainKey: id)
-	if (orderMap.contains(topicIdKey)) {
-		mTopicId = orderMap.value(topicIdKey).toInt();
-		if (mTopicId != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
-		}
+	if (mCustomerIdAsDataObject) {
+		targets.append(mCustomerIdAsDataObject);
 	}
-	// extras lazy pointing to Xtras* (domainKey: id)
-	if (orderMap.contains(extrasKey)) {
-		mExtras = orderMap.value(extrasKey).toInt();
-		if (mExtras != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
+	if (mDepIdAsDataObject) {
+		targets.append(mDepIdAsDataObject);
+	}
+	for (int i = 0; i < mTags.size(); ++i) {
+		targets.append(mTags.at(i));
+	}
+	return targets;
+}
+
+/*
+ * target will be deleted: reset all pointers to it
+ * lazy references keep their id but are marked invalid as if
+ * resolving didn't find the target, tags are removed from tags()
+ * as by removeFromTags() - their keys are not saved again
+ * returns the number of invalidated references
+ */
+int Order::invalidateReferenceTo(QObject* target)
+{
+	int references = 0;
+	if (mTopicIdAsDataObject == target) {
+		mTopicIdAsDataObject = 0;
+		mTopicIdInvalid = true;
+		references++;
+	}
+	if (mExtrasAsDataObject == target) {
+		mExtrasAsDataObject = 0;
+		mExtrasInvalid = true;
+		references++;
+	}
+	if (mCustomerIdAsDataObject == target) {
+		mCustomerIdAsDataObject = 0;
+		mCustomerIdInvalid = true;
+		references++;
+	}
+	if (mDepIdAsDataObject == target) {
+		mDepIdAsDataObject = 0;
+		mDepIdInvalid = true;
+		references++;
+	}
+	for (int i = mTags.size() - 1; i >= 0; --i) {
+		if (mTags.at(i) == target) {
+			mTags.removeAt(i);
+			references++;
 		}
 	}
-	// customerId lazy pointing to Customer* (domainKey: id)
-	if (orderMap.contains(customerIdKey)) {
-		mCustomerId = orderMap.value(customerIdKey).toInt();
-		if (mCustomerId != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
+	return references;
+}
+
+/*
+ * target will be replaced by an object with the same key (replaceAll...):
+ * reset all pointers to it without marking them invalid,
+ * so they are resolved again against the new objects.
+ * if a Tag is replaced all tags go back to their keys (tagsHandles())
+ * returns the number of released references
+ */
+int Order::releaseReferenceTo(QObject* target)
+{
+	int references = 0;
+	if (mTopicIdAsDataObject == target) {
+		mTopicIdAsDataObject = 0;
+		references++;
+	}
+	if (mExtrasAsDataObject == target) {
+		mExtrasAsDataObject = 0;
+		references++;
+	}
+	if (mCustomerIdAsDataObject == target) {
+		mCustomerIdAsDataObject = 0;
+		references++;
+	}
+	if (mDepIdAsDataObject == target) {
+		mDepIdAsDataObject = 0;
+		references++;
+	}
+	int tagReferences = 0;
+	for (int i = 0; i < mTags.size(); ++i) {
+		if (mTags.at(i) == target) {
+			tagReferences++;
 		}
 	}
-	// depId lazy pointing to Department* (domainKey: id)
-	if (orderMap.contains(depIdKey)) {
-		mDepId = orderMap.value(depIdKey).toInt();
-		if (mDepId != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
+	if (tagReferences > 0) {
+		// the index already dropped target - the other tags are removed here
+		mTagsHandles.clear();
+		mTagsHandles.reserve(mTags.size());
+		for (int i = 0; i < mTags.size(); ++i) {
+			mTagsHandles.append(mTags.at(i)->handle());
+			if (mTags.at(i) != target) {
+				replaceReference(mTags.at(i), 0);
+			}
 		}
+		mTags.clear();
+		mTagsKeysResolved = false;
+		references += tagReferences;
 	}
-	// mPositions is List of Item*
-	QVariantList positionsList;
-	positionsList = orderMap.value(positionsKey).toList();
-	mPositions.clear();
-	for (int i = 0; i < positionsList.size(); ++i) {
-		QVariantMap positionsMap;
-		positionsMap = positionsList.at(i).toMap();
-		Item* item = new Item();
-		item->setParent(this);
-		item->fillFromMap(positionsMap);
-		mPositions.append(item);
+	return references;
+}
+
+/*
+ * set by OrderEviction - 0: not attached
+ */
+void Order::setEviction(OrderEviction* eviction)
+{
+	mEviction = eviction;
+}
+
+void Order::setLastAccess(const quint64& lastAccess)
+{
+	mLastAccess = lastAccess;
+}
+
+// tick of OrderEviction - 0: never accessed
+quint64 Order::lastAccess() const
+{
+	return mLastAccess;
+}
+
+bool Order::hasMaterializedPositions() const
+{
+	return !mPositions.isEmpty();
+}
+
+qint64 Order::positionsMemoryBytes() const
+{
+	MemoryUsage usage;
+	for (int i = 0; i < mPositions.size(); ++i) {
+		mPositions.at(i)->addMemoryUsage(&usage);
 	}
-	// mTags is (lazy loaded) Array of Tag*
-	mTagsKeys = orderMap.value(tagsKey).toStringList();
-	// mTags must be resolved later if there are keys
-	mTagsKeysResolved = (mTagsKeys.size() == 0);
-	mTags.clear();
-	mDomainsStringList = orderMap.value(domainsKey).toStringList();
+	return usage.totalBytes();
 }
+
 /*
- * initialize OrderData from QVariantMap
- * Map got from JsonDataAccess or so
- * includes also transient values
- * uses foreign property names - per ex. from Server API
- * corresponding export method: toForeignMap()
+ * Items are deleted, positions are materialized again on next access:
+ * unchanged positions from the cache file are read again from their chunk,
+ * changed ones are kept as compact binary (no QVariantMaps)
+ * Items are deleted later: QML may still use them in this event loop
+ * returns false if there were no materialized positions
  */
-void Order::fillFromForeignMap(const QVariantMap& orderMap)
+bool Order::releasePositions(const bool& reloadableFromCache)
 {
-	mNr = orderMap.value(nrForeignKey).toInt();
-	mExpressOrder = orderMap.value(expressOrderForeignKey).toBool();
-	mTitle = orderMap.value(titleForeignKey).toString();
-	if (orderMap.contains(orderDateForeignKey)) {
-		// always getting the Date as a String (from server or JSON)
-		QString orderDateAsString = orderMap.value(orderDateForeignKey).toString();
-		mOrderDate = QDate::fromString(orderDateAsString, "yyyy-MM-dd");
-		if (!mOrderDate.isValid()) {
-			mOrderDate = QDate();
-			qDebug() << "mOrderDate is not valid for String: " << orderDateAsString;
-		}
+	if (mPositions.isEmpty()) {
+		return false;
 	}
-	// ENUM
-	if (orderMap.contains(stateForeignKey)) {
-		bool* ok;
-		ok = false;
-		orderMap.value(stateForeignKey).toInt(ok);
-		if (ok) {
-			mState = orderMap.value(stateForeignKey).toInt();
-		} else {
-			mState = stateStringToInt(orderMap.value(stateForeignKey).toString());
-		}
+	QByteArray data = positionsData();
+	bool inCache = reloadableFromCache && mPositionsFromCache && data == mPositionsCacheData;
+	if (inCache) {
+		mPositionsReleasedData.clear();
 	} else {
-		mState = OrderState::NO_VALUE;
+		mPositionsReleasedData = data;
 	}
-	// mProcessingState is transient
-	if (orderMap.contains(processingStateForeignKey)) {
-		mProcessingState = orderMap.value(processingStateForeignKey).toInt();
+	mPositionsReleasedCount = mPositions.size();
+	for (int i = 0; i < mPositions.size(); ++i) {
+		mPositions.at(i)->deleteLater();
 	}
-	// mInfo points to Info*
-	if (orderMap.contains(infoForeignKey)) {
-		QVariantMap infoMap;
-		infoMap = orderMap.value(infoForeignKey).toMap();
-		if (!infoMap.isEmpty()) {
-			mInfo = 0;
-			mInfo = new Info();
-			mInfo->setParent(this);
-			mInfo->fillFromForeignMap(infoMap);
-		}
+	mPositions.clear();
+	mPositionsFromCache = false;
+	mPositionsCacheData.clear();
+	mPositionsReleased = true;
+	return true;
+}
+
+void Order::setCacheChunk(const int& cacheChunk)
+{
+	mCacheChunk = cacheChunk;
+}
+
+int Order::cacheChunk() const
+{
+	return mCacheChunk;
+}
+
+bool Order::hasPositionsInCache() const
+{
+	return mPositionsReleased && mPositionsPending.isEmpty() && mPositionsReleasedData.isEmpty();
+}
+
+/*
+ * orderMap of this Order read again from the cache file
+ * positions are pending as after fillFromCacheMap()
+ */
+void Order::restorePositionsFromCacheMap(const QVariantMap& orderMap)
+{
+	mPositionsPending = orderMap.value(positionsKey).toList();
+	mPositionsPendingKeyNaming = DataWriter::OWN_KEYS;
+	mPositionsPendingTransientPolicy = DataWriter::WITHOUT_TRANSIENT;
+	mPositionsPendingFromCache = true;
+	mPositionsReleasedCount = 0;
+	if (mPositionsPending.isEmpty()) {
+		clearReleasedPositions();
 	}
-	// topicId lazy pointing to Topic* (domainKey: id)
-	if (orderMap.contains(topicIdForeignKey)) {
-		mTopicId = orderMap.value(topicIdForeignKey).toInt();
-		if (mTopicId != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
-		}
+}
+
+int Order::nrOfCacheMap(const QVariantMap& orderMap)
+{
+	return orderMap.value(nrKey, -1).toInt();
+}
+
+/*
+ * positions as BinaryDataWriter array - same bytes for unchanged positions
+ */
+QByteArray Order::positionsData() const
+{
+	QByteArray data;
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::WriteOnly);
+	BinaryDataWriter writer(&buffer, 4 * 1024);
+	writer.beginArray();
+	for (int i = 0; i < mPositions.size(); ++i) {
+		writer.beginObject();
+		mPositions.at(i)->writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
+		writer.endObject();
 	}
-	// extras lazy pointing to Xtras* (domainKey: id)
-	if (orderMap.contains(extrasForeignKey)) {
-		mExtras = orderMap.value(extrasForeignKey).toInt();
-		if (mExtras != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
-		}
+	writer.endArray();
+	writer.flush();
+	return data;
+}
+
+/*
+ * released positions back to pending maps - not materialized
+ * from the compact binary or from the chunk of the cache file
+ */
+void Order::loadReleasedPositions()
+{
+	if (!mPositionsReleased || !mPositionsPending.isEmpty() || !mPositions.isEmpty()) {
+		return;
 	}
-	// customerId lazy pointing to Customer* (domainKey: id)
-	if (orderMap.contains(customerIdForeignKey)) {
-		mCustomerId = orderMap.value(customerIdForeignKey).toInt();
-		if (mCustomerId != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
+	if (mPositionsReleasedData.isEmpty()) {
+		if (!mEviction || !mEviction->reloadPositions(this)) {
+			qWarning() << "Order: released positions not found in cache - nr " << mNr;
+			clearReleasedPositions();
 		}
+		return;
+	}
+	QBuffer buffer(&mPositionsReleasedData);
+	buffer.open(QIODevice::ReadOnly);
+	QScopedPointer<DataReader> reader(DataReader::create(&buffer));
+	QVariantMap itemMap;
+	while (reader->readNext(itemMap)) {
+		mPositionsPending.append(itemMap);
+	}
+	buffer.close();
+	mPositionsPendingKeyNaming = DataWriter::OWN_KEYS;
+	mPositionsPendingTransientPolicy = DataWriter::WITH_TRANSIENT;
+	mPositionsPendingFromCache = false;
+	mPositionsReleasedData.clear();
+	mPositionsReleasedCount = 0;
+}
+
+// positions replaced or cleared: released ones are not needed anymore
+void Order::clearReleasedPositions()
+{
+	mPositionsReleased = false;
+	mPositionsReleasedData.clear();
+	mPositionsReleasedCount = 0;
+}
+
+/*
+ * resets the resolved ...AsDataObject pointers - ids are kept, nothing is emitted
+ * the getters resolve them again by DataManager::resolveOrderReferences()
+ * tags stay resolved: only pointers, needed by queries
+ * returns false if no reference was resolved
+ */
+bool Order::releaseReferences()
+{
+	if (!mTopicIdAsDataObject && !mExtrasAsDataObject && !mCustomerIdAsDataObject && !mDepIdAsDataObject) {
+		return false;
 	}
-	// depId lazy pointing to Department* (domainKey: id)
-	if (orderMap.contains(depIdForeignKey)) {
-		mDepId = orderMap.value(depIdForeignKey).toInt();
-		if (mDepId != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
-		}
+	replaceReference(mTopicIdAsDataObject, 0);
+	mTopicIdAsDataObject = 0;
+	replaceReference(mExtrasAsDataObject, 0);
+	mExtrasAsDataObject = 0;
+	replaceReference(mCustomerIdAsDataObject, 0);
+	mCustomerIdAsDataObject = 0;
+	replaceReference(mDepIdAsDataObject, 0);
+	mDepIdAsDataObject = 0;
+	mReferencesReleased = true;
+	return true;
+}
+
+/*
+ * QML or the API read the positions: most recently used Order
+ * not called while saving, indexing or evicting
+ */
+void Order::markAccessed()
+{
+	if (mEviction) {
+		mEviction->touch(this);
 	}
-	// mPositions is List of Item*
-	QVariantList positionsList;
-	positionsList = orderMap.value(positionsForeignKey).toList();
-	mPositions.clear();
-	for (int i = 0; i < positionsList.size(); ++i) {
-		QVariantMap positionsMap;
-		positionsMap = positionsList.at(i).toMap();
-		Item* item = new Item();
-		item->setParent(this);
-		item->fillFromForeignMap(positionsMap);
-		mPositions.append(item);
+}
+
+/*
+ * released ...AsDataObject pointers are resolved again for the getters
+ * the getters stay logically const: the LRU state is not touched
+ */
+void Order::restoreReleasedReferences() const
+{
+	if (!mReferencesReleased || !mEviction) {
+		return;
+	}
+	Order* order = const_cast<Order*>(this);
+	order->mReferencesReleased = false;
+	mEviction->restoreReferences(order);
+}
+
+void Order::replaceReference(QObject* oldTarget, QObject* newTarget)
+{
+	if (!mReferenceIndex || oldTarget == newTarget) {
+		return;
+	}
+	if (oldTarget) {
+		mReferenceIndex->removeReference(oldTarget, this);
+	}
+	if (newTarget) {
+		mReferenceIndex->addReference(newTarget, this);
+	}
+}
+
+/*
+ * names of all positions, description and barcode of their subItems
+ * pending positions are read from their maps
+ */
+void Order::collectSearchText(QStringList& names, QStringList& descriptions, QStringList& barcodes)
+{
+	loadReleasedPositions();
+	for (int i = 0; i < mPositionsPending.size(); ++i) {
+		Item::collectSearchText(mPositionsPending.at(i).toMap(), mPositionsPendingKeyNaming, names,
+				descriptions, barcodes);
+	}
+	for (int i = 0; i < mPositions.size(); ++i) {
+		mPositions.at(i)->collectSearchText(names, descriptions, barcodes);
 	}
-	// mTags is (lazy loaded) Array of Tag*
-	mTagsKeys = orderMap.value(tagsForeignKey).toStringList();
-	// mTags must be resolved later if there are keys
-	mTagsKeysResolved = (mTagsKeys.size() == 0);
-	mTags.clear();
-	mDomainsStringList = orderMap.value(domainsForeignKey).toStringList();
+}
+
+/*
+ * initialize Order from QVariantMap
+ * Map got from JsonDataAccess or so
+ * includes also transient values
+ * uses own property names
+ * corresponding export method: toMap()
+ */
+void Order::fillFromMap(const QVariantMap& orderMap)
+{
+	fillFrom(orderMap, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
+}
+/*
+ * initialize OrderData from QVariantMap
+ * Map got from JsonDataAccess or so
+ * includes also transient values
+ * uses foreign property names - per ex. from Server API
+ * corresponding export method: toForeignMap()
+ */
+void Order::fillFromForeignMap(const QVariantMap& orderMap)
+{
+	fillFrom(orderMap, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -286,88 +611,137 @@ void Order::fillFromForeignMap(const QVariantMap& orderMap)
  */
 void Order::fillFromCacheMap(const QVariantMap& orderMap)
 {
-	mNr = orderMap.value(nrKey).toInt();
-	mExpressOrder = orderMap.value(expressOrderKey).toBool();
-	mTitle = orderMap.value(titleKey).toString();
-	if (orderMap.contains(orderDateKey)) {
-		// always getting the Date as a String (from server or JSON)
-		QString orderDateAsString = orderMap.value(orderDateKey).toString();
-		mOrderDate = QDate::fromString(orderDateAsString, "yyyy-MM-dd");
-		if (!mOrderDate.isValid()) {
-			mOrderDate = QDate();
-			qDebug() << "mOrderDate is not valid for String: " << orderDateAsString;
-		}
-	}
-	// ENUM
-	if (orderMap.contains(stateKey)) {
-		bool* ok;
-		ok = false;
-		orderMap.value(stateKey).toInt(ok);
-		if (ok) {
-			mState = orderMap.value(stateKey).toInt();
-		} else {
-			mState = stateStringToInt(orderMap.value(stateKey).toString());
-		}
-	} else {
-		mState = OrderState::NO_VALUE;
+	fillFrom(orderMap, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+	mPositionsPendingFromCache = !mPositionsPending.isEmpty();
+}
+
+/*
+ * initialize Order from QVariantMap
+ * walks orderMap only once: each key is dispatched by orderField()
+ * keyNaming: own property names or names from Server API
+ * transientPolicy WITHOUT_TRANSIENT ignores transient values (cache)
+ * corresponding export method: writeTo()
+ */
+void Order::fillFrom(const QVariantMap& orderMap, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	TraceSpan span("Order::fillFrom", "dto");
+	// properties not contained in orderMap get default values
+	mNr = 0;
+	mExpressOrder = false;
+	mTitle = QString();
+	mState = OrderState::NO_VALUE;
+	mPositions.clear();
+	mPositionsPending.clear();
+	mPositionsPendingFromCache = false;
+	mPositionsFromCache = false;
+	mPositionsCacheData.clear();
+	clearReleasedPositions();
+	if (mEviction) {
+		mEviction->positionsCleared(this);
+	}
+	mTagsHandles.clear();
+	for (int i = 0; i < mTags.size(); ++i) {
+		replaceReference(mTags.at(i), 0);
 	}
-	// mProcessingState is transient - don't forget to initialize
-	// mInfo points to Info*
-	if (orderMap.contains(infoKey)) {
-		QVariantMap infoMap;
-		infoMap = orderMap.value(infoKey).toMap();
-		if (!infoMap.isEmpty()) {
-			mInfo = new Info();
-			mInfo->setParent(this);
-			mInfo->fillFromCacheMap(infoMap);
+	mTags.clear();
+	mDomainsStringList.clear();
+	QVariantMap::const_iterator it;
+	for (it = orderMap.constBegin(); it != orderMap.constEnd(); ++it) {
+		switch (orderField(it.key(), keyNaming)) {
+		case NR_FIELD:
+			mNr = it.value().toInt();
+			break;
+		case EXPRESS_ORDER_FIELD:
+			mExpressOrder = it.value().toBool();
+			break;
+		case TITLE_FIELD:
+			mTitle = it.value().toString();
+			break;
+		case ORDER_DATE_FIELD:
+			// Date as String yyyy-MM-dd (from server or JSON) or QDate (binary cache)
+			mOrderDate = DateCodec::fromVariant(it.value());
+			if (!mOrderDate.isValid()) {
+				mOrderDate = QDate();
+				DATA_LOG(DATA_LOG_DTO) << "mOrderDate is not valid for String: " << it.value().toString();
+			}
+			break;
+		case STATE_FIELD: {
+			// ENUM as int or as String
+			bool ok = false;
+			mState = it.value().toInt(&ok);
+			if (!ok) {
+				mState = stateStringToInt(it.value().toString());
+			}
+			break;
 		}
-	}
-	// topicId lazy pointing to Topic* (domainKey: id)
-	if (orderMap.contains(topicIdKey)) {
-		mTopicId = orderMap.value(topicIdKey).toInt();
-		if (mTopicId != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
+		case PROCESSING_STATE_FIELD:
+			// mProcessingState is transient
+			if (transientPolicy == DataWriter::WITH_TRANSIENT) {
+				mProcessingState = it.value().toInt();
+			}
+			break;
+		case POSITIONS_FIELD:
+			// mPositions is List of Item* - created on first access
+			mPositionsPending = it.value().toList();
+			mPositionsPendingKeyNaming = keyNaming;
+			mPositionsPendingTransientPolicy = transientPolicy;
+			break;
+		case INFO_FIELD: {
+			// mInfo points to Info*
+			QVariantMap infoMap;
+			infoMap = it.value().toMap();
+			if (!infoMap.isEmpty()) {
+				mInfo = new Info();
+				mInfo->setParent(this);
+				mInfo->fillFrom(infoMap, keyNaming, transientPolicy);
+			}
+			break;
 		}
-	}
-	// extras lazy pointing to Xtras* (domainKey: id)
-	if (orderMap.contains(extrasKey)) {
-		mExtras = orderMap.value(extrasKey).toInt();
-		if (mExtras != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
+		case TOPIC_ID_FIELD:
+			// topicId lazy pointing to Topic* (domainKey: id)
+			mTopicId = it.value().toInt();
+			break;
+		case EXTRAS_FIELD:
+			// extras lazy pointing to Xtras* (domainKey: id)
+			mExtras = it.value().toInt();
+			break;
+		case CUSTOMER_ID_FIELD:
+			// customerId lazy pointing to Customer* (domainKey: id)
+			mCustomerId = it.value().toInt();
+			break;
+		case DEP_ID_FIELD:
+			// depId lazy pointing to Department* (domainKey: id)
+			mDepId = it.value().toInt();
+			break;
+		case TAGS_FIELD: {
+			// mTags is (lazy loaded) Array of Tag*
+			QStringList tagsKeyList;
+			tagsKeyList = it.value().toStringList();
+			mTagsHandles.reserve(tagsKeyList.size());
+			for (int i = 0; i < tagsKeyList.size(); ++i) {
+				if (!tagsKeyList.at(i).isEmpty()) {
+					mTagsHandles.append(Tag::handleForUuid(tagsKeyList.at(i)));
+				}
+			}
+			break;
 		}
-	}
-	// customerId lazy pointing to Customer* (domainKey: id)
-	if (orderMap.contains(customerIdKey)) {
-		mCustomerId = orderMap.value(customerIdKey).toInt();
-		if (mCustomerId != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
+		case DOMAINS_FIELD:
+			mDomainsStringList = StringPool::interned(it.value().toStringList());
+			break;
+		default:
+			break;
 		}
 	}
-	// depId lazy pointing to Department* (domainKey: id)
-	if (orderMap.contains(depIdKey)) {
-		mDepId = orderMap.value(depIdKey).toInt();
-		if (mDepId != -1) {
-			// resolve the corresponding Data Object on demand from DataManager
-		}
+	// mTags must be resolved later if there are keys
+	mTagsKeysResolved = (mTagsHandles.size() == 0);
+	if (mColumns) {
+		mColumns->update(mColumnRow, this);
 	}
-	// mPositions is List of Item*
-	QVariantList positionsList;
-	positionsList = orderMap.value(positionsKey).toList();
-	mPositions.clear();
-	for (int i = 0; i < positionsList.size(); ++i) {
-		QVariantMap positionsMap;
-		positionsMap = positionsList.at(i).toMap();
-		Item* item = new Item();
-		item->setParent(this);
-		item->fillFromCacheMap(positionsMap);
-		mPositions.append(item);
+	if (mRootList) {
+		mRootList->keyChanged(this);
 	}
-	// mTags is (lazy loaded) Array of Tag*
-	mTagsKeys = orderMap.value(tagsKey).toStringList();
-	// mTags must be resolved later if there are keys
-	mTagsKeysResolved = (mTagsKeys.size() == 0);
-	mTags.clear();
-	mDomainsStringList = orderMap.value(domainsKey).toStringList();
+	invalidateSearchText();
 }
 
 void Order::prepareNew()
@@ -388,7 +762,7 @@ bool Order::isValid()
 	if (mOrderDate.isNull() || !mOrderDate.isValid()) {
 		return false;
 	}
-	if (mPositions.size() == 0) {
+	if (positionsCount() == 0) {
 		return false;
 	}
 	// customerId lazy pointing to Customer* (domainKey: id)
@@ -409,52 +783,11 @@ bool Order::isValid()
  */
 QVariantMap Order::toMap()
 {
-	QVariantMap orderMap;
-	// topicId lazy pointing to Topic* (domainKey: id)
-	if (mTopicId != -1) {
-		orderMap.insert(topicIdKey, mTopicId);
-	}
-	// extras lazy pointing to Xtras* (domainKey: id)
-	if (mExtras != -1) {
-		orderMap.insert(extrasKey, mExtras);
-	}
-	// customerId lazy pointing to Customer* (domainKey: id)
-	if (mCustomerId != -1) {
-		orderMap.insert(customerIdKey, mCustomerId);
-	}
-	// depId lazy pointing to Department* (domainKey: id)
-	if (mDepId != -1) {
-		orderMap.insert(depIdKey, mDepId);
-	}
-	// mTags points to Tag*
-	// lazy array: persist only keys
-	if(mTagsKeysResolved || (mTagsKeys.size() == 0 && mTags.size() != 0)) {
-		mTagsKeys.clear();
-		for (int i = 0; i < mTags.size(); ++i) {
-			Tag* tag;
-			tag = mTags.at(i);
-			mTagsKeys << tag->uuid();
-		}
-	}
-	orderMap.insert(tagsKey, mTagsKeys);
-	orderMap.insert(nrKey, mNr);
-	orderMap.insert(expressOrderKey, mExpressOrder);
-	orderMap.insert(titleKey, mTitle);
-	if (hasOrderDate()) {
-		orderMap.insert(orderDateKey, mOrderDate.toString("yyyy-MM-dd"));
-	}
-	// ENUM always as  int
-	orderMap.insert(stateKey, mState);
-	orderMap.insert(processingStateKey, mProcessingState);
-	// mPositions points to Item*
-	orderMap.insert(positionsKey, positionsAsQVariantList());
-	// mInfo points to Info*
-	if (mInfo) {
-	orderMap.insert(infoKey, mInfo->toMap());
-	}
-	// Array of QString
-	orderMap.insert(domainsKey, mDomainsStringList);
-	return orderMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 /*
@@ -464,52 +797,11 @@ QVariantMap Order::toMap()
  */
 QVariantMap Order::toForeignMap()
 {
-	QVariantMap orderMap;
-	// topicId lazy pointing to Topic* (domainKey: id)
-	if (mTopicId != -1) {
-		orderMap.insert(topicIdForeignKey, mTopicId);
-	}
-	// extras lazy pointing to Xtras* (domainKey: id)
-	if (mExtras != -1) {
-		orderMap.insert(extrasForeignKey, mExtras);
-	}
-	// customerId lazy pointing to Customer* (domainKey: id)
-	if (mCustomerId != -1) {
-		orderMap.insert(customerIdForeignKey, mCustomerId);
-	}
-	// depId lazy pointing to Department* (domainKey: id)
-	if (mDepId != -1) {
-		orderMap.insert(depIdForeignKey, mDepId);
-	}
-	// mTags points to Tag*
-	// lazy array: persist only keys
-	if(mTagsKeysResolved || (mTagsKeys.size() == 0 && mTags.size() != 0)) {
-		mTagsKeys.clear();
-		for (int i = 0; i < mTags.size(); ++i) {
-			Tag* tag;
-			tag = mTags.at(i);
-			mTagsKeys << tag->uuid();
-		}
-	}
-	orderMap.insert(tagsKey, mTagsKeys);
-	orderMap.insert(nrForeignKey, mNr);
-	orderMap.insert(expressOrderForeignKey, mExpressOrder);
-	orderMap.insert(titleForeignKey, mTitle);
-	if (hasOrderDate()) {
-		orderMap.insert(orderDateForeignKey, mOrderDate.toString("yyyy-MM-dd"));
-	}
-	// ENUM always as  int
-	orderMap.insert(stateForeignKey, mState);
-	orderMap.insert(processingStateForeignKey, mProcessingState);
-	// mPositions points to Item*
-	orderMap.insert(positionsForeignKey, positionsAsQVariantList());
-	// mInfo points to Info*
-	if (mInfo) {
-		orderMap.insert(infoForeignKey, mInfo->toMap());
-	}
-	// Array of QString
-	orderMap.insert(domainsForeignKey, mDomainsStringList);
-	return orderMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 
@@ -521,52 +813,92 @@ QVariantMap Order::toForeignMap()
  */
 QVariantMap Order::toCacheMap()
 {
-	QVariantMap orderMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+	writer.endObject();
+	return writer.map();
+}
+
+/*
+ * writes all properties into the current object of writer
+ * used by toMap(), toForeignMap(), toCacheMap() and to write caches
+ * keyNaming: own property names or names from Server API
+ * transientPolicy WITHOUT_TRANSIENT excludes: mProcessingState
+ */
+void Order::writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
 	// topicId lazy pointing to Topic* (domainKey: id)
 	if (mTopicId != -1) {
-		orderMap.insert(topicIdKey, mTopicId);
+		writer->writeInt(foreign ? topicIdForeignKey : topicIdKey, mTopicId);
 	}
 	// extras lazy pointing to Xtras* (domainKey: id)
 	if (mExtras != -1) {
-		orderMap.insert(extrasKey, mExtras);
+		writer->writeInt(foreign ? extrasForeignKey : extrasKey, mExtras);
 	}
 	// customerId lazy pointing to Customer* (domainKey: id)
 	if (mCustomerId != -1) {
-		orderMap.insert(customerIdKey, mCustomerId);
+		writer->writeInt(foreign ? customerIdForeignKey : customerIdKey, mCustomerId);
 	}
 	// depId lazy pointing to Department* (domainKey: id)
 	if (mDepId != -1) {
-		orderMap.insert(depIdKey, mDepId);
+		writer->writeInt(foreign ? depIdForeignKey : depIdKey, mDepId);
 	}
 	// mTags points to Tag*
 	// lazy array: persist only keys
-	if(mTagsKeysResolved || (mTagsKeys.size() == 0 && mTags.size() != 0)) {
-		mTagsKeys.clear();
+	if(mTagsKeysResolved || (mTagsHandles.size() == 0 && mTags.size() != 0)) {
+		mTagsHandles.clear();
 		for (int i = 0; i < mTags.size(); ++i) {
 			Tag* tag;
 			tag = mTags.at(i);
-			mTagsKeys << tag->uuid();
+			mTagsHandles.append(tag->handle());
 		}
 	}
-	orderMap.insert(tagsKey, mTagsKeys);
-	orderMap.insert(nrKey, mNr);
-	orderMap.insert(expressOrderKey, mExpressOrder);
-	orderMap.insert(titleKey, mTitle);
+	writer->writeStringList(foreign ? tagsForeignKey : tagsKey, tagsKeys());
+	writer->writeInt(foreign ? nrForeignKey : nrKey, mNr);
+	writer->writeBool(foreign ? expressOrderForeignKey : expressOrderKey, mExpressOrder);
+	writer->writeString(foreign ? titleForeignKey : titleKey, mTitle);
 	if (hasOrderDate()) {
-		orderMap.insert(orderDateKey, mOrderDate.toString("yyyy-MM-dd"));
+		writer->writeDate(foreign ? orderDateForeignKey : orderDateKey, mOrderDate);
 	}
 	// ENUM always as  int
-	orderMap.insert(stateKey, mState);
+	writer->writeInt(foreign ? stateForeignKey : stateKey, mState);
+	// transient: mProcessingState
+	if (transientPolicy == DataWriter::WITH_TRANSIENT) {
+		writer->writeInt(foreign ? processingStateForeignKey : processingStateKey, mProcessingState);
+	}
 	// mPositions points to Item*
-	orderMap.insert(positionsKey, positionsAsQVariantList());
+	loadReleasedPositions();
+	if (!mPositionsPending.isEmpty() && mPositionsPendingKeyNaming == keyNaming) {
+		// not materialized: write the maps as read (Item has no transient properties)
+		// Item drops keys it doesn't know
+		writer->beginArray(foreign ? positionsForeignKey : positionsKey);
+		for (int i = 0; i < mPositionsPending.size(); ++i) {
+			writer->beginObject();
+			Item::writeMapTo(writer, mPositionsPending.at(i).toMap(), keyNaming);
+			writer->endObject();
+		}
+		writer->endArray();
+	} else {
+		materializePositions();
+		writer->beginArray(foreign ? positionsForeignKey : positionsKey);
+		for (int i = 0; i < mPositions.size(); ++i) {
+			writer->beginObject();
+			mPositions.at(i)->writeTo(writer, keyNaming, transientPolicy);
+			writer->endObject();
+		}
+		writer->endArray();
+	}
 	// mInfo points to Info*
 	if (mInfo) {
-	orderMap.insert(infoKey, mInfo->toMap());
+		writer->beginObject(foreign ? infoForeignKey : infoKey);
+		mInfo->writeTo(writer, keyNaming, transientPolicy);
+		writer->endObject();
 	}
 	// Array of QString
-	orderMap.insert(domainsKey, mDomainsStringList);
-	// excluded: mProcessingState
-	return orderMap;
+	writer->writeStringList(foreign ? domainsForeignKey : domainsKey, mDomainsStringList);
 }
 // REF
 // Lazy: topicId
@@ -578,6 +910,7 @@ int Order::topicId() const
 }
 Topic* Order::topicIdAsDataObject() const
 {
+	restoreReleasedReferences();
 	return mTopicIdAsDataObject;
 }
 void Order::setTopicId(int topicId)
@@ -586,6 +919,7 @@ void Order::setTopicId(int topicId)
         // remove old Data Object if one was resolved
         if (mTopicIdAsDataObject) {
             // reset pointer, don't delete the independent object !
+            replaceReference(mTopicIdAsDataObject, 0);
             mTopicIdAsDataObject = 0;
         }
         // set the new lazy reference
@@ -627,6 +961,7 @@ void Order::resolveTopicIdAsDataObject(Topic* topic)
         if (topic->id() != mTopicId) {
             setTopicId(topic->id());
         }
+        replaceReference(mTopicIdAsDataObject, topic);
         mTopicIdAsDataObject = topic;
         mTopicIdInvalid = false;
     }
@@ -645,6 +980,7 @@ int Order::extras() const
 }
 Xtras* Order::extrasAsDataObject() const
 {
+	restoreReleasedReferences();
 	return mExtrasAsDataObject;
 }
 void Order::setExtras(int extras)
@@ -653,6 +989,7 @@ void Order::setExtras(int extras)
         // remove old Data Object if one was resolved
         if (mExtrasAsDataObject) {
             // reset pointer, don't delete the independent object !
+            replaceReference(mExtrasAsDataObject, 0);
             mExtrasAsDataObject = 0;
         }
         // set the new lazy reference
@@ -694,6 +1031,7 @@ void Order::resolveExtrasAsDataObject(Xtras* xtras)
         if (xtras->id() != mExtras) {
             setExtras(xtras->id());
         }
+        replaceReference(mExtrasAsDataObject, xtras);
         mExtrasAsDataObject = xtras;
         mExtrasInvalid = false;
     }
@@ -712,6 +1050,7 @@ int Order::customerId() const
 }
 Customer* Order::customerIdAsDataObject() const
 {
+	restoreReleasedReferences();
 	return mCustomerIdAsDataObject;
 }
 void Order::setCustomerId(int customerId)
@@ -720,11 +1059,15 @@ void Order::setCustomerId(int customerId)
         // remove old Data Object if one was resolved
         if (mCustomerIdAsDataObject) {
             // reset pointer, don't delete the independent object !
+            replaceReference(mCustomerIdAsDataObject, 0);
             mCustomerIdAsDataObject = 0;
         }
         // set the new lazy reference
         mCustomerId = customerId;
         mCustomerIdInvalid = false;
+        if (mColumns) {
+            mColumns->setCustomerId(mColumnRow, customerId);
+        }
         emit customerIdChanged(customerId);
         if (customerId != -1) {
             // resolve the corresponding Data Object on demand from DataManager
@@ -761,6 +1104,7 @@ void Order::resolveCustomerIdAsDataObject(Customer* customer)
         if (customer->id() != mCustomerId) {
             setCustomerId(customer->id());
         }
+        replaceReference(mCustomerIdAsDataObject, customer);
         mCustomerIdAsDataObject = customer;
         mCustomerIdInvalid = false;
     }
@@ -779,6 +1123,7 @@ int Order::depId() const
 }
 Department* Order::depIdAsDataObject() const
 {
+	restoreReleasedReferences();
 	return mDepIdAsDataObject;
 }
 void Order::setDepId(int depId)
@@ -787,11 +1132,15 @@ void Order::setDepId(int depId)
         // remove old Data Object if one was resolved
         if (mDepIdAsDataObject) {
             // reset pointer, don't delete the independent object !
+            replaceReference(mDepIdAsDataObject, 0);
             mDepIdAsDataObject = 0;
         }
         // set the new lazy reference
         mDepId = depId;
         mDepIdInvalid = false;
+        if (mColumns) {
+            mColumns->setDepId(mColumnRow, depId);
+        }
         emit depIdChanged(depId);
         if (depId != -1) {
             // resolve the corresponding Data Object on demand from DataManager
@@ -828,6 +1177,7 @@ void Order::resolveDepIdAsDataObject(Department* department)
         if (department->id() != mDepId) {
             setDepId(department->id());
         }
+        replaceReference(mDepIdAsDataObject, department);
         mDepIdAsDataObject = department;
         mDepIdInvalid = false;
     }
@@ -848,6 +1198,12 @@ void Order::setNr(int nr)
 {
 	if (nr != mNr) {
 		mNr = nr;
+		if (mColumns) {
+			mColumns->setNr(mColumnRow, nr);
+		}
+		if (mRootList) {
+			mRootList->keyChanged(this);
+		}
 		emit nrChanged(nr);
 	}
 }
@@ -862,6 +1218,9 @@ void Order::setExpressOrder(bool expressOrder)
 {
 	if (expressOrder != mExpressOrder) {
 		mExpressOrder = expressOrder;
+		if (mColumns) {
+			mColumns->setExpressOrder(mColumnRow, expressOrder);
+		}
 		emit expressOrderChanged(expressOrder);
 	}
 }
@@ -877,6 +1236,7 @@ void Order::setTitle(QString title)
 	if (title != mTitle) {
 		mTitle = title;
 		emit titleChanged(title);
+		invalidateSearchText();
 	}
 }
 // ATT 
@@ -898,6 +1258,9 @@ void Order::setOrderDate(QDate orderDate)
 {
 	if (orderDate != mOrderDate) {
 		mOrderDate = orderDate;
+		if (mColumns) {
+			mColumns->setOrderDate(mColumnRow, orderDate);
+		}
 		emit orderDateChanged(orderDate);
 	}
 }
@@ -916,6 +1279,9 @@ void Order::setState(int state)
 {
 	if (state != mState) {
 		mState = state;
+		if (mColumns) {
+			mColumns->setState(mColumnRow, state);
+		}
 		emit stateChanged(state);
 	}
 }
@@ -1037,7 +1403,7 @@ bool Order::removeFromDomainsStringList(const QString& stringValue)
     bool ok = false;
     ok = mDomainsStringList.removeOne(stringValue);
     if (!ok) {
-    	qDebug() << "QString& not found in mDomainsStringList: " << stringValue;
+    	DATA_LOG(DATA_LOG_DTO) << "QString& not found in mDomainsStringList: " << stringValue;
     	return false;
     }
     emit removedFromDomainsStringList(stringValue);
@@ -1063,6 +1429,8 @@ void Order::setDomainsStringList(const QStringList& domains)
 // Mandatory: positions
 QVariantList Order::positionsAsQVariantList()
 {
+	markAccessed();
+	materializePositions();
 	QVariantList positionsList;
 	for (int i = 0; i < mPositions.size(); ++i) {
         positionsList.append((mPositions.at(i))->toMap());
@@ -1100,19 +1468,23 @@ void Order::undoCreateElementOfPositions(Item* item)
 }
 void Order::addToPositions(Item* item)
 {
+	materializePositions();
     mPositions.append(item);
     emit addedToPositions(item);
+    invalidateSearchText();
 }
 
 bool Order::removeFromPositions(Item* item)
 {
+	materializePositions();
     bool ok = false;
     ok = mPositions.removeOne(item);
     if (!ok) {
-    	qDebug() << "Item* not found in positions";
+    	DATA_LOG(DATA_LOG_DTO) << "Item* not found in positions";
     	return false;
     }
     emit removedFromPositionsByUuid(item->uuid());
+    invalidateSearchText();
     // positions are contained - so we must delete them
     item->deleteLater();
     item = 0;
@@ -1120,49 +1492,92 @@ bool Order::removeFromPositions(Item* item)
 }
 void Order::clearPositions()
 {
+	materializePositions();
     for (int i = mPositions.size(); i > 0; --i) {
         removeFromPositions(mPositions.last());
     }
 }
 void Order::addToPositionsFromMap(const QVariantMap& itemMap)
 {
+	materializePositions();
     Item* item = new Item();
     item->setParent(this);
     item->fillFromMap(itemMap);
     mPositions.append(item);
     emit addedToPositions(item);
+    invalidateSearchText();
 }
 bool Order::removeFromPositionsByUuid(const QString& uuid)
 {
+	materializePositions();
     for (int i = 0; i < mPositions.size(); ++i) {
     	Item* item;
         item = mPositions.at(i);
         if (item->uuid() == uuid) {
         	mPositions.removeAt(i);
         	emit removedFromPositionsByUuid(uuid);
+        	invalidateSearchText();
         	// positions are contained - so we must delete them
         	item->deleteLater();
         	item = 0;
         	return true;
         }
     }
-    qDebug() << "uuid not found in positions: " << uuid;
+    DATA_LOG(DATA_LOG_DTO) << "uuid not found in positions: " << uuid;
     return false;
 }
 
+/*
+ * positions from cache or map are kept as read until first access:
+ * list screens only need the properties of Order
+ */
+void Order::materializePositions()
+{
+	loadReleasedPositions();
+	if (mPositionsPending.isEmpty()) {
+		return;
+	}
+	for (int i = 0; i < mPositionsPending.size(); ++i) {
+		Item* item = new Item();
+		item->setParent(this);
+		item->fillFrom(mPositionsPending.at(i).toMap(), mPositionsPendingKeyNaming, mPositionsPendingTransientPolicy);
+		mPositions.append(item);
+	}
+	mPositionsPending.clear();
+	mPositionsFromCache = false;
+	mPositionsCacheData.clear();
+	if (mEviction) {
+		if (mPositionsPendingFromCache) {
+			// compared in releasePositions(): unchanged positions can be read again from the cache file
+			mPositionsFromCache = true;
+			mPositionsCacheData = positionsData();
+		}
+		mEviction->positionsMaterialized(this, mPositionsReleased);
+	}
+	mPositionsPendingFromCache = false;
+	mPositionsReleased = false;
+}
+
+/*
+ * doesn't materialize the positions
+ */
 int Order::positionsCount()
 {
-    return mPositions.size();
+    return mPositions.size() + mPositionsPending.size() + mPositionsReleasedCount;
 }
 QList<Item*> Order::positions()
 {
+	markAccessed();
+	materializePositions();
 	return mPositions;
 }
 void Order::setPositions(QList<Item*> positions) 
 {
+	materializePositions();
 	if (positions != mPositions) {
 		mPositions = positions;
 		emit positionsChanged(positions);
+		invalidateSearchText();
 	}
 }
 /**
@@ -1187,8 +1602,10 @@ void Order::appendToPositionsProperty(QDeclarativeListProperty<Item> *positionsL
     Order *orderObject = qobject_cast<Order *>(positionsList->object);
     if (orderObject) {
 		item->setParent(orderObject);
+        orderObject->materializePositions();
         orderObject->mPositions.append(item);
         emit orderObject->addedToPositions(item);
+        orderObject->invalidateSearchText();
     } else {
         qWarning() << "cannot append Item* to positions " << "Object is not of type Order*";
     }
@@ -1197,7 +1614,7 @@ int Order::positionsPropertyCount(QDeclarativeListProperty<Item> *positionsList)
 {
     Order *order = qobject_cast<Order *>(positionsList->object);
     if (order) {
-        return order->mPositions.size();
+        return order->positionsCount();
     } else {
         qWarning() << "cannot get size positions " << "Object is not of type Order*";
     }
@@ -1207,6 +1624,8 @@ Item* Order::atPositionsProperty(QDeclarativeListProperty<Item> *positionsList,
 {
     Order *order = qobject_cast<Order *>(positionsList->object);
     if (order) {
+        order->markAccessed();
+        order->materializePositions();
         if (order->mPositions.size() > pos) {
             return order->mPositions.at(pos);
         }
@@ -1226,6 +1645,12 @@ void Order::clearPositionsProperty(QDeclarativeListProperty<Item> *positionsList
             order->mPositions.at(i)->deleteLater();
         }
         order->mPositions.clear();
+        order->mPositionsPending.clear();
+        order->clearReleasedPositions();
+        if (order->mEviction) {
+            order->mEviction->positionsCleared(order);
+        }
+        order->invalidateSearchText();
     } else {
         qWarning() << "cannot clear positions " << "Object is not of type Order*";
     }
@@ -1245,6 +1670,7 @@ QVariantList Order::tagsAsQVariantList()
 void Order::addToTags(Tag* tag)
 {
     mTags.append(tag);
+    replaceReference(0, tag);
     emit addedToTags(tag);
 }
 
@@ -1253,9 +1679,12 @@ bool Order::removeFromTags(Tag* tag)
     bool ok = false;
     ok = mTags.removeOne(tag);
     if (!ok) {
-    	qDebug() << "Tag* not found in tags";
+    	DATA_LOG(DATA_LOG_DTO) << "Tag* not found in tags";
     	return false;
     }
+    if (!mTags.contains(tag)) {
+        replaceReference(tag, 0);
+    }
     // tags are independent - DON'T delete them
     return true;
 }
@@ -1271,7 +1700,7 @@ void Order::clearTags()
  * so we get a list of keys (uuid or domain keys) from map
  * and we persist only the keys toMap()
  * after initializing the keys must be resolved:
- * - get the list of keys: tagsKeys()
+ * - get the list of keys: tagsKeys() or tagsHandles()
  * - resolve them from DataManager
  * - then resolveTagsKeys()
  */
@@ -1282,7 +1711,16 @@ bool Order::areTagsKeysResolved()
 
 QStringList Order::tagsKeys()
 {
-    return mTagsKeys;
+    QStringList tagsKeyList;
+    for (int i = 0; i < mTagsHandles.size(); ++i) {
+        tagsKeyList << Tag::uuidForHandle(mTagsHandles.at(i));
+    }
+    return tagsKeyList;
+}
+
+QVector<int> Order::tagsHandles()
+{
+    return mTagsHandles;
 }
 
 void Order::resolveTagsKeys(QList<Tag*> tags)
@@ -1290,6 +1728,9 @@ void Order::resolveTagsKeys(QList<Tag*> tags)
     if(mTagsKeysResolved){
         return;
     }
+    for (int i = 0; i < mTags.size(); ++i) {
+        replaceReference(mTags.at(i), 0);
+    }
     mTags.clear();
     for (int i = 0; i < tags.size(); ++i) {
         addToTags(tags.at(i));
@@ -1308,7 +1749,13 @@ QList<Tag*> Order::tags()
 void Order::setTags(QList<Tag*> tags) 
 {
 	if (tags != mTags) {
+		for (int i = 0; i < mTags.size(); ++i) {
+			replaceReference(mTags.at(i), 0);
+		}
 		mTags = tags;
+		for (int i = 0; i < mTags.size(); ++i) {
+			replaceReference(0, mTags.at(i));
+		}
 		emit tagsChanged(tags);
 	}
 }
@@ -1334,6 +1781,7 @@ void Order::appendToTagsProperty(QDeclarativeListProperty<Tag> *tagsList,
     Order *orderObject = qobject_cast<Order *>(tagsList->object);
     if (orderObject) {
         orderObject->mTags.append(tag);
+        orderObject->replaceReference(0, tag);
         emit orderObject->addedToTags(tag);
     } else {
         qWarning() << "cannot append Tag* to tags " << "Object is not of type Order*";
@@ -1368,6 +1816,9 @@ void Order::clearTagsProperty(QDeclarativeListProperty<Tag> *tagsList)
     Order *order = qobject_cast<Order *>(tagsList->object);
     if (order) {
         // tags are independent - DON'T delete them
+        for (int i = 0; i < order->mTags.size(); ++i) {
+            order->replaceReference(order->mTags.at(i), 0);
+        }
         order->mTags.clear();
     } else {
         qWarning() << "cannot clear tags " << "Object is not of type Order*";
@@ -1375,6 +1826,27 @@ void Order::clearTagsProperty(QDeclarativeListProperty<Tag> *tagsList)
 }
 
 
+/*
+ * estimated memory of this Order, its positions and Info
+ * Topic, Xtras, Customer, Department and Tag are references - counted as their own type
+ */
+void Order::addMemoryUsage(MemoryUsage* usage) const
+{
+	qint64 stringBytes = MemoryUsage::stringBytes(mTitle) + MemoryUsage::stringListBytes(mDomainsStringList);
+	qint64 listBytes = MemoryUsage::listBytes(mPositions.size()) + MemoryUsage::listBytes(mTags.size())
+			+ MemoryUsage::vectorBytes(mTagsHandles.capacity(), sizeof(int));
+	// pending: maps not materialized yet and compact binary of released or cached positions
+	usage->addObject(MemoryUsage::ORDER, MemoryUsage::objectBytes(sizeof(Order)), stringBytes, listBytes,
+			MemoryUsage::variantListBytes(mPositionsPending) + mPositionsReleasedData.capacity()
+					+ mPositionsCacheData.capacity());
+	if (mInfo) {
+		mInfo->addMemoryUsage(usage);
+	}
+	for (int i = 0; i < mPositions.size(); ++i) {
+		mPositions.at(i)->addMemoryUsage(usage);
+	}
+}
+
 Order::~Order()
 {
 	// place cleanUp code here
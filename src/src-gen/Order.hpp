@@ -5,7 +5,9 @@
 #include <qvariant.h>
 #include <QDeclarativeListProperty>
 #include <QStringList>
+#include <QVector>
 #include <QDate>
+#include "../DataWriter.hpp"
 
 #include "OrderState.hpp"
 
@@ -17,6 +19,15 @@
 #include "Department.hpp"
 #include "Tag.hpp"
 
+class OrderColumns;
+class OrderSearchIndex;
+class BarcodeIndex;
+class OrderReferenceIndex;
+class OrderEviction;
+
+
+class MemoryUsage;
+class DenseObjectList;
 
 class Order: public QObject
 {
@@ -55,9 +66,46 @@ public:
 	Q_INVOKABLE
 	bool isAllResolved();
 
+	void setColumnRow(OrderColumns* columns, const int& row);
+	int columnRow() const;
+	// root list of DataManager - informed if the nr changes
+	void setRootList(DenseObjectList* rootList);
+
+	// text for the search index (see OrderSearchIndex.hpp)
+	void setSearchIndex(OrderSearchIndex* searchIndex);
+	void setBarcodeIndex(BarcodeIndex* barcodeIndex);
+	void invalidateSearchText();
+	void collectSearchText(QStringList& names, QStringList& descriptions, QStringList& barcodes);
+
+	// resolved references (see OrderReferenceIndex.hpp)
+	void setReferenceIndex(OrderReferenceIndex* referenceIndex);
+	QList<QObject*> referencedObjects() const;
+	int invalidateReferenceTo(QObject* target);
+	int releaseReferenceTo(QObject* target);
+
+	// LRU of cold Order releasing memory (see OrderEviction.hpp)
+	void setEviction(OrderEviction* eviction);
+	void setLastAccess(const quint64& lastAccess);
+	quint64 lastAccess() const;
+	bool hasMaterializedPositions() const;
+	// estimated bytes of the materialized positions
+	qint64 positionsMemoryBytes() const;
+	// reloadableFromCache: unchanged positions are read again from the cache file
+	bool releasePositions(const bool& reloadableFromCache);
+	bool releaseReferences();
+	// chunk of the Order cache file containing this Order - -1: none
+	void setCacheChunk(const int& cacheChunk);
+	int cacheChunk() const;
+	// positions released to the cache file - see DataManager::restoreOrderPositionsFromCache()
+	bool hasPositionsInCache() const;
+	void restorePositionsFromCacheMap(const QVariantMap& orderMap);
+	static int nrOfCacheMap(const QVariantMap& orderMap);
+
 	void fillFromMap(const QVariantMap& orderMap);
 	void fillFromForeignMap(const QVariantMap& orderMap);
 	void fillFromCacheMap(const QVariantMap& orderMap);
+	void fillFrom(const QVariantMap& orderMap, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
 	
 	void prepareNew();
 	
@@ -68,6 +116,11 @@ public:
 	QVariantMap toForeignMap();
 	QVariantMap toCacheMap();
 
+	void writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
+
+	void addMemoryUsage(MemoryUsage* usage) const;
+
 	int nr() const;
 	void setNr(int nr);
 	bool expressOrder() const;
@@ -233,6 +286,9 @@ public:
 	Q_INVOKABLE
 	QStringList tagsKeys();
 
+	// keys as dense Tag handles - see Tag::handle()
+	QVector<int> tagsHandles();
+
 	Q_INVOKABLE
 	void resolveTagsKeys(QList<Tag*> tags);
 	
@@ -316,7 +372,42 @@ private:
 	int mDepId;
 	bool mDepIdInvalid;
 	Department* mDepIdAsDataObject;
+	// columns of DataManager are updated from the setters
+	OrderColumns* mColumns;
+	int mColumnRow;
+	DenseObjectList* mRootList;
+	// marked dirty from the setters of title, positions ...
+	OrderSearchIndex* mSearchIndex;
+	BarcodeIndex* mBarcodeIndex;
+	// informed if resolved pointers change
+	OrderReferenceIndex* mReferenceIndex;
+	void replaceReference(QObject* oldTarget, QObject* newTarget);
+	// positions and references released by OrderEviction are restored on access
+	OrderEviction* mEviction;
+	quint64 mLastAccess;
+	bool mPositionsReleased;
+	bool mReferencesReleased;
+	// explicit access from QML or API - not from save, indexes or eviction
+	void markAccessed();
+	void restoreReleasedReferences() const;
+	int mCacheChunk;
+	// released positions: compact binary if changed, empty if in the cache file
+	QByteArray mPositionsReleasedData;
+	int mPositionsReleasedCount;
+	// positions materialized unchanged from the cache file: their binary form
+	// compared byte by byte - a hash could match changed positions
+	bool mPositionsFromCache;
+	QByteArray mPositionsCacheData;
+	QByteArray positionsData() const;
+	void loadReleasedPositions();
+	void clearReleasedPositions();
 	QList<Item*> mPositions;
+	// positions as read (maps) until first access - see materializePositions()
+	QVariantList mPositionsPending;
+	DataWriter::KeyNaming mPositionsPendingKeyNaming;
+	DataWriter::TransientPolicy mPositionsPendingTransientPolicy;
+	bool mPositionsPendingFromCache;
+	void materializePositions();
 	// implementation for QDeclarativeListProperty to use
 	// QML functions for List of Item*
 	static void appendToPositionsProperty(QDeclarativeListProperty<Item> *positionsList,
@@ -325,7 +416,8 @@ private:
 	static Item* atPositionsProperty(QDeclarativeListProperty<Item> *positionsList, int pos);
 	static void clearPositionsProperty(QDeclarativeListProperty<Item> *positionsList);
 	// lazy Array of independent Data Objects: only keys are persisted
-	QStringList mTagsKeys;
+	// keys (uuids) stored as Tag handles, uuids only used to persist
+	QVector<int> mTagsHandles;
 	bool mTagsKeysResolved;
 	QList<Tag*> mTags;
 	// implementation for QDeclarativeListProperty to use
@@ -1,6 +1,11 @@
 #include "SubItem.hpp"
 #include <QDebug>
 #include <quuid.h>
+#include "../VariantMapWriter.hpp"
+#include "../DataTracer.hpp"
+#include "../MemoryUsage.hpp"
+#include "../FieldKeyHash.hpp"
+#include "../DataObjectPool.hpp"
 #include "Item.hpp"
 
 // keys of QVariantMap used in this APP
@@ -17,6 +22,38 @@ static const QString descriptionForeignKey = "description";
 static const QString barcodeForeignKey = "barcode";
 // no key for item
 
+// property ids dispatched by subItemField()
+enum SubItemField
+{
+	NO_FIELD,
+	UUID_FIELD,
+	SUB_POS_NR_FIELD,
+	DESCRIPTION_FIELD,
+	BARCODE_FIELD
+};
+
+/*
+ * maps a key of subItemMap to the property id
+ * switch over the perfect hash from FieldKeyHash.hpp,
+ * then only one compare with the expected key
+ */
+static int subItemField(const QString& key, const DataWriter::KeyNaming& keyNaming)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	switch (fieldKeyHash(key)) {
+	case FIELD_KEY_HASH(4, 'u'):
+		return key == (foreign ? uuidForeignKey : uuidKey) ? UUID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(8, 's'):
+		return key == (foreign ? subPosNrForeignKey : subPosNrKey) ? SUB_POS_NR_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(11, 'd'):
+		return key == (foreign ? descriptionForeignKey : descriptionKey) ? DESCRIPTION_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(7, 'b'):
+		return key == (foreign ? barcodeForeignKey : barcodeKey) ? BARCODE_FIELD : NO_FIELD;
+	default:
+		return NO_FIELD;
+	}
+}
+
 /*
  * Default Constructor if SubItem not initialized from QVariantMap
  */
@@ -34,16 +71,7 @@ SubItem::SubItem(QObject *parent) :
  */
 void SubItem::fillFromMap(const QVariantMap& subItemMap)
 {
-	mUuid = subItemMap.value(uuidKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mSubPosNr = subItemMap.value(subPosNrKey).toInt();
-	mDescription = subItemMap.value(descriptionKey).toString();
-	mBarcode = subItemMap.value(barcodeKey).toString();
-	// mItem is parent (Item* containing SubItem)
+	fillFrom(subItemMap, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -54,16 +82,7 @@ void SubItem::fillFromMap(const QVariantMap& subItemMap)
  */
 void SubItem::fillFromForeignMap(const QVariantMap& subItemMap)
 {
-	mUuid = subItemMap.value(uuidForeignKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mSubPosNr = subItemMap.value(subPosNrForeignKey).toInt();
-	mDescription = subItemMap.value(descriptionForeignKey).toString();
-	mBarcode = subItemMap.value(barcodeForeignKey).toString();
-	// mItem is parent (Item* containing SubItem)
+	fillFrom(subItemMap, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -74,16 +93,49 @@ void SubItem::fillFromForeignMap(const QVariantMap& subItemMap)
  */
 void SubItem::fillFromCacheMap(const QVariantMap& subItemMap)
 {
-	mUuid = subItemMap.value(uuidKey).toString();
+	fillFrom(subItemMap, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+}
+
+/*
+ * initialize SubItem from QVariantMap
+ * walks subItemMap only once: each key is dispatched by subItemField()
+ * keyNaming: own property names or names from Server API
+ * transientPolicy WITHOUT_TRANSIENT ignores transient values (cache)
+ * corresponding export method: writeTo()
+ */
+void SubItem::fillFrom(const QVariantMap& subItemMap, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	TraceSpan span("SubItem::fillFrom", "dto");
+	// properties not contained in subItemMap get default values
+	mUuid = QString();
+	mSubPosNr = 0;
+	mDescription = QString();
+	mBarcode = QString();
+	QVariantMap::const_iterator it;
+	for (it = subItemMap.constBegin(); it != subItemMap.constEnd(); ++it) {
+		switch (subItemField(it.key(), keyNaming)) {
+		case UUID_FIELD:
+			mUuid = it.value().toString();
+			break;
+		case SUB_POS_NR_FIELD:
+			mSubPosNr = it.value().toInt();
+			break;
+		case DESCRIPTION_FIELD:
+			mDescription = it.value().toString();
+			break;
+		case BARCODE_FIELD:
+			mBarcode = it.value().toString();
+			break;
+		default:
+			break;
+		}
+	}
 	if (mUuid.isEmpty()) {
 		mUuid = QUuid::createUuid().toString();
 		mUuid = mUuid.right(mUuid.length() - 1);
 		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mSubPosNr = subItemMap.value(subPosNrKey).toInt();
-	mDescription = subItemMap.value(descriptionKey).toString();
-	mBarcode = subItemMap.value(barcodeKey).toString();
-	// mItem is parent (Item* containing SubItem)
+	}
 }
 
 void SubItem::prepareNew()
@@ -120,13 +172,11 @@ bool SubItem::isValid()
  */
 QVariantMap SubItem::toMap()
 {
-	QVariantMap subItemMap;
-	subItemMap.insert(uuidKey, mUuid);
-	subItemMap.insert(subPosNrKey, mSubPosNr);
-	subItemMap.insert(descriptionKey, mDescription);
-	subItemMap.insert(barcodeKey, mBarcode);
-	// mItem points to Item* containing SubItem
-	return subItemMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 /*
@@ -136,13 +186,11 @@ QVariantMap SubItem::toMap()
  */
 QVariantMap SubItem::toForeignMap()
 {
-	QVariantMap subItemMap;
-	subItemMap.insert(uuidForeignKey, mUuid);
-	subItemMap.insert(subPosNrForeignKey, mSubPosNr);
-	subItemMap.insert(descriptionForeignKey, mDescription);
-	subItemMap.insert(barcodeForeignKey, mBarcode);
-	// mItem points to Item* containing SubItem
-	return subItemMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 
@@ -153,10 +201,63 @@ QVariantMap SubItem::toForeignMap()
  */
 QVariantMap SubItem::toCacheMap()
 {
-	// no transient properties found from data model
-	// use default toMao()
-	return toMap();
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+	writer.endObject();
+	return writer.map();
+}
+
+/*
+ * writes all properties into the current object of writer
+ * used by toMap(), toForeignMap(), toCacheMap() and to write caches
+ * keyNaming: own property names or names from Server API
+ * no transient properties found from data model
+ */
+void SubItem::writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	Q_UNUSED(transientPolicy);
+	writer->writeString(foreign ? uuidForeignKey : uuidKey, mUuid);
+	writer->writeInt(foreign ? subPosNrForeignKey : subPosNrKey, mSubPosNr);
+	writer->writeString(foreign ? descriptionForeignKey : descriptionKey, mDescription);
+	writer->writeString(foreign ? barcodeForeignKey : barcodeKey, mBarcode);
+	// mItem points to Item* containing SubItem
+}
+
+/*
+ * writes a subItemMap not yet materialized
+ * only keys of SubItem properties - unknown keys of the source are dropped
+ */
+void SubItem::writeMapTo(DataWriter* writer, const QVariantMap& subItemMap,
+		const DataWriter::KeyNaming& keyNaming)
+{
+	QVariantMap::const_iterator it;
+	for (it = subItemMap.constBegin(); it != subItemMap.constEnd(); ++it) {
+		if (subItemField(it.key(), keyNaming) != NO_FIELD) {
+			writer->writeVariant(it.key(), it.value());
+		}
+	}
 }
+
+/*
+ * text for the search index from a map not yet materialized
+ */
+void SubItem::collectSearchText(const QVariantMap& subItemMap, const DataWriter::KeyNaming& keyNaming,
+		QStringList& descriptions, QStringList& barcodes)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	QString description = subItemMap.value(foreign ? descriptionForeignKey : descriptionKey).toString();
+	if (!description.isEmpty()) {
+		descriptions.append(description);
+	}
+	QString barcode = subItemMap.value(foreign ? barcodeForeignKey : barcodeKey).toString();
+	if (!barcode.isEmpty()) {
+		barcodes.append(barcode);
+	}
+}
+
 // ATT 
 // Mandatory: uuid
 // Domain KEY: uuid
@@ -198,6 +299,9 @@ void SubItem::setDescription(QString description)
 	if (description != mDescription) {
 		mDescription = description;
 		emit descriptionChanged(description);
+		if (item()) {
+			item()->invalidateSearchText();
+		}
 	}
 }
 // ATT 
@@ -212,6 +316,9 @@ void SubItem::setBarcode(QString barcode)
 	if (barcode != mBarcode) {
 		mBarcode = barcode;
 		emit barcodeChanged(barcode);
+		if (item()) {
+			item()->invalidateSearchText();
+		}
 	}
 }
 // REF
@@ -224,6 +331,17 @@ Item* SubItem::item() const
 }
 
 
+// cascaded DataObjects are allocated from a typed pool
+DATA_OBJECT_POOL_OPERATORS_IMPL(SubItem)
+
+// estimated memory of this SubItem
+void SubItem::addMemoryUsage(MemoryUsage* usage) const
+{
+	qint64 stringBytes = MemoryUsage::stringBytes(mUuid) + MemoryUsage::stringBytes(mDescription)
+			+ MemoryUsage::stringBytes(mBarcode);
+	usage->addObject(MemoryUsage::SUB_ITEM, MemoryUsage::pooledObjectBytes(sizeof(SubItem)), stringBytes);
+}
+
 SubItem::~SubItem()
 {
 	// place cleanUp code here
@@ -3,12 +3,17 @@
 
 #include <QObject>
 #include <qvariant.h>
+#include <QStringList>
+#include "../DataWriter.hpp"
+#include "../DataObjectPool.hpp"
 
 
 // forward declaration to avoid circular dependencies
 class Item;
 
 
+class MemoryUsage;
+
 class SubItem: public QObject
 {
 	Q_OBJECT
@@ -27,6 +32,8 @@ public:
 	void fillFromMap(const QVariantMap& subItemMap);
 	void fillFromForeignMap(const QVariantMap& subItemMap);
 	void fillFromCacheMap(const QVariantMap& subItemMap);
+	void fillFrom(const QVariantMap& subItemMap, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
 	
 	void prepareNew();
 	
@@ -37,6 +44,17 @@ public:
 	QVariantMap toForeignMap();
 	QVariantMap toCacheMap();
 
+	void writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
+
+	void addMemoryUsage(MemoryUsage* usage) const;
+
+	static void writeMapTo(DataWriter* writer, const QVariantMap& subItemMap,
+			const DataWriter::KeyNaming& keyNaming);
+
+	static void collectSearchText(const QVariantMap& subItemMap, const DataWriter::KeyNaming& keyNaming,
+			QStringList& descriptions, QStringList& barcodes);
+
 	QString uuid() const;
 	void setUuid(QString uuid);
 	int subPosNr() const;
@@ -52,6 +70,9 @@ public:
 
 	virtual ~SubItem();
 
+	// SubItem is a cascaded DataObject: memory comes from DataObjectPool<SubItem>
+	DATA_OBJECT_POOL_OPERATORS
+
 	Q_SIGNALS:
 
 	void uuidChanged(QString uuid);
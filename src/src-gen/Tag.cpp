@@ -1,6 +1,11 @@
 #include "Tag.hpp"
 #include <QDebug>
 #include <quuid.h>
+#include "../VariantMapWriter.hpp"
+#include "../DataTracer.hpp"
+#include "../MemoryUsage.hpp"
+#include "../FieldKeyHash.hpp"
+#include "../StringPool.hpp"
 
 // keys of QVariantMap used in this APP
 static const QString uuidKey = "uuid";
@@ -19,12 +24,47 @@ static int uuidQueryPos;
 static int nameQueryPos;
 static int valueQueryPos;
 static int colorQueryPos;
+// uuid <-> handle of all Tags ever loaded or created
+// handles stay valid while the APP runs
+static StringPool uuidHandles;
+
+// property ids dispatched by tagField()
+enum TagField
+{
+	NO_FIELD,
+	UUID_FIELD,
+	NAME_FIELD,
+	VALUE_FIELD,
+	COLOR_FIELD
+};
+
+/*
+ * maps a key of tagMap to the property id
+ * switch over the perfect hash from FieldKeyHash.hpp,
+ * then only one compare with the expected key
+ */
+static int tagField(const QString& key, const DataWriter::KeyNaming& keyNaming)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	switch (fieldKeyHash(key)) {
+	case FIELD_KEY_HASH(4, 'u'):
+		return key == (foreign ? uuidForeignKey : uuidKey) ? UUID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(4, 'n'):
+		return key == (foreign ? nameForeignKey : nameKey) ? NAME_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(5, 'v'):
+		return key == (foreign ? valueForeignKey : valueKey) ? VALUE_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(5, 'c'):
+		return key == (foreign ? colorForeignKey : colorKey) ? COLOR_FIELD : NO_FIELD;
+	default:
+		return NO_FIELD;
+	}
+}
 
 /*
  * Default Constructor if Tag not initialized from QVariantMap
  */
 Tag::Tag(QObject *parent) :
-        QObject(parent), mUuid(""), mName(""), mValue(0), mColor("")
+        QObject(parent), mUuid(""), mName(""), mValue(0), mColor(""), mHandle(-1)
 {
 }
 // S Q L
@@ -146,15 +186,17 @@ colorQueryPos = record.indexOf(colorKey);
  */
 void Tag::fillFromSqlQuery(const QSqlQuery& sqlQuery)
 {
-	mUuid = sqlQuery.value(uuidQueryPos).toString();
+	TraceSpan span("Tag::fillFromSqlQuery", "dto");
+	mUuid = StringPool::interned(sqlQuery.value(uuidQueryPos).toString());
 	if (mUuid.isEmpty()) {
 		mUuid = QUuid::createUuid().toString();
 		mUuid = mUuid.right(mUuid.length() - 1);
 		mUuid = mUuid.left(mUuid.length() - 1);
 	}	
+	mHandle = uuidHandles.handle(mUuid);
 	mName = sqlQuery.value(nameQueryPos).toString();
 	mValue = sqlQuery.value(valueQueryPos).toInt();
-	mColor = sqlQuery.value(colorQueryPos).toString();
+	mColor = StringPool::interned(sqlQuery.value(colorQueryPos).toString());
 }
 
 
@@ -167,15 +209,7 @@ void Tag::fillFromSqlQuery(const QSqlQuery& sqlQuery)
  */
 void Tag::fillFromMap(const QVariantMap& tagMap)
 {
-	mUuid = tagMap.value(uuidKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mName = tagMap.value(nameKey).toString();
-	mValue = tagMap.value(valueKey).toInt();
-	mColor = tagMap.value(colorKey).toString();
+	fillFrom(tagMap, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -186,15 +220,7 @@ void Tag::fillFromMap(const QVariantMap& tagMap)
  */
 void Tag::fillFromForeignMap(const QVariantMap& tagMap)
 {
-	mUuid = tagMap.value(uuidForeignKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mName = tagMap.value(nameForeignKey).toString();
-	mValue = tagMap.value(valueForeignKey).toInt();
-	mColor = tagMap.value(colorForeignKey).toString();
+	fillFrom(tagMap, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -205,15 +231,50 @@ void Tag::fillFromForeignMap(const QVariantMap& tagMap)
  */
 void Tag::fillFromCacheMap(const QVariantMap& tagMap)
 {
-	mUuid = tagMap.value(uuidKey).toString();
+	fillFrom(tagMap, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+}
+
+/*
+ * initialize Tag from QVariantMap
+ * walks tagMap only once: each key is dispatched by tagField()
+ * keyNaming: own property names or names from Server API
+ * transientPolicy WITHOUT_TRANSIENT ignores transient values (cache)
+ * corresponding export method: writeTo()
+ */
+void Tag::fillFrom(const QVariantMap& tagMap, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	TraceSpan span("Tag::fillFrom", "dto");
+	// properties not contained in tagMap get default values
+	mUuid = QString();
+	mName = QString();
+	mValue = 0;
+	mColor = QString();
+	QVariantMap::const_iterator it;
+	for (it = tagMap.constBegin(); it != tagMap.constEnd(); ++it) {
+		switch (tagField(it.key(), keyNaming)) {
+		case UUID_FIELD:
+			mUuid = StringPool::interned(it.value().toString());
+			break;
+		case NAME_FIELD:
+			mName = it.value().toString();
+			break;
+		case VALUE_FIELD:
+			mValue = it.value().toInt();
+			break;
+		case COLOR_FIELD:
+			mColor = StringPool::interned(it.value().toString());
+			break;
+		default:
+			break;
+		}
+	}
 	if (mUuid.isEmpty()) {
 		mUuid = QUuid::createUuid().toString();
 		mUuid = mUuid.right(mUuid.length() - 1);
 		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mName = tagMap.value(nameKey).toString();
-	mValue = tagMap.value(valueKey).toInt();
-	mColor = tagMap.value(colorKey).toString();
+	}
+	mHandle = uuidHandles.handle(mUuid);
 }
 
 void Tag::prepareNew()
@@ -221,6 +282,7 @@ void Tag::prepareNew()
 	mUuid = QUuid::createUuid().toString();
 	mUuid = mUuid.right(mUuid.length() - 1);
 	mUuid = mUuid.left(mUuid.length() - 1);
+	mHandle = uuidHandles.handle(mUuid);
 }
 
 /*
@@ -241,12 +303,11 @@ bool Tag::isValid()
  */
 QVariantMap Tag::toMap()
 {
-	QVariantMap tagMap;
-	tagMap.insert(uuidKey, mUuid);
-	tagMap.insert(nameKey, mName);
-	tagMap.insert(valueKey, mValue);
-	tagMap.insert(colorKey, mColor);
-	return tagMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 /*
@@ -256,12 +317,11 @@ QVariantMap Tag::toMap()
  */
 QVariantMap Tag::toForeignMap()
 {
-	QVariantMap tagMap;
-	tagMap.insert(uuidForeignKey, mUuid);
-	tagMap.insert(nameForeignKey, mName);
-	tagMap.insert(valueForeignKey, mValue);
-	tagMap.insert(colorForeignKey, mColor);
-	return tagMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 
@@ -272,9 +332,28 @@ QVariantMap Tag::toForeignMap()
  */
 QVariantMap Tag::toCacheMap()
 {
-	// no transient properties found from data model
-	// use default toMao()
-	return toMap();
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+	writer.endObject();
+	return writer.map();
+}
+
+/*
+ * writes all properties into the current object of writer
+ * used by toMap(), toForeignMap(), toCacheMap() and to write caches
+ * keyNaming: own property names or names from Server API
+ * no transient properties found from data model
+ */
+void Tag::writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	Q_UNUSED(transientPolicy);
+	writer->writeString(foreign ? uuidForeignKey : uuidKey, mUuid);
+	writer->writeString(foreign ? nameForeignKey : nameKey, mName);
+	writer->writeInt(foreign ? valueForeignKey : valueKey, mValue);
+	writer->writeString(foreign ? colorForeignKey : colorKey, mColor);
 }
 // ATT 
 // Optional: uuid
@@ -286,7 +365,12 @@ QString Tag::uuid() const
 void Tag::setUuid(QString uuid)
 {
 	if (uuid != mUuid) {
+		int oldHandle = mHandle;
 		mUuid = uuid;
+		mHandle = uuidHandles.handle(mUuid);
+		if (mHandle != oldHandle) {
+			emit handleChanged(this, oldHandle);
+		}
 		emit uuidChanged(uuid);
 	}
 }
@@ -334,6 +418,36 @@ void Tag::setColor(QString color)
 }
 
 
+/*
+ * dense handle of the uuid, assigned while loading
+ * Orders store handles instead of uuid Strings,
+ * uuids are only needed to persist or for foreign APIs
+ */
+int Tag::handle() const
+{
+	return mHandle;
+}
+int Tag::handleForUuid(const QString& uuid)
+{
+	return uuidHandles.handle(uuid);
+}
+int Tag::findHandleForUuid(const QString& uuid)
+{
+	return uuidHandles.findHandle(uuid);
+}
+QString Tag::uuidForHandle(const int& handle)
+{
+	return uuidHandles.value(handle);
+}
+
+// estimated memory of this Tag - the uuid is counted by the StringPool
+void Tag::addMemoryUsage(MemoryUsage* usage) const
+{
+	qint64 stringBytes = MemoryUsage::stringBytes(mUuid) + MemoryUsage::stringBytes(mName)
+			+ MemoryUsage::stringBytes(mColor);
+	usage->addObject(MemoryUsage::TAG, MemoryUsage::objectBytes(sizeof(Tag)), stringBytes);
+}
+
 Tag::~Tag()
 {
 	// place cleanUp code here
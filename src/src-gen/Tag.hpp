@@ -5,10 +5,13 @@
 #include <qvariant.h>
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlRecord>
+#include "../DataWriter.hpp"
 
 
 
 
+class MemoryUsage;
+
 class Tag: public QObject
 {
 	Q_OBJECT
@@ -26,6 +29,8 @@ public:
 	void fillFromMap(const QVariantMap& tagMap);
 	void fillFromForeignMap(const QVariantMap& tagMap);
 	void fillFromCacheMap(const QVariantMap& tagMap);
+	void fillFrom(const QVariantMap& tagMap, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
 	
 	void prepareNew();
 	
@@ -36,6 +41,11 @@ public:
 	QVariantMap toForeignMap();
 	QVariantMap toCacheMap();
 
+	void writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
+
+	void addMemoryUsage(MemoryUsage* usage) const;
+
 	QString uuid() const;
 	void setUuid(QString uuid);
 	QString name() const;
@@ -45,6 +55,13 @@ public:
 	QString color() const;
 	void setColor(QString color);
 
+	// dense int handle of uuid - used by Orders to reference Tags
+	int handle() const;
+	static int handleForUuid(const QString& uuid);
+	// -1 for a uuid never loaded or created - the uuid is not registered
+	static int findHandleForUuid(const QString& uuid);
+	static QString uuidForHandle(const int& handle);
+
 
 	// SQL
 	static const QString createTableCommand();
@@ -59,6 +76,8 @@ public:
 	Q_SIGNALS:
 
 	void uuidChanged(QString uuid);
+	// emitted before uuidChanged - DataManager moves the Tag to its new handle
+	void handleChanged(Tag* tag, int oldHandle);
 	void nameChanged(QString name);
 	void valueChanged(int value);
 	void colorChanged(QString color);
@@ -70,6 +89,7 @@ private:
 	QString mName;
 	int mValue;
 	QString mColor;
+	int mHandle;
 
 	Q_DISABLE_COPY (Tag)
 };
@@ -1,6 +1,13 @@
 #include "Topic.hpp"
 #include <QDebug>
 #include <quuid.h>
+#include "../VariantMapWriter.hpp"
+#include "../DataTracer.hpp"
+#include "../MemoryUsage.hpp"
+#include "../DenseObjectList.hpp"
+#include "../DataLog.hpp"
+#include "../FieldKeyHash.hpp"
+#include "../StringPool.hpp"
 
 // keys of QVariantMap used in this APP
 static const QString idKey = "id";
@@ -16,11 +23,46 @@ static const QString classificationForeignKey = "classification";
 static const QString subTopicForeignKey = "subTopic";
 static const QString parentTopicForeignKey = "parentTopic";
 
+// property ids dispatched by topicField()
+enum TopicField
+{
+	NO_FIELD,
+	ID_FIELD,
+	UUID_FIELD,
+	CLASSIFICATION_FIELD,
+	PARENT_TOPIC_FIELD,
+	SUB_TOPIC_FIELD
+};
+
+/*
+ * maps a key of topicMap to the property id
+ * switch over the perfect hash from FieldKeyHash.hpp,
+ * then only one compare with the expected key
+ */
+static int topicField(const QString& key, const DataWriter::KeyNaming& keyNaming)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	switch (fieldKeyHash(key)) {
+	case FIELD_KEY_HASH(2, 'i'):
+		return key == (foreign ? idForeignKey : idKey) ? ID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(4, 'u'):
+		return key == (foreign ? uuidForeignKey : uuidKey) ? UUID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(14, 'c'):
+		return key == (foreign ? classificationForeignKey : classificationKey) ? CLASSIFICATION_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(11, 'p'):
+		return key == (foreign ? parentTopicForeignKey : parentTopicKey) ? PARENT_TOPIC_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(8, 's'):
+		return key == (foreign ? subTopicForeignKey : subTopicKey) ? SUB_TOPIC_FIELD : NO_FIELD;
+	default:
+		return NO_FIELD;
+	}
+}
+
 /*
  * Default Constructor if Topic not initialized from QVariantMap
  */
 Topic::Topic(QObject *parent) :
-        QObject(parent), mId(-1), mUuid(""), mClassification("")
+        QObject(parent), mId(-1), mUuid(""), mClassification(""), mRootList(0)
 {
 	// set Types of DataObject* to NULL:
 	mParentTopic = 0;
@@ -35,37 +77,7 @@ Topic::Topic(QObject *parent) :
  */
 void Topic::fillFromMap(const QVariantMap& topicMap)
 {
-	mId = topicMap.value(idKey).toInt();
-	mUuid = topicMap.value(uuidKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mClassification = topicMap.value(classificationKey).toString();
-	// mParentTopic points to Topic*
-	if (topicMap.contains(parentTopicKey)) {
-		QVariantMap parentTopicMap;
-		parentTopicMap = topicMap.value(parentTopicKey).toMap();
-		if (!parentTopicMap.isEmpty()) {
-			mParentTopic = 0;
-			mParentTopic = new Topic();
-			mParentTopic->setParent(this);
-			mParentTopic->fillFromMap(parentTopicMap);
-		}
-	}
-	// mSubTopic is List of Topic*
-	QVariantList subTopicList;
-	subTopicList = topicMap.value(subTopicKey).toList();
-	mSubTopic.clear();
-	for (int i = 0; i < subTopicList.size(); ++i) {
-		QVariantMap subTopicMap;
-		subTopicMap = subTopicList.at(i).toMap();
-		Topic* topic = new Topic();
-		topic->setParent(this);
-		topic->fillFromMap(subTopicMap);
-		mSubTopic.append(topic);
-	}
+	fillFrom(topicMap, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -76,37 +88,7 @@ void Topic::fillFromMap(const QVariantMap& topicMap)
  */
 void Topic::fillFromForeignMap(const QVariantMap& topicMap)
 {
-	mId = topicMap.value(idForeignKey).toInt();
-	mUuid = topicMap.value(uuidForeignKey).toString();
-	if (mUuid.isEmpty()) {
-		mUuid = QUuid::createUuid().toString();
-		mUuid = mUuid.right(mUuid.length() - 1);
-		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mClassification = topicMap.value(classificationForeignKey).toString();
-	// mParentTopic points to Topic*
-	if (topicMap.contains(parentTopicForeignKey)) {
-		QVariantMap parentTopicMap;
-		parentTopicMap = topicMap.value(parentTopicForeignKey).toMap();
-		if (!parentTopicMap.isEmpty()) {
-			mParentTopic = 0;
-			mParentTopic = new Topic();
-			mParentTopic->setParent(this);
-			mParentTopic->fillFromForeignMap(parentTopicMap);
-		}
-	}
-	// mSubTopic is List of Topic*
-	QVariantList subTopicList;
-	subTopicList = topicMap.value(subTopicForeignKey).toList();
-	mSubTopic.clear();
-	for (int i = 0; i < subTopicList.size(); ++i) {
-		QVariantMap subTopicMap;
-		subTopicMap = subTopicList.at(i).toMap();
-		Topic* topic = new Topic();
-		topic->setParent(this);
-		topic->fillFromForeignMap(subTopicMap);
-		mSubTopic.append(topic);
-	}
+	fillFrom(topicMap, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -117,35 +99,73 @@ void Topic::fillFromForeignMap(const QVariantMap& topicMap)
  */
 void Topic::fillFromCacheMap(const QVariantMap& topicMap)
 {
-	mId = topicMap.value(idKey).toInt();
-	mUuid = topicMap.value(uuidKey).toString();
+	fillFrom(topicMap, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+}
+
+/*
+ * initialize Topic from QVariantMap
+ * walks topicMap only once: each key is dispatched by topicField()
+ * keyNaming: own property names or names from Server API
+ * transientPolicy WITHOUT_TRANSIENT ignores transient values (cache)
+ * corresponding export method: writeTo()
+ */
+void Topic::fillFrom(const QVariantMap& topicMap, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	TraceSpan span("Topic::fillFrom", "dto");
+	// properties not contained in topicMap get default values
+	mId = 0;
+	mUuid = QString();
+	mClassification = QString();
+	mSubTopic.clear();
+	QVariantMap::const_iterator it;
+	for (it = topicMap.constBegin(); it != topicMap.constEnd(); ++it) {
+		switch (topicField(it.key(), keyNaming)) {
+		case ID_FIELD:
+			mId = it.value().toInt();
+			break;
+		case UUID_FIELD:
+			mUuid = it.value().toString();
+			break;
+		case CLASSIFICATION_FIELD:
+			mClassification = StringPool::interned(it.value().toString());
+			break;
+		case PARENT_TOPIC_FIELD: {
+			// mParentTopic points to Topic*
+			QVariantMap parentTopicMap;
+			parentTopicMap = it.value().toMap();
+			if (!parentTopicMap.isEmpty()) {
+				mParentTopic = new Topic();
+				mParentTopic->setParent(this);
+				mParentTopic->fillFrom(parentTopicMap, keyNaming, transientPolicy);
+			}
+			break;
+		}
+		case SUB_TOPIC_FIELD: {
+			// mSubTopic is List of Topic*
+			QVariantList subTopicList;
+			subTopicList = it.value().toList();
+			for (int i = 0; i < subTopicList.size(); ++i) {
+				QVariantMap subTopicMap;
+				subTopicMap = subTopicList.at(i).toMap();
+				Topic* topic = new Topic();
+				topic->setParent(this);
+				topic->fillFrom(subTopicMap, keyNaming, transientPolicy);
+				mSubTopic.append(topic);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
 	if (mUuid.isEmpty()) {
 		mUuid = QUuid::createUuid().toString();
 		mUuid = mUuid.right(mUuid.length() - 1);
 		mUuid = mUuid.left(mUuid.length() - 1);
-	}	
-	mClassification = topicMap.value(classificationKey).toString();
-	// mParentTopic points to Topic*
-	if (topicMap.contains(parentTopicKey)) {
-		QVariantMap parentTopicMap;
-		parentTopicMap = topicMap.value(parentTopicKey).toMap();
-		if (!parentTopicMap.isEmpty()) {
-			mParentTopic = new Topic();
-			mParentTopic->setParent(this);
-			mParentTopic->fillFromCacheMap(parentTopicMap);
-		}
 	}
-	// mSubTopic is List of Topic*
-	QVariantList subTopicList;
-	subTopicList = topicMap.value(subTopicKey).toList();
-	mSubTopic.clear();
-	for (int i = 0; i < subTopicList.size(); ++i) {
-		QVariantMap subTopicMap;
-		subTopicMap = subTopicList.at(i).toMap();
-		Topic* topic = new Topic();
-		topic->setParent(this);
-		topic->fillFromCacheMap(subTopicMap);
-		mSubTopic.append(topic);
+	if (mRootList) {
+		mRootList->keyChanged(this);
 	}
 }
 
@@ -177,17 +197,11 @@ bool Topic::isValid()
  */
 QVariantMap Topic::toMap()
 {
-	QVariantMap topicMap;
-	topicMap.insert(idKey, mId);
-	topicMap.insert(uuidKey, mUuid);
-	topicMap.insert(classificationKey, mClassification);
-	// mSubTopic points to Topic*
-	topicMap.insert(subTopicKey, subTopicAsQVariantList());
-	// mParentTopic points to Topic*
-	if (mParentTopic) {
-	topicMap.insert(parentTopicKey, mParentTopic->toMap());
-	}
-	return topicMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 /*
@@ -197,17 +211,11 @@ QVariantMap Topic::toMap()
  */
 QVariantMap Topic::toForeignMap()
 {
-	QVariantMap topicMap;
-	topicMap.insert(idForeignKey, mId);
-	topicMap.insert(uuidForeignKey, mUuid);
-	topicMap.insert(classificationForeignKey, mClassification);
-	// mSubTopic points to Topic*
-	topicMap.insert(subTopicForeignKey, subTopicAsQVariantList());
-	// mParentTopic points to Topic*
-	if (mParentTopic) {
-		topicMap.insert(parentTopicForeignKey, mParentTopic->toMap());
-	}
-	return topicMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 
@@ -218,9 +226,40 @@ QVariantMap Topic::toForeignMap()
  */
 QVariantMap Topic::toCacheMap()
 {
-	// no transient properties found from data model
-	// use default toMao()
-	return toMap();
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+	writer.endObject();
+	return writer.map();
+}
+
+/*
+ * writes all properties into the current object of writer
+ * used by toMap(), toForeignMap(), toCacheMap() and to write caches
+ * keyNaming: own property names or names from Server API
+ * no transient properties found from data model
+ */
+void Topic::writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	writer->writeInt(foreign ? idForeignKey : idKey, mId);
+	writer->writeString(foreign ? uuidForeignKey : uuidKey, mUuid);
+	writer->writeString(foreign ? classificationForeignKey : classificationKey, mClassification);
+	// mSubTopic points to Topic*
+	writer->beginArray(foreign ? subTopicForeignKey : subTopicKey);
+	for (int i = 0; i < mSubTopic.size(); ++i) {
+		writer->beginObject();
+		mSubTopic.at(i)->writeTo(writer, keyNaming, transientPolicy);
+		writer->endObject();
+	}
+	writer->endArray();
+	// mParentTopic points to Topic*
+	if (mParentTopic) {
+		writer->beginObject(foreign ? parentTopicForeignKey : parentTopicKey);
+		mParentTopic->writeTo(writer, keyNaming, transientPolicy);
+		writer->endObject();
+	}
 }
 // ATT 
 // Mandatory: id
@@ -234,9 +273,16 @@ void Topic::setId(int id)
 {
 	if (id != mId) {
 		mId = id;
+		if (mRootList) {
+			mRootList->keyChanged(this);
+		}
 		emit idChanged(id);
 	}
 }
+void Topic::setRootList(DenseObjectList* rootList)
+{
+	mRootList = rootList;
+}
 // ATT 
 // Optional: uuid
 QString Topic::uuid() const
@@ -381,7 +427,7 @@ bool Topic::removeFromSubTopic(Topic* topic)
     bool ok = false;
     ok = mSubTopic.removeOne(topic);
     if (!ok) {
-    	qDebug() << "Topic* not found in subTopic";
+    	DATA_LOG(DATA_LOG_DTO) << "Topic* not found in subTopic";
     	return false;
     }
     emit removedFromSubTopicByUuid(topic->uuid());
@@ -414,7 +460,7 @@ bool Topic::removeFromSubTopicByUuid(const QString& uuid)
         	return true;
         }
     }
-    qDebug() << "uuid not found in subTopic: " << uuid;
+    DATA_LOG(DATA_LOG_DTO) << "uuid not found in subTopic: " << uuid;
     return false;
 }
 
@@ -430,7 +476,7 @@ bool Topic::removeFromSubTopicById(const int& id)
         	return true;
         }
     }
-    qDebug() << "id not found in subTopic: " << id;
+    DATA_LOG(DATA_LOG_DTO) << "id not found in subTopic: " << id;
     return false;
 }
 int Topic::subTopicCount()
@@ -512,6 +558,17 @@ void Topic::clearSubTopicProperty(QDeclarativeListProperty<Topic> *subTopicList)
 }
 
 
+// estimated memory of this Topic and its sub Topics
+void Topic::addMemoryUsage(MemoryUsage* usage) const
+{
+	qint64 stringBytes = MemoryUsage::stringBytes(mUuid) + MemoryUsage::stringBytes(mClassification);
+	usage->addObject(MemoryUsage::TOPIC, MemoryUsage::objectBytes(sizeof(Topic)), stringBytes,
+			MemoryUsage::listBytes(mSubTopic.size()));
+	for (int i = 0; i < mSubTopic.size(); ++i) {
+		mSubTopic.at(i)->addMemoryUsage(usage);
+	}
+}
+
 Topic::~Topic()
 {
 	// place cleanUp code here
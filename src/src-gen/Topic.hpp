@@ -4,10 +4,14 @@
 #include <QObject>
 #include <qvariant.h>
 #include <QDeclarativeListProperty>
+#include "../DataWriter.hpp"
 
 
 
 
+class MemoryUsage;
+class DenseObjectList;
+
 class Topic: public QObject
 {
 	Q_OBJECT
@@ -27,6 +31,8 @@ public:
 	void fillFromMap(const QVariantMap& topicMap);
 	void fillFromForeignMap(const QVariantMap& topicMap);
 	void fillFromCacheMap(const QVariantMap& topicMap);
+	void fillFrom(const QVariantMap& topicMap, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
 	
 	void prepareNew();
 	
@@ -37,6 +43,13 @@ public:
 	QVariantMap toForeignMap();
 	QVariantMap toCacheMap();
 
+	void writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
+
+	void addMemoryUsage(MemoryUsage* usage) const;
+	// root list of DataManager - informed if the id changes
+	void setRootList(DenseObjectList* rootList);
+
 	int id() const;
 	void setId(int id);
 	QString uuid() const;
@@ -127,6 +140,8 @@ private:
 	static Topic* atSubTopicProperty(QDeclarativeListProperty<Topic> *subTopicList, int pos);
 	static void clearSubTopicProperty(QDeclarativeListProperty<Topic> *subTopicList);
 
+	DenseObjectList* mRootList;
+
 	Q_DISABLE_COPY (Topic)
 };
 Q_DECLARE_METATYPE(Topic*)
@@ -1,6 +1,14 @@
 #include "Xtras.hpp"
 #include <QDebug>
 #include <quuid.h>
+#include <limits.h>
+#include "../VariantMapWriter.hpp"
+#include "../DataTracer.hpp"
+#include "../MemoryUsage.hpp"
+#include "../DenseObjectList.hpp"
+#include "../DataLog.hpp"
+#include "../FieldKeyHash.hpp"
+#include "../AggregationKernels.hpp"
 
 // keys of QVariantMap used in this APP
 static const QString idKey = "id";
@@ -14,11 +22,43 @@ static const QString nameForeignKey = "name";
 static const QString textForeignKey = "text";
 static const QString valuesForeignKey = "values";
 
+// property ids dispatched by xtrasField()
+enum XtrasField
+{
+	NO_FIELD,
+	ID_FIELD,
+	NAME_FIELD,
+	TEXT_FIELD,
+	VALUES_FIELD
+};
+
+/*
+ * maps a key of xtrasMap to the property id
+ * switch over the perfect hash from FieldKeyHash.hpp,
+ * then only one compare with the expected key
+ */
+static int xtrasField(const QString& key, const DataWriter::KeyNaming& keyNaming)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	switch (fieldKeyHash(key)) {
+	case FIELD_KEY_HASH(2, 'i'):
+		return key == (foreign ? idForeignKey : idKey) ? ID_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(4, 'n'):
+		return key == (foreign ? nameForeignKey : nameKey) ? NAME_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(4, 't'):
+		return key == (foreign ? textForeignKey : textKey) ? TEXT_FIELD : NO_FIELD;
+	case FIELD_KEY_HASH(6, 'v'):
+		return key == (foreign ? valuesForeignKey : valuesKey) ? VALUES_FIELD : NO_FIELD;
+	default:
+		return NO_FIELD;
+	}
+}
+
 /*
  * Default Constructor if Xtras not initialized from QVariantMap
  */
 Xtras::Xtras(QObject *parent) :
-        QObject(parent), mId(-1), mName("")
+        QObject(parent), mId(-1), mName(""), mRootList(0)
 {
 }
 
@@ -31,16 +71,7 @@ Xtras::Xtras(QObject *parent) :
  */
 void Xtras::fillFromMap(const QVariantMap& xtrasMap)
 {
-	mId = xtrasMap.value(idKey).toInt();
-	mName = xtrasMap.value(nameKey).toString();
-	mTextStringList = xtrasMap.value(textKey).toStringList();
-	// mValues is Array of int
-	QVariantList valuesList;
-	valuesList = xtrasMap.value(valuesKey).toList();
-	mValues.clear();
-	for (int i = 0; i < valuesList.size(); ++i) {
-		mValues.append(valuesList.at(i).toInt());
-	}
+	fillFrom(xtrasMap, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -51,16 +82,7 @@ void Xtras::fillFromMap(const QVariantMap& xtrasMap)
  */
 void Xtras::fillFromForeignMap(const QVariantMap& xtrasMap)
 {
-	mId = xtrasMap.value(idForeignKey).toInt();
-	mName = xtrasMap.value(nameForeignKey).toString();
-	mTextStringList = xtrasMap.value(textForeignKey).toStringList();
-	// mValues is Array of int
-	QVariantList valuesList;
-	valuesList = xtrasMap.value(valuesForeignKey).toList();
-	mValues.clear();
-	for (int i = 0; i < valuesList.size(); ++i) {
-		mValues.append(valuesList.at(i).toInt());
-	}
+	fillFrom(xtrasMap, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
 }
 /*
  * initialize OrderData from QVariantMap
@@ -71,15 +93,59 @@ void Xtras::fillFromForeignMap(const QVariantMap& xtrasMap)
  */
 void Xtras::fillFromCacheMap(const QVariantMap& xtrasMap)
 {
-	mId = xtrasMap.value(idKey).toInt();
-	mName = xtrasMap.value(nameKey).toString();
-	mTextStringList = xtrasMap.value(textKey).toStringList();
-	// mValues is Array of int
-	QVariantList valuesList;
-	valuesList = xtrasMap.value(valuesKey).toList();
+	fillFrom(xtrasMap, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+}
+
+/*
+ * initialize Xtras from QVariantMap
+ * walks xtrasMap only once: each key is dispatched by xtrasField()
+ * keyNaming: own property names or names from Server API
+ * transientPolicy WITHOUT_TRANSIENT ignores transient values (cache)
+ * corresponding export method: writeTo()
+ */
+void Xtras::fillFrom(const QVariantMap& xtrasMap, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	TraceSpan span("Xtras::fillFrom", "dto");
+	// properties not contained in xtrasMap get default values
+	mId = 0;
+	mName = QString();
+	mTextStringList.clear();
 	mValues.clear();
-	for (int i = 0; i < valuesList.size(); ++i) {
-		mValues.append(valuesList.at(i).toInt());
+	QVariantMap::const_iterator it;
+	for (it = xtrasMap.constBegin(); it != xtrasMap.constEnd(); ++it) {
+		switch (xtrasField(it.key(), keyNaming)) {
+		case ID_FIELD:
+			mId = it.value().toInt();
+			break;
+		case NAME_FIELD:
+			mName = it.value().toString();
+			break;
+		case TEXT_FIELD:
+			mTextStringList = it.value().toStringList();
+			break;
+		case VALUES_FIELD: {
+			// mValues is Array of int
+			// binary caches deliver the packed QVector - shared, not copied
+			if (it.value().userType() == qMetaTypeId<QVector<int> >()) {
+				mValues = it.value().value<QVector<int> >();
+				break;
+			}
+			QVariantList valuesList;
+			valuesList = it.value().toList();
+			mValues.resize(valuesList.size());
+			int* values = mValues.data();
+			for (int i = 0; i < valuesList.size(); ++i) {
+				values[i] = valuesList.at(i).toInt();
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	if (mRootList) {
+		mRootList->keyChanged(this);
 	}
 }
 
@@ -105,14 +171,11 @@ bool Xtras::isValid()
  */
 QVariantMap Xtras::toMap()
 {
-	QVariantMap xtrasMap;
-	xtrasMap.insert(idKey, mId);
-	xtrasMap.insert(nameKey, mName);
-	// Array of QString
-	xtrasMap.insert(textKey, mTextStringList);
-	// Array of int
-	xtrasMap.insert(valuesKey, valuesList());
-	return xtrasMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 /*
@@ -122,14 +185,11 @@ QVariantMap Xtras::toMap()
  */
 QVariantMap Xtras::toForeignMap()
 {
-	QVariantMap xtrasMap;
-	xtrasMap.insert(idForeignKey, mId);
-	xtrasMap.insert(nameForeignKey, mName);
-	// Array of QString
-	xtrasMap.insert(textForeignKey, mTextStringList);
-	// Array of int
-	xtrasMap.insert(valuesForeignKey, valuesList());
-	return xtrasMap;
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::FOREIGN_KEYS, DataWriter::WITH_TRANSIENT);
+	writer.endObject();
+	return writer.map();
 }
 
 
@@ -140,9 +200,30 @@ QVariantMap Xtras::toForeignMap()
  */
 QVariantMap Xtras::toCacheMap()
 {
-	// no transient properties found from data model
-	// use default toMao()
-	return toMap();
+	VariantMapWriter writer;
+	writer.beginObject();
+	writeTo(&writer, DataWriter::OWN_KEYS, DataWriter::WITHOUT_TRANSIENT);
+	writer.endObject();
+	return writer.map();
+}
+
+/*
+ * writes all properties into the current object of writer
+ * used by toMap(), toForeignMap(), toCacheMap() and to write caches
+ * keyNaming: own property names or names from Server API
+ * no transient properties found from data model
+ */
+void Xtras::writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+		const DataWriter::TransientPolicy& transientPolicy)
+{
+	bool foreign = (keyNaming == DataWriter::FOREIGN_KEYS);
+	Q_UNUSED(transientPolicy);
+	writer->writeInt(foreign ? idForeignKey : idKey, mId);
+	writer->writeString(foreign ? nameForeignKey : nameKey, mName);
+	// Array of QString
+	writer->writeStringList(foreign ? textForeignKey : textKey, mTextStringList);
+	// Array of int
+	writer->writeIntList(foreign ? valuesForeignKey : valuesKey, mValues);
 }
 // ATT 
 // Mandatory: id
@@ -156,9 +237,16 @@ void Xtras::setId(int id)
 {
 	if (id != mId) {
 		mId = id;
+		if (mRootList) {
+			mRootList->keyChanged(this);
+		}
 		emit idChanged(id);
 	}
 }
+void Xtras::setRootList(DenseObjectList* rootList)
+{
+	mRootList = rootList;
+}
 // ATT 
 // Optional: name
 QString Xtras::name() const
@@ -186,7 +274,7 @@ bool Xtras::removeFromTextStringList(const QString& stringValue)
     bool ok = false;
     ok = mTextStringList.removeOne(stringValue);
     if (!ok) {
-    	qDebug() << "QString& not found in mTextStringList: " << stringValue;
+    	DATA_LOG(DATA_LOG_DTO) << "QString& not found in mTextStringList: " << stringValue;
     	return false;
     }
     emit removedFromTextStringList(stringValue);
@@ -217,12 +305,12 @@ void Xtras::addToValuesList(const int& intValue)
 
 bool Xtras::removeFromValuesList(const int& intValue)
 {
-    bool ok = false;
-    ok = mValues.removeOne(intValue);
-    if (!ok) {
-    	qDebug() << "int& not found in : mValues" << intValue;
+    int i = mValues.indexOf(intValue);
+    if (i < 0) {
+    	DATA_LOG(DATA_LOG_DTO) << "int& not found in : mValues" << intValue;
     	return false;
     }
+    mValues.remove(i);
     emit removedFromValuesList(intValue);
     return true;
 }
@@ -230,25 +318,22 @@ int Xtras::valuesCount()
 {
     return mValues.size();
 }
-QList<int> Xtras::values()
+QVector<int> Xtras::values()
 {
     return mValues;
 }
-void Xtras::setValues(QList<int> values)
+void Xtras::setValues(const QVector<int>& values)
 {
     if (values != mValues) {
         mValues = values;
-        QVariantList variantList;
-        for (int i = 0; i < values.size(); ++i) {
-            variantList.append(values.at(i));
-        }
-        emit valuesListChanged(variantList);
+        emit valuesListChanged(valuesList());
     }
 }
 // access from QML to values
 QVariantList Xtras::valuesList()
 {
 	QVariantList variantList;
+	variantList.reserve(mValues.size());
     for (int i = 0; i < mValues.size(); ++i) {
         variantList.append(mValues.at(i));
     }
@@ -256,13 +341,77 @@ QVariantList Xtras::valuesList()
 }
 void Xtras::setValuesList(const QVariantList& values) 
 {
-	mValues.clear();
+	mValues.resize(values.size());
     for (int i = 0; i < values.size(); ++i) {
-        mValues.append(values.at(i).toInt());
+        mValues[i] = values.at(i).toInt();
     }
 }
+qlonglong Xtras::valuesSum()
+{
+	return AggregationKernels::sum(mValues.constData(), mValues.size());
+}
+int Xtras::valuesMin()
+{
+	int minValue = 0;
+	int maxValue = 0;
+	AggregationKernels::minMax(mValues.constData(), mValues.size(), minValue, maxValue);
+	return minValue;
+}
+int Xtras::valuesMax()
+{
+	int minValue = 0;
+	int maxValue = 0;
+	AggregationKernels::minMax(mValues.constData(), mValues.size(), minValue, maxValue);
+	return maxValue;
+}
+double Xtras::valuesMean()
+{
+	if (mValues.isEmpty()) {
+		return 0.0;
+	}
+	return (double) AggregationKernels::sum(mValues.constData(), mValues.size()) / mValues.size();
+}
+QVariantMap Xtras::valuesHistogram(int bucketCount)
+{
+	QVariantMap histogramMap;
+	int minValue = 0;
+	int maxValue = 0;
+	if (bucketCount < 1
+			|| !AggregationKernels::minMax(mValues.constData(), mValues.size(), minValue, maxValue)) {
+		return histogramMap;
+	}
+	// round up: maxValue always falls into the last bucket
+	qint64 range = (qint64) maxValue - minValue + 1;
+	qint64 bucketWidth = (range + bucketCount - 1) / bucketCount;
+	QVector<int> counts(bucketCount, 0);
+	if (bucketCount == 1) {
+		// INT_MIN .. INT_MAX needs a width of 2^32 - not an unsigned int
+		counts[0] = mValues.size();
+	} else {
+		AggregationKernels::histogram(mValues.constData(), mValues.size(), minValue,
+				(unsigned int) bucketWidth, counts.data(), bucketCount);
+	}
+	QVariantList countList;
+	countList.reserve(bucketCount);
+	for (int i = 0; i < bucketCount; ++i) {
+		countList.append(counts.at(i));
+	}
+	histogramMap.insert("min", minValue);
+	histogramMap.insert("max", maxValue);
+	histogramMap.insert("bucketWidth", (qlonglong) bucketWidth);
+	histogramMap.insert("counts", countList);
+	return histogramMap;
+}
 
 
+// estimated memory of this Xtras
+void Xtras::addMemoryUsage(MemoryUsage* usage) const
+{
+	qint64 stringBytes = MemoryUsage::stringBytes(mName) + MemoryUsage::stringListBytes(mTextStringList);
+	usage->addObject(MemoryUsage::XTRAS, MemoryUsage::objectBytes(sizeof(Xtras)), stringBytes,
+			MemoryUsage::vectorBytes(mValues.capacity(), sizeof(int)));
+}
+
 Xtras::~Xtras()
 {
 	// place cleanUp code here
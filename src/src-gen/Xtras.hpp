@@ -5,10 +5,15 @@
 #include <qvariant.h>
 #include <QDeclarativeListProperty>
 #include <QStringList>
+#include <QVector>
+#include "../DataWriter.hpp"
 
 
 
 
+class MemoryUsage;
+class DenseObjectList;
+
 class Xtras: public QObject
 {
 	Q_OBJECT
@@ -27,6 +32,8 @@ public:
 	void fillFromMap(const QVariantMap& xtrasMap);
 	void fillFromForeignMap(const QVariantMap& xtrasMap);
 	void fillFromCacheMap(const QVariantMap& xtrasMap);
+	void fillFrom(const QVariantMap& xtrasMap, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
 	
 	void prepareNew();
 	
@@ -37,6 +44,13 @@ public:
 	QVariantMap toForeignMap();
 	QVariantMap toCacheMap();
 
+	void writeTo(DataWriter* writer, const DataWriter::KeyNaming& keyNaming,
+			const DataWriter::TransientPolicy& transientPolicy);
+
+	void addMemoryUsage(MemoryUsage* usage) const;
+	// root list of DataManager - informed if the id changes
+	void setRootList(DenseObjectList* rootList);
+
 	int id() const;
 	void setId(int id);
 	QString name() const;
@@ -64,13 +78,31 @@ public:
 	Q_INVOKABLE
 	int valuesCount();
 	
-	// access from C++ to values
-	QList<int> values();
-	void setValues(QList<int> values);
+	// access from C++ to values (packed)
+	QVector<int> values();
+	void setValues(const QVector<int>& values);
 	// access from QML to values (array of int)
 	QVariantList valuesList();
 	void setValuesList(const QVariantList& values);
 
+	// statistics over values - 0 if there are no values
+	Q_INVOKABLE
+	qlonglong valuesSum();
+
+	Q_INVOKABLE
+	int valuesMin();
+
+	Q_INVOKABLE
+	int valuesMax();
+
+	Q_INVOKABLE
+	double valuesMean();
+
+	// bucketCount buckets of equal width from valuesMin() to valuesMax()
+	// map: min, max, bucketWidth, counts (list of int)
+	Q_INVOKABLE
+	QVariantMap valuesHistogram(int bucketCount);
+
 
 	virtual ~Xtras();
 
@@ -91,7 +123,10 @@ private:
 	int mId;
 	QString mName;
 	QStringList mTextStringList;
-	QList<int> mValues;
+	// packed: filled in one step from binary caches
+	QVector<int> mValues;
+
+	DenseObjectList* mRootList;
 
 	Q_DISABLE_COPY (Xtras)
 };